@@ -1,7 +1,10 @@
 #ifndef JAY_ADVECTION_ADVECTED_FIELD_HPP
 #define JAY_ADVECTION_ADVECTED_FIELD_HPP
 
+#include <algorithm>
+
 #include <jay/advection/field_objects.hpp>
+#include <jay/advection/trajectory_export.hpp>
 
 #include <jay/export.hpp>
 #include <glm/glm.hpp>
@@ -30,6 +33,11 @@ namespace jay
     std::unique_ptr<globjects::Buffer> b_utility0  = nullptr;
     std::unique_ptr<globjects::Buffer> b_utility1  = nullptr;
     std::unique_ptr<globjects::Buffer> b_utility2 = nullptr;
+    std::unique_ptr<globjects::Buffer> b_trace_lengths = nullptr;
+    std::unique_ptr<globjects::Buffer> b_trace_offsets = nullptr;   // Prefix sum of the lengths (compaction)
+
+    std::unique_ptr<trajectory_export> pos_export  = nullptr;
+    std::unique_ptr<trajectory_export> velo_export = nullptr;
 
     //std::unique_ptr<globjects::StaticStringSource>   vertex_shader_source   = nullptr;
     std::unique_ptr<globjects::File>   vertex_shader_source   = nullptr;
@@ -53,6 +61,7 @@ namespace jay
     double t_milliseconds_per_frame = 0.0;  // Inverse of FPS, averaged over 100 frames
 
     advected_field();
+    ~advected_field();
     void init_configuration(antMenu* menu);
     void init_render_conf(antMenu* menu);
     void init_shading_conf(antMenu* menu);
@@ -67,9 +76,15 @@ namespace jay
     void enable_array_buffers();
     void enable_element_array_buffer();
     void setup_triangle_element_array_buffer();
+    // Quads between two sets of traces in one position buffer (the second one starting at vertex base1), ranges as of get_trace_ranges(..).
+    // Traces are frozen after their last vertex, quads past the ends of both are left out.
+    void setup_triangle_element_array_buffer(const std::vector<gl::GLuint>& first0, const std::vector<gl::GLuint>& count0,
+                                             const std::vector<gl::GLuint>& first1, const std::vector<gl::GLuint>& count1, gl::GLuint base1);
     void setup_triangle_strip_element_array_buffer();
     void export_positions(antMenu* menu);
     void export_velocities(antMenu* menu);
+    // Advances running exports (call once per frame)
+    void update_exports(antMenu* menu);
     void export_image(antMenu* menu);
     void load_positions(std::string filepath);
     void load_velocities(std::string filepath);
@@ -97,19 +112,76 @@ namespace jay
       return buffer->getSubData<T>(read, offset);
     }
 
-    // Returns a vector holding the content of the velocity buffer.
+    // Returns the content of a compacted buffer in the full seed * step layout, terminated traces are frozen after their last vertex.
+    // offset (bytes) and read (items) refer to the full layout.
+    template <typename T>
+    std::vector<T> read_compacted_buffer(std::unique_ptr<globjects::Buffer>& buffer, std::size_t offset = 0, std::size_t read = 0)
+    {
+      fetch_trace_ranges();
+
+      const std::size_t per_vertex = 4 * sizeof(float) / sizeof(T);
+      const std::size_t steps      = r_conf->step_count;
+      const auto        packed     = read_buffer<T>(buffer);
+
+      std::vector<T> full(trace_lengths.size() * steps * per_vertex);
+      for (std::size_t s = 0; s < trace_lengths.size(); s++)
+      {
+        const std::size_t length = std::min<std::size_t>(trace_lengths[s], steps);
+        if (length == 0)
+          continue;
+
+        auto src = packed.begin() + trace_offsets[s] * per_vertex;
+        auto dst = full.begin() + s * steps * per_vertex;
+        std::copy(src, src + length * per_vertex, dst);
+
+        for (std::size_t i = length; i < steps; i++)
+          std::copy(src + (length - 1) * per_vertex, src + length * per_vertex, dst + i * per_vertex);
+      }
+
+      if (offset == 0 && read == 0)
+        return full;
+
+      const std::size_t first = std::min(offset / sizeof(T), full.size());
+      const std::size_t count = (read == 0) ? full.size() - first : std::min(read, full.size() - first);
+      return std::vector<T>(full.begin() + first, full.begin() + first + count);
+    }
+
+    // Returns the vertices of the position buffer as stored: compacted traces without their terminated vertices.
+    // Seed s starts at vertex first[s] and holds count[s] vertices (see get_trace_ranges(..)).
+    template <typename T>
+    std::vector<T> get_packed_positions()
+    {
+      return read_buffer<T>(b_positions);
+    }
+
+    // Same as get_packed_positions() for the velocity buffer.
+    template <typename T>
+    std::vector<T> get_packed_velocity()
+    {
+      return read_buffer<T>(b_velocity);
+    }
+
+    // Returns a vector holding the content of the position buffer (always in the full seed * step layout).
+    // Prefer get_packed_positions() for compacted traces, this expands them again.
     // If T holds all vector components at once (e.g. glm::vec3) set vec_len = 1.
     template <typename T>
     std::vector<T> get_positions(std::size_t offset = 0, std::size_t read = 0)
     {
+      if (compacted)
+        return read_compacted_buffer<T>(b_positions, offset, read);
+
       return read_buffer<T>(b_positions, offset, read);
     }
 
-    // Returns a vector holding the content of the position buffer.
+    // Returns a vector holding the content of the velocity buffer (always in the full seed * step layout).
+    // Prefer get_packed_velocity() for compacted traces, this expands them again.
     // If T holds all vector components at once (e.g. glm::vec3) set vec_len = 1.
     template <typename T>
     std::vector<T> get_velocity(std::size_t offset = 0, std::size_t read = 0)
     {
+      if (compacted)
+        return read_compacted_buffer<T>(b_velocity, offset, read);
+
       return read_buffer<T>(b_velocity, offset, read);
     }
 
@@ -118,7 +190,29 @@ namespace jay
     std::vector<void*>       indexFirst;
     std::vector<int>         indexCount;
 
+    // Early termination: positions & velocities hold only the valid vertices, seed s starts at trace_offsets[s]
+    // (call fetch_trace_ranges() before reading them after a compaction)
+    bool                     compacted = false;
+    std::vector<gl::GLuint>  trace_offsets;
+    std::vector<gl::GLuint>  trace_lengths;
+
+    // Copies the lengths & offsets of a compaction into a staging buffer, fetch_trace_ranges() reads them once the fence signals
+    void request_trace_ranges();
+    // Waits for the requested ranges (if any) and updates trace_offsets & trace_lengths
+    void fetch_trace_ranges();
+    // First vertex & vertex count of each seed in the position & velocity buffers (compacted or full layout)
+    void get_trace_ranges(std::vector<gl::GLuint>& first, std::vector<gl::GLuint>& count);
+
+    // Progressive advection: seeds [0, ready_seeds) hold next_steps vertices, the others ready_steps
+    bool                     in_progress = false;
+    std::uint32_t            ready_seeds = 0;
+    std::uint32_t            ready_steps = 0;
+    std::uint32_t            next_steps  = 0;
+
     protected:
+      // Creates a buffer from a file written by trajectory_io and updates the seed & step count
+      std::unique_ptr<globjects::Buffer> load_trajectories(std::string filepath);
+
       glm::mat4 projection = glm::mat4(1.0);
       glm::mat4 view = glm::mat4(1.0);
       glm::mat4 model = glm::mat4(1.0);
@@ -126,6 +220,10 @@ namespace jay
 
       gl::GLsizei draw_steps = 0;
       gl::GLsizei draw_seeds = 0;
+
+      std::vector<gl::GLuint>            triangle_first;             // First index of each seed in b_indices (triangles), one past the last
+      std::unique_ptr<globjects::Buffer> b_range_readback = nullptr;
+      gl::GLsync                         range_fence      = nullptr;
   };
 }
 
@@ -10,11 +10,13 @@ namespace jay
 {  
   typedef struct vector_field vector_field;
   typedef struct antMenu antMenu;
+  typedef struct timestep_source timestep_source;
 
   struct advection_pass : render_pass
   {
     advection_pass(std::vector<float>& data, vector_field* field, antMenu* menu, bool prefer_2darray = false);
     advection_pass(std::vector<astc_datatype>& data, std::vector<float>& denormalization_data, vector_field* field, antMenu* menu);
+    advection_pass(timestep_source& data, vector_field* field, antMenu* menu, bool prefer_2darray = false);
 
     // Local variables
     int advection_count;
@@ -22,6 +24,7 @@ namespace jay
 
   JAY_EXPORT advection_pass make_advection_pass(std::vector<float>& data, vector_field* field, antMenu* menu, bool prefer_2darray = false);
   JAY_EXPORT advection_pass make_advection_pass(std::vector<astc_datatype>& data, std::vector<float>& denormalization_data, vector_field* field, antMenu* menu);
+  JAY_EXPORT advection_pass make_advection_pass(timestep_source& data, vector_field* field, antMenu* menu, bool prefer_2darray = false);
 
 }
 
@@ -1,6 +1,9 @@
 #ifndef JAY_ADVECTION_FIELD_OBJECTS_HPP
 #define JAY_ADVECTION_FIELD_OBJECTS_HPP
 
+#include <string>
+#include <vector>
+
 #include <glbinding/gl/types.h>
 #include <glbinding/gl/enum.h>
 #include <glm/vec4.hpp>
@@ -19,6 +22,18 @@ namespace jay
     int pos_binding;
     int vel_binding;
     int denorm_binding;
+
+    // Early termination: particles leaving the domain stop, the valid vertices are compacted afterwards
+    bool early_termination;
+    int  length_binding;
+    int  offset_binding;
+    int  packed_pos_binding;
+    int  packed_vel_binding;
+    int  scan_binding;          // Prefix sum of the lengths (scan.glsl)
+    int  scan_sum_binding;
+
+    // Seeds traced along a space-filling curve (seeding_conf::ordering), invocation i traces seed order[i]
+    int  order_binding;
   };
 
   struct render_conf
@@ -62,6 +77,14 @@ namespace jay
     std::vector<int> indices;
   };
 
+  // Values of seeding_conf::ordering
+  enum seed_ordering : gl::GLuint
+  {
+    SeedOrderGrid    = 0,   // x fastest
+    SeedOrderMorton  = 1,
+    SeedOrderHilbert = 2
+  };
+
   struct seeding_conf
   {
     // UBO Content
@@ -72,10 +95,20 @@ namespace jay
 
     // Meta info
     glm::vec3 seeds;
+    gl::GLuint ordering = SeedOrderGrid;   // Order the seeds are traced in (results stay in grid order)
     int binding;
     std::string name;
   };
 
+  // Values of integration_conf::strategy
+  enum integration_strategy : gl::GLuint
+  {
+    StrategyEuler = 0,
+    StrategyRK4   = 1,
+    StrategyRK45  = 2,
+    StrategyABM4  = 3
+  };
+
   struct integration_conf
   {
     // UBO Content (Strategies)
@@ -91,6 +124,12 @@ namespace jay
     gl::GLuint global_step_count;
     gl::GLuint local_step_count;
     gl::GLuint remainder_step_count;
+    // UBO Content (adaptive strategies)
+    gl::GLfloat tolerance        = 1e-3f;
+    gl::GLfloat step_size_min    = 1e-3f;
+    gl::GLfloat step_size_max    = 1.0f;
+    gl::GLuint  resample_mode    = 0;       // 0: every accepted step, 1: fixed time, 2: fixed arc length
+    gl::GLfloat resample_spacing = 0.0f;    // <= 0: step_size_h
 
     // Meta info
     int binding;
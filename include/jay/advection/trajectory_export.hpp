@@ -0,0 +1,117 @@
+#ifndef JAY_ADVECTION_TRAJECTORY_EXPORT_HPP
+#define JAY_ADVECTION_TRAJECTORY_EXPORT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+#include <globjects/Buffer.h>
+
+#include <jay/io/trajectory_io.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* Exports a trajectory buffer without reading it back as a whole.
+   * The source is copied into a private buffer on the GPU right away, so it may be replaced or re-advected while the export runs.
+   * Chunks of whole seeds are copied into a small ring of persistently mapped staging buffers.
+   * A fence tells when a copy is done; the chunk is then encoded & written by a background thread.
+   * update() never waits for the GPU, so it can be called once per frame while the render loop keeps running.
+   * Host memory is bounded by ring_size * chunk_bytes (plus the encoded chunk).
+   */
+  struct JAY_EXPORT trajectory_export
+  {
+    trajectory_export(
+      globjects::Buffer* source,
+      std::uint32_t      seeds,
+      std::uint32_t      steps,
+      trajectory_kind    kind,
+      std::string        filepath,
+      std::size_t        chunk_bytes = 64 * 1024 * 1024,
+      std::size_t        ring_size   = 3
+    );
+    // Compacted source: seed s holds lengths[s] vec4 (at most steps), packed one after another
+    trajectory_export(
+      globjects::Buffer*         source,
+      std::vector<std::uint32_t> lengths,
+      std::uint32_t              steps,
+      trajectory_kind            kind,
+      std::string                filepath,
+      std::size_t                chunk_bytes = 64 * 1024 * 1024,
+      std::size_t                ring_size   = 3
+    );
+    ~trajectory_export();
+
+    trajectory_export(const trajectory_export&) = delete;
+    trajectory_export& operator=(const trajectory_export&) = delete;
+
+    // Retires finished copies and issues new ones. Returns true once the file is complete.
+    bool  update();
+    // Blocks until the export is complete. Returns false on failure.
+    bool  finish();
+
+    bool  done()     const;
+    bool  failed()   const;
+    // Written seeds / all seeds
+    float progress() const;
+
+  protected:
+    trajectory_export(
+      globjects::Buffer*         source,
+      std::uint32_t              seeds,
+      std::uint32_t              steps,
+      std::vector<std::uint32_t> lengths,
+      trajectory_kind            kind,
+      std::string                filepath,
+      std::size_t                chunk_bytes,
+      std::size_t                ring_size
+    );
+
+    enum class slot_state { Free, Copying, Writing };
+
+    struct staging_slot
+    {
+      std::unique_ptr<globjects::Buffer> buffer;
+      const float*                       mapped = nullptr;
+      gl::GLsync                         fence  = nullptr;
+      std::uint32_t                      first  = 0;
+      std::uint32_t                      seeds  = 0;
+      std::atomic<slot_state>            state  { slot_state::Free };
+    };
+
+    std::unique_ptr<globjects::Buffer> source;            // Private copy of the exported buffer
+    std::uint32_t             seeds;
+    std::uint32_t             steps;
+    std::uint32_t             seeds_per_chunk;
+    std::uint32_t             issued_seeds = 0;
+    std::atomic<std::uint32_t> written_seeds{ 0 };
+
+    // Compacted source only (empty otherwise)
+    std::vector<std::uint32_t> lengths;
+    std::vector<std::size_t>   vertex_first;              // Prefix sum of lengths (seeds + 1)
+
+    std::vector<std::unique_ptr<staging_slot>> slots;
+    std::deque<std::size_t>                    copying;   // Slots in the order their copies were issued
+
+    // Background writer
+    trajectory_writer         writer;
+    std::thread               writer_thread;
+    std::mutex                m;
+    std::condition_variable   cv;
+    std::deque<std::size_t>   writing;                   // Slots waiting to be written (in order)
+    bool                      all_issued = false;
+    std::atomic<bool>         complete   { false };
+    std::atomic<bool>         error      { false };
+
+    void write_loop();
+  };
+}
+
+#endif
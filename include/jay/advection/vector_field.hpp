@@ -6,18 +6,22 @@
 #include <jay/advection/field_objects.hpp>
 
 #include <jay/advection/advected_field.hpp>
+#include <jay/integration/trace_cache.hpp>
 #include <jay/types/image.hpp>
 #include <jay/types/jaydata.hpp>
 #include <jay/analysis/performance_measure.hpp>
 
 #include <glbinding/gl/enum.h>
 
+#include <deque>
 #include <vector>
 
 #include <jay/export.hpp>
 
 namespace jay
 {
+  typedef struct timestep_source timestep_source;
+
   struct JAY_EXPORT vector_field
   {
     compute_conf* c_conf = nullptr;
@@ -36,12 +40,25 @@ namespace jay
     std::unique_ptr<globjects::UniformBlock> ubo_integration = nullptr;
     std::unique_ptr<globjects::Buffer>       b_seeding       = nullptr;
     std::unique_ptr<globjects::Buffer>       b_integration   = nullptr;
+    std::unique_ptr<globjects::Buffer>       b_seed_order    = nullptr;
 
     std::unique_ptr<globjects::StaticStringSource>   compute_shader_source   = nullptr;
     std::unique_ptr<globjects::AbstractStringSource> compute_shader_template = nullptr;
     std::unique_ptr<globjects::Shader>               compute_shader          = nullptr;
     std::unique_ptr<globjects::Program>              compute_program         = nullptr;
 
+    std::unique_ptr<globjects::StaticStringSource>   compact_shader_source   = nullptr;
+    std::unique_ptr<globjects::Shader>               compact_shader          = nullptr;
+    std::unique_ptr<globjects::Program>              compact_program         = nullptr;
+
+    std::unique_ptr<globjects::StaticStringSource>   scan_shader_source      = nullptr;
+    std::unique_ptr<globjects::Shader>               scan_shader             = nullptr;
+    std::unique_ptr<globjects::Program>              scan_program            = nullptr;
+
+    std::unique_ptr<globjects::StaticStringSource>   extend_shader_source    = nullptr;
+    std::unique_ptr<globjects::Shader>               extend_shader           = nullptr;
+    std::unique_ptr<globjects::Program>              extend_program          = nullptr;
+
     std::unique_ptr<advected_field> output = nullptr;
 
     vector_field(bool steady_vectorfield = true);
@@ -90,8 +107,43 @@ namespace jay
     void update_advection_count();
 
     double advect(bool measure_time = true);
+    // Steady advection through a trace_cache: only seeds missing in the cache are dispatched (via the seed order buffer),
+    // the cached trajectories are uploaded. As many new ones as fit into the budget are copied to staging buffers & cached
+    // by fetch_cached_traces(..) once the copies are done. Cache entries are tied to the uploaded texture.
+    double advect_cached(bool measure_time = true);
+    // Caches the trajectories copied by earlier advect_cached(..) calls whose fences signaled (all of them if wait),
+    // true if none are left in flight. Called by advect_cached(..), call it once per frame to cache them earlier.
+    bool        fetch_cached_traces(bool wait = false);
+    // Budget of the trace cache used by advect_cached(..), 0 disables it (default)
+    void        set_trace_cache(std::size_t budget_bytes);
+    bool        caching() const;
+    trace_cache* get_trace_cache();
+    // Seeds dispatched by the last advect_cached(..) (cache misses)
+    std::size_t get_traced_seeds() const;
     double unsteady_advect(std::vector<float>& data, bool measure_time = true);
     double unsteady_advect(std::vector<astc_datatype>& data, bool measure_time = true);
+    // Streams the timesteps instead of reading them from a fully loaded field
+    double unsteady_advect(timestep_source& data, bool measure_time = true);
+    // Packs the valid vertices of all seeds after an advection with early termination (no-op otherwise).
+    // The offsets are summed up on the GPU and the full buffers are released, only the vertex count is read back right away
+    // (the per seed ranges follow through a fenced copy, see advected_field::fetch_trace_ranges()).
+    double compact(bool measure_time = true);
+
+    // True if only the step count grew since the last steady Euler / RK4 advection (same seeds & parameters)
+    bool extendable() const;
+    // Grows the position & velocity buffers to the new step count, the traced vertices are copied on the GPU
+    double extend_storage_buffers(bool measure_time = true);
+    // Integrates only the new steps, starting from the last vertex of every trace
+    double extend(bool measure_time = true);
+
+    // Progressive (steady) advection: the trace is split into chunks of seeds & steps (whole traces for RK45 & ABM4),
+    // dispatched over several frames. Call begin_progressive(..) after update_storage_buffers(..), then advect_progressive(..)
+    // once per frame: it dispatches as many chunks as fit into budget_ms of GPU time & returns true once the trace is complete.
+    // The GPU time is estimated from the timings of earlier frames, no frame waits for the GPU.
+    void   begin_progressive(std::uint32_t step_chunk = 128);
+    bool   advect_progressive(double budget_ms);
+    bool   in_progress()  const;
+    float  get_progress() const;   // 0 - 1
 
     // Returns an object holding all information for rendering the result
     advected_field* get_result();    
@@ -102,6 +154,50 @@ namespace jay
   protected:
     long int generation_count = -1;
 
+    // Configuration of the last steady advection (see extendable())
+    bool             traced             = false;
+    bool             traced_termination = false;
+    seeding_conf     traced_s_conf;
+    integration_conf traced_i_conf;
+
+    void remember_trace();
+
+    std::unique_ptr<trace_cache> cache;
+    std::uint64_t                texture_version = 1;   // Changes with every upload to the textures / denormalization buffer (field id of the cache entries)
+    std::size_t                  traced_seeds    = 0;
+
+    // Trajectories of dispatched seeds on their way to the cache (see fetch_cached_traces(..))
+    struct cache_readback
+    {
+      trace_cache::key                   k;
+      std::vector<glm::vec3>             seeds;
+      std::size_t                        steps        = 0;   // Cached steps per seed (at most, if terminated)
+      std::size_t                        global_steps = 0;   // Stride of the staging buffers
+      std::unique_ptr<globjects::Buffer> b_positions  = nullptr;
+      std::unique_ptr<globjects::Buffer> b_velocity   = nullptr;
+      std::unique_ptr<globjects::Buffer> b_lengths    = nullptr;   // Terminated traces only
+      gl::GLsync                         fence        = nullptr;
+    };
+    std::deque<cache_readback> cache_readbacks;
+
+    void release_cache_readbacks();
+
+    // Progressive advection: every round traces steps [progress_step, + progress_chunk) of all seeds, chunk by chunk
+    bool        progressive      = false;
+    std::size_t progress_seed    = 0;     // First seed of the next chunk
+    std::size_t progress_step    = 0;     // First step of the current round
+    std::size_t progress_chunk   = 0;
+    double      ms_per_step      = 0.0;   // Estimated GPU time per seed & step
+
+    // Nothing waits for the GPU: the timings & trace lengths of a frame are read in later frames
+    std::deque<std::size_t>            interval_work;          // Seeds * steps of the timed frames in flight (0: earlier trace)
+    std::unique_ptr<globjects::Buffer> b_length_readback = nullptr;
+    gl::GLsync                         length_fence      = nullptr;
+
+    void release_length_fence();
+    // Exclusive prefix sum of count values in place (scan.glsl), blocks of 256 recursively
+    void prefix_sum(globjects::Buffer* values, gl::GLuint count);
+
     void setup_texture(std::unique_ptr<globjects::Texture>& texture, int texture_index, std::string sampler_name);
     void setup_compressed_texture(std::unique_ptr<globjects::Texture>& texture, int texture_index, std::string sampler_name);
 
@@ -28,6 +28,11 @@ namespace jay
   // Each element in vector denominates the area of a quad. The quads are ordered by seed, having vertices_per_seed-1 quads for each seed.
   std::vector<double> calculate_seed_area(std::vector<float>& b_pos0, std::vector<float>& b_pos1, std::size_t seeds);
 
+  // Same as above for packed (compacted) traces: seed s of b_posN holds countN[s] elements from firstN[s] on.
+  // Traces are frozen after their last vertex (as in the full layout of advected_field::get_positions(..)), seeds without vertices have no area.
+  std::vector<double> calculate_seed_area(const std::vector<float>& b_pos0, const std::vector<unsigned int>& first0, const std::vector<unsigned int>& count0,
+                                          const std::vector<float>& b_pos1, const std::vector<unsigned int>& first1, const std::vector<unsigned int>& count1);
+
   std::size_t get_count_quads_per_seed(std::size_t elements_per_seed);
 
   // Calculates arithmetic mean for a single dimension.
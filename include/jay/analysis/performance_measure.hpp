@@ -45,6 +45,13 @@ namespace jay
 
     static bool timings_available();
 
+    // GPU time between two timestamps of this object's own (not collected by get_GPU_timings(), e.g. for scheduling work).
+    // Nothing waits for the GPU: poll_GPU_interval(..) returns the oldest finished interval (ms) once its timestamps arrived.
+    // Up to 4 intervals are in flight, start_GPU_interval() returns false (& measures nothing) if all of them are.
+    bool   start_GPU_interval();
+    void   end_GPU_interval();
+    bool   poll_GPU_interval(double& ms);
+
 
   private:
     static void wait_for_GPU(int query_id);
@@ -55,6 +62,11 @@ namespace jay
     static std::vector<std::uint32_t> gl_query_ids_;
     static std::vector<std::chrono::steady_clock::time_point> cpu_times_t1_;
     static std::vector<std::chrono::steady_clock::time_point> cpu_times_t2_;
+
+    // Start & end query of each interval, a ring of the intervals in flight
+    std::uint32_t interval_queries[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    std::size_t   interval_first = 0;
+    std::size_t   interval_count = 0;
   };
 }
 
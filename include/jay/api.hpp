@@ -28,9 +28,33 @@
 #include <jay/io/io_enums.hpp>
 #include <jay/io/io.hpp>
 #include <jay/io/image_io.hpp>
+#include <jay/io/timestep_source.hpp>
+#include <jay/io/hdf5_series.hpp>
+#include <jay/io/trajectory_io.hpp>
+#include <jay/io/paged_field.hpp>
+#include <jay/io/dataset_server.hpp>
 #include <jay/compression/compressor.hpp>
 #include <jay/compression/astc.hpp>
 
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+#include <jay/integration/particle_batch.hpp>
+#include <jay/integration/unsteady_cpu_tracer.hpp>
+#include <jay/integration/rk45.hpp>
+#include <jay/integration/abm4.hpp>
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/integration/seed_order.hpp>
+#include <jay/integration/bricked_field.hpp>
+#include <jay/integration/astc_sampler.hpp>
+#include <jay/integration/paged_tracer.hpp>
+#include <jay/integration/trace_cache.hpp>
+#include <jay/integration/lockstep_tracer.hpp>
+#include <jay/integration/ensemble_tracer.hpp>
+#include <jay/integration/flow_map.hpp>
+#include <jay/integration/domain_tracer.hpp>
+
 #include <jay/analysis/performance_measure.hpp>
 #include <jay/analysis/distance_measure.hpp>
 #include <jay/analysis/psnr_measure.hpp>
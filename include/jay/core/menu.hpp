@@ -203,11 +203,17 @@ namespace jay
     glm::uvec2    seed_range_z;
     glm::uvec3    seed_directional;              
     std::uint32_t seed_count;
+    std::uint32_t seed_ordering;
 
     // Integration Params
-    bool          int_strategy_rk4;
+    std::uint32_t int_strategy;
     bool          int_unsteady;
     bool          int_texelfetch;
+    bool          int_early_termination;
+    bool          int_progressive;        // Advect over several frames (steady)
+    float         int_frame_budget;       // GPU time per frame of a progressive advection (ms)
+    float         int_progress;           // Of the running progressive advection (%)
+    std::uint32_t int_cache_budget;       // Trajectories of traced seeds kept for later advections (MB, 0 = off, steady)
     glm::vec4     int_simulation_range;
     std::uint32_t int_global_step_count;
     std::uint32_t int_local_step_count;
@@ -216,6 +222,11 @@ namespace jay
     float         int_step_size_h;
     float         int_step_size_dt;
     float         int_dataset_factor;
+    float         int_tolerance;
+    float         int_step_size_min;
+    float         int_step_size_max;
+    std::uint32_t int_resample_mode;
+    float         int_resample_spacing;
     std::uint32_t int_iteration_count;
     std::uint32_t int_vram;
 
@@ -240,6 +251,7 @@ namespace jay
     double        export_velo_size;
     bool          export_velo;
     bool          export_velo_status;
+    double        export_progress;
     int           export_timers_count;
     bool          export_timers_status;
     bool          export_img;
@@ -0,0 +1,102 @@
+#ifndef JAY_INTEGRATION_ABM4_HPP
+#define JAY_INTEGRATION_ABM4_HPP
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include <jay/integration/particle_batch.hpp>
+
+namespace jay
+{
+  // Field velocities f(p) of the last 4 positions of a particle_batch, f[0] is the latest.
+  template <std::size_t Width = 8>
+  struct abm4_history
+  {
+    alignas(32) float fx[4][Width];
+    alignas(32) float fy[4][Width];
+    alignas(32) float fz[4][Width];
+    std::size_t       steps = 0;    // Steps taken (the history is complete from 3 on)
+
+    // Call together with particle_batch::load(..)
+    void reset()
+    {
+      steps = 0;
+    }
+
+    // Drops the oldest velocities to make room for f[0]
+    void shift()
+    {
+      for (std::size_t k = 3; k > 0; k--)
+        for (std::size_t i = 0; i < Width; i++)
+        {
+          fx[k][i] = fx[k - 1][i];
+          fy[k][i] = fy[k - 1][i];
+          fz[k][i] = fz[k - 1][i];
+        }
+    }
+  };
+
+  /* Adams-Bashforth-Moulton 4th order, as advect_abm4(..) in main_steady.glsl.
+   * Predicts with the last 4 field velocities and corrects with the velocity at the prediction,
+   * so a step takes 2 samples instead of 4 (the first 3 steps are bootstrapped with RK4).
+   * Call update_alive(..) before each step, like for rk4_step(..). Time & rel_dt are the same as for rk4_step(..),
+   * the history holds the velocities at the times they were taken.
+   */
+  template <typename Sampler, std::size_t Width>
+  inline void abm4_step(particle_batch<Width>& b, abm4_history<Width>& history, const Sampler& sampler, float h, float vector_factor, const glm::vec4& cell_factor, float time = 0.0f, float rel_dt = 0.0f)
+  {
+    using namespace batch_detail;
+
+    const glm::vec3 factor = glm::vec3(cell_factor) * vector_factor;
+
+    alignas(32) float px[Width], py[Width], pz[Width];
+    alignas(32) float vx[Width], vy[Width], vz[Width];
+
+    advance(b, h, px, py, pz);
+
+    history.shift();
+    slope<Sampler, Width>(sampler, time, b.alive, px, py, pz, factor, history.fx[0], history.fy[0], history.fz[0]);
+
+    if (history.steps < 3)
+    {
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        vx[i] = history.fx[0][i];
+        vy[i] = history.fy[0][i];
+        vz[i] = history.fz[0][i];
+      }
+      rk4_increment<Sampler, Width>(sampler, time, rel_dt, b.alive, px, py, pz, h, factor, vx, vy, vz);
+    }
+    else
+    {
+      const auto& fx = history.fx;
+      const auto& fy = history.fy;
+      const auto& fz = history.fz;
+
+      // Predictor (Adams-Bashforth)
+      alignas(32) float qx[Width], qy[Width], qz[Width];
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        qx[i] = px[i] + h * (55.0f * fx[0][i] - 59.0f * fx[1][i] + 37.0f * fx[2][i] - 9.0f * fx[3][i]) / 24.0f;
+        qy[i] = py[i] + h * (55.0f * fy[0][i] - 59.0f * fy[1][i] + 37.0f * fy[2][i] - 9.0f * fy[3][i]) / 24.0f;
+        qz[i] = pz[i] + h * (55.0f * fz[0][i] - 59.0f * fz[1][i] + 37.0f * fz[2][i] - 9.0f * fz[3][i]) / 24.0f;
+      }
+
+      slope<Sampler, Width>(sampler, time + rel_dt, b.alive, qx, qy, qz, factor, vx, vy, vz);
+
+      // Corrector (Adams-Moulton)
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        vx[i] = (9.0f * vx[i] + 19.0f * fx[0][i] - 5.0f * fx[1][i] + fx[2][i]) / 24.0f;
+        vy[i] = (9.0f * vy[i] + 19.0f * fy[0][i] - 5.0f * fy[1][i] + fy[2][i]) / 24.0f;
+        vz[i] = (9.0f * vz[i] + 19.0f * fz[0][i] - 5.0f * fz[1][i] + fz[2][i]) / 24.0f;
+      }
+    }
+
+    history.steps++;
+    commit(b, px, py, pz, vx, vy, vz);
+  }
+}
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef JAY_INTEGRATION_ASTC_SAMPLER_HPP
+#define JAY_INTEGRATION_ASTC_SAMPLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <astcenc.h>
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/compression/compressor.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/types/image.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* A timestep of an ASTC compressed, vectorlike 3-component field (as written by astc::compress(..) on the images of
+   * convert_data_to_img(..)): one 2D image per depth layer (Plane) or one 3D image per timestep (Volume), all images of
+   * the same size, img_len bytes each. Pixels hold the x-components of a row one after another, `color` channels per pixel.
+   * The field only keeps a pointer to the compressed data and the denormalization of every depth layer (taken from the peaks,
+   * per layer or per component, just like denormalize_float(..) / denormalize_per_component(..)).
+   */
+  struct JAY_EXPORT astc_field
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The compressed data has to outlive the field (it's not copied), grid = { x, y, z(, t) }
+    astc_field(const jayComp<astc_datatype>& comp, const std::vector<float>& peaks, const std::vector<std::size_t>& grid, std::size_t t = 0, bool per_component = false, colorspace color = colorspace::RGB, astcenc_profile profile = ASTCENC_PRF_LDR);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Index of the block (over all images) holding pixel (px, py, pz) of image `image`
+    std::uint64_t block_id(std::size_t image, int px, int py, int pz) const
+    {
+      return image * blocks_per_image + (static_cast<std::size_t>(pz / block.z) * blocks.y + py / block.y) * blocks.x + px / block.x;
+    }
+
+    // Grid only, for the bounds (e.g. particle_batch::update_alive(..))
+    field_view  view()      const;
+    std::size_t texels_per_block() const;
+    // Compressed bytes of the timestep
+    std::size_t byte_size() const;
+
+    const jayComp<astc_datatype>* comp = nullptr;
+    glm::ivec3                    grid;
+    glm::ivec3                    block;            // Texels per block
+    glm::ivec3                    blocks;           // Blocks per image & axis
+    std::size_t                   blocks_per_image;
+    std::size_t                   first_image;      // Image of depth layer 0 (Plane) or of the timestep (Volume)
+    bool                          volume;
+    int                           channels;         // Channels per pixel used by the data
+    std::vector<glm::vec3>        scale;            // Denormalization per depth layer: value * scale + offset
+    std::vector<glm::vec3>        offset;
+    astcenc_config                config;
+  };
+
+
+  // Lookups of an astc_block_cache
+  struct JAY_EXPORT astc_cache_stats
+  {
+    std::size_t hits   = 0;
+    std::size_t misses = 0;   // = decoded blocks
+
+    void   add(const astc_cache_stats& other);
+    double hit_rate() const;
+  };
+
+
+  /* The decoded blocks of a single thread, least recently used block evicted first.
+   * Blocks are decoded one at a time (astcenc_decompress_image(..) on a block sized image, with an own context)
+   * and denormalized right away, so a lookup returns the final floats: `channels` per texel, x fastest.
+   * Not thread safe, give every thread its own cache.
+   */
+  class JAY_EXPORT astc_block_cache
+  {
+  public:
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    astc_block_cache(const astc_field& field, std::size_t capacity = 64);
+    ~astc_block_cache();
+
+    astc_block_cache(const astc_block_cache&)            = delete;
+    astc_block_cache& operator=(const astc_block_cache&) = delete;
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    const float* block(std::uint64_t id)
+    {
+      // Consecutive lookups mostly hit the same block
+      if (head != none && keys[head] == id)
+      {
+        stats.hits++;
+        return slot_data(head);
+      }
+      return lookup(id);
+    }
+
+    std::size_t             get_capacity() const;
+    // Bytes of the decoded blocks & bookkeeping
+    std::size_t             byte_size()    const;
+    const astc_cache_stats& get_stats()    const;
+    void                    reset_stats();
+    // Drops all blocks
+    void                    clear();
+
+  protected:
+    static constexpr std::uint32_t none = 0xFFFFFFFF;
+
+    const astc_field*    field;
+    std::size_t          capacity;
+    std::size_t          slot_floats;
+    astc_cache_stats     stats;
+    astcenc_context*     context = nullptr;
+
+    // Slots form a doubly linked list from the most (head) to the least (tail) recently used
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> prev;
+    std::vector<std::uint32_t> next;
+    std::uint32_t              head = none;
+    std::uint32_t              tail = none;
+    std::uint32_t              used = 0;
+    std::unordered_map<std::uint64_t, std::uint32_t> slots;
+    std::vector<float>         data;
+
+    // Decode target, a block sized F16 RGBA image
+    std::vector<std::uint16_t>   texels;
+    std::vector<std::uint16_t*>  rows;
+    std::vector<std::uint16_t**> planes;
+    astcenc_image                image;
+
+    float* slot_data(std::uint32_t slot) { return data.data() + slot * slot_floats; }
+
+    const float* lookup(std::uint64_t id);
+    void         unlink(std::uint32_t slot);
+    void         push_front(std::uint32_t slot);
+    bool         decode(std::uint64_t id, float* dst);
+  };
+
+
+  /* Trilinear interpolation on an ASTC compressed field (same results as texelfetch_sampler on the decompressed field).
+   * Nodes outside of the grid are zero, the blocks of all other nodes come from the cache of the sampler.
+   * Cheap to copy, but copies share the cache: use one sampler (and cache) per thread.
+   */
+  struct astc_sampler
+  {
+    const astc_field* field = nullptr;
+    astc_block_cache* cache = nullptr;
+
+    astc_sampler() = default;
+    astc_sampler(const astc_field& field, astc_block_cache& cache) : field{ &field }, cache{ &cache } { }
+
+    glm::vec3 node(int x, int y, int z) const
+    {
+      const auto& f = *field;
+      if (x < 0 || y < 0 || z < 0 || x >= f.grid.x || y >= f.grid.y || z >= f.grid.z)
+        return glm::vec3(0.0f);
+
+      const std::size_t image = f.first_image + (f.volume ? 0 : z);
+      const int         pz    = f.volume ? z : 0;
+
+      glm::vec3 result;
+      int k = 0;
+      while (k < 3)
+      {
+        // First component in this pixel, the rest of the vector may continue in the next pixel (& block)
+        const int value   = 3 * x + k;
+        const int px      = value / f.channels;
+        const int channel = value % f.channels;
+
+        const float* b     = cache->block(f.block_id(image, px, y, pz));
+        const float* texel = b + ((static_cast<std::size_t>(pz % f.block.z) * f.block.y + y % f.block.y) * f.block.x + px % f.block.x) * f.channels;
+
+        for (int c = channel; c < f.channels && k < 3; c++, k++)
+          result[k] = texel[c];
+      }
+
+      return result;
+    }
+
+    // Same as texelfetch_sampler
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      const glm::vec3 P0 = glm::floor(pos);
+      const int x = static_cast<int>(P0.x);
+      const int y = static_cast<int>(P0.y);
+      const int z = static_cast<int>(P0.z);
+
+      const float s      = pos.x - P0.x;
+      const float t      = pos.y - P0.y;
+      const float lambda = pos.z - P0.z;
+
+      const auto c = glm::mix(glm::mix(node(x, y,     z),     node(x + 1, y,     z),     s),
+                              glm::mix(node(x, y + 1, z),     node(x + 1, y + 1, z),     s), t);
+      const auto d = glm::mix(glm::mix(node(x, y,     z + 1), node(x + 1, y,     z + 1), s),
+                              glm::mix(node(x, y + 1, z + 1), node(x + 1, y + 1, z + 1), s), t);
+
+      return glm::mix(c, d, lambda);
+    }
+
+    void sample(std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+    {
+      sample_each(*this, n, x, y, z, vx, vy, vz);
+    }
+  };
+
+
+  // Cache lookups & memory of the last astc_tracer trace
+  struct JAY_EXPORT astc_trace_stats
+  {
+    std::vector<astc_cache_stats> threads;
+    std::size_t compressed_bytes = 0;
+    std::size_t cache_bytes      = 0;     // All threads
+    std::size_t decoded_bytes    = 0;     // The field as floats, for comparison
+    double      trace_time       = 0.0;   // ms
+
+    astc_cache_stats total()          const;
+    std::size_t      resident_bytes() const;
+    void             print()          const;
+  };
+
+
+  /* Headless steady tracer on an ASTC compressed field, without decompressing it (all strategies of cpu_tracer, see batch_stepper).
+   * Seeds are cut into batches of 8 along s_conf.ordering and distributed by work stealing,
+   * every thread samples through its own astc_block_cache of cache_blocks blocks.
+   * Results are laid out like the ones of cpu_tracer (seed after seed in grid order).
+   */
+  struct JAY_EXPORT astc_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    astc_tracer(const astc_field& field, unsigned int thread_count = 0, std::size_t cache_blocks = 64);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result        trace(const seeding_conf& s_conf, const integration_conf& i_conf) const;
+    void                    trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+
+    unsigned int            get_thread_count() const;
+    const astc_trace_stats& get_stats()        const;
+
+  protected:
+    astc_field                                     field;
+    unsigned int                                   thread_count;
+    mutable work_stealing_scheduler                scheduler;
+    mutable std::vector<std::unique_ptr<astc_block_cache>> caches;
+    mutable astc_trace_stats                       stats;
+  };
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef JAY_INTEGRATION_BATCH_STEPPER_HPP
+#define JAY_INTEGRATION_BATCH_STEPPER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/abm4.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/particle_batch.hpp>
+#include <jay/integration/rk45.hpp>
+#include <jay/integration/schemes.hpp>
+
+namespace jay
+{
+  /* The step loop shared by the CPU tracers: a particle_batch (and its ABM4 history) advanced with the strategy of an integration_conf.
+   * step(..) freezes the lanes outside of the domain and advances the others by one Euler, RK4 or ABM4 step.
+   * trace(..) writes the local steps of up to Width seeds; RK45 adapts the step size per particle, so it traces seed after seed there.
+   * Keep one stepper per thread.
+   */
+  template <std::size_t Width = 8>
+  struct batch_stepper
+  {
+    particle_batch<Width> batch;
+    abm4_history<Width>   history;
+    rk45_stats            stats;          // Of the RK45 traces since construction
+
+    batch_stepper() = default;
+    batch_stepper(const integration_conf& i_conf)
+      : conf          { i_conf }
+      , strategy      { i_conf.strategy }
+      , h             { i_conf.step_size_h }
+      , vector_factor { i_conf.dataset_factor }
+      , cf            { cell_factor(i_conf.cell_size) }
+      , global_steps  { i_conf.global_step_count }
+      , local_steps   { std::min<std::size_t>(i_conf.local_step_count, i_conf.global_step_count) }
+    { }
+
+    // Strategies step(..) can take, RK45 is only available through trace(..)
+    static bool batched(gl::GLuint strategy)
+    {
+      return strategy == StrategyEuler || strategy == StrategyRK4 || strategy == StrategyABM4;
+    }
+
+    static bool supported(gl::GLuint strategy)
+    {
+      return batched(strategy) || strategy == StrategyRK45;
+    }
+
+    // Takes up to Width seeds and starts a new ABM4 history
+    void load(const glm::vec4* seeds, std::size_t n)
+    {
+      batch.load(seeds, n);
+      history.reset();
+    }
+
+    void load(const glm::vec4* seeds, const std::uint32_t* index, std::size_t n)
+    {
+      batch.load(seeds, index, n);
+      history.reset();
+    }
+
+    // One step of all lanes inside of bounds, the others are frozen. Returns false if no lane is alive.
+    // Time & rel_dt are passed on to time_interpolated_sampler (see rk4_step(..)).
+    template <typename Sampler>
+    bool step(const Sampler& sampler, const field_view& bounds, float time = 0.0f, float rel_dt = 0.0f)
+    {
+      if (!batch.update_alive(bounds))
+        return false;
+
+      if (strategy == StrategyABM4)
+        abm4_step (batch, history, sampler, h, vector_factor, cf, time, rel_dt);
+      else if (strategy == StrategyEuler)
+        euler_step(batch, sampler, h, vector_factor, cf, time, rel_dt);
+      else
+        rk4_step  (batch, sampler, h, vector_factor, cf, time, rel_dt);
+
+      return true;
+    }
+
+    // Traces the n seeds index[l] (first + l without an index) for the local steps into the layout of advected_field
+    template <typename Sampler>
+    void trace(const Sampler& sampler, const field_view& bounds, const glm::vec4* seeds, const std::uint32_t* index, std::size_t first, std::size_t n, glm::vec4* positions, glm::vec4* velocities)
+    {
+      if (strategy == StrategyRK45)
+      {
+        for (std::size_t l = 0; l < n; l++)
+        {
+          const std::size_t s = index ? index[l] : first + l;
+          stats.add(rk45_advect(sampler, bounds, seeds[s], conf, positions + s * global_steps, velocities + s * global_steps, local_steps));
+        }
+        return;
+      }
+
+      if (index)
+        load(seeds, index, n);
+      else
+        load(seeds + first, n);
+
+      for (std::size_t i = 0; i < local_steps; i++)
+      {
+        step(sampler, bounds);
+
+        if (index)
+          batch.store(positions, velocities, global_steps, i, index);
+        else
+          batch.store(positions + first * global_steps, velocities + first * global_steps, global_steps, i);
+      }
+    }
+
+  protected:
+    integration_conf conf          = {};
+    gl::GLuint       strategy      = StrategyRK4;
+    float            h             = 0.0f;
+    float            vector_factor = 1.0f;
+    glm::vec4        cf            = glm::vec4(1.0f);
+    std::size_t      global_steps  = 0;
+    std::size_t      local_steps   = 0;
+  };
+}
+
+#endif
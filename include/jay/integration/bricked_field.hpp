@@ -0,0 +1,249 @@
+#ifndef JAY_INTEGRATION_BRICKED_FIELD_HPP
+#define JAY_INTEGRATION_BRICKED_FIELD_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* A vectorlike 3-component field stored as cubic bricks of brick_size^3 cells (power of 2).
+   * Each brick holds (brick_size + 1)^3 nodes: its own and a one node ghost layer towards +x, +y & +z,
+   * so all 8 corners of a cell are inside of one brick (a few cache lines instead of up to 4 distant rows).
+   * Nodes outside of the grid are zero, so the border cells need no special treatment either.
+   * Bricks are stored along a Morton curve.
+   */
+  struct JAY_EXPORT bricked_field
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // Copies the field brick by brick on thread_count threads (default: all cores)
+    bricked_field(field_view field, unsigned int brick_size = 8, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Largest brick size with a brick (nodes & ghost layer) fitting into cache_bytes (at least 4),
+    // e.g. 8 for a 32 KB L1 cache, 16 for a 256 KB L2 cache
+    static unsigned int brick_size_for(std::size_t cache_bytes);
+
+    // Node as stored (zero outside of the grid)
+    glm::vec3   node(int x, int y, int z) const;
+    // Bytes of all bricks
+    std::size_t byte_size() const;
+
+    field_view          field;          // Source (for the bounds, the data is not used after construction)
+    unsigned int        brick_size;
+    unsigned int        brick_shift;    // log2(brick_size)
+    unsigned int        brick_nodes;    // Nodes per axis of a brick (brick_size + 1)
+    glm::ivec3          bricks;         // Bricks per axis
+    glm::ivec3          cells;          // Cells covered by the bricks per axis (bricks * brick_size)
+    std::vector<std::uint32_t> ranks;   // Position of brick (x fastest) in data, in bricks
+    std::size_t         brick_floats;   // 3 * brick_nodes^3
+    std::vector<float>  data;
+    double              build_time = 0.0;   // ms
+  };
+
+
+  /* Trilinear interpolation on a bricked_field, with the results of trilinear_sampler.
+   * Positions inside of the bricks take a branch-free path: brick, cell & weights by shifts and masks,
+   * 24 loads from a single brick. Only positions outside of the grid fall back to the checked node lookup.
+   * sample(..) gathers 8 positions at once with AVX2 where available (fields of less than 2^31 floats, others are sampled one by one).
+   */
+  struct bricked_sampler
+  {
+    const bricked_field* bricks = nullptr;
+    std::size_t          corner[8];
+    bool                 gather = false;   // All brick offsets fit the 32 bit indices of the gathers
+
+    bricked_sampler() = default;
+    bricked_sampler(const bricked_field& bricks) : bricks{ &bricks }
+    {
+      const std::size_t dx = 3;
+      const std::size_t dy = 3 * static_cast<std::size_t>(bricks.brick_nodes);
+      const std::size_t dz = dy * bricks.brick_nodes;
+
+      for (int i = 0; i < 8; i++)
+        corner[i] = ((i & 1) ? dx : 0) + ((i & 2) ? dy : 0) + ((i & 4) ? dz : 0);
+
+      gather = bricks.data.size() <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+    }
+
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      const float fx = std::floor(pos.x);
+      const float fy = std::floor(pos.y);
+      const float fz = std::floor(pos.z);
+      const int   x  = static_cast<int>(fx);
+      const int   y  = static_cast<int>(fy);
+      const int   z  = static_cast<int>(fz);
+
+      const float s      = pos.x - fx;
+      const float t      = pos.y - fy;
+      const float lambda = pos.z - fz;
+
+      // Negative cells wrap to large unsigned values
+      const bool inside = (static_cast<unsigned int>(x) < static_cast<unsigned int>(bricks->cells.x))
+                        & (static_cast<unsigned int>(y) < static_cast<unsigned int>(bricks->cells.y))
+                        & (static_cast<unsigned int>(z) < static_cast<unsigned int>(bricks->cells.z));
+      if (!inside)
+        return outside(x, y, z, s, t, lambda);
+
+      const unsigned int shift = bricks->brick_shift;
+      const unsigned int mask  = bricks->brick_size - 1;
+      const unsigned int n     = bricks->brick_nodes;
+
+      const std::size_t brick = ((static_cast<std::size_t>(z >> shift) * bricks->bricks.y) + (y >> shift)) * bricks->bricks.x + (x >> shift);
+      const std::size_t local = ((static_cast<std::size_t>(z & mask) * n) + (y & mask)) * n + (x & mask);
+
+      const float* c = bricks->data.data() + bricks->ranks[brick] * bricks->brick_floats + 3 * local;
+
+      glm::vec3 result;
+      for (std::size_t k = 0; k < 3; k++)
+      {
+        const float i0 = lerp(c[corner[0] + k], c[corner[1] + k], s);
+        const float i1 = lerp(c[corner[2] + k], c[corner[3] + k], s);
+        const float j0 = lerp(c[corner[4] + k], c[corner[5] + k], s);
+        const float j1 = lerp(c[corner[6] + k], c[corner[7] + k], s);
+
+        result[k] = lerp(lerp(i0, i1, t), lerp(j0, j1, t), lambda);
+      }
+
+      return result;
+    }
+
+    void sample(std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+    {
+      std::size_t i = 0;
+#ifdef JAY_INTEGRATION_AVX2
+      for (; gather && i + 8 <= n; i += 8)
+        sample8(x + i, y + i, z + i, vx + i, vy + i, vz + i);
+#endif
+      sample_each(*this, n - i, x + i, y + i, z + i, vx + i, vy + i, vz + i);
+    }
+
+#ifdef JAY_INTEGRATION_AVX2
+    // Samples exactly 8 positions, only valid if gather is set. See trilinear_sampler::sample8(..)
+    void sample8(const float* px, const float* py, const float* pz, float* vx, float* vy, float* vz) const
+    {
+      const auto& b = *bricks;
+
+      const __m256 x  = _mm256_loadu_ps(px);
+      const __m256 y  = _mm256_loadu_ps(py);
+      const __m256 z  = _mm256_loadu_ps(pz);
+      const __m256 fx = _mm256_floor_ps(x);
+      const __m256 fy = _mm256_floor_ps(y);
+      const __m256 fz = _mm256_floor_ps(z);
+
+      const __m256i ix = _mm256_cvttps_epi32(fx);
+      const __m256i iy = _mm256_cvttps_epi32(fy);
+      const __m256i iz = _mm256_cvttps_epi32(fz);
+
+      // 0 <= i < cells for all dimensions
+      const __m256i minus_one = _mm256_set1_epi32(-1);
+      __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(ix, minus_one), _mm256_cmpgt_epi32(_mm256_set1_epi32(b.cells.x), ix));
+      inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(iy, minus_one), _mm256_cmpgt_epi32(_mm256_set1_epi32(b.cells.y), iy)));
+      inside = _mm256_and_si256(inside, _mm256_and_si256(_mm256_cmpgt_epi32(iz, minus_one), _mm256_cmpgt_epi32(_mm256_set1_epi32(b.cells.z), iz)));
+
+      // Lanes outside read brick 0, cell 0
+      const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b.brick_shift));
+      const __m256i mask  = _mm256_set1_epi32(static_cast<int>(b.brick_size - 1));
+      const __m256i n     = _mm256_set1_epi32(static_cast<int>(b.brick_nodes));
+
+      __m256i brick = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sra_epi32(iz, shift), _mm256_set1_epi32(b.bricks.y)), _mm256_sra_epi32(iy, shift));
+      brick = _mm256_add_epi32(_mm256_mullo_epi32(brick, _mm256_set1_epi32(b.bricks.x)), _mm256_sra_epi32(ix, shift));
+      brick = _mm256_and_si256(brick, inside);
+
+      __m256i local = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(iz, mask), n), _mm256_and_si256(iy, mask));
+      local = _mm256_add_epi32(_mm256_mullo_epi32(local, n), _mm256_and_si256(ix, mask));
+      local = _mm256_and_si256(local, inside);
+
+      const __m256i rank = _mm256_i32gather_epi32(reinterpret_cast<const int*>(b.ranks.data()), brick, 4);
+      const __m256i base = _mm256_add_epi32(_mm256_mullo_epi32(rank, _mm256_set1_epi32(static_cast<int>(b.brick_floats))), _mm256_mullo_epi32(local, _mm256_set1_epi32(3)));
+
+      const __m256 s      = _mm256_sub_ps(x, fx);
+      const __m256 t      = _mm256_sub_ps(y, fy);
+      const __m256 lambda = _mm256_sub_ps(z, fz);
+
+      auto mix = [](__m256 a, __m256 b, __m256 w) { return _mm256_fmadd_ps(w, _mm256_sub_ps(b, a), a); };
+
+      float* out[3] = { vx, vy, vz };
+      for (std::size_t k = 0; k < 3; k++)
+      {
+        __m256 c[8];
+        for (std::size_t i = 0; i < 8; i++)
+          c[i] = _mm256_i32gather_ps(b.data.data() + corner[i] + k, base, 4);
+
+        const __m256 i0 = mix(c[0], c[1], s);
+        const __m256 i1 = mix(c[2], c[3], s);
+        const __m256 j0 = mix(c[4], c[5], s);
+        const __m256 j1 = mix(c[6], c[7], s);
+
+        _mm256_storeu_ps(out[k], mix(mix(i0, i1, t), mix(j0, j1, t), lambda));
+      }
+
+      const int lanes = _mm256_movemask_ps(_mm256_castsi256_ps(inside));
+      if (lanes == 0xFF)
+        return;
+
+      for (int i = 0; i < 8; i++)
+        if (!(lanes & (1 << i)))
+        {
+          const auto v = (*this)(glm::vec3(px[i], py[i], pz[i]));
+          vx[i] = v.x;
+          vy[i] = v.y;
+          vz[i] = v.z;
+        }
+    }
+#endif
+
+  protected:
+    // Same as texelfetch_sampler
+    glm::vec3 outside(int x, int y, int z, float s, float t, float lambda) const
+    {
+      const auto& b = *bricks;
+
+      const auto c = glm::mix(glm::mix(b.node(x, y,     z),     b.node(x + 1, y,     z),     s),
+                              glm::mix(b.node(x, y + 1, z),     b.node(x + 1, y + 1, z),     s), t);
+      const auto d = glm::mix(glm::mix(b.node(x, y,     z + 1), b.node(x + 1, y,     z + 1), s),
+                              glm::mix(b.node(x, y + 1, z + 1), b.node(x + 1, y + 1, z + 1), s), t);
+
+      return glm::mix(c, d, lambda);
+    }
+  };
+
+
+  /* Steady tracing on the linear field (trilinear_sampler) against the bricked field (bricked_sampler), both with cpu_tracer.
+   * Times are the best of `runs` traces.
+   */
+  struct JAY_EXPORT bricked_report
+  {
+    unsigned int brick_size      = 0;
+    std::size_t  linear_bytes    = 0;
+    std::size_t  bricked_bytes   = 0;
+    double       build_time      = 0.0;   // ms
+    double       linear_time     = 0.0;   // ms
+    double       bricked_time    = 0.0;   // ms
+    std::size_t  steps           = 0;     // Per trace (seeds * local steps)
+    float        max_difference  = 0.0f;  // Largest distance of a bricked to a linear position
+
+    double speedup() const;
+    void   print()   const;
+  };
+
+  JAY_EXPORT bricked_report compare_bricked_linear(const jaySrc<float>& src, const seeding_conf& s_conf, const integration_conf& i_conf, unsigned int brick_size = 8, unsigned int thread_count = 0, unsigned int runs = 3);
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef JAY_INTEGRATION_CPU_TRACER_HPP
+#define JAY_INTEGRATION_CPU_TRACER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/bricked_field.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/rk45.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  // Same layout as the position & velocity buffers of advected_field: seed after seed, global_step_count vec4 each.
+  struct cpu_trace_result
+  {
+    std::vector<glm::vec4> positions;
+    std::vector<glm::vec4> velocities;
+    std::size_t            seed_count = 0;
+    std::size_t            step_count = 0;
+  };
+
+  /* Headless steady particle tracer, following main_steady.glsl step by step.
+   * Seeding, integration strategy (Euler / RK4 / RK45 / ABM4), sampling (texture / texelFetch), step size, dataset factor,
+   * cell size & step counts are taken from the same configs that fill the UBOs.
+   * Tiles of seeds are distributed over thread_count threads (default: all cores) by work stealing,
+   * in the order of s_conf.ordering (x fastest or along a space-filling curve).
+   * With use_bricks(..) texelFetch sampling reads from a bricked copy of the field (see bricked_field).
+   * Useful for tracing without a GL context, or as reference for the GPU results.
+   */
+  struct JAY_EXPORT cpu_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The field has to outlive the tracer (it's not copied).
+    cpu_tracer(const jaySrc<float>& src, unsigned int thread_count = 0);
+    // E.g. a field attached from a dataset_server
+    cpu_tracer(const jaySrcView<float>& src, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result trace(const seeding_conf& s_conf, const integration_conf& i_conf) const;
+    // Writes into preallocated buffers of seed_count(s_conf) * global_step_count vec4 each (e.g. mapped GL buffers).
+    // Steps after local_step_count are left untouched, just like on the GPU.
+    void             trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+    // Traces a list of seeds (w = 1) into buffers of seeds.size() * global_step_count vec4 each
+    void             trace(const std::vector<glm::vec4>& seeds, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+
+    // Samples a bricked copy of the field (texelFetch only), brick_size 0 returns to the linear field
+    void             use_bricks(unsigned int brick_size = 8);
+    const bricked_field* get_bricks() const;
+
+    // Seed positions in dispatch order (x fastest), w = 1
+    static std::vector<glm::vec4> make_seeds(const seeding_conf& s_conf);
+    static std::size_t            seed_count(const seeding_conf& s_conf);
+
+    unsigned int get_thread_count() const;
+    // Duration of the last trace in ms
+    double       get_trace_time()   const;
+    // Accepted & rejected steps, samples and arc length of the last RK45 trace
+    rk45_stats   get_rk45_stats()   const;
+    // Busy & idle time per thread of the last trace
+    const work_stealing_scheduler& get_scheduler() const;
+
+  protected:
+    field_view         field;
+    unsigned int       thread_count;
+    mutable double     trace_time = 0.0;
+    mutable rk45_stats rk45_trace_stats;
+    mutable work_stealing_scheduler scheduler;
+
+    std::unique_ptr<bricked_field> bricks;
+
+    template <typename Sampler>
+    void trace_seeds(const Sampler& sampler, const std::vector<glm::vec4>& seeds, const glm::uvec3& dims, gl::GLuint ordering, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+  };
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef JAY_INTEGRATION_DOMAIN_TRACER_HPP
+#define JAY_INTEGRATION_DOMAIN_TRACER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/io/paged_field.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* Trilinear interpolation in a slab of depth layers [z_offset, z_offset + grid_z) of a larger field
+   * (same results as texelfetch_sampler as long as all corners are inside of the slab).
+   * Corners outside of the slab read as zero, samples needing them inside of the grid are counted as misses.
+   */
+  struct slab_sampler
+  {
+    field_view          slab;
+    int                 z_offset = 0;
+    int                 grid_z   = 0;      // Of the whole field
+    mutable std::size_t misses   = 0;
+
+    slab_sampler() = default;
+    slab_sampler(field_view slab, int z_offset, int grid_z)
+      : slab     { slab }
+      , z_offset { z_offset }
+      , grid_z   { grid_z }
+    { }
+
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      const glm::vec3 local(pos.x, pos.y, pos.z - static_cast<float>(z_offset));
+
+      const int z = static_cast<int>(std::floor(local.z));
+      if ((z < 0 && z_offset > 0) || (z + 1 >= slab.grid_z && z_offset + slab.grid_z < grid_z))
+        misses++;
+
+      return texelfetch_sampler(slab)(local);
+    }
+  };
+
+
+  // Work of the subdomains of the last domain_tracer trace
+  struct JAY_EXPORT domain_trace_stats
+  {
+    struct subdomain
+    {
+      std::size_t z_offset     = 0;   // Loaded depth layers (halo included)
+      std::size_t z_count      = 0;
+      std::size_t steps        = 0;
+      std::size_t handoffs     = 0;   // Particles sent to other subdomains
+      std::size_t halo_misses  = 0;   // Samples beyond the halo
+      double      load_ms      = 0.0;
+      bool        finished     = false;
+    };
+
+    std::vector<subdomain> subdomains;
+    double                 trace_time = 0.0;     // ms
+    bool                   processes  = false;   // Workers ran in forked processes (threads otherwise)
+
+    std::size_t steps()       const;
+    std::size_t handoffs()    const;
+    std::size_t halo_misses() const;
+    void        print()       const;
+  };
+
+
+  /* Headless steady RK4 tracer (Euler with StrategyEuler, texelFetch sampling) for fields larger than a process can hold.
+   * The cells are split along z into slabs owned by separate worker processes, each reading only its depth layers
+   * plus halo layers on both sides through the slab reader (e.g. hyperslabs of a HDF5 file).
+   * A particle is advanced by the owner of the cell it samples next (like paged_tracer); once it enters another slab,
+   * it's pushed to the queue of the owner in shared memory (one state per seed, shared by all queues).
+   * Worker processes write the trajectories to shared memory as well, worker threads directly to the buffers of the caller.
+   * Termination is detected by a shared counter of unfinished particles: the worker finishing the last one wakes all.
+   * The halo should cover the stages of a step (halo > step_size_h * |v|), or the stats report misses.
+   * trace(..) forks one worker per subdomain. Workers are threads on Windows and while other threads of the process
+   * are running (a forked child would inherit the locks they hold, e.g. of a prefetching timestep_source).
+   * If a worker process dies, the remaining ones are killed and the trajectories are incomplete.
+   * run_worker(..) is the worker itself, so other launchers can attach to the shared memory of a trace.
+   * The output has the layout of the GPU buffers (see cpu_tracer). RK45 and ABM4 throw std::invalid_argument.
+   */
+  struct JAY_EXPORT domain_tracer
+  {
+    using slab_reader_fn = paged_field::slab_reader_fn;
+    // Receives the trajectory of a seed (global_step_count positions & velocities), valid during the call only
+    using trajectory_fn  = std::function<void(std::size_t seed, const glm::vec4* positions, const glm::vec4* velocities)>;
+
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The reader is called by the workers (after the fork, or concurrently in worker threads)
+    domain_tracer(const glm::uvec3& grid, std::size_t subdomain_count, slab_reader_fn reader, unsigned int halo = 2);
+    // Timestep t of a HDF5 file, each worker opens the file & reads its hyperslab (see hdf5_io::read_hdf5_slab(..))
+    domain_tracer(std::string h5_filepath, std::vector<std::string> datasets, std::size_t subdomain_count, unsigned int halo = 2, std::size_t t = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result          trace(const seeding_conf& s_conf, const integration_conf& i_conf);
+    void                      trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities);
+    // Streams the trajectories out of the shared memory once the trace is done, seed by seed (no copy of the whole output)
+    void                      trace(const seeding_conf& s_conf, const integration_conf& i_conf, const trajectory_fn& consumer);
+
+    // Traces the particles of subdomain rank in the shared memory segment of a trace until all particles are done
+    static bool               run_worker(const std::string& segment, std::size_t rank, const slab_reader_fn& reader);
+
+    // Cells [first, second) along z owned by a subdomain
+    std::pair<std::size_t, std::size_t> subdomain_range(std::size_t rank) const;
+    std::size_t               get_subdomain_count() const;
+    const domain_trace_stats& get_stats()           const;
+
+  protected:
+    glm::uvec3         grid;
+    std::size_t        subdomain_count;
+    slab_reader_fn     reader;
+    unsigned int       halo;
+    domain_trace_stats stats;
+
+    void                      trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities, const trajectory_fn* consumer);
+    // Writes the trajectories to positions & velocities instead of the segment (worker threads, see trace(..))
+    static bool               run_worker(const std::string& segment, std::size_t rank, const slab_reader_fn& reader, glm::vec4* positions, glm::vec4* velocities);
+  };
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef JAY_INTEGRATION_ENSEMBLE_TRACER_HPP
+#define JAY_INTEGRATION_ENSEMBLE_TRACER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/bricked_field.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/rk45.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  // Member after member, each in the layout of cpu_trace_result (seed after seed, step_count vec4 each)
+  struct ensemble_trace_result
+  {
+    std::vector<glm::vec4> positions;
+    std::vector<glm::vec4> velocities;
+    std::size_t            member_count = 0;
+    std::size_t            seed_count   = 0;
+    std::size_t            step_count   = 0;
+
+    // First vertex of a seed of a member
+    std::size_t offset(std::size_t member, std::size_t seed) const
+    {
+      return (member * seed_count + seed) * step_count;
+    }
+  };
+
+  /* Traces one seed set through all members of an ensemble (steady fields) in a single scheduled job.
+   * Seeds, their order & the samplers are set up once, the chunks (the tiles of cpu_tracer, see seed_tiles) are numbered
+   * member after member, so the contiguous chunk ranges of the work stealing scheduler keep a thread on one member's data.
+   * Members may differ in size, particles leaving a member are frozen (see cpu_tracer).
+   * With use_bricks(..) texelFetch sampling reads from bricked copies of the members (see bricked_field).
+   */
+  struct JAY_EXPORT ensemble_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The members have to outlive the tracer (they're not copied).
+    ensemble_tracer(const std::vector<jaySrc<float>>& members, unsigned int thread_count = 0);
+    ensemble_tracer(const std::vector<const jaySrc<float>*>& members, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    ensemble_trace_result trace(const seeding_conf& s_conf, const integration_conf& i_conf) const;
+    // Writes into preallocated buffers of member_count * seed_count(s_conf) * global_step_count vec4 each.
+    // Steps after local_step_count are left untouched, just like on the GPU.
+    void                  trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+
+    // Samples bricked copies of the members (texelFetch only), brick_size 0 returns to the linear fields
+    void         use_bricks(unsigned int brick_size = 8);
+
+    std::size_t  get_member_count() const;
+    unsigned int get_thread_count() const;
+    // Duration of the last trace in ms
+    double       get_trace_time()   const;
+    // Accepted & rejected steps, samples and arc length of the last RK45 trace (all members)
+    rk45_stats   get_rk45_stats()   const;
+    // Busy & idle time per thread of the last trace
+    const work_stealing_scheduler& get_scheduler() const;
+
+  protected:
+    std::vector<field_view> members;
+    std::vector<std::unique_ptr<bricked_field>> bricks;
+    unsigned int            thread_count;
+    mutable double          trace_time = 0.0;
+    mutable rk45_stats      rk45_trace_stats;
+    mutable work_stealing_scheduler scheduler;
+
+    template <typename Sampler>
+    void trace_members(const std::vector<Sampler>& samplers, const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const;
+  };
+}
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef JAY_INTEGRATION_FIELD_SAMPLER_HPP
+#define JAY_INTEGRATION_FIELD_SAMPLER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include <glm/glm.hpp>
+
+#include <jay/types/jaydata.hpp>
+
+namespace jay
+{
+  /* CPU counterparts of the sampling functions in 3D_regular_header.glsl.
+   * Samplers only hold a pointer to the data and the grid, so they are cheap to copy (e.g. one per thread).
+   * The data must be a vectorlike (VectorFirst) 3-component field; for 4D data a timestep can be selected.
+   */
+  struct field_view
+  {
+    const float* data = nullptr;
+    int          grid_x = 0;
+    int          grid_y = 0;
+    int          grid_z = 0;
+
+    field_view() = default;
+    field_view(const float* data, int grid_x, int grid_y, int grid_z)
+      : data   { data }
+      , grid_x { grid_x }
+      , grid_y { grid_y }
+      , grid_z { grid_z }
+    { }
+    field_view(const jaySrc<float>& src, std::size_t t = 0)
+      : data   { src.data.data() + t * src.grid[0] * src.grid[1] * src.grid[2] * src.vec_len }
+      , grid_x { static_cast<int>(src.grid[0]) }
+      , grid_y { static_cast<int>(src.grid[1]) }
+      , grid_z { static_cast<int>(src.grid[2]) }
+    {
+      if (src.vec_len != 3 || src.ordering != Order::VectorFirst)
+        printf("Error: Samplers need a vectorlike ordered field with 3 components.\n");
+    }
+    field_view(const jaySrcView<float>& src, std::size_t t = 0)
+      : data   { src.data + t * src.grid[0] * src.grid[1] * src.grid[2] * src.vec_len }
+      , grid_x { static_cast<int>(src.grid[0]) }
+      , grid_y { static_cast<int>(src.grid[1]) }
+      , grid_z { static_cast<int>(src.grid[2]) }
+    {
+      if (src.vec_len != 3 || src.ordering != Order::VectorFirst)
+        printf("Error: Samplers need a vectorlike ordered field with 3 components.\n");
+    }
+
+    // Extent of the domain in grid units (tex_size in the shaders)
+    glm::vec3 tex_size() const
+    {
+      return glm::vec3(grid_x - 1, grid_y - 1, grid_z - 1);
+    }
+
+    // Same test as check_boundaries(..) in common.glsl
+    bool contains(const glm::vec3& pos) const
+    {
+      if ((pos.x < 0) || (pos.y < 0) || (pos.z < 0))
+        return false;
+
+      if ((pos.x > grid_x - 1) || (pos.y > grid_y - 1) || (pos.z > grid_z - 1))
+        return false;
+
+      return true;
+    }
+
+    // Node outside of the grid read as zero (like an out of range texelFetch(..) with robust access)
+    glm::vec3 node(int x, int y, int z) const
+    {
+      if (x < 0 || y < 0 || z < 0 || x >= grid_x || y >= grid_y || z >= grid_z)
+        return glm::vec3(0.0f);
+
+      const float* v = data + 3 * ((static_cast<std::size_t>(z) * grid_y + y) * grid_x + x);
+      return glm::vec3(v[0], v[1], v[2]);
+    }
+  };
+
+
+  // Samples n positions given as structure of arrays, one after another
+  template <typename Sampler>
+  inline void sample_each(const Sampler& sampler, std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz)
+  {
+    for (std::size_t i = 0; i < n; i++)
+    {
+      const auto v = sampler(glm::vec3(x[i], y[i], z[i]));
+      vx[i] = v.x;
+      vy[i] = v.y;
+      vz[i] = v.z;
+    }
+  }
+
+
+  // Manual trilinear interpolation on the grid nodes (texelfetch_velo).
+  struct texelfetch_sampler
+  {
+    field_view field;
+
+    texelfetch_sampler() = default;
+    texelfetch_sampler(field_view field) : field{ field } { }
+
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      const glm::vec3 P0 = glm::floor(pos);
+      const int x = static_cast<int>(P0.x);
+      const int y = static_cast<int>(P0.y);
+      const int z = static_cast<int>(P0.z);
+
+      const float s      = pos.x - P0.x;
+      const float t      = pos.y - P0.y;
+      const float lambda = pos.z - P0.z;
+
+      const auto c = glm::mix(glm::mix(field.node(x, y,     z),     field.node(x + 1, y,     z),     s),
+                              glm::mix(field.node(x, y + 1, z),     field.node(x + 1, y + 1, z),     s), t);
+      const auto d = glm::mix(glm::mix(field.node(x, y,     z + 1), field.node(x + 1, y,     z + 1), s),
+                              glm::mix(field.node(x, y + 1, z + 1), field.node(x + 1, y + 1, z + 1), s), t);
+
+      return glm::mix(c, d, lambda);
+    }
+
+    void sample(std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+    {
+      sample_each(*this, n, x, y, z, vx, vy, vz);
+    }
+  };
+
+
+  // Emulates texture(..) on pos / tex_size with linear filtering and GL_MIRRORED_REPEAT (texture_velo).
+  // Note that this maps the nodes onto the texel centers, i.e. it doesn't sample exactly on the nodes.
+  struct texture_sampler
+  {
+    field_view field;
+
+    texture_sampler() = default;
+    texture_sampler(field_view field) : field{ field } { }
+
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      int   i0[3], i1[3];
+      float a[3];
+
+      const int size[3] = { field.grid_x, field.grid_y, field.grid_z };
+      for (int c = 0; c < 3; c++)
+      {
+        // Normalized texture coordinate => texel space
+        const float u  = (size[c] > 1) ? pos[c] / (size[c] - 1) : 0.0f;
+        const float uT = u * size[c] - 0.5f;
+        const float fl = std::floor(uT);
+
+        a [c] = uT - fl;
+        i0[c] = mirror(static_cast<int>(fl),     size[c]);
+        i1[c] = mirror(static_cast<int>(fl) + 1, size[c]);
+      }
+
+      const auto c = glm::mix(glm::mix(field.node(i0[0], i0[1], i0[2]), field.node(i1[0], i0[1], i0[2]), a[0]),
+                              glm::mix(field.node(i0[0], i1[1], i0[2]), field.node(i1[0], i1[1], i0[2]), a[0]), a[1]);
+      const auto d = glm::mix(glm::mix(field.node(i0[0], i0[1], i1[2]), field.node(i1[0], i0[1], i1[2]), a[0]),
+                              glm::mix(field.node(i0[0], i1[1], i1[2]), field.node(i1[0], i1[1], i1[2]), a[0]), a[1]);
+
+      return glm::mix(c, d, a[2]);
+    }
+
+    void sample(std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+    {
+      sample_each(*this, n, x, y, z, vx, vy, vz);
+    }
+
+    // GL_MIRRORED_REPEAT for texel indices (OpenGL 4.5, table 8.20)
+    static int mirror(int i, int size)
+    {
+      const int period = 2 * size;
+      const int m      = ((i % period) + period) % period - size;
+      return (size - 1) - ((m >= 0) ? m : -(1 + m));
+    }
+  };
+
+
+  /* Linear interpolation between two timesteps (data1 / data2 in main_unsteady.glsl).
+   * time is the relative position in between, 0 at t0 and 1 at t1.
+   */
+  template <typename Sampler>
+  struct time_interpolated_sampler
+  {
+    Sampler t0;
+    Sampler t1;
+
+    time_interpolated_sampler() = default;
+    time_interpolated_sampler(Sampler t0, Sampler t1) : t0{ t0 }, t1{ t1 } { }
+
+    glm::vec3 operator()(const glm::vec3& pos, float time) const
+    {
+      return glm::mix(t0(pos), t1(pos), time);
+    }
+
+    void sample(float time, std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+    {
+      float ux[8], uy[8], uz[8];
+      for (std::size_t i = 0; i < n; i += 8)
+      {
+        const std::size_t m = (n - i < 8) ? n - i : 8;
+
+        t0.sample(m, x + i, y + i, z + i, vx + i, vy + i, vz + i);
+        t1.sample(m, x + i, y + i, z + i, ux, uy, uz);
+
+        for (std::size_t j = 0; j < m; j++)
+        {
+          vx[i + j] = vx[i + j] * (1.0f - time) + ux[j] * time;
+          vy[i + j] = vy[i + j] * (1.0f - time) + uy[j] * time;
+          vz[i + j] = vz[i + j] * (1.0f - time) + uz[j] * time;
+        }
+      }
+    }
+  };
+
+  // Batch sampling at a relative time, steady samplers ignore it
+  template <typename Sampler>
+  inline void sample_at(const Sampler& sampler, float, std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz)
+  {
+    sampler.sample(n, x, y, z, vx, vy, vz);
+  }
+
+  template <typename Sampler>
+  inline void sample_at(const time_interpolated_sampler<Sampler>& sampler, float time, std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz)
+  {
+    sampler.sample(time, n, x, y, z, vx, vy, vz);
+  }
+}
+
+#endif
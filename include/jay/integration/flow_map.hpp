@@ -0,0 +1,134 @@
+#ifndef JAY_INTEGRATION_FLOW_MAP_HPP
+#define JAY_INTEGRATION_FLOW_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* End positions (grid units) of particles seeded at the nodes of a regular grid, x fastest.
+   * Node (i, j, k) sits at (i, j, k) * node_stride, positions in between are mapped by trilinear interpolation.
+   */
+  struct JAY_EXPORT flow_map
+  {
+    glm::uvec3             dims        = glm::uvec3(0);
+    float                  node_stride = 1.0f;
+    std::vector<glm::vec3> positions;
+    // Particles that left the domain (their position stays at the border from then on)
+    std::vector<std::uint8_t> stopped;
+    // Estimated bound of the composition error per node & its maximum (empty / 0 if traced directly)
+    std::vector<float>     errors;
+    double                 error_bound = 0.0;
+    bool                   composed    = false;
+
+    // Maps a position in grid units (clamped to the nodes)
+    glm::vec3   operator()(const glm::vec3& pos) const;
+    glm::vec3   node(std::size_t i, std::size_t j, std::size_t k) const;
+    // Share of the stopped corners at pos (same weights as the interpolation), paths stop at 0.5 & more
+    float       stop_weight(const glm::vec3& pos) const;
+    // Cells between the nodes (at least 1 per axis) & the one containing pos, x fastest
+    glm::uvec3  cell_dims() const;
+    std::size_t cell(const glm::vec3& pos) const;
+  };
+
+
+  /* Dense flow maps of an unsteady field (4D jaySrc: x, y, z, t) for FTLE.
+   * compute(..) integrates one flow map per sub-interval (timestep t to t + 1, local_step_count steps of step_size_h,
+   * like a pass of unsteady_cpu_tracer) for all nodes, once & in parallel. The flow map of any window of sub-intervals
+   * is then composed by interpolating the sub-interval maps one after the other, without integrating again.
+   * Composition error: along the path of a node, each sub-interval map k (after the first one of a window) adds the
+   * interpolation error e of the cell it's interpolated in, and the error so far is stretched by the Lipschitz constant L
+   * of that cell (largest Frobenius norm of the gradient at its corners): bound_k = L * bound_(k-1) + e.
+   * e is the largest error of the interpolated map against particles traced directly from the centers of the cell & its
+   * neighbours; the map bends where particles stop at the border, so cells with a stopped corner take the spread of
+   * their corner images if that's larger.
+   * Windows whose largest bound exceeds the error tolerance are traced directly instead.
+   * Euler, RK4 & ABM4 as in unsteady_cpu_tracer (RK45 throws std::invalid_argument). Particles stop at the domain border
+   * and stay there for the rest of a window, both traced & composed (see flow_map::stop_weight(..)). Once a composed path
+   * passed a cell with stopped & moving corners, the direct path may have stopped (or not) instead, so the distance each
+   * following map moves the path is added to its bound.
+   */
+  struct JAY_EXPORT flow_map_engine
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The field has to outlive the engine (it's not copied).
+    flow_map_engine(const jaySrc<float>& src, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Integrates the flow maps of all sub-intervals for nodes every node_stride grid cells
+    void     compute(const integration_conf& i_conf, unsigned int node_stride = 1);
+
+    // Flow map from timestep first to first + length
+    flow_map compose(std::size_t first, std::size_t length) const;
+    // Same window, integrated directly (reference)
+    flow_map trace  (std::size_t first, std::size_t length) const;
+    // Largest estimated composition error of a window in grid units
+    double   error_bound(std::size_t first, std::size_t length) const;
+
+    // Largest finite-time Lyapunov exponent per node: ln(sqrt(max eigenvalue of the Cauchy-Green tensor)) / |time|
+    static std::vector<float> ftle(const flow_map& map, float integration_time);
+    // FTLE of the window from first to first + length (time: length * local_step_count * step_size_h)
+    std::vector<float>              ftle        (std::size_t first, std::size_t length) const;
+    // FTLE of all windows of length sub-intervals, window after window
+    std::vector<std::vector<float>> sliding_ftle(std::size_t length) const;
+
+    // Windows with a larger bound are traced directly (0: always composed)
+    void         set_error_tolerance(double tolerance);
+    double       get_error_tolerance()                  const;
+
+    std::size_t  get_interval_count()                   const;
+    glm::uvec3   get_node_dims()                        const;
+    // Largest interpolation error & Lipschitz constant of the cells of sub-interval t
+    double       get_interpolation_error(std::size_t t) const;
+    double       get_lipschitz          (std::size_t t) const;
+    unsigned int get_thread_count()                     const;
+    // Duration of the last compute in ms
+    double       get_compute_time()                     const;
+
+  protected:
+    const jaySrc<float>*  src;
+    glm::uvec3            grid;
+    std::size_t           timesteps;
+    unsigned int          thread_count;
+    mutable work_stealing_scheduler scheduler;
+
+    integration_conf      conf;
+    unsigned int          stride    = 1;
+    glm::uvec3            node_dims = glm::uvec3(0);
+    double                tolerance = 0.0;
+    double                compute_time = 0.0;
+
+    // One map per sub-interval, with the interpolation error & Lipschitz constant per cell
+    std::vector<flow_map>           maps;
+    std::vector<std::vector<float>> cell_errors;
+    std::vector<std::vector<float>> cell_lipschitz;
+    std::vector<double>             interpolation_errors;
+    std::vector<double>             lipschitz;
+
+    field_view slice(std::size_t t) const;
+    // Maps n points through sub-interval t (end positions written to ends). Points already set in stopped stay where they are,
+    // stopped is set for particles that leave the domain.
+    void       advect(std::size_t t, const glm::vec4* points, std::size_t n, glm::vec3* ends, std::uint8_t* stopped = nullptr) const;
+    template <typename Sampler>
+    void       advect(const Sampler& sampler, const field_view& bounds, const glm::vec4* points, std::size_t n, glm::vec3* ends, std::uint8_t* stopped) const;
+    // Composed map of a window with its error bounds (never traced)
+    flow_map   compose_maps(std::size_t first, std::size_t length) const;
+    std::vector<glm::vec4> nodes() const;
+  };
+}
+
+#endif
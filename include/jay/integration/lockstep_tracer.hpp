@@ -0,0 +1,96 @@
+#ifndef JAY_INTEGRATION_LOCKSTEP_TRACER_HPP
+#define JAY_INTEGRATION_LOCKSTEP_TRACER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/astc_sampler.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/work_stealing.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  // Divergence of the two traces of a seed (same measures as distance_measure.hpp, accumulated step by step)
+  struct seed_divergence
+  {
+    double        mean_distance       = 0.0;   // Over all vertices (calculate_seed_distance)
+    double        max_distance        = 0.0;
+    double        final_distance      = 0.0;
+    double        area                = 0.0;   // Of the quads between both traces (calculate_seed_area)
+    double        mean_velocity_error = 0.0;   // |v0 - v1| over all vertices
+    std::uint32_t divergence_step     = 0;     // First vertex further apart than the threshold (vertex count if none)
+  };
+
+  // Over all seeds
+  struct JAY_EXPORT divergence_summary
+  {
+    double      mean_distance       = 0.0;
+    double      max_distance        = 0.0;
+    double      mean_final_distance = 0.0;
+    double      mean_area           = 0.0;
+    double      total_area          = 0.0;
+    double      mean_velocity_error = 0.0;
+    std::size_t diverged_seeds      = 0;       // Seeds exceeding the threshold at some vertex
+
+    void print() const;
+  };
+
+  struct lockstep_result
+  {
+    std::vector<seed_divergence> seeds;
+    divergence_summary           summary;
+    // Only if requested: the traces through both fields (layout of cpu_tracer)
+    cpu_trace_result             reference;
+    cpu_trace_result             other;
+  };
+
+
+  /* Traces the same seeds through a reference field & another one (e.g. its ASTC compressed version) in lockstep
+   * and accumulates the divergence of both traces per seed while they are advanced, so neither trace has to be stored.
+   * Both fields are sampled like cpu_tracer (texture / texelFetch), ASTC fields through per-thread block caches (texelFetch).
+   * Euler, RK4 & ABM4 advance both traces step by step, RK45 (steps of different sizes) isn't supported.
+   */
+  struct JAY_EXPORT lockstep_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The fields have to outlive the tracer (they're not copied).
+    lockstep_tracer(const jaySrc<float>& reference, const jaySrc<float>& other, unsigned int thread_count = 0);
+    lockstep_tracer(const jaySrc<float>& reference, const astc_field& other, unsigned int thread_count = 0, std::size_t cache_blocks = 64);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Vertices further apart than divergence_threshold count as diverged. keep_trajectories stores both traces as well.
+    lockstep_result trace(const seeding_conf& s_conf, const integration_conf& i_conf, float divergence_threshold = 1.0f, bool keep_trajectories = false) const;
+
+    unsigned int    get_thread_count() const;
+    // Duration of the last trace in ms
+    double          get_trace_time()   const;
+
+  protected:
+    field_view        reference;
+    field_view        other;
+    const astc_field* other_astc = nullptr;
+    unsigned int      thread_count;
+    mutable double    trace_time = 0.0;
+    mutable work_stealing_scheduler scheduler;
+
+    std::vector<std::unique_ptr<astc_block_cache>> caches;
+
+    template <typename MakeReferenceSampler, typename MakeOtherSampler>
+    void trace_pairs(const MakeReferenceSampler& make_reference, const MakeOtherSampler& make_other, const seeding_conf& s_conf, const integration_conf& i_conf, float divergence_threshold, lockstep_result& result) const;
+  };
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef JAY_INTEGRATION_PAGED_TRACER_HPP
+#define JAY_INTEGRATION_PAGED_TRACER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/io/paged_field.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* Trilinear interpolation inside of a resident brick of a paged_field (same results as texelfetch_sampler).
+   * Cells reaching beyond the nodes of the brick (ghost layer included) are looked up in the paged field (remote),
+   * which may load the neighbouring brick.
+   */
+  struct paged_sampler
+  {
+    paged_field*         field  = nullptr;
+    const float*         data   = nullptr;
+    glm::ivec3           origin;
+    int                  nodes  = 0;
+    mutable std::size_t  remote = 0;
+
+    paged_sampler() = default;
+    paged_sampler(paged_field& field, std::size_t brick, const float* data)
+      : field  { &field }
+      , data   { data }
+      , origin { field.brick_origin(brick) }
+      , nodes  { static_cast<int>(field.brick_nodes) }
+    { }
+
+    glm::vec3 operator()(const glm::vec3& pos) const
+    {
+      const glm::vec3 P0 = glm::floor(pos);
+      const int x = static_cast<int>(P0.x) - origin.x;
+      const int y = static_cast<int>(P0.y) - origin.y;
+      const int z = static_cast<int>(P0.z) - origin.z;
+
+      const float s      = pos.x - P0.x;
+      const float t      = pos.y - P0.y;
+      const float lambda = pos.z - P0.z;
+
+      // All 8 corners inside of the brick (negative values wrap to large unsigned ones)
+      const unsigned int last = static_cast<unsigned int>(nodes - 1);
+      const bool local = (static_cast<unsigned int>(x) < last) & (static_cast<unsigned int>(y) < last) & (static_cast<unsigned int>(z) < last);
+
+      auto node = [&](int dx, int dy, int dz)
+      {
+        if (local)
+        {
+          const float* v = data + 3 * ((static_cast<std::size_t>(z + dz) * nodes + (y + dy)) * nodes + (x + dx));
+          return glm::vec3(v[0], v[1], v[2]);
+        }
+        return field->node(origin.x + x + dx, origin.y + y + dy, origin.z + z + dz);
+      };
+
+      if (!local)
+        remote++;
+
+      const auto c = glm::mix(glm::mix(node(0, 0, 0), node(1, 0, 0), s),
+                              glm::mix(node(0, 1, 0), node(1, 1, 0), s), t);
+      const auto d = glm::mix(glm::mix(node(0, 0, 1), node(1, 0, 1), s),
+                              glm::mix(node(0, 1, 1), node(1, 1, 1), s), t);
+
+      return glm::mix(c, d, lambda);
+    }
+  };
+
+
+  // Scheduling & paging of the last paged_tracer trace
+  struct JAY_EXPORT paged_trace_stats
+  {
+    paged_stats  paging;
+    std::size_t  brick_visits   = 0;   // Times a brick was taken by a thread
+    std::size_t  handoffs       = 0;   // Particles passed on to another brick
+    std::size_t  remote_samples = 0;   // Samples beyond the ghost layer
+    std::size_t  steps          = 0;
+    double       trace_time     = 0.0; // ms
+
+    void print() const;
+  };
+
+
+  /* Headless steady RK4 tracer (Euler with StrategyEuler) for paged fields larger than the memory.
+   * Particles are queued at the brick they sample next. A thread takes the brick with the most queued particles
+   * (resident bricks first), pins it and advances each of its particles until it enters another brick, leaves the domain
+   * or is done; particles entering the brick meanwhile are taken as well, only then the brick is released.
+   * At most capacity - 1 threads work at once, so a remote lookup always finds a slot.
+   * The output has the layout of the GPU buffers (see cpu_tracer), frozen particles repeat their last state.
+   * RK45 & ABM4 throw std::invalid_argument.
+   */
+  struct JAY_EXPORT paged_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The field has to outlive the tracer.
+    paged_tracer(paged_field& field, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result         trace(const seeding_conf& s_conf, const integration_conf& i_conf);
+    void                     trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities);
+
+    unsigned int             get_thread_count() const;
+    const paged_trace_stats& get_stats()        const;
+
+  protected:
+    paged_field&      field;
+    unsigned int      thread_count;
+    paged_trace_stats stats;
+  };
+}
+
+#endif
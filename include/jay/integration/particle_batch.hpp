@@ -0,0 +1,284 @@
+#ifndef JAY_INTEGRATION_PARTICLE_BATCH_HPP
+#define JAY_INTEGRATION_PARTICLE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <jay/integration/field_sampler.hpp>
+
+namespace jay
+{
+  /* A fixed number of particles stored as structure of arrays.
+   * All lanes are advanced together: the loops over a batch have a constant trip count and no branches,
+   * so the compiler turns them into vector instructions, and the samplers can gather 8 lanes at once.
+   * Lanes that left the domain keep their state (like check_boundaries(..) in the shaders).
+   * Lanes >= count are padding and never alive.
+   */
+  template <std::size_t Width = 8>
+  struct particle_batch
+  {
+    static constexpr std::size_t width = Width;
+
+    alignas(32) float x [Width];
+    alignas(32) float y [Width];
+    alignas(32) float z [Width];
+    alignas(32) float vx[Width];
+    alignas(32) float vy[Width];
+    alignas(32) float vz[Width];
+    alignas(32) bool  alive[Width];
+    std::size_t       count = 0;
+
+    // Takes up to Width seeds (w is ignored), velocities start at zero
+    void load(const glm::vec4* seeds, std::size_t n)
+    {
+      count = (n < Width) ? n : Width;
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        x [i] = (i < count) ? seeds[i].x : 0.0f;
+        y [i] = (i < count) ? seeds[i].y : 0.0f;
+        z [i] = (i < count) ? seeds[i].z : 0.0f;
+        vx[i] = vy[i] = vz[i] = 0.0f;
+        alive[i] = false;
+      }
+    }
+
+    // Continues from step i of n seeds written by store(..) (like a pass of main_unsteady.glsl)
+    void resume(const glm::vec4* positions, const glm::vec4* velocities, std::size_t step_count, std::size_t i, std::size_t n)
+    {
+      count = (n < Width) ? n : Width;
+      for (std::size_t l = 0; l < Width; l++)
+      {
+        const auto p = (l < count) ? positions [l * step_count + i] : glm::vec4(0.0f);
+        const auto v = (l < count) ? velocities[l * step_count + i] : glm::vec4(0.0f);
+        x [l] = p.x;
+        y [l] = p.y;
+        z [l] = p.z;
+        vx[l] = v.x;
+        vy[l] = v.y;
+        vz[l] = v.z;
+        alive[l] = false;
+      }
+    }
+
+    // Same as load(..) / resume(..), lane l takes seed index[l] (e.g. seeds sorted along a space-filling curve)
+    void load(const glm::vec4* seeds, const std::uint32_t* index, std::size_t n)
+    {
+      alignas(16) glm::vec4 gathered[Width];
+      count = (n < Width) ? n : Width;
+      for (std::size_t l = 0; l < count; l++)
+        gathered[l] = seeds[index[l]];
+      load(gathered, count);
+    }
+
+    void resume(const glm::vec4* positions, const glm::vec4* velocities, std::size_t step_count, std::size_t i, const std::uint32_t* index, std::size_t n)
+    {
+      count = (n < Width) ? n : Width;
+      for (std::size_t l = 0; l < Width; l++)
+      {
+        const auto p = (l < count) ? positions [index[l] * step_count + i] : glm::vec4(0.0f);
+        const auto v = (l < count) ? velocities[index[l] * step_count + i] : glm::vec4(0.0f);
+        x [l] = p.x;
+        y [l] = p.y;
+        z [l] = p.z;
+        vx[l] = v.x;
+        vy[l] = v.y;
+        vz[l] = v.z;
+        alive[l] = false;
+      }
+    }
+
+    // Marks the lanes inside of the domain, returns false if there is none
+    bool update_alive(const field_view& field)
+    {
+      const float max_x = static_cast<float>(field.grid_x - 1);
+      const float max_y = static_cast<float>(field.grid_y - 1);
+      const float max_z = static_cast<float>(field.grid_z - 1);
+
+      bool any = false;
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        alive[i] = (i < count)
+          & (x[i] >= 0.0f) & (y[i] >= 0.0f) & (z[i] >= 0.0f)
+          & (x[i] <= max_x) & (y[i] <= max_y) & (z[i] <= max_z);
+        any |= alive[i];
+      }
+      return any;
+    }
+
+    // Writes step i of all valid lanes in the interleaved vec4 layout of advected_field (seed after seed).
+    void store(glm::vec4* positions, glm::vec4* velocities, std::size_t step_count, std::size_t i) const
+    {
+      for (std::size_t l = 0; l < count; l++)
+      {
+        positions [l * step_count + i] = glm::vec4(x [l], y [l], z [l], 1.0f);
+        velocities[l * step_count + i] = glm::vec4(vx[l], vy[l], vz[l], 0.0f);
+      }
+    }
+
+    // Writes lane l to seed index[l]
+    void store(glm::vec4* positions, glm::vec4* velocities, std::size_t step_count, std::size_t i, const std::uint32_t* index) const
+    {
+      for (std::size_t l = 0; l < count; l++)
+      {
+        positions [index[l] * step_count + i] = glm::vec4(x [l], y [l], z [l], 1.0f);
+        velocities[index[l] * step_count + i] = glm::vec4(vx[l], vy[l], vz[l], 0.0f);
+      }
+    }
+  };
+
+
+  namespace batch_detail
+  {
+    // k = S(p) * factor, dead lanes sample a harmless position (no border fallbacks)
+    template <typename Sampler, std::size_t Width>
+    inline void slope(const Sampler& sampler, float time, const bool* alive, const float* px, const float* py, const float* pz, const glm::vec3& factor, float* kx, float* ky, float* kz)
+    {
+      alignas(32) float sx[Width], sy[Width], sz[Width];
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        sx[i] = alive[i] ? px[i] : 0.0f;
+        sy[i] = alive[i] ? py[i] : 0.0f;
+        sz[i] = alive[i] ? pz[i] : 0.0f;
+      }
+
+      sample_at(sampler, time, Width, sx, sy, sz, kx, ky, kz);
+
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        kx[i] *= factor.x;
+        ky[i] *= factor.y;
+        kz[i] *= factor.z;
+      }
+    }
+
+    // q = p + (h * k) * scale
+    template <std::size_t Width>
+    inline void offset(const float* p, const float* k, float h, float scale, float* q)
+    {
+      for (std::size_t i = 0; i < Width; i++)
+        q[i] = p[i] + (h * k[i]) * scale;
+    }
+
+    // Advances the alive lanes with the velocity of the last step
+    template <std::size_t Width>
+    inline void advance(particle_batch<Width>& b, float h, float* px, float* py, float* pz)
+    {
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        px[i] = b.alive[i] ? b.x[i] + h * b.vx[i] : b.x[i];
+        py[i] = b.alive[i] ? b.y[i] + h * b.vy[i] : b.y[i];
+        pz[i] = b.alive[i] ? b.z[i] + h * b.vz[i] : b.z[i];
+      }
+    }
+
+    // Replaces k1 = f(p) with the RK4 increment (k1 + 2 k2 + 2 k3 + k4) / 6 at p, 3 more samples
+    template <typename Sampler, std::size_t Width>
+    inline void rk4_increment(const Sampler& sampler, float time, float rel_dt, const bool* alive, const float* px, const float* py, const float* pz, float h, const glm::vec3& factor, float* k1x, float* k1y, float* k1z)
+    {
+      alignas(32) float qx [Width], qy [Width], qz [Width];
+      alignas(32) float k2x[Width], k2y[Width], k2z[Width];
+      alignas(32) float k3x[Width], k3y[Width], k3z[Width];
+      alignas(32) float k4x[Width], k4y[Width], k4z[Width];
+
+      offset<Width>(px, k1x, h, 0.5f, qx);
+      offset<Width>(py, k1y, h, 0.5f, qy);
+      offset<Width>(pz, k1z, h, 0.5f, qz);
+      slope<Sampler, Width>(sampler, time + 0.5f * rel_dt, alive, qx, qy, qz, factor, k2x, k2y, k2z);
+
+      offset<Width>(px, k2x, h, 0.5f, qx);
+      offset<Width>(py, k2y, h, 0.5f, qy);
+      offset<Width>(pz, k2z, h, 0.5f, qz);
+      slope<Sampler, Width>(sampler, time + 0.5f * rel_dt, alive, qx, qy, qz, factor, k3x, k3y, k3z);
+
+      offset<Width>(px, k3x, h, 1.0f, qx);
+      offset<Width>(py, k3y, h, 1.0f, qy);
+      offset<Width>(pz, k3z, h, 1.0f, qz);
+      slope<Sampler, Width>(sampler, time + rel_dt, alive, qx, qy, qz, factor, k4x, k4y, k4z);
+
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        k1x[i] = (k1x[i] + 2.0f * k2x[i] + 2.0f * k3x[i] + k4x[i]) / 6.0f;
+        k1y[i] = (k1y[i] + 2.0f * k2y[i] + 2.0f * k3y[i] + k4y[i]) / 6.0f;
+        k1z[i] = (k1z[i] + 2.0f * k2z[i] + 2.0f * k3z[i] + k4z[i]) / 6.0f;
+      }
+    }
+
+    template <std::size_t Width>
+    inline void commit(particle_batch<Width>& b, const float* px, const float* py, const float* pz, const float* vx, const float* vy, const float* vz)
+    {
+      for (std::size_t i = 0; i < Width; i++)
+      {
+        b.x [i] = px[i];
+        b.y [i] = py[i];
+        b.z [i] = pz[i];
+        b.vx[i] = b.alive[i] ? vx[i] : b.vx[i];
+        b.vy[i] = b.alive[i] ? vy[i] : b.vy[i];
+        b.vz[i] = b.alive[i] ? vz[i] : b.vz[i];
+      }
+    }
+  }
+
+  /* Vectorized counterparts of euler_velo(..) / rk4_velo(..) (schemes.hpp).
+   * One call is one iteration of the loop in main_steady.glsl for all alive lanes:
+   * the position is advanced with the previous velocity, then the new velocity is integrated there.
+   * Call update_alive(..) before each step.
+   * For time_interpolated_sampler the stages are taken at time, time + rel_dt / 2 and time + rel_dt (main_unsteady.glsl).
+   */
+  // Improved Euler (Heun)
+  template <typename Sampler, std::size_t Width>
+  inline void euler_step(particle_batch<Width>& b, const Sampler& sampler, float h, float vector_factor, const glm::vec4& cell_factor, float time = 0.0f, float rel_dt = 0.0f)
+  {
+    using namespace batch_detail;
+
+    const glm::vec3 factor = glm::vec3(cell_factor) * vector_factor;
+
+    alignas(32) float px[Width], py[Width], pz[Width];
+    alignas(32) float qx[Width], qy[Width], qz[Width];
+    alignas(32) float lx[Width], ly[Width], lz[Width];
+    alignas(32) float rx[Width], ry[Width], rz[Width];
+
+    advance(b, h, px, py, pz);
+
+    // Left slope
+    slope<Sampler, Width>(sampler, time, b.alive, px, py, pz, factor, lx, ly, lz);
+
+    // Right slope
+    offset<Width>(px, lx, h, 1.0f, qx);
+    offset<Width>(py, ly, h, 1.0f, qy);
+    offset<Width>(pz, lz, h, 1.0f, qz);
+    slope<Sampler, Width>(sampler, time + rel_dt, b.alive, qx, qy, qz, factor, rx, ry, rz);
+
+    // Average
+    for (std::size_t i = 0; i < Width; i++)
+    {
+      rx[i] = lx[i] + (rx[i] - lx[i]) * 0.5f;
+      ry[i] = ly[i] + (ry[i] - ly[i]) * 0.5f;
+      rz[i] = lz[i] + (rz[i] - lz[i]) * 0.5f;
+    }
+
+    commit(b, px, py, pz, rx, ry, rz);
+  }
+
+  // Runge Kutta 4th order
+  template <typename Sampler, std::size_t Width>
+  inline void rk4_step(particle_batch<Width>& b, const Sampler& sampler, float h, float vector_factor, const glm::vec4& cell_factor, float time = 0.0f, float rel_dt = 0.0f)
+  {
+    using namespace batch_detail;
+
+    const glm::vec3 factor = glm::vec3(cell_factor) * vector_factor;
+
+    alignas(32) float px [Width], py [Width], pz [Width];
+    alignas(32) float k1x[Width], k1y[Width], k1z[Width];
+
+    advance(b, h, px, py, pz);
+
+    slope<Sampler, Width>(sampler, time, b.alive, px, py, pz, factor, k1x, k1y, k1z);
+    rk4_increment<Sampler, Width>(sampler, time, rel_dt, b.alive, px, py, pz, h, factor, k1x, k1y, k1z);
+
+    commit(b, px, py, pz, k1x, k1y, k1z);
+  }
+}
+
+#endif
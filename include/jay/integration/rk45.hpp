@@ -0,0 +1,183 @@
+#ifndef JAY_INTEGRATION_RK45_HPP
+#define JAY_INTEGRATION_RK45_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/integration/schemes.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  // Upper bound of attempted steps per output step (same as RK45_MAX_ITERATIONS in main_steady.glsl)
+  constexpr std::size_t rk45_max_iterations = 16;
+
+  struct rk45_stats
+  {
+    std::size_t accepted   = 0;
+    std::size_t rejected   = 0;
+    std::size_t samples    = 0;     // Field evaluations
+    double      arc_length = 0.0;
+
+    void add(const rk45_stats& other)
+    {
+      accepted   += other.accepted;
+      rejected   += other.rejected;
+      samples    += other.samples;
+      arc_length += other.arc_length;
+    }
+
+    double samples_per_length() const
+    {
+      return (arc_length > 0.0) ? samples / arc_length : 0.0;
+    }
+  };
+
+  /* One Dormand-Prince 5(4) step of size h from pos with k1 = f(pos), as rk45_step(..) in main_steady.glsl.
+   * Returns the 5th order position, k7 = f(result) (first same as last) & the error relative to the tolerance.
+   */
+  template <typename Sampler>
+  inline glm::vec4 rk45_step(const Sampler& sampler, const glm::vec4& pos, const glm::vec4& k1, float h, float vector_factor, const glm::vec4& cell_factor, float tolerance, glm::vec4& k7, float& err)
+  {
+    auto f = [&](const glm::vec4& p) { return sample_velo(sampler, p) * vector_factor * cell_factor; };
+
+    const auto k2 = f(pos + h * (k1 / 5.0f));
+    const auto k3 = f(pos + h * (3.0f/40.0f * k1 + 9.0f/40.0f * k2));
+    const auto k4 = f(pos + h * (44.0f/45.0f * k1 - 56.0f/15.0f * k2 + 32.0f/9.0f * k3));
+    const auto k5 = f(pos + h * (19372.0f/6561.0f * k1 - 25360.0f/2187.0f * k2 + 64448.0f/6561.0f * k3 - 212.0f/729.0f * k4));
+    const auto k6 = f(pos + h * (9017.0f/3168.0f * k1 - 355.0f/33.0f * k2 + 46732.0f/5247.0f * k3 + 49.0f/176.0f * k4 - 5103.0f/18656.0f * k5));
+
+    const auto y5 = pos + h * (35.0f/384.0f * k1 + 500.0f/1113.0f * k3 + 125.0f/192.0f * k4 - 2187.0f/6784.0f * k5 + 11.0f/84.0f * k6);
+    k7 = f(y5);
+
+    // Difference to the embedded 4th order solution
+    const auto e = h * (71.0f/57600.0f * k1 - 71.0f/16695.0f * k3 + 71.0f/1920.0f * k4 - 17253.0f/339200.0f * k5 + 22.0f/525.0f * k6 - 1.0f/40.0f * k7);
+    err = std::max(std::max(std::abs(e.x), std::abs(e.y)), std::abs(e.z)) / tolerance;
+
+    return y5;
+  }
+
+  // Cubic hermite interpolation within a step (s in [0, 1])
+  inline glm::vec4 hermite(const glm::vec4& p0, const glm::vec4& v0, const glm::vec4& p1, const glm::vec4& v1, float h, float s)
+  {
+    const float s2 = s * s;
+    const float s3 = s2 * s;
+    return (2*s3 - 3*s2 + 1) * p0 + (s3 - 2*s2 + s) * h * v0 + (-2*s3 + 3*s2) * p1 + (s3 - s2) * h * v1;
+  }
+
+  /* Adaptive trace of a single seed, as advect_rk45(..) in main_steady.glsl.
+   * Writes steps vec4 to positions & velocities: every accepted step or samples at fixed time / arc length (i_conf.resample_mode).
+   */
+  template <typename Sampler>
+  rk45_stats rk45_advect(const Sampler& sampler, const field_view& bounds, glm::vec4 pos, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities, std::size_t steps)
+  {
+    rk45_stats stats;
+    if (steps == 0)
+      return stats;
+
+    const float     vector_factor = i_conf.dataset_factor;
+    const glm::vec4 cf            = cell_factor(i_conf.cell_size);
+    const float     spacing       = (i_conf.resample_spacing > 0) ? i_conf.resample_spacing : i_conf.step_size_h;
+
+    float h    = glm::clamp(i_conf.step_size_h, i_conf.step_size_min, i_conf.step_size_max);
+    auto  velo = sample_velo(sampler, pos) * vector_factor * cf;
+    float t    = 0.0f;
+    float s    = 0.0f;
+
+    positions [0] = pos;
+    velocities[0] = velo;
+    stats.samples = 1;
+
+    std::size_t i          = 1;
+    std::size_t iterations = 0;
+    while (i < steps && bounds.contains(glm::vec3(pos)) && iterations < rk45_max_iterations * steps)
+    {
+      iterations++;
+
+      glm::vec4 k7;
+      float     err;
+      const auto  next   = rk45_step(sampler, pos, velo, h, vector_factor, cf, i_conf.tolerance, k7, err);
+      const float factor = glm::clamp(0.9f * std::pow(std::max(err, 1e-10f), -0.2f), 0.2f, 5.0f);
+      stats.samples += 6;
+
+      // Rejected
+      if (err > 1.0f && h > i_conf.step_size_min)
+      {
+        h = std::max(h * factor, i_conf.step_size_min);
+        stats.rejected++;
+        continue;
+      }
+
+      const float chord = glm::distance(glm::vec3(next), glm::vec3(pos));
+
+      if (i_conf.resample_mode == 0)
+      {
+        positions [i] = next;
+        velocities[i] = k7;
+        i++;
+      }
+      else
+      {
+        const float from = (i_conf.resample_mode == 1) ? t : s;
+        const float to   = (i_conf.resample_mode == 1) ? t + h : s + chord;
+
+        while (i < steps && i * spacing <= to)
+        {
+          const float theta = (to > from) ? (i * spacing - from) / (to - from) : 1.0f;
+          positions [i] = hermite(pos, velo, next, k7, h, theta);
+          velocities[i] = glm::mix(velo, k7, theta);
+          i++;
+        }
+      }
+
+      t    += h;
+      s    += chord;
+      pos   = next;
+      velo  = k7;
+      h     = glm::clamp(h * factor, i_conf.step_size_min, i_conf.step_size_max);
+      stats.accepted++;
+    }
+    stats.arc_length = s;
+
+    // Frozen (left the domain)
+    for (; i < steps; i++)
+    {
+      positions [i] = pos;
+      velocities[i] = velo;
+    }
+
+    return stats;
+  }
+
+
+  /* Cost of RK45 against fixed-step RK4 at equal accuracy.
+   * All seeds are traced to the time (global_step_count - 1) * step_size_h (RK45 resampled at every step_size_h).
+   * The error is the largest distance of an end point to a reference (RK45 with tolerance / 1000).
+   * RK4 takes 1, 2, 4, .. steps to the same time until its error is not larger than the error of RK45.
+   */
+  struct JAY_EXPORT rk45_report
+  {
+    std::size_t seeds        = 0;
+    double      arc_length   = 0.0;   // Of the reference, summed over all seeds
+    double      rk45_error   = 0.0;
+    std::size_t rk45_samples = 0;
+    double      rk4_error    = 0.0;
+    std::size_t rk4_samples  = 0;
+    std::size_t rk4_steps    = 0;     // RK4 steps per seed needed to reach the RK45 error
+
+    double rk45_samples_per_length() const;
+    double rk4_samples_per_length()  const;
+    void print() const;
+  };
+
+  JAY_EXPORT rk45_report compare_rk45_rk4(const jaySrc<float>& src, const seeding_conf& s_conf, const integration_conf& i_conf, unsigned int thread_count = 0);
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef JAY_INTEGRATION_SCHEMES_HPP
+#define JAY_INTEGRATION_SCHEMES_HPP
+
+#include <glm/glm.hpp>
+
+namespace jay
+{
+  /* CPU counterparts of the steady update_velocity_*_refined(..) functions in 3D_funcs.glsl.
+   * The sampler is any callable vec3 -> vec3 (see field_sampler.hpp).
+   * Like in the shaders the 4th component is carried along (1 for positions, 0 for velocities).
+   */
+  template <typename Sampler>
+  inline glm::vec4 sample_velo(const Sampler& sampler, const glm::vec4& pos)
+  {
+    return glm::vec4(sampler(glm::vec3(pos)), 0.0f);
+  }
+
+  // Improved Euler (Heun)
+  template <typename Sampler>
+  inline glm::vec4 euler_velo(const Sampler& sampler, const glm::vec4& pos, float h, float vector_factor, const glm::vec4& cell_factor)
+  {
+    // Left slope
+    const auto l_velo = sample_velo(sampler, pos) * vector_factor * cell_factor;
+
+    // Right slope
+    const auto r_velo = sample_velo(sampler, pos + h * l_velo) * vector_factor * cell_factor;
+
+    // Average
+    return glm::mix(l_velo, r_velo, 0.5f);
+  }
+
+  // Runge Kutta 4th order
+  template <typename Sampler>
+  inline glm::vec4 rk4_velo(const Sampler& sampler, const glm::vec4& pos, float h, float vector_factor, const glm::vec4& cell_factor)
+  {
+    const auto k1 = sample_velo(sampler, pos)                 * vector_factor * cell_factor;
+    const auto k2 = sample_velo(sampler, pos + h * k1 / 2.0f) * vector_factor * cell_factor;
+    const auto k3 = sample_velo(sampler, pos + h * k2 / 2.0f) * vector_factor * cell_factor;
+    const auto k4 = sample_velo(sampler, pos + h * k3)        * vector_factor * cell_factor;
+
+    return (k1 + 2.0f * k2 + 2.0f * k3 + k4) / 6.0f;
+  }
+
+  // Relative cell size, as computed in main() of the shaders
+  inline glm::vec4 cell_factor(const glm::vec4& cell_size)
+  {
+    const float cell_min = glm::min(glm::min(cell_size.x, cell_size.y), cell_size.z);
+    return glm::vec4(cell_min / cell_size.x, cell_min / cell_size.y, cell_min / cell_size.z, 1.0f);
+  }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef JAY_INTEGRATION_SEED_ORDER_HPP
+#define JAY_INTEGRATION_SEED_ORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  /* Space-filling curves over integer cells.
+   * Particles traced one after another along a curve sample neighbouring parts of the field,
+   * so the field (texture / cache lines) is reused instead of being fetched again for every row of seeds.
+   */
+
+  // Interleaved bits (x lowest), up to 21 bits per axis
+  JAY_EXPORT std::uint64_t morton_key (std::uint32_t x, std::uint32_t y, std::uint32_t z);
+  // Position on the Hilbert curve through a cube of 2^bits cells per axis (bits <= 21)
+  JAY_EXPORT std::uint64_t hilbert_key(std::uint32_t x, std::uint32_t y, std::uint32_t z, unsigned int bits);
+
+  // Permutation of the cells along the curve: order[i] is the index of the i-th cell.
+  // Cells with the same key keep their order, SeedOrderGrid returns 0, 1, 2, ..
+  JAY_EXPORT std::vector<std::uint32_t> curve_order(const std::vector<glm::uvec3>& cells, gl::GLuint ordering);
+
+  // Order of the seeds of cpu_tracer::make_seeds(..) (x fastest) along the curve of s_conf.ordering
+  JAY_EXPORT std::vector<std::uint32_t> seed_order(const seeding_conf& s_conf);
+  // Same for n cells of a grid in x fastest order
+  JAY_EXPORT std::vector<std::uint32_t> grid_order(const glm::uvec3& dims, gl::GLuint ordering);
+
+  // Order of n particles by their current position (positions[index[i] * stride]) inside of a grid,
+  // positions are quantized to (at most) 1024 cells per axis. Returns the reordered indices.
+  JAY_EXPORT std::vector<std::uint32_t> position_order(const glm::vec4* positions, std::size_t stride, const std::vector<std::uint32_t>& index, const glm::vec3& grid, gl::GLuint ordering);
+
+
+  /* The chunks of the CPU tracers: tiles of neighbouring seeds (rows of row_width seeds in x, 4 in y, 2 in z)
+   * of a seeding grid, numbered along a space-filling curve. Nearby particles sample the same part of the field,
+   * and the chunks of a thread (and the next chunks of all threads) stay close together.
+   */
+  struct JAY_EXPORT seed_tiles
+  {
+    glm::uvec3                 dims;    // Seeds per axis
+    glm::uvec3                 tile;
+    glm::uvec3                 tiles;   // Per axis
+    std::vector<std::uint32_t> order;
+
+    seed_tiles(const glm::uvec3& dims, gl::GLuint ordering, unsigned int row_width = 8);
+
+    std::size_t count() const;
+
+    // Calls row(first seed, seed count) for the rows of the i-th tile (seeds in x fastest order)
+    template <typename Row>
+    void for_rows(std::size_t i, Row&& row) const
+    {
+      const std::size_t tile_id = order[i];
+      const glm::uvec3  t(tile_id % tiles.x, (tile_id / tiles.x) % tiles.y, tile_id / (static_cast<std::size_t>(tiles.x) * tiles.y));
+      const glm::uvec3  begin = t * tile;
+      const glm::uvec3  end   = glm::min(begin + tile, dims);
+
+      for (std::size_t z = begin.z; z < end.z; z++)
+        for (std::size_t y = begin.y; y < end.y; y++)
+          row((z * dims.y + y) * dims.x + begin.x, static_cast<std::size_t>(end.x - begin.x));
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef JAY_INTEGRATION_TRACE_CACHE_HPP
+#define JAY_INTEGRATION_TRACE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  struct JAY_EXPORT trace_cache_stats
+  {
+    std::size_t hits      = 0;   // Seeds copied from the cache
+    std::size_t misses    = 0;   // Seeds integrated
+    std::size_t evictions = 0;
+
+    double hit_rate() const;
+  };
+
+
+  /* Trajectories (positions & velocities) of single seeds, least recently used ones evicted first
+   * once the stored vec4s exceed budget_bytes.
+   * A trajectory is identified by the field, the integration parameters (see params_id(..)) & the exact seed position.
+   * Not thread safe.
+   */
+  class JAY_EXPORT trace_cache
+  {
+  public:
+    struct key
+    {
+      std::uint64_t field  = 0;
+      std::uint64_t params = 0;
+      glm::vec3     seed;
+
+      bool operator==(const key& other) const;
+    };
+
+    struct entry
+    {
+      std::vector<glm::vec4> positions;
+      std::vector<glm::vec4> velocities;
+    };
+
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    trace_cache(std::size_t budget_bytes = 256 * 1024 * 1024);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Hash of everything in i_conf a trajectory depends on (strategy, sampling, grid, cell size, step sizes & counts, ..)
+    static std::uint64_t params_id(const integration_conf& i_conf);
+    // Same, but tells apart tracers which trace the same parameters differently (e.g. GPU & CPU)
+    static std::uint64_t params_id(const integration_conf& i_conf, std::uint64_t variant);
+    // Content stamp of a field (grid, layout & all values), never 0
+    static std::uint64_t field_id(const jaySrc<float>& src);
+
+    // nullptr if not cached, valid until the next insert(..)
+    const entry* find(const key& k);
+    // Copies steps vec4 each, evicting old trajectories if necessary (trajectories above the budget are not stored)
+    void         insert(const key& k, const glm::vec4* positions, const glm::vec4* velocities, std::size_t steps);
+
+    std::size_t  size()       const;   // Trajectories
+    std::size_t  byte_size()  const;
+    std::size_t  get_budget() const;
+    void         set_budget(std::size_t budget_bytes);
+
+    const trace_cache_stats& get_stats() const;
+    void                     reset_stats();
+    void                     clear();
+
+  protected:
+    struct key_hash
+    {
+      std::size_t operator()(const key& k) const;
+    };
+
+    using lru_list = std::list<std::pair<key, entry>>;
+
+    std::size_t       budget;
+    std::size_t       bytes = 0;
+    trace_cache_stats stats;
+
+    // Most recently used first
+    lru_list                                               lru;
+    std::unordered_map<key, lru_list::iterator, key_hash>  entries;
+
+    void evict(std::size_t budget_bytes);
+  };
+
+
+  /* cpu_tracer with a trace_cache: only seeds missing in the cache are integrated (as one list, see cpu_tracer::trace(..)),
+   * the result is assembled from cached & new trajectories. Changing the seed ranges or strides back & forth,
+   * or revisiting a configuration, reuses all trajectories of seeds at the same positions.
+   * The field_id tells fields apart when caches are shared (default: trace_cache::field_id(src), a content stamp taken
+   * by the constructor; create a new tracer after changing the field).
+   */
+  struct JAY_EXPORT cached_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The field has to outlive the tracer (it's not copied).
+    cached_tracer(const jaySrc<float>& src, std::size_t budget_bytes = 256 * 1024 * 1024, unsigned int thread_count = 0, std::uint64_t field_id = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result   trace(const seeding_conf& s_conf, const integration_conf& i_conf);
+    void               trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities);
+
+    trace_cache&       get_cache();
+    cpu_tracer&        get_tracer();
+    // Seeds integrated by the last trace (cache misses)
+    std::size_t        get_traced_seeds() const;
+    // Duration of the last trace in ms (lookups & copies included)
+    double             get_trace_time()   const;
+
+  protected:
+    cpu_tracer    tracer;
+    trace_cache   cache;
+    std::uint64_t field_id;
+    std::size_t   traced_seeds = 0;
+    double        trace_time   = 0.0;
+  };
+}
+
+#endif
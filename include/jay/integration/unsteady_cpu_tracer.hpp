@@ -0,0 +1,70 @@
+#ifndef JAY_INTEGRATION_UNSTEADY_CPU_TRACER_HPP
+#define JAY_INTEGRATION_UNSTEADY_CPU_TRACER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/field_sampler.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  typedef struct timestep_source timestep_source;
+
+  /* Headless pathline tracer, following vector_field::unsteady_advect(..) & main_unsteady.glsl pass by pass.
+   * Pass t integrates local_step_count steps of all particles between timestep t and t + 1,
+   * the last pass integrates the remainder steps in the last timestep only.
+   * Only the two timesteps of the current pass are touched, each timestep is visited once.
+   * The data either is a 4D jaySrc (x, y, z, t) or streamed by a timestep_source (which then also prefetches).
+   * The output has the layout of the GPU buffers (see cpu_tracer).
+   * Seeds are traced in the order of s_conf.ordering. With a space-filling curve, the live particles can be re-sorted
+   * by their current position every few passes, so particles traced together stay close while they drift apart.
+   */
+  struct JAY_EXPORT unsteady_cpu_tracer
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    // The data has to outlive the tracer (it's not copied).
+    unsteady_cpu_tracer(const jaySrc<float>& src, unsigned int thread_count = 0);
+    unsteady_cpu_tracer(timestep_source& source, unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    cpu_trace_result trace(const seeding_conf& s_conf, const integration_conf& i_conf);
+    // Writes into preallocated buffers of seed_count * global_step_count vec4 each.
+    void             trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities);
+
+    // Re-sorts the particles along the curve of s_conf.ordering every n passes (0: never)
+    void         set_resort_interval(std::size_t passes);
+
+    unsigned int get_thread_count() const;
+    // Duration of the last trace in ms
+    double       get_trace_time()   const;
+
+  protected:
+    const jaySrc<float>*     src    = nullptr;
+    timestep_source*         source = nullptr;
+    std::vector<std::size_t> grid;   // x, y, z, t
+    unsigned int             thread_count;
+    double                   trace_time = 0.0;
+    std::size_t              resort_interval = 0;
+
+    field_view acquire(std::size_t t);
+    void       release(std::size_t t);
+
+    // Integrates steps of all seeds in the given order, starting at step offset (from the seeds if offset is 0)
+    template <typename Sampler>
+    void pass(const Sampler& sampler, const field_view& bounds, const std::vector<glm::vec4>& seeds, const std::vector<std::uint32_t>& order, const integration_conf& i_conf, std::size_t offset, std::size_t steps, glm::vec4* positions, glm::vec4* velocities) const;
+  };
+}
+
+#endif
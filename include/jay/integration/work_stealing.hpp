@@ -0,0 +1,70 @@
+#ifndef JAY_INTEGRATION_WORK_STEALING_HPP
+#define JAY_INTEGRATION_WORK_STEALING_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+  // Time a thread spent on its chunks (busy) and everything else until the last thread finished (idle)
+  struct worker_stats
+  {
+    double      busy_ms = 0.0;
+    double      idle_ms = 0.0;
+    std::size_t chunks  = 0;
+    std::size_t steals  = 0;
+  };
+
+  /* Distributes chunk indices [0, chunk_count) over thread_count threads.
+   * Every thread starts with its own contiguous range of chunks (neighbouring chunks stay on the same thread),
+   * and takes them from the front. A thread that runs out steals the back half of the largest remaining range.
+   * Chunks are never split, so a chunk should be some work (e.g. a tile of seeds).
+   */
+  struct JAY_EXPORT work_stealing_scheduler
+  {
+    /* =========================================================================*/
+    /*                             Constructors
+    /* =========================================================================*/
+    work_stealing_scheduler(unsigned int thread_count = 0);
+
+    /* =========================================================================*/
+    /*                                Methods
+    /* =========================================================================*/
+    // Calls task(thread, chunk) once per chunk, returns after all chunks are done
+    void run(std::size_t chunk_count, const std::function<void(unsigned int, std::size_t)>& task);
+
+    unsigned int                     get_thread_count() const;
+    // Per thread stats of the last run
+    const std::vector<worker_stats>& get_stats()        const;
+    // Duration of the last run in ms
+    double                           get_run_time()     const;
+    // Busy time of all threads / (thread count * run time), 1 = perfect scaling
+    double                           efficiency()       const;
+    void                             print()            const;
+
+  protected:
+    struct chunk_range
+    {
+      std::mutex  m;
+      std::size_t begin = 0;
+      std::size_t end   = 0;
+    };
+
+    unsigned int                              thread_count;
+    std::vector<std::unique_ptr<chunk_range>> ranges;
+    std::vector<worker_stats>                 stats;
+    double                                    run_time = 0.0;
+
+    // Next chunk of the own range
+    bool pop  (unsigned int thread, std::size_t& chunk);
+    // Moves the back half of the largest other range into the own (empty) range
+    bool steal(unsigned int thread);
+  };
+}
+
+#endif
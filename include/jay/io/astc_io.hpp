@@ -1,10 +1,14 @@
 #ifndef JAY_ASTC_IO_HPP
 #define JAY_ASTC_IO_HPP
 
+#include <functional>
+#include <string>
 #include <vector>
 #include <jay/types/image.hpp>
 #include <jay/types/jaydata.hpp>
 
+#include <jay/export.hpp>
+
 namespace jay
 {
 
@@ -19,7 +23,22 @@ struct astc_header
   uint8_t dim_z[3];			// block count is inferred
 };
 
-struct astc_io
+// Timings of astc_read_multiple. Throughput is given in MB/s.
+struct JAY_EXPORT astc_read_stats
+{
+  std::vector<std::string> filenames;
+  std::vector<double>      file_ms;           // Time to read each file (without the callback)
+  std::vector<std::size_t> file_bytes;
+  double                   total_ms    = 0.0; // Wall time of the whole call
+  std::size_t              total_bytes = 0;
+
+  double file_throughput(std::size_t i) const;
+  double throughput() const;
+
+  void print() const;
+};
+
+struct JAY_EXPORT astc_io
 {
   /* =============================================================
 
@@ -48,6 +67,18 @@ struct astc_io
   // Returns a vector of astc compressed images (without the fileheaders).
   static std::vector<jayComp<astc_datatype>> astc_read_multiple(const std::vector<std::string>& filenames);
 
+  // Is called from the reading thread as soon as file i is read (e.g. to decode it right away).
+  using astc_read_callback = std::function<void(std::size_t i, jayComp<astc_datatype>& comp_imgs)>;
+
+  // Reads multiple astc compressed files concurrently on io_threads threads.
+  // The result keeps the order of filenames. Timings are written to stats (if given).
+  static std::vector<jayComp<astc_datatype>> astc_read_multiple(
+    const std::vector<std::string>& filenames,
+    unsigned int                    io_threads,
+    astc_read_callback              on_read = nullptr,
+    astc_read_stats*                stats   = nullptr
+  );
+
 };
 
 }
@@ -0,0 +1,115 @@
+#ifndef JAY_IO_DATASET_SERVER_HPP
+#define JAY_IO_DATASET_SERVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <jay/io/io_enums.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+struct astc_field;
+
+// Start of a dataset segment, followed by the peaks & the data (both 64 byte aligned)
+struct dataset_descriptor
+{
+  static constexpr std::uint32_t magic_value = 0x4A415944;   // "JAYD"
+
+  std::uint32_t              magic         = magic_value;
+  std::atomic<std::uint32_t> ready         { 0 };            // Set once the data is complete
+  std::uint64_t              owner         = 0;              // Process id of the server
+  std::uint64_t              grid[4]       = { 1, 1, 1, 1 };
+  std::uint64_t              grid_dim      = 0;
+  std::uint64_t              vec_len       = 0;
+  std::uint32_t              ordering      = 0;              // jay::Order
+  std::uint64_t              peak_count    = 0;
+  std::uint64_t              element_count = 0;              // Floats of the data
+  std::uint64_t              peak_offset   = 0;              // Bytes from the start of the segment
+  std::uint64_t              data_offset   = 0;
+};
+
+
+/* Loads or decodes a field once into POSIX shared memory (named segment), so that any number of processes on the machine
+ * can attach to it zero-copy with a dataset_client instead of reading & holding their own copy.
+ * The segment holds a dataset_descriptor (grid, vec_len, ordering, peaks) and the data, floats in the given ordering.
+ * Clients wait until the data is complete. The segment is removed when the server is destroyed; attached clients keep
+ * their mapping until they detach. A segment of the same name is only replaced if the process of its server is gone
+ * (a crashed server), otherwise the new server fails to publish and is not valid.
+ */
+struct JAY_EXPORT dataset_server
+{
+  // Writes element_count floats into dst
+  using loader_fn = std::function<void(float* dst)>;
+
+  /* =========================================================================*/
+  /*                             Constructors
+  /* =========================================================================*/
+  // Copies a field in memory
+  dataset_server(std::string name, const jaySrc<float>& src, std::vector<float> peaks = {});
+  // Reads a HDF5 file straight into shared memory (like io::hdf5_read(..))
+  dataset_server(std::string name, std::string h5_filepath, std::vector<std::string> datasets, Order ordering = Order::VectorFirst, std::vector<float> peaks = {});
+  // Decodes an ASTC compressed timestep (vectorlike, 3 components); peaks as used by the field
+  dataset_server(std::string name, const astc_field& field, std::vector<float> peaks);
+  // Grid is x, y, z(, t)
+  dataset_server(std::string name, loader_fn loader, std::vector<std::size_t> grid, std::size_t grid_dim, std::size_t vec_len, Order ordering, std::vector<float> peaks = {});
+  ~dataset_server();
+
+  dataset_server(const dataset_server&) = delete;
+  dataset_server& operator=(const dataset_server&) = delete;
+
+  /* =========================================================================*/
+  /*                                Methods
+  /* =========================================================================*/
+  // False if the segment could not be created (e.g. the name is served by another process)
+  bool               valid()         const;
+  const std::string& get_name()      const;
+  std::size_t        byte_size()     const;
+  // The served data, for the server process itself
+  jaySrcView<float>  view()          const;
+  // Duration of loading / decoding in ms
+  double             get_load_time() const;
+
+protected:
+  std::string                                        name;
+  std::unique_ptr<boost::interprocess::mapped_region> region;
+  double                                             load_ms = 0.0;
+
+  void publish(const loader_fn& loader, std::vector<std::size_t> grid, std::size_t grid_dim, std::size_t vec_len, Order ordering, const std::vector<float>& peaks);
+};
+
+
+// A dataset attached (read only) from the segment of a dataset_server
+struct JAY_EXPORT dataset_client
+{
+  /* =========================================================================*/
+  /*                             Constructors
+  /* =========================================================================*/
+  // Waits up to timeout_ms for the server to complete the data
+  dataset_client(std::string name, double timeout_ms = 10000.0);
+
+  /* =========================================================================*/
+  /*                                Methods
+  /* =========================================================================*/
+  // False if there is no (complete) dataset of that name
+  bool                      valid()      const;
+  // Points into shared memory, valid as long as the client lives
+  jaySrcView<float>         view()       const;
+  std::vector<float>        peaks()      const;
+  const dataset_descriptor& descriptor() const;
+  std::size_t               byte_size()  const;
+
+protected:
+  std::unique_ptr<boost::interprocess::mapped_region> region;
+};
+}
+
+#endif
@@ -6,8 +6,12 @@
 #include <highfive/H5DataSpace.hpp>
 #include <glm/glm.hpp>
 
+#include <jay/io/io_enums.hpp>
 #include <jay/export.hpp>
 
+#include <mutex>
+#include <vector>
+
 namespace jay
 {
 struct JAY_EXPORT hdf5_io
@@ -38,6 +42,12 @@ struct JAY_EXPORT hdf5_io
   // Returns the dimension of the grids elements (1 => scalar, (1, inf) => vector)
   std::size_t              get_vec_len();
 
+  // Returns the dimensions of the first dataset as stored in the file (descending order). Read once, then cached.
+  const std::vector<std::size_t>& get_dims();
+
+  // The HDF5 library is not reentrant. Every read that may run off the main thread has to hold this lock.
+  static std::mutex&       library_mutex();
+
   /* =========================================================================*/
   /*                                Methods
   /* =========================================================================*/
@@ -186,10 +196,113 @@ struct JAY_EXPORT hdf5_io
     delete[] slice;
   }
   
+  /* Reads a single timestep of the opened file into a pointer.
+   * Only a hyperslab of [1, grid_z, grid_y, grid_x] is selected per dataset, so the rest of the file is never touched.
+   * 3D datasets only have the timestep 0.
+   * The pointer must hold grid_z * grid_y * grid_x * vec_len elements.
+   */
+  template <typename T>
+  void read_hdf5_timestep(
+    T*           data_addr,
+    std::size_t  t,
+    Order        ordering = Order::VectorFirst
+  )
+  {
+    std::lock_guard<std::mutex> lock(library_mutex());
+
+    const auto dim     = get_grid_dim();
+    const auto vec_len = get_vec_len();
+    const auto grid    = get_grid_fixsize();
+    // Slice elements per component
+    const auto slice_elements_scalar = grid[0] * grid[1] * grid[2];
+
+    // Vectorlike ordering needs to interleave the components afterwards
+    std::vector<T> buffer((ordering == Order::VectorFirst && vec_len > 1) ? slice_elements_scalar : 0);
+    T* slice = buffer.empty() ? nullptr : buffer.data();
+
+    for (std::size_t c = 0; c < vec_len; c++)
+    {
+      auto dataset = hdf5_file.getDataSet(hdf5_datasets[c]);
+
+      std::vector<std::size_t> offset(dim, 0);
+      std::vector<std::size_t> count = dataset.getDimensions();
+      if (dim == 4)
+      {
+        offset[0] = t;
+        count[0]  = 1;
+      }
+
+      T* dst = (slice) ? slice : data_addr + c * slice_elements_scalar;
+      dataset.select(offset, count).read(dst);
+
+      if (!slice)
+        continue;
+
+      for (std::size_t i = 0; i < slice_elements_scalar; i++)
+        data_addr[i * vec_len + c] = slice[i];
+    }
+  }
+
+  /* Reads the depth layers [z_offset, z_offset + z_count) of timestep t, like read_hdf5_timestep(..) but for a slab
+   * (a hyperslab of [1, z_count, grid_y, grid_x] per dataset).
+   * The pointer must hold z_count * grid_y * grid_x * vec_len elements.
+   */
+  template <typename T>
+  void read_hdf5_slab(
+    T*           data_addr,
+    std::size_t  t,
+    std::size_t  z_offset,
+    std::size_t  z_count,
+    Order        ordering = Order::VectorFirst
+  )
+  {
+    std::lock_guard<std::mutex> lock(library_mutex());
+
+    const auto dim     = get_grid_dim();
+    const auto vec_len = get_vec_len();
+    const auto grid    = get_grid_fixsize();
+    // Slab elements per component
+    const auto slab_elements_scalar = grid[0] * grid[1] * z_count;
+
+    // Vectorlike ordering reads each component into a staging buffer first
+    std::vector<T> staging((ordering == Order::VectorFirst && vec_len > 1) ? slab_elements_scalar : 0);
+    T* slab = staging.empty() ? nullptr : staging.data();
+
+    for (std::size_t c = 0; c < vec_len; c++)
+    {
+      auto dataset = hdf5_file.getDataSet(hdf5_datasets[c]);
+
+      // Dimensions are stored slowest first: (t,) z, y, x
+      std::vector<std::size_t> offset(dim, 0);
+      std::vector<std::size_t> count = dataset.getDimensions();
+      if (dim >= 3)
+      {
+        offset[dim - 3] = z_offset;
+        count [dim - 3] = z_count;
+      }
+      if (dim == 4)
+      {
+        offset[0] = t;
+        count[0]  = 1;
+      }
+
+      T* dst = (slab) ? slab : data_addr + c * slab_elements_scalar;
+      dataset.select(offset, count).read(dst);
+
+      if (!slab)
+        continue;
+
+      for (std::size_t i = 0; i < slab_elements_scalar; i++)
+        data_addr[i * vec_len + c] = slab[i];
+    }
+  }
+
   /* =========================================================================*/
   /*                                Exceptions
   /* =========================================================================*/
 protected:
+  std::vector<std::size_t> hdf5_dims;
+
   struct GridException : public std::exception {
     const char* what() const throw () {
       return "You can only select datasets with grid-dimension of 1 to 4 and as specified.";
@@ -0,0 +1,215 @@
+#ifndef JAY_IO_HDF5_SERIES_HPP
+#define JAY_IO_HDF5_SERIES_HPP
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <jay/io/hdf5_io.hpp>
+#include <jay/io/io_enums.hpp>
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+/* Presents many HDF5 files (e.g. per-timestep dumps) as one 4D dataset.
+ * Each file contributes one (3D) or several (4D) consecutive timesteps; all files must share x, y, z and the datasets.
+ * The metadata of every file is read once while opening, one file after the other (the HDF5 library is not reentrant).
+ * Timesteps of contiguous, uncompressed datasets are read straight from the file offsets without going through the
+ * HDF5 library, which allows truly parallel reads. Everything else falls back to hyperslab reads via hdf5_io.
+ */
+struct JAY_EXPORT hdf5_series
+{
+  struct member
+  {
+    std::string              filepath;
+    std::unique_ptr<hdf5_io> handler;
+    std::vector<std::size_t> grid;          // x, y, z, t
+    std::size_t              grid_dim = 0;
+    std::size_t              t_begin = 0;   // First global timestep in this file
+    std::vector<long long>   raw_offset;    // Byte offset of each (native float) dataset in the file, -1 if not directly readable
+  };
+
+  std::vector<member>      members;
+  std::vector<std::string> hdf5_datasets;
+
+  /* =========================================================================*/
+  /*                             Constructors
+  /* =========================================================================*/
+  // The files are ordered as given.
+  // Entries may contain '*' and '?' in their filename, the matching files are then ordered by name.
+  hdf5_series(
+    std::vector<std::string> filepaths,
+    std::vector<std::string> datasets,
+    unsigned int             thread_count = 0
+  );
+
+  /* =========================================================================*/
+  /*                             Getter / Setter
+  /* =========================================================================*/
+  // False if a file couldn't be opened or the grids of the files don't match.
+  bool                     valid() const;
+  // Size of each dimension (x, y, z, t), t spans all files. Zeros for an inconsistent series.
+  std::vector<std::size_t> get_grid() const;
+  std::size_t              get_grid_dim() const;
+  std::size_t              get_vec_len() const;
+  std::size_t              timesteps() const;
+  // Elements of a single timestep (all components)
+  std::size_t              slice_elements() const;
+
+  // Returns the matching files of a pattern, sorted by name (numbers by value, "step_2" before "step_10")
+  static std::vector<std::string> expand_pattern(std::string pattern);
+
+  /* =========================================================================*/
+  /*                                Methods
+  /* =========================================================================*/
+  // Reads component c of the global timestep t into a buffer of grid_x * grid_y * grid_z elements.
+  template <typename T>
+  void read_component(T* data_addr, std::size_t t, std::size_t c)
+  {
+    if (!valid() || t >= timesteps() || c >= get_vec_len())
+    {
+      printf("Error: Can't read component %zu of timestep %zu from the series.\n", c, t);
+      return;
+    }
+
+    const auto& m       = members[find_member(t)];
+    const auto  t_local = t - m.t_begin;
+    const auto  slice_elements_scalar = slice_elements() / get_vec_len();
+
+    // Direct read (no HDF5 lock needed)
+    if (std::is_same<T, float>::value && m.raw_offset[c] >= 0)
+    {
+      std::ifstream file(m.filepath, std::ios::in | std::ios::binary);
+      file.seekg(m.raw_offset[c] + t_local * slice_elements_scalar * sizeof(T));
+      file.read(reinterpret_cast<char*>(data_addr), slice_elements_scalar * sizeof(T));
+
+      if (file)
+        return;
+
+      printf("Error: Direct read failed for '%s', falling back to HDF5.\n", m.filepath.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+
+    auto dataset = m.handler->hdf5_file.getDataSet(hdf5_datasets[c]);
+    const auto& dims = m.handler->get_dims();
+
+    std::vector<std::size_t> offset(dims.size(), 0);
+    std::vector<std::size_t> count = dims;
+    if (dims.size() == 4)
+    {
+      offset[0] = t_local;
+      count[0]  = 1;
+    }
+
+    dataset.select(offset, count).read(data_addr);
+  }
+
+  // Reads the global timestep t into a buffer of slice_elements() elements. Components are read in parallel.
+  template <typename T>
+  void read_timestep(T* data_addr, std::size_t t, Order ordering = Order::VectorFirst)
+  {
+    if (!valid() || t >= timesteps())
+    {
+      printf("Error: Can't read timestep %zu from the series.\n", t);
+      return;
+    }
+
+    const auto vec_len               = get_vec_len();
+    const auto slice_elements_scalar = slice_elements() / vec_len;
+
+    std::vector<std::thread> threads;
+    threads.reserve(vec_len);
+
+    for (std::size_t c = 0; c < vec_len; c++)
+      threads.emplace_back([&, c]()
+      {
+        if (ordering == Order::ComponentFirst)
+        {
+          read_component(data_addr + c * slice_elements_scalar, t, c);
+          return;
+        }
+
+        // Vectorlike ordering needs to interleave the components afterwards
+        std::vector<T> slice(slice_elements_scalar);
+        read_component(slice.data(), t, c);
+
+        for (std::size_t i = 0; i < slice_elements_scalar; i++)
+          data_addr[i * vec_len + c] = slice[i];
+      });
+
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  // Reads the whole series into a container with metainfo. Timesteps are read in parallel.
+  template <typename T>
+  jaySrc<T> read(Order ordering = Order::VectorFirst)
+  {
+    if (!valid())
+    {
+      printf("Error: Can't read an inconsistent series.\n");
+      return {};
+    }
+
+    const auto grid                  = get_grid();
+    const auto vec_len               = get_vec_len();
+    const auto slice_elements_scalar = grid[0] * grid[1] * grid[2];
+    const auto grid_elements_scalar  = slice_elements_scalar * grid[3];
+
+    jaySrc<T> data_container{ std::vector<T>(grid_elements_scalar * vec_len), grid, get_grid_dim(), vec_len, ordering };
+
+    std::atomic<std::size_t> next{ 0 };
+    auto worker = [&]()
+    {
+      std::vector<T> slice(slice_elements_scalar);
+
+      for (auto t = next++; t < timesteps(); t = next++)
+        for (std::size_t c = 0; c < vec_len; c++)
+        {
+          // Componentwise ordering (offset = blocksize)
+          if (ordering == Order::ComponentFirst)
+          {
+            read_component(data_container.data.data() + c * grid_elements_scalar + t * slice_elements_scalar, t, c);
+            continue;
+          }
+
+          // Vectorlike ordering (stride = vec_size, offset = component_id)
+          read_component(slice.data(), t, c);
+
+          T* dst = data_container.data.data() + t * slice_elements_scalar * vec_len;
+          for (std::size_t i = 0; i < slice_elements_scalar; i++)
+            dst[i * vec_len + c] = slice[i];
+        }
+    };
+
+    std::vector<std::thread> threads(std::min<std::size_t>(thread_count, timesteps()));
+    for (auto& thread : threads)
+      thread = std::thread(worker);
+    for (auto& thread : threads)
+      thread.join();
+
+    return data_container;
+  }
+
+  // A reader which streams the series through a timestep_source
+  std::function<void(std::size_t, float*)> timestep_reader();
+
+protected:
+  unsigned int thread_count;
+  bool         consistent = false;
+
+  void        open(std::vector<std::string> filepaths);
+  // Member holding the global timestep t, members.size() if t is out of range
+  std::size_t find_member(std::size_t t) const;
+};
+}
+
+#endif
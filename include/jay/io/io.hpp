@@ -6,6 +6,7 @@
 #include <jay/io/data_io.hpp>
 #include <jay/io/astc_io.hpp>
 #include <jay/io/hdf5_io.hpp>
+#include <jay/io/hdf5_series.hpp>
 #include <jay/io/image_io.hpp>
 #include <jay/io/io_enums.hpp>
 #include <jay/types/image.hpp>
@@ -173,6 +174,18 @@ struct JAY_EXPORT io
     hdf5_handler->read_hdf5(data_addr)
   }
 
+  // Reads many files (a list or a pattern like "../files/run_*.h5") as one 4D container with metainfo.
+  template <typename T>
+  jaySrc<T> hdf5_read_series(
+    std::vector<std::string> filepaths,
+    std::vector<std::string> datasets,
+    Order                    ordering = Order::VectorFirst
+  )
+  {
+    hdf5_series series(filepaths, datasets);
+    return series.read<T>(ordering);
+  }
+
   std::vector<std::size_t> hdf5_get_grid(bool desc_order = false)
   {
     return hdf5_handler->get_grid(desc_order);
@@ -225,6 +238,7 @@ struct JAY_EXPORT io
   jayComp<astc_datatype> astc_read(std::string filename);
 
   std::vector<jayComp<astc_datatype>> astc_read_multiple(const std::vector<std::string>& filenames);
+  std::vector<jayComp<astc_datatype>> astc_read_multiple(const std::vector<std::string>& filenames, unsigned int io_threads, astc_io::astc_read_callback on_read = nullptr, astc_read_stats* stats = nullptr);
 
 
   /* =============================================================
@@ -0,0 +1,119 @@
+#ifndef JAY_IO_PAGED_FIELD_HPP
+#define JAY_IO_PAGED_FIELD_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <jay/types/jaydata.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+// Loads & evictions of a paged_field
+struct paged_stats
+{
+  std::size_t loads     = 0;
+  std::size_t hits      = 0;
+  std::size_t evictions = 0;
+  std::size_t bytes     = 0;     // Read from disk
+  double      read_ms   = 0.0;
+};
+
+/* A vectorlike 3-component field (one timestep) split into cubic bricks of brick_size^3 cells, stored in a single file.
+ * Every brick holds the nodes of its cells plus `ghost` nodes on all sides, (brick_size + 2 * ghost + 1)^3 nodes,
+ * so steps starting inside of a brick rarely need a neighbour. Nodes outside of the grid are zero.
+ * Bricks are read on demand into an LRU cache of at most budget bytes (at least 2 bricks).
+ * Every concurrent read uses its own file handle, so threads missing different bricks page them in in parallel.
+ * The file is written slab by slab, so neither writing nor tracing needs the whole field in memory.
+ */
+struct JAY_EXPORT paged_field
+{
+  // Reads the depth layers [z_offset, z_offset + z_count) (vectorlike, all of x & y) into dst
+  using slab_reader_fn = std::function<void(std::size_t z_offset, std::size_t z_count, float* dst)>;
+
+  /* =========================================================================*/
+  /*                             Constructors
+  /* =========================================================================*/
+  paged_field(std::string filepath, std::size_t budget_bytes);
+  ~paged_field();
+
+  paged_field(const paged_field&) = delete;
+  paged_field& operator=(const paged_field&) = delete;
+
+  /* =========================================================================*/
+  /*                                Methods
+  /* =========================================================================*/
+  // Writes a bricked file of the grid (x, y, z), reading brick_size + 2 * ghost + 1 depth layers at a time
+  static bool write(slab_reader_fn reader, const glm::uvec3& grid, std::string filepath, unsigned int brick_size = 32, unsigned int ghost = 2);
+  // Timestep t of a field in memory
+  static bool write(const jaySrc<float>& src, std::string filepath, unsigned int brick_size = 32, unsigned int ghost = 2, std::size_t t = 0);
+  // Timestep t of a HDF5 file (read with hyperslabs, see hdf5_io::read_hdf5_slab(..))
+  static bool write_hdf5(std::string h5_filepath, std::vector<std::string> datasets, std::string filepath, unsigned int brick_size = 32, unsigned int ghost = 2, std::size_t t = 0);
+
+  // Blocks until the brick is resident & pins it. The nodes stay valid until the brick is released.
+  const float* acquire(std::size_t brick);
+  void         release(std::size_t brick);
+  bool         resident(std::size_t brick) const;
+
+  // Brick owning the cell of pos (clamped to the grid)
+  std::size_t  brick_of(const glm::vec3& pos) const;
+  // First node of a brick (may be negative)
+  glm::ivec3   brick_origin(std::size_t brick) const;
+  // Any node (zero outside of the grid), pins the owning brick for the lookup
+  glm::vec3    node(int x, int y, int z);
+
+  std::size_t  brick_count()  const;
+  // Bricks fitting into the budget
+  std::size_t  capacity()     const;
+  std::size_t  brick_bytes()  const;
+  paged_stats  get_stats()    const;
+  void         reset_stats();
+
+  glm::ivec3   grid;
+  glm::ivec3   bricks;           // Bricks per axis
+  unsigned int brick_size  = 0;
+  unsigned int ghost       = 0;
+  unsigned int brick_nodes = 0;  // Nodes per axis of a brick (brick_size + 2 * ghost + 1)
+
+protected:
+  struct slot
+  {
+    std::vector<float> data;
+    long long          brick   = -1;
+    unsigned int       pins    = 0;
+    bool               loading = false;
+  };
+
+  std::string               filepath;
+  // Idle file handles, a read takes one (or opens another) and returns it afterwards
+  std::vector<std::unique_ptr<std::ifstream>> files;
+  std::mutex                                  file_mutex;
+
+  std::vector<slot>          slots;
+  std::vector<long long>     slot_of;     // Slot of every brick (-1 if not resident)
+  // Unpinned slots form a doubly linked list from the most (head) to the least (tail) recently used
+  std::vector<long long>     prev;
+  std::vector<long long>     next;
+  long long                  head = -1;
+  long long                  tail = -1;
+
+  paged_stats                stats;
+  mutable std::mutex         m;
+  std::condition_variable    cv;
+
+  void unlink    (long long s);
+  void push_front(long long s);
+  void read      (std::size_t brick, float* dst);
+};
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef JAY_IO_TIMESTEP_SOURCE_HPP
+#define JAY_IO_TIMESTEP_SOURCE_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jay/io/hdf5_io.hpp>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+/* Streams the timesteps of an unsteady field instead of holding the whole 4D data in memory.
+ * A ring of K slots keeps the timesteps [window_begin, window_begin + K) resident.
+ * A background thread reads ahead into free slots while the current timesteps are integrated.
+ * Slices are stored vectorlike (VectorFirst), just like a slice of hdf5_read<float>().
+ */
+struct JAY_EXPORT timestep_source
+{
+  // Reads the timestep t into a buffer of slice_elements() floats
+  using reader_fn = std::function<void(std::size_t t, float* dst)>;
+
+  std::vector<std::size_t> grid;      // x, y, z, t
+  std::size_t              grid_dim;
+  std::size_t              vec_len;
+
+  /* =========================================================================*/
+  /*                             Constructors
+  /* =========================================================================*/
+  // Streams from a HDF5 file, which is opened by the source itself.
+  timestep_source(
+    std::string              filepath,
+    std::vector<std::string> datasets,
+    std::size_t              resident_steps = 3
+  );
+  // Streams from an arbitrary reader. Grid is x, y, z, t.
+  timestep_source(
+    reader_fn                reader,
+    std::vector<std::size_t> grid,
+    std::size_t              grid_dim,
+    std::size_t              vec_len,
+    std::size_t              resident_steps = 3
+  );
+  ~timestep_source();
+
+  timestep_source(const timestep_source&) = delete;
+  timestep_source& operator=(const timestep_source&) = delete;
+
+  /* =========================================================================*/
+  /*                                Methods
+  /* =========================================================================*/
+  // Blocks until timestep t is resident and returns its slice.
+  // The pointer stays valid until t is released. Requesting a timestep before the window restarts the stream.
+  const float* slice(std::size_t t);
+
+  // Timesteps up to (and including) t are not needed anymore; their slots can be refilled.
+  void release(std::size_t t);
+
+  // Restarts the stream at t (e.g. for a new advection).
+  void seek(std::size_t t = 0);
+
+  std::size_t timesteps()      const;
+  std::size_t resident_steps() const;
+  std::size_t slice_elements() const;
+  std::size_t slice_bytes()    const;
+
+  // Accumulated time the background thread spent reading (in ms)
+  double      read_time()      const;
+
+protected:
+  std::unique_ptr<hdf5_io> hdf5_handler;
+  reader_fn                reader;
+
+  std::vector<std::vector<float>> slots;
+  std::vector<long long>          slot_step;   // Timestep held by each slot (-1 if empty or in flight)
+
+  std::size_t window_begin = 0;
+  std::size_t next_load    = 0;
+  std::size_t generation   = 0;
+  double      read_ms      = 0.0;
+  bool        stop         = false;
+
+  mutable std::mutex      m;
+  std::condition_variable cv_load;
+  std::condition_variable cv_ready;
+  std::thread             prefetcher;
+
+  void start(std::size_t resident_steps);
+  void prefetch_loop();
+  void seek_locked(std::size_t t);
+};
+}
+
+#endif
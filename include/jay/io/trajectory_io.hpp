@@ -0,0 +1,117 @@
+#ifndef JAY_IO_TRAJECTORY_IO_HPP
+#define JAY_IO_TRAJECTORY_IO_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <jay/export.hpp>
+
+namespace jay
+{
+/* Compact trajectory format (*.positions / *.velocities).
+ *
+ * [trajectory_header][seed 0]...[seed n-1][index: uint64 file offset of every seed]
+ *
+ * Every seed is stored as [uint32 valid_len][uint32 byte_len][float box_min[3]][float box_max[3]][payload].
+ * The payload holds the xyz components quantized to `bits` inside the box of the seed.
+ * The first sample is stored as is, every further sample as the zigzag/varint encoded residual to a linear prediction.
+ * After valid_len samples the trajectory doesn't change anymore (e.g. the particle left the domain); the tail is not stored.
+ * w is dropped and restored as 1 (positions) or 0 (velocities).
+ */
+enum class trajectory_kind : std::uint8_t
+{
+  Positions  = 0,
+  Velocities = 1
+};
+
+struct trajectory_header
+{
+  char          magic[4];       // "JTRJ"
+  std::uint16_t version;
+  std::uint8_t  kind;
+  std::uint8_t  bits;           // Quantization bits per component
+  std::uint32_t seeds;
+  std::uint32_t steps;
+  std::uint64_t index_offset;   // File offset of the seed index (0 while the file is written)
+};
+
+// Writes trajectories seed by seed. Seeds can be appended in chunks, e.g. while they are read back from the GPU.
+struct JAY_EXPORT trajectory_writer
+{
+  trajectory_writer(
+    std::string     filepath,
+    trajectory_kind kind,
+    std::uint32_t   seeds,
+    std::uint32_t   steps,
+    unsigned int    bits    = 16,
+    unsigned int    threads = 0
+  );
+  ~trajectory_writer();
+
+  bool good() const;
+
+  // Appends seed_count whole seeds (seed_count * steps vec4, seed-major). The seeds are encoded in parallel.
+  bool append(const float* data, std::uint32_t seed_count);
+  // Appends seed_count seeds of lengths[s] vec4, packed one after another (e.g. early terminated traces).
+  // Seeds shorter than steps are read back frozen after their last vertex.
+  bool append(const float* data, const std::uint32_t* lengths, std::uint32_t seed_count);
+
+  // Writes the index and completes the header. Returns the filesize or -1 on failure.
+  long long close();
+
+protected:
+  std::ofstream              file;
+  trajectory_header          hdr;
+  std::vector<std::uint64_t> offsets;
+  unsigned int               threads;
+  bool                       failed = false;
+};
+
+// Decodes trajectories seed by seed, without holding the encoded file in memory.
+struct JAY_EXPORT trajectory_reader
+{
+  trajectory_reader(std::string filepath);
+
+  bool                     good() const;
+  const trajectory_header& header() const;
+
+  // Decodes the next (up to) seed_count seeds as vec4 into dst. Returns the number of decoded seeds.
+  std::uint32_t read(float* dst, std::uint32_t seed_count);
+
+  // Decodes a single seed as vec4 into dst (random access via the index).
+  bool read_seed(std::uint32_t seed, float* dst);
+
+protected:
+  std::ifstream              file;
+  trajectory_header          hdr;
+  std::uint32_t              next_seed = 0;
+  std::vector<std::uint8_t>  payload;
+  bool                       failed = false;
+
+  bool read_chunk(float* dst);
+};
+
+struct JAY_EXPORT trajectory_io
+{
+  // True if the file starts with the trajectory magic (and is not a legacy raw export).
+  static bool is_trajectory_file(std::string filepath);
+
+  // Stores vec4 trajectories (seed-major). Returns the filesize or -1 on failure.
+  static long long store(
+    const float*    data,
+    std::uint32_t   seeds,
+    std::uint32_t   steps,
+    trajectory_kind kind,
+    std::string     filepath,
+    unsigned int    bits    = 16,
+    unsigned int    threads = 0
+  );
+
+  // Loads all trajectories as vec4 (seed-major).
+  static std::vector<float> load(std::string filepath, trajectory_header* hdr = nullptr);
+};
+}
+
+#endif
@@ -16,6 +16,33 @@ struct jaySrc
   jay::Order                 ordering;
 };
 
+// Non-owning counterpart of jaySrc, e.g. for data in shared memory (see dataset_server)
+template <typename T>
+struct jaySrcView
+{
+  const T*                   data     = nullptr;
+  std::vector<std::size_t>   grid;
+  std::size_t                grid_dim = 0;
+  std::size_t                vec_len  = 0;
+  jay::Order                 ordering = jay::Order::None;
+
+  jaySrcView() = default;
+  jaySrcView(const T* data, std::vector<std::size_t> grid, std::size_t grid_dim, std::size_t vec_len, jay::Order ordering)
+    : data     { data }
+    , grid     { grid }
+    , grid_dim { grid_dim }
+    , vec_len  { vec_len }
+    , ordering { ordering }
+  { }
+  jaySrcView(const jaySrc<T>& src)
+    : data     { src.data.data() }
+    , grid     { src.grid }
+    , grid_dim { src.grid_dim }
+    , vec_len  { src.vec_len }
+    , ordering { src.ordering }
+  { }
+};
+
 template <typename T>
 struct jayComp
 {
@@ -1,6 +1,7 @@
 #ifndef JAY_TYPES_REGULAR_GRID_HPP
 #define JAY_TYPES_REGULAR_GRID_HPP
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <vector>
@@ -8,8 +9,6 @@
 #include <boost/multi_array.hpp>
 #include <glm/glm.hpp>
 
-#include <jay/utility/permute_for.hpp>
-
 namespace jay
 {
 template <typename _element_type, std::size_t _dimensions>
@@ -59,30 +58,32 @@ struct regular_grid
   /* Returns a number that is interpolated between the nearest prior node and the explicit successor within the defined grid. */
   // BUT: You can't use interpolate on a position on the outer boundary
   //      Only works for scalarwise arranged data, element_type must not be a vector => a grid per vectorcomponent?
+  //      For vectorlike 3D fields use jay::trilinear_sampler instead.
   element_type  interpolate(const domain_type& position) const
   {
-    domain_type weights    ;
-    index_type  start_index;
-    index_type  end_index  ;
-    index_type  increment  ;
+    using index = typename container_type::index;
+    constexpr std::size_t corners = std::size_t(1) << dimensions;
 
+    domain_type                     weights    ;
+    std::array<index, dimensions>   start_index;
     for (std::size_t i = 0; i < dimensions; ++i)
     {
       weights    [i] = std::fmod ((position[i] - offset[i]) , spacing[i]) / spacing[i];
-      start_index[i] = std::floor((position[i] - offset[i]) / spacing[i]);
-      end_index  [i] = start_index[i] + 2;
-      increment  [i] = 1;
+      start_index[i] = static_cast<index>(std::floor((position[i] - offset[i]) / spacing[i]));
     }
 
-    std::vector<element_type> intermediates;
-    intermediates.reserve(std::pow(2, dimensions));
-    permute_for<index_type>([&] (const index_type& index)
+    // Corner c is offset by bit (dimensions - 1 - i) of c in dimension i
+    std::array<element_type, corners> intermediates;
+    for (std::size_t c = 0; c < corners; ++c)
     {
-      intermediates.push_back(data(*reinterpret_cast<const std::array<std::size_t, 3>*>(&index)));
-    }, start_index, end_index, increment);
+      auto corner = start_index;
+      for (std::size_t i = 0; i < dimensions; ++i)
+        corner[i] += (c >> (dimensions - 1 - i)) & 1;
+      intermediates[c] = data(corner);
+    }
 
-    for (std::int64_t i = dimensions - 1; i >= 0; --i)
-      for (std::size_t j = 0; j < std::pow(2, i); ++j)
+    for (std::size_t i = dimensions; i-- > 0;)
+      for (std::size_t j = 0; j < (std::size_t(1) << i); ++j)
         intermediates[j] = (1.f - weights[i]) * intermediates[2 * j] + weights[i] * intermediates[2 * j + 1];
     return intermediates[0];
   }
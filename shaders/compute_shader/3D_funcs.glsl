@@ -30,7 +30,7 @@ vec4 update_velocity_euler_texture_refined(sampler3D tex0, sampler3D tex1, vec4
   // Right slope
   vec4 r_velo_t0 = texture_velo(tex0, pos + h * l_velo, false);
   vec4 r_velo_t1 = texture_velo(tex1, pos + h * l_velo, true);
-  vec4 r_velo = mix(l_velo_t0, l_velo_t1, curr_time + rel_dt) * vector_factor * cell_factor;
+  vec4 r_velo = mix(r_velo_t0, r_velo_t1, curr_time + rel_dt) * vector_factor * cell_factor;
 
   // Average
   return mix(l_velo, r_velo, 0.5) * one_zero.xxxy;
@@ -132,7 +132,7 @@ vec4 update_velocity_euler_texel_refined(sampler3D tex0, sampler3D tex1, vec4 po
   // Right slope
   vec4 r_velo_t0 = texelfetch_velo(tex0, pos + h * l_velo, false);
   vec4 r_velo_t1 = texelfetch_velo(tex1, pos + h * l_velo, true);
-  vec4 r_velo = mix(l_velo_t0, l_velo_t1, curr_time + rel_dt) * vector_factor * cell_factor;
+  vec4 r_velo = mix(r_velo_t0, r_velo_t1, curr_time + rel_dt) * vector_factor * cell_factor;
 
   // Average
   return mix(l_velo, r_velo, 0.5) * one_zero.xxxy;
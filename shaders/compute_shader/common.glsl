@@ -26,6 +26,16 @@ layout(std430, binding = 3) buffer TestBuffer
   float test[];
 };
 
+layout(std430, binding = 4) buffer TraceLengthBuffer
+{
+  uint trace_lengths[];
+};
+
+layout(std430, binding = 8) readonly buffer SeedOrderBuffer
+{
+  uint seed_order[];
+};
+
 layout(std140, binding = 0) uniform SeedingBuffer
 {
   vec4  seeding_stride;
@@ -46,11 +56,22 @@ layout(std140, binding = 1) uniform IntegrationBuffer
   uint  integration_remainder_stepcount;
   uint  integration_strategy;
   uint  integration_texelfetch;
+  float integration_tolerance;
+  float integration_stepsize_min;
+  float integration_stepsize_max;
+  uint  integration_resample_mode;
+  float integration_resample_spacing;
 };
 
 // Uniforms
 uniform uint global_time;
 uniform int fin;
+uniform int terminate;    // Stop particles leaving the domain instead of writing frozen steps
+uniform int ordered;      // Invocation i traces seed_order[i] (space-filling curve) instead of seed i
+uniform uint resume_step; // > 0: the first steps are already traced, continue from the last of them (steady Euler & RK4)
+uniform uint step_end;    // > 0: stop after this step (progressive advection, steady Euler & RK4)
+uniform uvec3 seed_grid;  // Seeds per axis
+uniform uint seed_base;   // First invocation of the dispatch (progressive advection: chunks of seeds)
 
 // Global Variables
 vec2  one_zero  = vec2(1.0, 0.0);
@@ -67,6 +88,19 @@ bool check_boundaries(vec4 pos)
   return true;
 }
 
+// Index of the seed traced by this invocation (position in the SSBOs)
+uint seed_index()
+{
+  uint invocation = seed_base + gl_GlobalInvocationID.z * gl_NumWorkGroups.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.x;
+  return (ordered == 1) ? seed_order[invocation] : invocation;
+}
+
+// Cell of the seed in the seeding grid (x fastest)
+uvec3 seed_cell(uint seed)
+{
+  return uvec3(seed % seed_grid.x, (seed / seed_grid.x) % seed_grid.y, seed / (seed_grid.x * seed_grid.y));
+}
+
 bool check_depth(float d)
 {
   if (d < 0)
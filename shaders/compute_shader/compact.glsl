@@ -0,0 +1,56 @@
+// Compaction (early terminated traces)
+// ====================================
+// Packs the valid vertices of all seeds one after another (CSR layout: trace_offsets & trace_lengths).
+
+#version 450
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) readonly buffer PositionBuffer
+{
+  vec4 positions[];
+};
+
+layout(std430, binding = 1) readonly buffer VelocityBuffer
+{
+  vec4 velocities[];
+};
+
+layout(std430, binding = 4) readonly buffer TraceLengthBuffer
+{
+  uint trace_lengths[];
+};
+
+layout(std430, binding = 5) readonly buffer TraceOffsetBuffer
+{
+  uint trace_offsets[];
+};
+
+layout(std430, binding = 6) writeonly buffer PackedPositionBuffer
+{
+  vec4 packed_positions[];
+};
+
+layout(std430, binding = 7) writeonly buffer PackedVelocityBuffer
+{
+  vec4 packed_velocities[];
+};
+
+uniform uint seed_count;
+uniform uint step_count;
+
+void main()
+{
+  uint seed = gl_GlobalInvocationID.x;
+  if (seed >= seed_count)
+    return;
+
+  uint src = seed * step_count;
+  uint dst = trace_offsets[seed];
+
+  for (uint i = 0; i < trace_lengths[seed]; i++)
+  {
+    packed_positions[dst + i] = positions[src + i];
+    packed_velocities[dst + i] = velocities[src + i];
+  }
+}
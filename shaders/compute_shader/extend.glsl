@@ -0,0 +1,57 @@
+// Extension (more steps)
+// ======================
+// Copies the traced vertices of all seeds into buffers with room for step_count vertices per seed.
+// The source is either the full layout (trace_offsets[seed] = seed * previous step count) or a compacted one.
+
+#version 450
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) readonly buffer PositionBuffer
+{
+  vec4 positions[];
+};
+
+layout(std430, binding = 1) readonly buffer VelocityBuffer
+{
+  vec4 velocities[];
+};
+
+layout(std430, binding = 4) readonly buffer TraceLengthBuffer
+{
+  uint trace_lengths[];
+};
+
+layout(std430, binding = 5) readonly buffer TraceOffsetBuffer
+{
+  uint trace_offsets[];
+};
+
+layout(std430, binding = 6) writeonly buffer ExtendedPositionBuffer
+{
+  vec4 extended_positions[];
+};
+
+layout(std430, binding = 7) writeonly buffer ExtendedVelocityBuffer
+{
+  vec4 extended_velocities[];
+};
+
+uniform uint seed_count;
+uniform uint step_count;
+
+void main()
+{
+  uint seed = gl_GlobalInvocationID.x;
+  if (seed >= seed_count)
+    return;
+
+  uint src = trace_offsets[seed];
+  uint dst = seed * step_count;
+
+  for (uint i = 0; i < trace_lengths[seed]; i++)
+  {
+    extended_positions[dst + i] = positions[src + i];
+    extended_velocities[dst + i] = velocities[src + i];
+  }
+}
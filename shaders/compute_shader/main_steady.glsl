@@ -8,80 +8,260 @@ vec4 update_position(vec4 pos, vec4 velo, float h)
   return (pos + h * velo);
 }
 
-void advect_euler_texture(vec4 pos, float h, float vector_factor, vec4 rel_cell_size, int id, uint steps)
+uint advect_euler_texture(vec4 pos, vec4 velo, float h, float vector_factor, vec4 rel_cell_size, int id, uint first, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
-  vec4 velo = vec4(0.0, 0.0, 0.0, 0.0);
 
-  for (int i = 0; i < steps; i++)
+  uint i = first;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
       pos  = update_position(pos, velo, h);
       velo = update_velocity_euler_texture_refined(data1, pos, h, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
     positions[id + i] = pos;
     velocities[id + i] = velo;
   }
+
+  return i;
 }
 
-void advect_rk4_texture(vec4 pos, float h, float vector_factor, vec4 rel_cell_size, uint id, uint steps)
+uint advect_rk4_texture(vec4 pos, vec4 velo, float h, float vector_factor, vec4 rel_cell_size, uint id, uint first, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
-  vec4 velo = vec4(0.0, 0.0, 0.0, 0.0);
 
-  for (int i = 0; i < steps; i++)
+  uint i = first;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
       pos  = update_position(pos, velo, h);
       velo = update_velocity_rk4_texture_refined(data1, pos, h, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
     positions[id + i] = pos;
     velocities[id + i] = velo;
   }
+
+  return i;
 }
 
-void advect_euler_texelfetch(vec4 pos, float h, float vector_factor, vec4 rel_cell_size, uint id, uint steps)
+uint advect_euler_texelfetch(vec4 pos, vec4 velo, float h, float vector_factor, vec4 rel_cell_size, uint id, uint first, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
-  vec4 velo = vec4(0.0, 0.0, 0.0, 0.0);
 
-  for (int i = 0; i < integration_local_stepcount; i++)
+  uint i = first;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
       pos  = update_position(pos, velo, h);
       velo = update_velocity_euler_texel_refined(data1, pos, h, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
 
     positions[id + i] = pos;
     velocities[id + i] = velo;
   }
+
+  return i;
 }
 
-void advect_rk4_texelfetch(vec4 pos, float h, float vector_factor, vec4 rel_cell_size, uint id, uint steps)
+uint advect_rk4_texelfetch(vec4 pos, vec4 velo, float h, float vector_factor, vec4 rel_cell_size, uint id, uint first, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
-  vec4 velo = vec4(0.0, 0.0, 0.0, 0.0);
 
-  for (int i = 0; i < integration_local_stepcount; i++)
+  uint i = first;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
       pos  = update_position(pos, velo, h);
       velo = update_velocity_rk4_texel_refined(data1, pos, h, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
 
     positions[id + i] = pos;
     velocities[id + i] = velo;
   }
+
+  return i;
+}
+
+// Adaptive Runge Kutta 4(5) (Dormand-Prince)
+// ==========================================
+#define RK45_MAX_ITERATIONS 16
+
+// Scaled velocity, as used by all strategies
+vec4 steady_velo(vec4 pos, float vector_factor, vec4 cell_factor)
+{
+  vec4 velo = (integration_texelfetch == 0) ? texture_velo(data1, pos, false) : texelfetch_velo(data1, pos, false);
+  return velo * vector_factor * cell_factor * one_zero.xxxy;
+}
+
+// One step of size h from pos with k1 = f(pos).
+// Returns the 5th order position, k7 = f(result) (first same as last) & the error relative to the tolerance.
+vec4 rk45_step(vec4 pos, vec4 k1, float h, float vector_factor, vec4 cell_factor, out vec4 k7, out float err)
+{
+  vec4 k2 = steady_velo(pos + h * (k1 / 5.0), vector_factor, cell_factor);
+  vec4 k3 = steady_velo(pos + h * (3.0/40.0 * k1 + 9.0/40.0 * k2), vector_factor, cell_factor);
+  vec4 k4 = steady_velo(pos + h * (44.0/45.0 * k1 - 56.0/15.0 * k2 + 32.0/9.0 * k3), vector_factor, cell_factor);
+  vec4 k5 = steady_velo(pos + h * (19372.0/6561.0 * k1 - 25360.0/2187.0 * k2 + 64448.0/6561.0 * k3 - 212.0/729.0 * k4), vector_factor, cell_factor);
+  vec4 k6 = steady_velo(pos + h * (9017.0/3168.0 * k1 - 355.0/33.0 * k2 + 46732.0/5247.0 * k3 + 49.0/176.0 * k4 - 5103.0/18656.0 * k5), vector_factor, cell_factor);
+
+  vec4 y5 = pos + h * (35.0/384.0 * k1 + 500.0/1113.0 * k3 + 125.0/192.0 * k4 - 2187.0/6784.0 * k5 + 11.0/84.0 * k6);
+  k7 = steady_velo(y5, vector_factor, cell_factor);
+
+  // Difference to the embedded 4th order solution
+  vec4 e = h * (71.0/57600.0 * k1 - 71.0/16695.0 * k3 + 71.0/1920.0 * k4 - 17253.0/339200.0 * k5 + 22.0/525.0 * k6 - 1.0/40.0 * k7);
+  err = max(max(abs(e.x), abs(e.y)), abs(e.z)) / integration_tolerance;
+
+  return y5;
+}
+
+// Cubic hermite interpolation within a step (s in [0, 1])
+vec4 hermite(vec4 p0, vec4 v0, vec4 p1, vec4 v1, float h, float s)
+{
+  float s2 = s * s;
+  float s3 = s2 * s;
+  return (2*s3 - 3*s2 + 1) * p0 + (s3 - 2*s2 + s) * h * v0 + (-2*s3 + 3*s2) * p1 + (s3 - s2) * h * v1;
+}
+
+// Writes either every accepted step, or samples at fixed time / arc length (resample_mode 0, 1, 2).
+uint advect_rk45(vec4 pos, float vector_factor, vec4 cell_factor, uint id, uint steps)
+{
+  float h       = clamp(integration_stepsize_h, integration_stepsize_min, integration_stepsize_max);
+  float spacing = (integration_resample_spacing > 0) ? integration_resample_spacing : integration_stepsize_h;
+  vec4  velo    = steady_velo(pos, vector_factor, cell_factor);
+  float t       = 0.0;
+  float s       = 0.0;
+
+  positions[id] = pos;
+  velocities[id] = velo;
+
+  uint i = 1;
+  uint iterations = 0;
+  while (i < steps && check_boundaries(pos) && iterations < uint(RK45_MAX_ITERATIONS) * steps)
+  {
+    iterations++;
+
+    vec4  k7;
+    float err;
+    vec4  next   = rk45_step(pos, velo, h, vector_factor, cell_factor, k7, err);
+    float factor = clamp(0.9 * pow(max(err, 1e-10), -0.2), 0.2, 5.0);
+
+    // Rejected
+    if (err > 1.0 && h > integration_stepsize_min)
+    {
+      h = max(h * factor, integration_stepsize_min);
+      continue;
+    }
+
+    float chord = distance(next.xyz, pos.xyz);
+
+    if (integration_resample_mode == 0)
+    {
+      positions[id + i] = next;
+      velocities[id + i] = k7;
+      i++;
+    }
+    else
+    {
+      float from = (integration_resample_mode == 1) ? t : s;
+      float to   = (integration_resample_mode == 1) ? t + h : s + chord;
+
+      while (i < steps && float(i) * spacing <= to)
+      {
+        float theta = (to > from) ? (float(i) * spacing - from) / (to - from) : 1.0;
+        positions[id + i] = hermite(pos, velo, next, k7, h, theta);
+        velocities[id + i] = mix(velo, k7, theta);
+        i++;
+      }
+    }
+
+    t   += h;
+    s   += chord;
+    pos  = next;
+    velo = k7;
+    h    = clamp(h * factor, integration_stepsize_min, integration_stepsize_max);
+  }
+
+  // Frozen (left the domain)
+  if (terminate == 1)
+    return i;
+
+  for (; i < steps; i++)
+  {
+    positions[id + i] = pos;
+    velocities[id + i] = velo;
+  }
+
+  return i;
+}
+
+// Adams-Bashforth-Moulton 4th order (predictor-corrector)
+// ========================================================
+// RK4 (with k1 = f0) for steps without a full history
+vec4 rk4_increment(vec4 pos, vec4 f0, float h, float vector_factor, vec4 cell_factor)
+{
+  vec4 k2 = steady_velo(pos + h * f0 / 2.0, vector_factor, cell_factor);
+  vec4 k3 = steady_velo(pos + h * k2 / 2.0, vector_factor, cell_factor);
+  vec4 k4 = steady_velo(pos + h * k3, vector_factor, cell_factor);
+
+  return (f0 + 2.0 * k2 + 2.0 * k3 + k4) / 6.0;
+}
+
+// Reuses the field velocities of the last 3 positions: 2 samples per step (predict, evaluate, correct, evaluate).
+// The first 3 steps are bootstrapped with RK4.
+uint advect_abm4(vec4 pos, float h, float vector_factor, vec4 cell_factor, uint id, uint steps)
+{
+  vec4 velo = vec4(0.0, 0.0, 0.0, 0.0);
+
+  // f0 = f(pos), f1 = f(previous pos), ..
+  vec4 f0, f1, f2, f3;
+
+  uint i = 0;
+  for (; i < steps; i++)
+  {
+    if (check_boundaries(pos))
+    {
+      pos = update_position(pos, velo, h);
+
+      f3 = f2;
+      f2 = f1;
+      f1 = f0;
+      f0 = steady_velo(pos, vector_factor, cell_factor);
+
+      if (i < 3)
+        velo = rk4_increment(pos, f0, h, vector_factor, cell_factor);
+      else
+      {
+        vec4 predicted = pos + h * (55.0 * f0 - 59.0 * f1 + 37.0 * f2 - 9.0 * f3) / 24.0;
+        vec4 fp = steady_velo(predicted, vector_factor, cell_factor);
+        velo = (9.0 * fp + 19.0 * f0 - 5.0 * f1 + f2) / 24.0;
+      }
+    }
+    else if (terminate == 1)
+      break;
+
+    positions[id + i] = pos;
+    velocities[id + i] = velo;
+  }
+
+  return i;
 }
 
 void main()
 {
   // The ID resembles the position of the individual seed in the SSBO / Array Buffer.
-  int id = int(gl_GlobalInvocationID.z * gl_NumWorkGroups.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.x) * int(integration_global_stepcount);
+  uint seed = seed_index();
+  int id = int(seed) * int(integration_global_stepcount);
 
   tex_size = vec3(textureSize(data1, 0) - ivec3(1, 1, 1));
 
@@ -90,29 +270,59 @@ void main()
 
   // The initial seeds are placed evenly in the vectorfield (or a selection of it).
   uvec3 seeding_offset = uvec3(seeding_range_x.x, seeding_range_y.x, seeding_range_z.x);
-  vec4 pos = vec4(gl_GlobalInvocationID.xyz * seeding_stride.xyz + seeding_offset, 1);
+  vec4 pos = vec4(seed_cell(seed) * seeding_stride.xyz + seeding_offset, 1);
 
   float h = integration_stepsize_h;
   float vector_factor = integration_ds_factor;
   
-  // There are 4 different integration strategies:
+  // There are 6 different integration strategies:
   // 1. Using texture(..) method & improved Euler integration
   // 2. Using texture(..) method & Runge Kutta 4th Order integration
   // 3. Using texelFetch(..) method & improved Euler integration
   // 4. Using texelFetch(..) method & Runge Kutta 4th Order integration
+  // 5. Using either method & adaptive Runge Kutta 4(5) integration
+  // 6. Using either method & Adams-Bashforth-Moulton 4th Order integration
   // - in case of an 2D Texture Array the interpolation in z-dimension will be applied manually
   // - in case of the texelFetch(..) method the interpolation in all directions will be applied manually
 
-  if (integration_texelfetch == 0)
+  // Extension of the last trace (only more steps): continue from its last vertex
+  vec4 velo  = vec4(0.0, 0.0, 0.0, 0.0);
+  uint first = 0;
+  if (resume_step > 0)
+  {
+    // Terminated early, the length stays
+    if (trace_lengths[seed] < resume_step)
+      return;
+
+    first = resume_step;
+    pos   = positions[id + first - 1];
+    velo  = velocities[id + first - 1];
+  }
+
+  // Progressive advection traces the steps in chunks
+  uint last = (step_end > 0) ? min(step_end, integration_local_stepcount) : integration_local_stepcount;
+
+  uint valid_steps;
+
+  if (integration_strategy == 2)
+    valid_steps = advect_rk45(pos, vector_factor, cell_factor, id, integration_local_stepcount);
+
+  else if (integration_strategy == 3)
+    valid_steps = advect_abm4(pos, h, vector_factor, cell_factor, id, integration_local_stepcount);
+
+  else if (integration_texelfetch == 0)
     if (integration_strategy == 0)
-      advect_euler_texture(pos, h, vector_factor, cell_factor, id, integration_local_stepcount);
+      valid_steps = advect_euler_texture(pos, velo, h, vector_factor, cell_factor, id, first, last);
     else
-      advect_rk4_texture(pos, h, vector_factor, cell_factor, id, integration_local_stepcount);
+      valid_steps = advect_rk4_texture(pos, velo, h, vector_factor, cell_factor, id, first, last);
 
   else
 
     if (integration_strategy == 0)
-      advect_euler_texelfetch(pos, h, vector_factor, cell_factor, id, integration_local_stepcount);
+      valid_steps = advect_euler_texelfetch(pos, velo, h, vector_factor, cell_factor, id, first, last);
     else
-      advect_rk4_texelfetch(pos, h, vector_factor, cell_factor, id, integration_local_stepcount);
-}
+      valid_steps = advect_rk4_texelfetch(pos, velo, h, vector_factor, cell_factor, id, first, last);
+
+  // Number of valid vertices (less than the step count if terminated early)
+  trace_lengths[seed] = valid_steps;
+}
\ No newline at end of file
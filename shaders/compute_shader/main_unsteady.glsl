@@ -8,14 +8,15 @@ vec4 update_position(vec4 pos, vec4 velo, float h)
   return (pos + h * velo);
 }
 
-void advect_euler_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
+uint advect_euler_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
 
   // Interpolation factor of the 2 present textures
   float local_time = 0.0;
 
-  for (int i = 0; i < steps; i++)
+  uint i = 0;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
@@ -26,21 +27,26 @@ void advect_euler_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vect
       else
         velo = update_velocity_euler_texture_refined(data1, data2, pos, h, rel_dt, local_time, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
     positions[id + id_offset + i] = pos;
     velocities[id + id_offset + i] = velo;
 
     local_time += rel_dt;
   }
+
+  return i;
 }
 
-void advect_rk4_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
+uint advect_rk4_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
 
   // Interpolation factor of the 2 present textures
   float local_time = 0.0;
 
-  for (int i = 0; i < steps; i++)
+  uint i = 0;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
@@ -51,22 +57,27 @@ void advect_rk4_texture(vec4 pos, vec4 velo, float h, float rel_dt, float vector
       else
         velo = update_velocity_rk4_texture_refined(data1, data2, pos, h, rel_dt, local_time, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
 
     positions[id + id_offset + i] = pos;
     velocities[id + id_offset + i] = velo;
 
     local_time += rel_dt;
   }
+
+  return i;
 }
 
-void advect_euler_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
+uint advect_euler_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
 {  
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
 
   // Interpolation factor of the 2 present textures
   float local_time = 0.0;
 
-  for (int i = 0; i < steps; i++)
+  uint i = 0;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
@@ -77,22 +88,27 @@ void advect_euler_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float v
       else
         velo = update_velocity_euler_texel_refined(data1, data2, pos, h, rel_dt, local_time, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
 
     positions[id + id_offset + i] = pos;
     velocities[id + id_offset + i] = velo;
 
     local_time += rel_dt;
   }
+
+  return i;
 }
 
-void advect_rk4_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
+uint advect_rk4_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float vector_factor, vec4 rel_cell_size, int id, int id_offset, uint steps)
 {
   vec4 cell_factor = vec4(rel_cell_size.xyz, 1);
 
   // Interpolation factor of the 2 present textures
   float local_time = 0.0;
 
-  for (int i = 0; i < steps; i++)
+  uint i = 0;
+  for (; i < steps; i++)
   {
     if (check_boundaries(pos))
     {
@@ -103,21 +119,30 @@ void advect_rk4_texelfetch(vec4 pos, vec4 velo, float h, float rel_dt, float vec
       else
         velo = update_velocity_rk4_texel_refined(data1, data2, pos, h, rel_dt, local_time, vector_factor, cell_factor);
     }
+    else if (terminate == 1)
+      break;
 
     positions[id + id_offset + i] = pos;
     velocities[id + id_offset + i] = velo;
 
     local_time += rel_dt;
   }
+
+  return i;
 }
 
 void main()
 {
   // Initial position of current seed in Buffer
-  int id = int(gl_GlobalInvocationID.z * gl_NumWorkGroups.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.y * gl_NumWorkGroups.x + gl_GlobalInvocationID.x) * int(integration_global_stepcount);
+  uint seed = seed_index();
+  int id = int(seed) * int(integration_global_stepcount);
   // Track of current seeds position in Buffer
   int id_offs = int(global_time * integration_local_stepcount);
 
+  // Terminated in an earlier pass
+  if (terminate == 1 && global_time > 0 && trace_lengths[seed] < uint(id_offs))
+    return;
+
   tex_size = vec3(textureSize(data1, 0) - ivec3(1, 1, 1));
 
   // Velocity Vector factor
@@ -132,7 +157,7 @@ void main()
   if (global_time == 0)
   {
     uvec3 seeding_offset = uvec3(seeding_range_x.x, seeding_range_y.x, seeding_range_z.x);
-    pos   = vec4(gl_GlobalInvocationID.xyz * seeding_stride.xyz + seeding_offset, 1);
+    pos   = vec4(seed_cell(seed) * seeding_stride.xyz + seeding_offset, 1);
     velo  = vec4(0,0,0,0);
   }
 
@@ -150,20 +175,22 @@ void main()
   // - in case of an 2D Texture Array the interpolation in z-dimension will be applied manually
   // - in case of the texelFetch(..) method the interpolation in all directions will be applied manually
 
+  uint valid_steps = 0;
+
   if (fin == 0)
   {
     if (integration_texelfetch == 0)
       if (integration_strategy == 0)
-        advect_euler_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
+        valid_steps = advect_euler_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
       else
-        advect_rk4_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
+        valid_steps = advect_rk4_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
 
     else
 
         if (integration_strategy == 0)
-          advect_euler_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
+          valid_steps = advect_euler_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
         else
-          advect_rk4_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
+          valid_steps = advect_rk4_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_local_stepcount);
   }
   
   // On last advection do the remainder steps
@@ -174,15 +201,18 @@ void main()
 
     if (integration_texelfetch == 0)
         if (integration_strategy == 0)
-          advect_euler_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
+          valid_steps = advect_euler_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
         else
-          advect_rk4_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
+          valid_steps = advect_rk4_texture(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
 
     else
 
         if (integration_strategy == 0)
-          advect_euler_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
+          valid_steps = advect_euler_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
         else
-          advect_rk4_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
+          valid_steps = advect_rk4_texelfetch(pos, velo, h, rel_dt, vector_factor, cell_factor, id, id_offs, integration_remainder_stepcount);
   }
-}
+
+  // Number of valid vertices (less than the step count if terminated early)
+  trace_lengths[seed] = uint(id_offs) + valid_steps;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+// Prefix Sum (compaction offsets)
+// ===============================
+// Exclusive scan of blocks of 256 values in place, the block totals are written to the sums (scan_pass = 0).
+// Once the sums are scanned the same way, they are added to the values of their block (scan_pass = 1).
+
+#version 450
+
+layout (local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 9) buffer ScanBuffer
+{
+  uint values[];
+};
+
+layout(std430, binding = 10) buffer ScanSumBuffer
+{
+  uint sums[];
+};
+
+uniform uint count;
+uniform uint scan_pass;
+
+shared uint block[256];
+
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  uint l = gl_LocalInvocationID.x;
+
+  if (scan_pass == 1)
+  {
+    if (i < count)
+      values[i] += sums[gl_WorkGroupID.x];
+    return;
+  }
+
+  uint value = (i < count) ? values[i] : 0;
+  block[l] = value;
+  barrier();
+
+  // Inclusive scan of the block (Hillis-Steele)
+  for (uint d = 1; d < 256; d <<= 1)
+  {
+    uint add = (l >= d) ? block[l - d] : 0;
+    barrier();
+    block[l] += add;
+    barrier();
+  }
+
+  if (i < count)
+    values[i] = block[l] - value;
+
+  if (l == 255)
+    sums[gl_WorkGroupID.x] = block[255];
+}
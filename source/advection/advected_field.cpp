@@ -5,7 +5,9 @@
 #include <jay/core/menu.hpp>
 #include <jay/core/camera.hpp>
 #include <jay/io/image_io.hpp>
+#include <jay/io/trajectory_io.hpp>
 #include <glbinding/gl/gl.h>
+#include <algorithm>
 
 namespace jay
 {
@@ -13,6 +15,12 @@ namespace jay
     : vao        (globjects::VertexArray::create())
   { }
 
+  advected_field::~advected_field()
+  {
+    if (range_fence)
+      gl::glDeleteSync(range_fence);
+  }
+
   void advected_field::init_configuration(antMenu* menu)
   {
     if (r_conf == nullptr)
@@ -134,26 +142,47 @@ namespace jay
 
   void advected_field::setup_triangle_element_array_buffer()
   {
-    const auto& seeds = r_conf->seed_count;
-    const auto& steps = r_conf->step_count;
-    auto vertices = seeds * steps;
+    const std::size_t seeds = r_conf->seed_count;
+    const std::size_t steps = r_conf->step_count;
+
+    std::vector<gl::GLuint> first(seeds);
+    std::vector<gl::GLuint> count(seeds, static_cast<gl::GLuint>(steps));
+    for (std::size_t s = 0; s < seeds; s++)
+      first[s] = static_cast<gl::GLuint>(s * steps);
 
+    setup_triangle_element_array_buffer(first, count, first, count, static_cast<gl::GLuint>(seeds * steps));
+  }
+
+  void advected_field::setup_triangle_element_array_buffer(const std::vector<gl::GLuint>& first0, const std::vector<gl::GLuint>& count0,
+                                                           const std::vector<gl::GLuint>& first1, const std::vector<gl::GLuint>& count1, gl::GLuint base1)
+  {
     b_indices = globjects::Buffer::create();
     b_indices->bind(gl::GLenum::GL_ELEMENT_ARRAY_BUFFER);
 
-    std::vector<unsigned int> indices((seeds * (steps - 1)) * 6);
-    for (unsigned int s = 0; s < seeds; s++) // seeds
-      for (unsigned int v = 0; v < steps - 1; v++) // vertices per seed
+    const std::size_t seeds = std::min(count0.size(), count1.size());
+
+    std::vector<unsigned int> indices;
+    triangle_first.assign(seeds + 1, 0);
+    for (std::size_t s = 0; s < seeds; s++)
+    {
+      triangle_first[s] = static_cast<gl::GLuint>(indices.size());
+      if (count0[s] == 0 || count1[s] == 0)
+        continue;
+
+      auto vertex0 = [&](gl::GLuint v) { return first0[s] + std::min(v, count0[s] - 1); };
+      auto vertex1 = [&](gl::GLuint v) { return base1 + first1[s] + std::min(v, count1[s] - 1); };
+
+      for (gl::GLuint v = 0; v + 1 < std::max(count0[s], count1[s]); v++)
       {
-        unsigned int index = (s * (steps - 1) + v);
-        unsigned int vertex = (s * steps + v);
-        indices[6U * index + 0U] = vertex;
-        indices[6U * index + 1U] = vertex + vertices + 1;
-        indices[6U * index + 2U] = vertex + vertices;
-        indices[6U * index + 3U] = vertex;
-        indices[6U * index + 4U] = vertex + 1;
-        indices[6U * index + 5U] = vertex + vertices + 1;
+        indices.push_back(vertex0(v));
+        indices.push_back(vertex1(v + 1));
+        indices.push_back(vertex1(v));
+        indices.push_back(vertex0(v));
+        indices.push_back(vertex0(v + 1));
+        indices.push_back(vertex1(v + 1));
       }
+    }
+    triangle_first[seeds] = static_cast<gl::GLuint>(indices.size());
 
     b_indices->setData(indices, gl::GLenum::GL_STATIC_DRAW);
   }
@@ -203,17 +232,20 @@ namespace jay
       return;
     }
 
-    auto positions = get_positions<float>();
-    std::uint32_t seeds = r_conf->seed_count;
+    // Only one export at a time
+    if (pos_export)
+      return;
 
+    std::uint32_t seeds = r_conf->seed_count;
+    std::uint32_t steps = (seeds > 0) ? b_positions->getParameter64(gl::GL_BUFFER_SIZE) / (4 * sizeof(float) * seeds) : 0;
 
-    // Save the seedcount as a header (uint32)
-    auto status = data_io::store_binary((char*) &seeds, sizeof(std::uint32_t), (char*)positions.data(), positions.size() * sizeof(float), filepath, true);
-    
-    if (status == -1)
-      menu->export_pos_status = false;
+    // Read back in chunks & written in the background (see update_exports)
+    fetch_trace_ranges();
+    if (compacted)
+      pos_export = std::make_unique<trajectory_export>(b_positions.get(), trace_lengths, r_conf->step_count, trajectory_kind::Positions, filepath);
     else
-      menu->export_pos_status = true;
+      pos_export = std::make_unique<trajectory_export>(b_positions.get(), seeds, steps, trajectory_kind::Positions, filepath);
+    menu->export_pos_status = true;
   }
 
   void advected_field::export_image(antMenu* menu)
@@ -248,20 +280,52 @@ namespace jay
       return;
     }
 
-    auto velocities = get_velocity<float>();
+    // Only one export at a time
+    if (velo_export)
+      return;
+
     std::uint32_t seeds = r_conf->seed_count;
+    std::uint32_t steps = (seeds > 0) ? b_velocity->getParameter64(gl::GL_BUFFER_SIZE) / (4 * sizeof(float) * seeds) : 0;
 
-    // Save the seedcount as a header (uint32)
-    auto status = data_io::store_binary((char*)&seeds, sizeof(std::uint32_t), (char*)velocities.data(), velocities.size() * sizeof(float), filepath, true);
-    
-    if (status == -1)
-      menu->export_velo_status = false;
+    // Read back in chunks & written in the background (see update_exports)
+    fetch_trace_ranges();
+    if (compacted)
+      velo_export = std::make_unique<trajectory_export>(b_velocity.get(), trace_lengths, r_conf->step_count, trajectory_kind::Velocities, filepath);
     else
-      menu->export_velo_status = true;
+      velo_export = std::make_unique<trajectory_export>(b_velocity.get(), seeds, steps, trajectory_kind::Velocities, filepath);
+    menu->export_velo_status = true;
+  }
+
+  void advected_field::update_exports(antMenu* menu)
+  {
+    if (pos_export && pos_export->update())
+    {
+      menu->export_pos_status = !pos_export->failed();
+      pos_export = nullptr;
+    }
+
+    if (velo_export && velo_export->update())
+    {
+      menu->export_velo_status = !velo_export->failed();
+      velo_export = nullptr;
+    }
+
+    menu->export_progress = 100.0 * ((pos_export) ? pos_export->progress() : 1.0);
+    if (velo_export)
+      menu->export_progress = std::min(menu->export_progress, 100.0 * velo_export->progress());
   }
 
   void advected_field::load_positions(std::string filepath)
   {
+    compacted = false;
+
+    if (trajectory_io::is_trajectory_file(filepath))
+    {
+      b_positions = load_trajectories(filepath);
+      return;
+    }
+
+    // Legacy export: uint32 seedcount + raw vec4
     auto filereader = io();
     auto pos   = filereader.read_vector<float>(filepath);
     auto seeds = *reinterpret_cast<std::uint32_t*>(&pos[0]);
@@ -277,6 +341,15 @@ namespace jay
 
   void advected_field::load_velocities(std::string filepath)
   {
+    compacted = false;
+
+    if (trajectory_io::is_trajectory_file(filepath))
+    {
+      b_velocity = load_trajectories(filepath);
+      return;
+    }
+
+    // Legacy export: uint32 seedcount + raw vec4
     auto filereader = io();
     auto velo  = filereader.read_vector<float>(filepath);
     auto seeds = *reinterpret_cast<std::uint32_t*>(&velo[0]);
@@ -290,6 +363,94 @@ namespace jay
     b_velocity->setData((velo.size() - 1) * sizeof(float), velo.data() + 1, gl::GLenum::GL_STATIC_DRAW);
   }
 
+  std::unique_ptr<globjects::Buffer> advected_field::load_trajectories(std::string filepath)
+  {
+    trajectory_reader reader(filepath);
+    if (!reader.good())
+      return nullptr;
+
+    const auto& hdr   = reader.header();
+    const auto  bytes = 4 * static_cast<std::size_t>(hdr.seeds) * hdr.steps * sizeof(float);
+
+    r_conf->seed_count = hdr.seeds;
+    r_conf->step_count = hdr.steps;
+
+    auto buffer = globjects::Buffer::create();
+    buffer->setData(bytes, nullptr, gl::GLenum::GL_STATIC_DRAW);
+
+    // Decode seed by seed straight into the buffer, the file is never held in memory as a whole
+    auto dst = static_cast<float*>(buffer->mapRange(0, bytes, gl::GL_MAP_WRITE_BIT | gl::GL_MAP_INVALIDATE_BUFFER_BIT));
+    auto decoded = reader.read(dst, hdr.seeds);
+    buffer->unmap();
+
+    if (decoded != hdr.seeds)
+      printf("Error: Could only decode %u of %u seeds.\n", decoded, hdr.seeds);
+
+    return buffer;
+  }
+
+  void advected_field::request_trace_ranges()
+  {
+    const std::size_t seeds = r_conf->seed_count;
+
+    if (range_fence)
+      gl::glDeleteSync(range_fence);
+
+    // Lengths first, offsets after them
+    b_range_readback = globjects::Buffer::create();
+    b_range_readback->setData(std::max<std::size_t>(2 * seeds, 1) * sizeof(gl::GLuint), NULL, gl::GL_STREAM_READ);
+    b_trace_lengths->copySubData(b_range_readback.get(), 0, 0, seeds * sizeof(gl::GLuint));
+    b_trace_offsets->copySubData(b_range_readback.get(), 0, seeds * sizeof(gl::GLuint), seeds * sizeof(gl::GLuint));
+
+    range_fence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::UnusedMask::GL_NONE_BIT);
+    gl::glFlush();
+  }
+
+  void advected_field::fetch_trace_ranges()
+  {
+    if (!range_fence)
+      return;
+
+    // Ranges of an older compaction don't apply to a new advection
+    if (compacted)
+    {
+      while (true)
+      {
+        auto status = gl::glClientWaitSync(range_fence, gl::SyncObjectMask::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        if (status == gl::GL_ALREADY_SIGNALED || status == gl::GL_CONDITION_SATISFIED || status == gl::GL_WAIT_FAILED)
+          break;
+      }
+
+      const std::size_t seeds  = r_conf->seed_count;
+      const auto        ranges = b_range_readback->getSubData<gl::GLuint>(static_cast<gl::GLsizei>(2 * seeds));
+      trace_lengths.assign(ranges.begin(), ranges.begin() + seeds);
+      trace_offsets.assign(ranges.begin() + seeds, ranges.end());
+    }
+
+    gl::glDeleteSync(range_fence);
+    range_fence = nullptr;
+    b_range_readback = nullptr;
+  }
+
+  void advected_field::get_trace_ranges(std::vector<gl::GLuint>& first, std::vector<gl::GLuint>& count)
+  {
+    const std::size_t seeds = r_conf->seed_count;
+    const std::size_t steps = r_conf->step_count;
+
+    fetch_trace_ranges();
+    if (compacted)
+    {
+      first = trace_offsets;
+      count = trace_lengths;
+      return;
+    }
+
+    first.resize(seeds);
+    count.assign(seeds, static_cast<gl::GLuint>(steps));
+    for (std::size_t s = 0; s < seeds; s++)
+      first[s] = static_cast<gl::GLuint>(s * steps);
+  }
+
   void advected_field::update_draw_range()
   {
     draw_steps = r_conf->step_count;
@@ -298,6 +459,14 @@ namespace jay
     vertexFirst.resize(draw_seeds);
     vertexCount.resize(draw_seeds);
 
+    fetch_trace_ranges();
+    if (compacted)
+    {
+      std::copy(trace_offsets.begin(), trace_offsets.end(), vertexFirst.begin());
+      std::copy(trace_lengths.begin(), trace_lengths.end(), vertexCount.begin());
+      return;
+    }
+
     std::uint32_t id = 0;
     for (auto& val : vertexFirst)
     {
@@ -333,6 +502,39 @@ namespace jay
     if (vertexCount.size() != r_conf->seed_count)
       update_draw_range();
 
+    // Only the vertices traced so far (early terminated traces are shorter)
+    if (in_progress)
+    {
+      const bool terminated = (trace_lengths.size() == vertexCount.size());
+      for (std::size_t s = 0; s < vertexCount.size(); s++)
+      {
+        gl::GLsizei traced = (s < ready_seeds) ? next_steps : ready_steps;
+        if (terminated)
+          traced = std::min<gl::GLsizei>(traced, trace_lengths[s]);
+
+        vertexFirst[s] = s * r_conf->step_count;
+        vertexCount[s] = std::min(traced, draw_steps);
+      }
+      return;
+    }
+
+    // Terminated traces are shorter
+    fetch_trace_ranges();
+    if (compacted)
+    {
+      for (std::size_t s = 0; s < vertexCount.size(); s++)
+      {
+        vertexFirst[s] = trace_offsets[s];
+        vertexCount[s] = std::min<gl::GLsizei>(trace_lengths[s], draw_steps);
+      }
+      return;
+    }
+
+    // Back from a compacted layout
+    if (vertexFirst.size() > 1 && vertexFirst[1] != static_cast<gl::GLint>(r_conf->step_count))
+      for (std::size_t s = 0; s < vertexFirst.size(); s++)
+        vertexFirst[s] = s * r_conf->step_count;
+
     if (draw_steps != vertexCount[0])
       std::fill(vertexCount.begin(), vertexCount.end(), draw_steps);
   }
@@ -354,12 +556,16 @@ namespace jay
 
   void advected_field::draw_triangle_elements()
   {
-    const std::uint32_t seeds = r_conf->seed_count;
-    const std::uint32_t steps = r_conf->step_count;
-    const std::uint32_t verts = (steps - 1) * 6;
+    if (triangle_first.size() < 2)
+      return;
+
+    // Seeds have different numbers of quads (terminated traces)
+    const std::size_t seeds = triangle_first.size() - 1;
+    const std::size_t first = std::min<std::size_t>(d_conf->draw_offset, seeds - 1);
+    const std::size_t count = std::min<std::size_t>(d_conf->draw_seeds, seeds - first);
 
-    auto o = std::min(d_conf->draw_offset * verts, seeds * verts - verts);
-    auto s = std::min(d_conf->draw_seeds * verts, seeds * verts - o);
+    const auto o = triangle_first[first];
+    const auto s = triangle_first[first + count] - o;
 
     shader_program->use();
     vao->drawElements(gl::GL_TRIANGLES, s, gl::GL_UNSIGNED_INT, (void*) (o*sizeof(gl::GLuint)));
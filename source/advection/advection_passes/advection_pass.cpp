@@ -2,12 +2,31 @@
 #include <jay/core/menu.hpp>
 #include <jay/advection/vector_field.hpp>
 #include <jay/advection/advected_field.hpp>
+#include <jay/io/timestep_source.hpp>
 #include <iostream>
 
 #include <glbinding/gl/gl.h>
 
 namespace jay
 {
+  namespace
+  {
+    // Dispatches the chunks of a progressive advection fitting into this frame, the result is drawn once it's complete
+    void continue_progressive(vector_field* field, antMenu* menu)
+    {
+      field->compute_program->use();
+
+      if (field->advect_progressive(menu->int_frame_budget))
+      {
+        field->compact();
+        field->update_advection_count();
+        menu->markDirty();
+      }
+
+      menu->int_progress = 100.0f * field->get_progress();
+    }
+  }
+
   // Uncompressed
 advection_pass::advection_pass(std::vector<float>& data, vector_field* field, antMenu* menu, bool prefer_2darray)
   : advection_count(0)
@@ -44,16 +63,44 @@ advection_pass::advection_pass(std::vector<float>& data, vector_field* field, an
     on_update = [&, field, menu]()
     {
       if (!menu->isDirty())
+      {
+        if (field->in_progress())
+          continue_progressive(field, menu);
+        // Caches the trajectories of the last cached advection once they arrived
+        field->fetch_cached_traces();
         return;
+      }
 
       field->update_configuration(menu);
       field->compute_program->use();
 
+      // Only more steps: continue the traces instead of starting over
+      if (field->extendable())
+      {
+        field->update_integration();
+        field->extend_storage_buffers();
+        field->extend();
+        field->compact();
+        field->update_advection_count();
+        return;
+      }
+
       auto t_seed = field->update_seeding();
       auto t_int  = field->update_integration();
       auto t_ssbo = field->update_storage_buffers();
 
-      auto t_advect = field->advect();
+      // Spread over the next frames
+      if (menu->int_progressive)
+      {
+        field->begin_progressive();
+        continue_progressive(field, menu);
+        return;
+      }
+
+      // Seeds traced before are taken from the cache
+      field->set_trace_cache(static_cast<std::size_t>(menu->int_cache_budget) * 1024 * 1024);
+      auto t_advect = field->advect_cached();
+      field->compact();
       field->update_advection_count();
 
       //field->add_timer("UBO Upload",  t_seed + t_int, menu);
@@ -100,6 +147,7 @@ advection_pass::advection_pass(std::vector<float>& data, vector_field* field, an
       auto t_ssbo = field->update_storage_buffers();
 
       auto t_advect = field->unsteady_advect(data);
+      field->compact();
 
       field->update_advection_count();
 
@@ -152,16 +200,44 @@ advection_pass::advection_pass(std::vector<astc_datatype>& data, std::vector<flo
     on_update = [&, field, menu]()
     {
       if (!menu->isDirty())
+      {
+        if (field->in_progress())
+          continue_progressive(field, menu);
+        // Caches the trajectories of the last cached advection once they arrived
+        field->fetch_cached_traces();
         return;
+      }
 
       field->update_configuration(menu);
       field->compute_program->use();
 
+      // Only more steps: continue the traces instead of starting over
+      if (field->extendable())
+      {
+        field->update_integration();
+        field->extend_storage_buffers();
+        field->extend();
+        field->compact();
+        field->update_advection_count();
+        return;
+      }
+
       auto t_seed = field->update_seeding();
       auto t_int  = field->update_integration();
       auto t_ssbo = field->update_storage_buffers();
 
-      auto t_advect = field->advect();
+      // Spread over the next frames
+      if (menu->int_progressive)
+      {
+        field->begin_progressive();
+        continue_progressive(field, menu);
+        return;
+      }
+
+      // Seeds traced before are taken from the cache
+      field->set_trace_cache(static_cast<std::size_t>(menu->int_cache_budget) * 1024 * 1024);
+      auto t_advect = field->advect_cached();
+      field->compact();
 
       field->update_advection_count();
       
@@ -220,6 +296,7 @@ advection_pass::advection_pass(std::vector<astc_datatype>& data, std::vector<flo
       auto t_ssbo = field->update_storage_buffers();
 
       auto t_advect = field->unsteady_advect(data);
+      field->compact();
 
       field->update_advection_count();
 
@@ -236,6 +313,123 @@ advection_pass::advection_pass(std::vector<astc_datatype>& data, std::vector<flo
   }
 }
 
+// Uncompressed, streamed timestep by timestep
+advection_pass::advection_pass(timestep_source& data, vector_field* field, antMenu* menu, bool prefer_2darray)
+  : advection_count(0)
+{
+  // Steady (only the first timestep is used)
+  if (field->output->steady_advection)
+  {
+    on_prepare = [&, field, menu, prefer_2darray]()
+    {
+      menu->int_unsteady = false;
+
+      field->init_configuration(menu, false, prefer_2darray);
+      auto t_cs = field->setup_compute_shader();
+      field->compute_program->use();
+
+      auto t_ssbo = field->setup_storage_buffers();
+      auto t_ubo  = field->setup_uniform_buffers();
+      auto t_tex  = field->setup_textures();
+
+      // slice(..) reports an empty source itself
+      const float* slice = data.slice(0);
+      if (!slice)
+        return;
+
+      auto t_tex_up = field->update_texture(const_cast<float*>(slice), 0);
+
+      field->update_global_time(0U);
+
+      // Field is not yet advected, but all intial invocations will be summed up under index "-1"
+      // The following advection will then be under index "0"
+      field->update_advection_count();
+    };
+    on_update = [&, field, menu]()
+    {
+      if (!menu->isDirty())
+      {
+        if (field->in_progress())
+          continue_progressive(field, menu);
+        // Caches the trajectories of the last cached advection once they arrived
+        field->fetch_cached_traces();
+        return;
+      }
+
+      field->update_configuration(menu);
+      field->compute_program->use();
+
+      // Only more steps: continue the traces instead of starting over
+      if (field->extendable())
+      {
+        field->update_integration();
+        field->extend_storage_buffers();
+        field->extend();
+        field->compact();
+        field->update_advection_count();
+        return;
+      }
+
+      auto t_seed = field->update_seeding();
+      auto t_int  = field->update_integration();
+      auto t_ssbo = field->update_storage_buffers();
+
+      // Spread over the next frames
+      if (menu->int_progressive)
+      {
+        field->begin_progressive();
+        continue_progressive(field, menu);
+        return;
+      }
+
+      // Seeds traced before are taken from the cache
+      field->set_trace_cache(static_cast<std::size_t>(menu->int_cache_budget) * 1024 * 1024);
+      auto t_advect = field->advect_cached();
+      field->compact();
+      field->update_advection_count();
+    };
+  }
+  else
+  {
+    // Unsteady
+    on_prepare = [&, field, menu, prefer_2darray]()
+    {
+      menu->int_unsteady = true;
+
+      field->init_configuration(menu, false, prefer_2darray);
+      auto t_cs = field->setup_compute_shader();
+      field->compute_program->use();
+
+      auto t_ssbo = field->setup_storage_buffers();
+      auto t_ubo  = field->setup_uniform_buffers();
+      auto t_tex  = field->setup_textures();
+
+      field->update_global_time(0);
+
+      // Field is not yet advected, but all intial invocations will be summed up under index "-1"
+      // The following advection will then be under index "0"
+      field->update_advection_count();
+    };
+    on_update = [&, menu, field]()
+    {
+      if (!menu->isDirty())
+        return;
+
+      field->update_configuration(menu);
+      field->compute_program->use();
+
+      auto t_seed = field->update_seeding();
+      auto t_int  = field->update_integration();
+      auto t_ssbo = field->update_storage_buffers();
+
+      auto t_advect = field->unsteady_advect(data);
+      field->compact();
+
+      field->update_advection_count();
+    };
+  }
+}
+
   advection_pass make_advection_pass(std::vector<float>& data, vector_field* field, antMenu* menu, bool prefer_2darray)
   {
     return advection_pass(data, field, menu, prefer_2darray);
@@ -245,4 +439,9 @@ advection_pass::advection_pass(std::vector<astc_datatype>& data, std::vector<flo
   {
     return advection_pass(data, denormalization_data, field, menu);
   };
-}
+
+  advection_pass make_advection_pass(timestep_source& data, vector_field* field, antMenu* menu, bool prefer_2darray)
+  {
+    return advection_pass(data, field, menu, prefer_2darray);
+  };
+}
\ No newline at end of file
@@ -66,7 +66,7 @@ namespace jay
         // Maybe read content of the buffers
         if (false)
         {
-          auto content = field->get_positions<glm::vec4>();
+          auto content = field->get_packed_positions<glm::vec4>();
           auto relative = content[0];
 
           for (auto i = 0; i < content.size(); i++)
@@ -92,6 +92,8 @@ namespace jay
       if (menu->export_velocities())
         field->export_velocities(menu);
 
+      field->update_exports(menu);
+
       if (menu->change_camera_state())
         menu->set_camera_state(camera);
 
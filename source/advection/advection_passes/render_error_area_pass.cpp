@@ -34,11 +34,7 @@ namespace jay
       field0->init_configuration(menu);
       field1->init_configuration(menu);
 
-      const auto& steps = field0->r_conf->step_count;
       const auto& seeds = field0->r_conf->seed_count;
-      auto vertices = seeds * steps; // originally
-      auto bytes = vertices * 4 * sizeof(float); // originally
-      auto triangles = 2 * seeds * (steps - 1);
 
       // Use modified shaders
       field0->r_conf->vs_code = data_io::read_shader_file("../shaders/_tests/render_divergion/vertex_shader.glsl");
@@ -48,14 +44,24 @@ namespace jay
       // Start setting up rendering pipeline
       field0->setup_render_shader();
       field0->shader_program->use();
-      
+
+      // Vertices as stored (compacted traces without their terminated vertices)
+      std::vector<gl::GLuint> first0, count0, first1, count1;
+      field0->get_trace_ranges(first0, count0);
+      field1->get_trace_ranges(first1, count1);
+
       // Get the positional data of the buffers to calculate error area
-      auto p0 = field0->get_positions<float>();
-      auto p1 = field1->get_positions<float>();
-      auto s_area = jay::calculate_seed_area(p0, p1, seeds);
+      auto p0 = field0->get_packed_positions<float>();
+      auto p1 = field1->get_packed_positions<float>();
+      auto s_area = jay::calculate_seed_area(p0, first0, count0, p1, first1, count1);
+
+      const auto vertices0 = static_cast<gl::GLuint>(p0.size() / 4);
+      const auto vertices1 = static_cast<gl::GLuint>(p1.size() / 4);
+      const auto bytes0    = vertices0 * 4 * sizeof(float);
+      const auto bytes1    = vertices1 * 4 * sizeof(float);
       p0.clear();
       p1.clear();
-      
+
       // Merge the content of both position buffers in a single one
       // 1. Move some pointers
       field0->b_utility1 = std::move(field0->b_positions);
@@ -64,14 +70,14 @@ namespace jay
       // 2. Create a buffer with enough memory for the input
       field0->b_positions = globjects::Buffer::create();
       field0->b_positions->bind(gl::GLenum::GL_COPY_WRITE_BUFFER);
-      field0->b_positions->setData(2 * bytes, NULL, gl::GLenum::GL_STATIC_COPY);
+      field0->b_positions->setData(bytes0 + bytes1, NULL, gl::GLenum::GL_STATIC_COPY);
 
       // 3. Copy the content into the new buffer
       field0->b_utility1->bind(gl::GLenum::GL_COPY_READ_BUFFER);
-      field0->b_utility1->copySubData(field0->b_positions.get(), 0, 0, bytes);
+      field0->b_utility1->copySubData(field0->b_positions.get(), 0, 0, bytes0);
       field0->b_utility1->unbind(gl::GLenum::GL_COPY_READ_BUFFER);
       field0->b_utility2->bind(gl::GLenum::GL_COPY_READ_BUFFER);
-      field0->b_utility2->copySubData(field0->b_positions.get(), 0, bytes, bytes);
+      field0->b_utility2->copySubData(field0->b_positions.get(), 0, bytes0, bytes1);
       field0->b_utility2->unbind(gl::GLenum::GL_COPY_READ_BUFFER);
 
       // 4. Delete the old buffers
@@ -83,15 +89,12 @@ namespace jay
       field0->b_utility0->bind(gl::GL_SHADER_STORAGE_BUFFER);
       field0->b_utility0->setData(s_area, gl::GLenum::GL_STATIC_DRAW);
 
-      // Calculate & upload indices into the error area buffer
-      std::vector<unsigned int> area_indices(2 * vertices);
-      for (auto b = 0; b < 2; b++)
+      // Calculate & upload indices into the error area buffer (the seed of each vertex)
+      std::vector<unsigned int> area_indices(vertices0 + vertices1, 0);
+      for (std::size_t s = 0; s < seeds; s++)
       {
-        std::size_t offset = b * vertices;
-        for (auto i = 0; i < vertices; i++)
-        {
-          area_indices[offset + i] = i / steps;
-        }
+        std::fill_n(area_indices.begin() + first0[s],             count0[s], static_cast<unsigned int>(s));
+        std::fill_n(area_indices.begin() + vertices0 + first1[s], count1[s], static_cast<unsigned int>(s));
       }
 
       field0->b_utility1 = globjects::Buffer::create();
@@ -99,7 +102,7 @@ namespace jay
       field0->b_utility1->setData(area_indices, gl::GLenum::GL_STATIC_DRAW);
 
       // Vertex indices
-      field0->setup_triangle_element_array_buffer();
+      field0->setup_triangle_element_array_buffer(first0, count0, first1, count1, vertices0);
 
       // Update external settings
       field0->update_menu(menu);
@@ -0,0 +1,230 @@
+#include <jay/advection/trajectory_export.hpp>
+
+#include <algorithm>
+
+#include <glbinding/gl/gl.h>
+
+namespace jay
+{
+  trajectory_export::trajectory_export(
+    globjects::Buffer* source,
+    std::uint32_t      seeds,
+    std::uint32_t      steps,
+    trajectory_kind    kind,
+    std::string        filepath,
+    std::size_t        chunk_bytes,
+    std::size_t        ring_size
+  ) : trajectory_export(source, seeds, steps, {}, kind, filepath, chunk_bytes, ring_size)
+  {
+  }
+
+  trajectory_export::trajectory_export(
+    globjects::Buffer*         source,
+    std::vector<std::uint32_t> lengths,
+    std::uint32_t              steps,
+    trajectory_kind            kind,
+    std::string                filepath,
+    std::size_t                chunk_bytes,
+    std::size_t                ring_size
+  ) : trajectory_export(source, static_cast<std::uint32_t>(lengths.size()), steps, std::move(lengths), kind, filepath, chunk_bytes, ring_size)
+  {
+  }
+
+  trajectory_export::trajectory_export(
+    globjects::Buffer*         source,
+    std::uint32_t              seeds,
+    std::uint32_t              steps,
+    std::vector<std::uint32_t> lengths,
+    trajectory_kind            kind,
+    std::string                filepath,
+    std::size_t                chunk_bytes,
+    std::size_t                ring_size
+  ) : source  { globjects::Buffer::create() }
+    , seeds   { seeds }
+    , steps   { steps }
+    , lengths { std::move(lengths) }
+    , writer  (filepath, kind, seeds, steps)
+  {
+    // A chunk always holds whole seeds (packed chunks of as many seeds always fit)
+    const std::size_t seed_bytes = 4 * sizeof(float) * static_cast<std::size_t>(std::max(steps, 1U));
+    seeds_per_chunk = static_cast<std::uint32_t>(std::clamp<std::size_t>(chunk_bytes / seed_bytes, 1, std::max(seeds, 1U)));
+
+    std::size_t vertices = static_cast<std::size_t>(seeds) * steps;
+    if (!this->lengths.empty())
+    {
+      vertex_first.resize(this->lengths.size() + 1, 0);
+      for (std::size_t s = 0; s < this->lengths.size(); s++)
+        vertex_first[s + 1] = vertex_first[s] + std::min(this->lengths[s], steps);
+
+      vertices = vertex_first.back();
+    }
+
+    // Snapshot of the source: the copies below only read the snapshot, which the GPU orders after this copy
+    const std::size_t source_bytes = std::max<std::size_t>(vertices * 4 * sizeof(float), 1);
+    this->source->setStorage(source_bytes, nullptr, gl::BufferStorageMask::GL_NONE_BIT);
+    if (vertices > 0)
+      source->copySubData(this->source.get(), 0, 0, vertices * 4 * sizeof(float));
+
+    const auto flags = gl::GL_MAP_READ_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT;
+    const auto bytes = seeds_per_chunk * seed_bytes;
+
+    slots.resize(std::max<std::size_t>(ring_size, 1));
+    for (auto& slot : slots)
+    {
+      slot = std::make_unique<staging_slot>();
+      slot->buffer = globjects::Buffer::create();
+      slot->buffer->setStorage(bytes, nullptr, flags);
+      slot->mapped = static_cast<const float*>(slot->buffer->mapRange(0, bytes, flags));
+    }
+
+    if (!writer.good())
+      error = true;
+
+    writer_thread = std::thread(&trajectory_export::write_loop, this);
+  }
+
+  trajectory_export::~trajectory_export()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      all_issued = true;
+    }
+    cv.notify_all();
+
+    if (writer_thread.joinable())
+      writer_thread.join();
+
+    for (auto& slot : slots)
+    {
+      if (slot->fence)
+        gl::glDeleteSync(slot->fence);
+
+      slot->buffer->unmap();
+    }
+  }
+
+  bool trajectory_export::update()
+  {
+    if (complete || error)
+      return true;
+
+    // Hand finished copies to the writer (fences signal in order)
+    while (!copying.empty())
+    {
+      auto& slot   = *slots[copying.front()];
+      auto  status = gl::glClientWaitSync(slot.fence, gl::SyncObjectMask::GL_NONE_BIT, 0);
+
+      if (status != gl::GL_ALREADY_SIGNALED && status != gl::GL_CONDITION_SATISFIED)
+        break;
+
+      gl::glDeleteSync(slot.fence);
+      slot.fence = nullptr;
+      slot.state = slot_state::Writing;
+
+      {
+        std::lock_guard<std::mutex> lock(m);
+        writing.push_back(copying.front());
+      }
+      cv.notify_one();
+
+      copying.pop_front();
+    }
+
+    // Issue copies into all free slots
+    const std::size_t seed_bytes = 4 * sizeof(float) * static_cast<std::size_t>(steps);
+    for (std::size_t i = 0; i < slots.size() && issued_seeds < seeds; i++)
+    {
+      auto& slot = *slots[i];
+      if (slot.state != slot_state::Free)
+        continue;
+
+      slot.first = issued_seeds;
+      slot.seeds = std::min(seeds_per_chunk, seeds - issued_seeds);
+      slot.state = slot_state::Copying;
+
+      if (lengths.empty())
+        source->copySubData(slot.buffer.get(), issued_seeds * seed_bytes, 0, slot.seeds * seed_bytes);
+      else
+      {
+        const auto first = vertex_first[slot.first];
+        const auto last  = vertex_first[slot.first + slot.seeds];
+        source->copySubData(slot.buffer.get(), first * 4 * sizeof(float), 0, (last - first) * 4 * sizeof(float));
+      }
+      slot.fence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::UnusedMask::GL_NONE_BIT);
+
+      copying.push_back(i);
+      issued_seeds += slot.seeds;
+    }
+
+    // Make sure the copies get submitted, even if nobody swaps
+    gl::glFlush();
+
+    if (issued_seeds == seeds && copying.empty())
+    {
+      std::lock_guard<std::mutex> lock(m);
+      all_issued = true;
+      cv.notify_one();
+    }
+
+    return complete || error;
+  }
+
+  bool trajectory_export::finish()
+  {
+    while (!update())
+      std::this_thread::yield();
+
+    return !error;
+  }
+
+  bool trajectory_export::done() const
+  {
+    return complete || error;
+  }
+
+  bool trajectory_export::failed() const
+  {
+    return error;
+  }
+
+  float trajectory_export::progress() const
+  {
+    return (seeds > 0) ? written_seeds / static_cast<float>(seeds) : 1.0f;
+  }
+
+  void trajectory_export::write_loop()
+  {
+    while (true)
+    {
+      std::size_t index;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return !writing.empty() || all_issued; });
+
+        if (writing.empty())
+          break;
+
+        index = writing.front();
+        writing.pop_front();
+      }
+
+      auto& slot = *slots[index];
+
+      // The mapping is coherent, the fence already guaranteed the copy is visible
+      const bool appended = lengths.empty()
+        ? writer.append(slot.mapped, slot.seeds)
+        : writer.append(slot.mapped, lengths.data() + slot.first, slot.seeds);
+
+      if (!error && !appended)
+        error = true;
+
+      written_seeds += slot.seeds;
+      slot.state     = slot_state::Free;
+    }
+
+    if (writer.close() < 0)
+      error = true;
+
+    complete = true;
+  }
+}
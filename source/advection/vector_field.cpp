@@ -1,8 +1,12 @@
 #include <jay/advection/vector_field.hpp>
 
 #include <jay/io/data_io.hpp>
+#include <jay/io/timestep_source.hpp>
+#include <jay/integration/seed_order.hpp>
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/bitfield.h>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <globjects/base/StringTemplate.h>
 
@@ -11,6 +15,19 @@
 
 namespace jay
 {
+  namespace
+  {
+    // Strategies main_unsteady.glsl can't integrate run as RK4
+    gl::GLuint advection_strategy(std::uint32_t strategy, bool steady)
+    {
+      if (steady || (strategy != StrategyRK45 && strategy != StrategyABM4))
+        return strategy;
+
+      printf("Warning: Strategy %u is not available for unsteady advection, using RK4.\n", strategy);
+      return StrategyRK4;
+    }
+  }
+
   vector_field::vector_field(bool steady_vectorfield)
     : output(std::make_unique<advected_field>())
     , p     (performance())
@@ -80,6 +97,7 @@ namespace jay
     s_conf->range_z = menu->seed_range_z;
 
     s_conf->seeds = menu->seed_directional;
+    s_conf->ordering = menu->seed_ordering;
 
     s_conf->binding = 0;
     s_conf->name = "SeedingBuffer";
@@ -89,7 +107,7 @@ namespace jay
   {
     i_conf = new integration_conf();
 
-    i_conf->strategy = (gl::GLuint) menu->int_strategy_rk4;
+    i_conf->strategy = advection_strategy(menu->int_strategy, output->steady_advection);
     i_conf->texelfetch = (gl::GLuint) menu->int_texelfetch;
 
     i_conf->grid.x = (menu->src_grid_dim >= 1) ? menu->src_grid[0] : 0;
@@ -103,6 +121,11 @@ namespace jay
     i_conf->global_step_count = menu->int_global_step_count;
     i_conf->local_step_count = menu->int_local_step_count;
     i_conf->remainder_step_count = menu->int_remainder_step_count;
+    i_conf->tolerance = menu->int_tolerance;
+    i_conf->step_size_min = menu->int_step_size_min;
+    i_conf->step_size_max = menu->int_step_size_max;
+    i_conf->resample_mode = menu->int_resample_mode;
+    i_conf->resample_spacing = menu->int_resample_spacing;
 
 
     i_conf->binding = 1;
@@ -118,6 +141,15 @@ namespace jay
     c_conf->pos_binding = 0;
     c_conf->vel_binding = 1;
     c_conf->prefer_arraytexture = texture_array;
+
+    c_conf->early_termination = menu->int_early_termination;
+    c_conf->length_binding = 4;
+    c_conf->offset_binding = 5;
+    c_conf->packed_pos_binding = 6;
+    c_conf->packed_vel_binding = 7;
+    c_conf->order_binding = 8;
+    c_conf->scan_binding = 9;
+    c_conf->scan_sum_binding = 10;
   }
 
   void vector_field::update_seeding_conf(antMenu* menu)
@@ -128,11 +160,12 @@ namespace jay
     s_conf->range_z = menu->seed_range_z;
 
     s_conf->seeds = menu->seed_directional;
+    s_conf->ordering = menu->seed_ordering;
   }
 
   void vector_field::update_integration_conf(antMenu* menu)
   {
-    i_conf->strategy = (gl::GLuint) menu->int_strategy_rk4;
+    i_conf->strategy = advection_strategy(menu->int_strategy, output->steady_advection);
     i_conf->texelfetch = (gl::GLuint) menu->int_texelfetch;
 
     i_conf->cell_size = menu->int_cell_size;
@@ -142,6 +175,13 @@ namespace jay
     i_conf->global_step_count = menu->int_global_step_count;
     i_conf->local_step_count = menu->int_local_step_count;
     i_conf->remainder_step_count = menu->int_remainder_step_count;
+    i_conf->tolerance = menu->int_tolerance;
+    i_conf->step_size_min = menu->int_step_size_min;
+    i_conf->step_size_max = menu->int_step_size_max;
+    i_conf->resample_mode = menu->int_resample_mode;
+    i_conf->resample_spacing = menu->int_resample_spacing;
+
+    c_conf->early_termination = menu->int_early_termination;
   }
 
   double vector_field::setup_compute_shader(bool componentwise_normalized, bool measure_time)
@@ -152,6 +192,9 @@ namespace jay
     std::string shader_sampler = "";
     std::string shader_main = "";
 
+    // Other sampling, the cached trajectories don't apply anymore
+    texture_version++;
+
     // At the moment only ASTC compressed data is normalized.
     // TODO: Generalize this.
     bool normalized = c_conf->astc_compressed;
@@ -211,6 +254,29 @@ namespace jay
     compute_program->attach(compute_shader.get());
     compute_program->link();
 
+    // Compaction of early terminated traces
+    compact_shader_source = globjects::Shader::sourceFromString(data_io::read_shader_file(shader_fp + "compact.glsl"));
+    compact_shader = globjects::Shader::create(gl::GL_COMPUTE_SHADER, compact_shader_source.get());
+
+    compact_program = globjects::Program::create();
+    compact_program->attach(compact_shader.get());
+    compact_program->link();
+
+    scan_shader_source = globjects::Shader::sourceFromString(data_io::read_shader_file(shader_fp + "scan.glsl"));
+    scan_shader = globjects::Shader::create(gl::GL_COMPUTE_SHADER, scan_shader_source.get());
+
+    scan_program = globjects::Program::create();
+    scan_program->attach(scan_shader.get());
+    scan_program->link();
+
+    // Extension of steady traces
+    extend_shader_source = globjects::Shader::sourceFromString(data_io::read_shader_file(shader_fp + "extend.glsl"));
+    extend_shader = globjects::Shader::create(gl::GL_COMPUTE_SHADER, extend_shader_source.get());
+
+    extend_program = globjects::Program::create();
+    extend_program->attach(extend_shader.get());
+    extend_program->link();
+
     if (measure_time)
       p.issue_GPU_timestamp("Compute Shader Setup", generation_count);
       //return p.finish_measure_GPU_time(0) / 1000000.0; // ms
@@ -311,6 +377,11 @@ namespace jay
     output->b_velocity->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
     output->b_velocity->setData(vertex_count * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
 
+    output->b_trace_lengths = globjects::Buffer::create();
+    output->b_trace_lengths->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->length_binding);
+    output->b_trace_lengths->setData(seed_count * sizeof(gl::GLuint), NULL, gl::GL_DYNAMIC_DRAW);
+    output->compacted = false;
+
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
       p.issue_GPU_timestamp("SSBO Setup", generation_count);
@@ -332,7 +403,7 @@ namespace jay
     ubo_integration = std::unique_ptr<globjects::UniformBlock>(compute_program->uniformBlock(i_conf->name));
     b_integration = std::unique_ptr<globjects::Buffer>(globjects::Buffer::create());
     b_integration->bindBase(gl::GL_UNIFORM_BUFFER, i_conf->binding);
-    b_integration->setData(sizeof(glm::vec4) + sizeof(glm::uvec4) + 8 * 4, NULL, gl::GL_DYNAMIC_DRAW);
+    b_integration->setData(sizeof(glm::vec4) + sizeof(glm::uvec4) + 13 * 4, NULL, gl::GL_DYNAMIC_DRAW);
 
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
@@ -373,6 +444,7 @@ namespace jay
       p.issue_GPU_timestamp("Peaks SSBO Update", generation_count);
 
     b_denormalization->setData(data, gl::GLenum::GL_STATIC_DRAW);
+    texture_version++;
 
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
@@ -399,6 +471,14 @@ namespace jay
     output->b_velocity->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
     output->b_velocity->setData(vertex_count * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
 
+    output->b_trace_lengths->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->length_binding);
+    output->b_trace_lengths->setData(seed_count * sizeof(gl::GLuint), NULL, gl::GL_DYNAMIC_DRAW);
+    output->compacted = false;
+
+    // A running progressive advection is dropped
+    progressive         = false;
+    output->in_progress = false;
+
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
       p.issue_GPU_timestamp("SSBO Update", generation_count);
@@ -409,6 +489,7 @@ namespace jay
   void vector_field::update_texture(std::unique_ptr<globjects::Texture>& texture, const gl::GLvoid* data, std::size_t offset_byte)
   {
     texture->subImage3D(t_conf->level, glm::ivec3(0, 0, 0), t_conf->size, t_conf->format, t_conf->type, (std::uint8_t*) data + offset_byte);
+    texture_version++;
   }
 
   double vector_field::update_texture(gl::GLvoid* data, std::size_t offset_byte, bool measure_time)
@@ -462,6 +543,7 @@ namespace jay
   void vector_field::update_astc_texture(std::unique_ptr<globjects::Texture>& texture, const gl::GLvoid* data, std::size_t offset_byte)
   {
     texture->compressedImage3D(t_conf->level, t_conf->internal_format, t_conf->size, t_conf->border, t_conf->compressed_byte_size, (std::uint8_t*)(data) + offset_byte);
+    texture_version++;
   }
 
   double vector_field::update_astc_texture(gl::GLvoid* data, std::size_t offset_byte, bool measure_time)
@@ -524,6 +606,16 @@ namespace jay
     b_seeding->setSubData(sizeof(glm::vec4) + sizeof(glm::uvec2), sizeof(glm::vec2), (gl::GLvoid*) & s_conf->range_y);
     b_seeding->setSubData(sizeof(glm::vec4) + 2 * sizeof(glm::uvec2), sizeof(glm::vec2), (gl::GLvoid*) & s_conf->range_z);
 
+    // Invocation i traces seed order[i], the results stay in grid order
+    const bool ordered = (s_conf->ordering != SeedOrderGrid);
+    const auto order   = ordered ? seed_order(*s_conf) : std::vector<std::uint32_t>(1, 0);
+
+    b_seed_order = globjects::Buffer::create();
+    b_seed_order->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->order_binding);
+    b_seed_order->setData(order, gl::GL_STATIC_DRAW);
+    compute_program->setUniform("ordered", ordered ? 1 : 0);
+    compute_program->setUniform("seed_grid", glm::uvec3(s_conf->seeds));
+
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
       p.issue_GPU_timestamp("Seeding Update", generation_count);
@@ -557,6 +649,18 @@ namespace jay
     b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->strategy);
     offset += 4;
     b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->texelfetch);
+    offset += 4;
+    b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->tolerance);
+    offset += 4;
+    b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->step_size_min);
+    offset += 4;
+    b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->step_size_max);
+    offset += 4;
+    b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->resample_mode);
+    offset += 4;
+    b_integration->setSubData(offset, 4, (gl::GLvoid*) & i_conf->resample_spacing);
+
+    compute_program->setUniform("terminate", c_conf->early_termination ? 1 : 0);
 
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
@@ -588,6 +692,7 @@ namespace jay
     gl::glDispatchCompute(s_conf->seeds.x, s_conf->seeds.y, s_conf->seeds.z);
     gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
 
+    remember_trace();
 
     if (measure_time)
       //return p.finish_measure_GPU_time(0) / 1000000.0;
@@ -596,6 +701,516 @@ namespace jay
     return 0.0;
   }
 
+  double vector_field::advect_cached(bool measure_time)
+  {
+    if (!cache || !output->steady_advection)
+      return advect(measure_time);
+
+    if (measure_time)
+      p.issue_GPU_timestamp("Advection", generation_count);
+
+    // Trajectories of earlier calls which already arrived
+    fetch_cached_traces();
+
+    const std::size_t seed_count   = output->r_conf->seed_count;
+    const std::size_t global_steps = i_conf->global_step_count;
+    // Steps after local_step_count are left untouched (as by the shader)
+    const std::size_t steps        = std::min<std::size_t>(i_conf->local_step_count, global_steps);
+    const bool        terminate    = c_conf->early_termination;
+    const auto        seeds        = cpu_tracer::make_seeds(*s_conf);
+
+    trace_cache::key k;
+    k.field  = texture_version;
+    // The GPU samples differently than the CPU tracers, terminated traces end early
+    k.params = trace_cache::params_id(*i_conf, terminate ? 2 : 1);
+
+    // Consecutive cached seeds are uploaded together
+    std::vector<gl::GLuint> lengths(seed_count, 0);
+    std::vector<gl::GLuint> missing;
+    std::vector<glm::vec4>  run_positions;
+    std::vector<glm::vec4>  run_velocities;
+    std::size_t             run_begin = 0;
+
+    auto upload_run = [&](std::size_t run_end)
+    {
+      if (run_end > run_begin)
+      {
+        output->b_positions->setSubData(run_begin * global_steps * sizeof(glm::vec4), run_positions .size() * sizeof(glm::vec4), run_positions .data());
+        output->b_velocity ->setSubData(run_begin * global_steps * sizeof(glm::vec4), run_velocities.size() * sizeof(glm::vec4), run_velocities.data());
+      }
+      run_positions .clear();
+      run_velocities.clear();
+      run_begin = run_end + 1;
+    };
+
+    for (std::size_t s = 0; s < seed_count; s++)
+    {
+      k.seed = glm::vec3(seeds[s]);
+      const auto* e = cache->find(k);
+      if (!e)
+      {
+        upload_run(s);
+        missing.push_back(static_cast<gl::GLuint>(s));
+        continue;
+      }
+
+      lengths[s] = static_cast<gl::GLuint>(e->positions.size());
+      run_positions .insert(run_positions .end(), e->positions .begin(), e->positions .end());
+      run_velocities.insert(run_velocities.end(), e->velocities.begin(), e->velocities.end());
+      run_positions .resize((s + 1 - run_begin) * global_steps, e->positions .empty() ? glm::vec4(0.0f) : e->positions .back());
+      run_velocities.resize((s + 1 - run_begin) * global_steps, e->velocities.empty() ? glm::vec4(0.0f) : e->velocities.back());
+    }
+    upload_run(seed_count);
+
+    // The shader only writes the lengths of the dispatched seeds
+    output->b_trace_lengths->setSubData(0, lengths.size() * sizeof(gl::GLuint), lengths.data());
+
+    traced_seeds = missing.size();
+
+    if (!missing.empty())
+    {
+      // Invocation i traces seed dispatch[i], in the same order as a full advection (see update_seeding(..))
+      std::vector<gl::GLuint> dispatch;
+      if (s_conf->ordering != SeedOrderGrid)
+      {
+        std::vector<char> dispatched(seed_count, 0);
+        for (auto s : missing)
+          dispatched[s] = 1;
+
+        dispatch.reserve(missing.size());
+        for (auto s : seed_order(*s_conf))
+          if (dispatched[s])
+            dispatch.push_back(s);
+      }
+      else
+        dispatch = missing;
+
+      auto b_missing = globjects::Buffer::create();
+      b_missing->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->order_binding);
+      b_missing->setData(dispatch, gl::GL_STATIC_DRAW);
+      compute_program->setUniform("ordered", 1);
+
+      for (std::size_t base = 0; base < dispatch.size(); base += 65535)
+      {
+        compute_program->setUniform("seed_base", static_cast<gl::GLuint>(base));
+        gl::glDispatchCompute(static_cast<gl::GLuint>(std::min<std::size_t>(dispatch.size() - base, 65535)), 1, 1);
+      }
+      gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+
+      compute_program->setUniform("seed_base", 0U);
+      compute_program->setUniform("ordered",   (s_conf->ordering != SeedOrderGrid) ? 1 : 0);
+      b_seed_order->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->order_binding);
+
+      // Only as many trajectories as the budget holds are kept (more would evict each other right away),
+      // copied on the GPU in runs of consecutive seeds & read once the copies are done
+      const std::size_t seed_bytes = 2 * steps * sizeof(glm::vec4);
+      const std::size_t kept       = (seed_bytes == 0) ? 0 : std::min(missing.size(), cache->get_budget() / seed_bytes);
+
+      if (kept > 0)
+      {
+        const std::size_t trace_size = global_steps * sizeof(glm::vec4);
+
+        cache_readback r;
+        r.k            = k;
+        r.steps        = steps;
+        r.global_steps = global_steps;
+        r.b_positions  = globjects::Buffer::create();
+        r.b_positions->setData(static_cast<gl::GLsizeiptr>(kept * trace_size), NULL, gl::GL_STREAM_READ);
+        r.b_velocity   = globjects::Buffer::create();
+        r.b_velocity ->setData(static_cast<gl::GLsizeiptr>(kept * trace_size), NULL, gl::GL_STREAM_READ);
+        if (terminate)
+        {
+          r.b_lengths = globjects::Buffer::create();
+          r.b_lengths->setData(static_cast<gl::GLsizeiptr>(kept * sizeof(gl::GLuint)), NULL, gl::GL_STREAM_READ);
+        }
+
+        for (std::size_t m = 0; m < kept;)
+        {
+          std::size_t end = m + 1;
+          while (end < kept && missing[end] == missing[end - 1] + 1)
+            end++;
+
+          const auto size = static_cast<gl::GLsizeiptr>((end - m) * trace_size);
+          output->b_positions->copySubData(r.b_positions.get(), missing[m] * trace_size, m * trace_size, size);
+          output->b_velocity ->copySubData(r.b_velocity .get(), missing[m] * trace_size, m * trace_size, size);
+          if (terminate)
+            output->b_trace_lengths->copySubData(r.b_lengths.get(), missing[m] * sizeof(gl::GLuint), m * sizeof(gl::GLuint), (end - m) * sizeof(gl::GLuint));
+          m = end;
+        }
+
+        r.seeds.reserve(kept);
+        for (std::size_t i = 0; i < kept; i++)
+          r.seeds.push_back(glm::vec3(seeds[missing[i]]));
+
+        r.fence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::UnusedMask::GL_NONE_BIT);
+        cache_readbacks.push_back(std::move(r));
+      }
+    }
+
+    remember_trace();
+
+    if (measure_time)
+      p.issue_GPU_timestamp("Advection", generation_count);
+
+    return 0.0;
+  }
+
+  bool vector_field::fetch_cached_traces(bool wait)
+  {
+    if (!cache)
+    {
+      release_cache_readbacks();
+      return true;
+    }
+
+    while (!cache_readbacks.empty())
+    {
+      auto& r = cache_readbacks.front();
+
+      if (wait)
+      {
+        while (true)
+        {
+          auto status = gl::glClientWaitSync(r.fence, gl::SyncObjectMask::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+          if (status == gl::GL_ALREADY_SIGNALED || status == gl::GL_CONDITION_SATISFIED || status == gl::GL_WAIT_FAILED)
+            break;
+        }
+      }
+      else if (gl::glClientWaitSync(r.fence, gl::SyncObjectMask::GL_NONE_BIT, 0) == gl::GL_TIMEOUT_EXPIRED)
+        return false;
+
+      const auto count      = static_cast<gl::GLsizei>(r.seeds.size() * r.global_steps);
+      const auto positions  = r.b_positions->getSubData<glm::vec4>(count);
+      const auto velocities = r.b_velocity ->getSubData<glm::vec4>(count);
+      const auto lengths    = r.b_lengths ? r.b_lengths->getSubData<gl::GLuint>(static_cast<gl::GLsizei>(r.seeds.size())) : std::vector<gl::GLuint>();
+
+      auto k = r.k;
+      for (std::size_t i = 0; i < r.seeds.size(); i++)
+      {
+        const std::size_t length = r.b_lengths ? std::min<std::size_t>(lengths[i], r.steps) : r.steps;
+        const std::size_t local  = i * r.global_steps;
+
+        k.seed = r.seeds[i];
+        cache->insert(k, positions.data() + local, velocities.data() + local, length);
+      }
+
+      gl::glDeleteSync(r.fence);
+      cache_readbacks.pop_front();
+    }
+
+    return true;
+  }
+
+  void vector_field::release_cache_readbacks()
+  {
+    for (auto& r : cache_readbacks)
+      gl::glDeleteSync(r.fence);
+    cache_readbacks.clear();
+  }
+
+  void vector_field::set_trace_cache(std::size_t budget_bytes)
+  {
+    if (budget_bytes == 0)
+    {
+      cache = nullptr;
+      release_cache_readbacks();
+    }
+    else if (!cache)
+      cache = std::make_unique<trace_cache>(budget_bytes);
+    else
+      cache->set_budget(budget_bytes);
+  }
+
+  bool vector_field::caching() const
+  {
+    return cache != nullptr;
+  }
+
+  trace_cache* vector_field::get_trace_cache()
+  {
+    return cache.get();
+  }
+
+  std::size_t vector_field::get_traced_seeds() const
+  {
+    return traced_seeds;
+  }
+
+  bool vector_field::extendable() const
+  {
+    if (!traced || !output->steady_advection || output->b_positions == nullptr || output->b_velocity == nullptr)
+      return false;
+
+    // Later steps only depend on the last position & velocity
+    if (i_conf->strategy != StrategyEuler && i_conf->strategy != StrategyRK4)
+      return false;
+
+    if (i_conf->global_step_count <= traced_i_conf.global_step_count || output->r_conf->step_count != traced_i_conf.global_step_count)
+      return false;
+
+    if (c_conf->early_termination != traced_termination)
+      return false;
+
+    const auto& s = traced_s_conf;
+    if (s_conf->stride != s.stride || s_conf->range_x != s.range_x || s_conf->range_y != s.range_y || s_conf->range_z != s.range_z
+     || s_conf->seeds  != s.seeds  || s_conf->ordering != s.ordering)
+      return false;
+
+    const auto& i = traced_i_conf;
+    return i_conf->strategy       == i.strategy       && i_conf->texelfetch == i.texelfetch && i_conf->grid == i.grid
+        && i_conf->cell_size      == i.cell_size      && i_conf->step_size_h == i.step_size_h
+        && i_conf->dataset_factor == i.dataset_factor;
+  }
+
+  double vector_field::extend_storage_buffers(bool measure_time)
+  {
+    if (measure_time)
+      p.issue_GPU_timestamp("SSBO Extension", generation_count);
+
+    const auto seed_count = static_cast<gl::GLuint>(output->r_conf->seed_count);
+    const auto old_steps  = static_cast<gl::GLuint>(output->r_conf->step_count);
+    const auto step_count = i_conf->global_step_count;
+    const auto vertex_count = static_cast<std::size_t>(seed_count) * step_count;
+
+    // Where the traces start in the current buffers (compacted ones have their offsets on the GPU)
+    std::unique_ptr<globjects::Buffer> b_offsets = nullptr;
+    if (output->compacted)
+      output->b_trace_offsets->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->offset_binding);
+    else
+    {
+      std::vector<gl::GLuint> offsets(seed_count);
+      for (std::size_t s = 0; s < seed_count; s++)
+        offsets[s] = static_cast<gl::GLuint>(s * old_steps);
+
+      b_offsets = globjects::Buffer::create();
+      b_offsets->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->offset_binding);
+      b_offsets->setData(offsets, gl::GL_STATIC_DRAW);
+    }
+
+    auto b_extended_positions = globjects::Buffer::create();
+    b_extended_positions->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->packed_pos_binding);
+    b_extended_positions->setData(vertex_count * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
+
+    auto b_extended_velocities = globjects::Buffer::create();
+    b_extended_velocities->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->packed_vel_binding);
+    b_extended_velocities->setData(vertex_count * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
+
+    output->b_positions    ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->pos_binding);
+    output->b_velocity     ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
+    output->b_trace_lengths->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->length_binding);
+
+    extend_program->use();
+    extend_program->setUniform("seed_count", seed_count);
+    extend_program->setUniform("step_count", step_count);
+    gl::glDispatchCompute((seed_count + 63) / 64, 1, 1);
+    gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+    compute_program->use();
+
+    output->b_positions = std::move(b_extended_positions);
+    output->b_velocity  = std::move(b_extended_velocities);
+    output->b_positions->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->pos_binding);
+    output->b_velocity ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
+    output->r_conf->step_count = step_count;
+    output->compacted = false;
+
+    if (measure_time)
+      p.issue_GPU_timestamp("SSBO Extension", generation_count);
+
+    return 0.0;
+  }
+
+  double vector_field::extend(bool measure_time)
+  {
+    if (measure_time)
+      p.issue_GPU_timestamp("Advection", generation_count);
+
+    // Seeds terminated before the last step keep their length
+    compute_program->setUniform("resume_step", traced_i_conf.global_step_count);
+    gl::glDispatchCompute(s_conf->seeds.x, s_conf->seeds.y, s_conf->seeds.z);
+    gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+    compute_program->setUniform("resume_step", 0U);
+
+    remember_trace();
+
+    if (measure_time)
+      p.issue_GPU_timestamp("Advection", generation_count);
+
+    return 0.0;
+  }
+
+  void vector_field::begin_progressive(std::uint32_t step_chunk)
+  {
+    const auto seed_count = output->r_conf->seed_count;
+    const auto step_count = i_conf->local_step_count;
+
+    progressive    = (seed_count > 0 && step_count > 0);
+    progress_seed  = 0;
+    progress_step  = 0;
+    progress_chunk = std::max<std::uint32_t>(step_chunk, 1);
+    ms_per_step    = 0.0;
+
+    // The buffers don't hold the last trace anymore
+    traced = false;
+
+    output->in_progress = progressive;
+    output->ready_seeds = 0;
+    output->ready_steps = 0;
+    output->next_steps  = 0;
+    output->trace_lengths.clear();
+
+    // Timings still in flight belong to the last trace
+    std::fill(interval_work.begin(), interval_work.end(), 0);
+
+    // Terminated traces aren't drawn until their lengths were read back (see advect_progressive(..))
+    if (c_conf->early_termination)
+    {
+      output->trace_lengths.assign(seed_count, 0);
+
+      b_length_readback = globjects::Buffer::create();
+      b_length_readback->setData(seed_count * sizeof(gl::GLuint), NULL, gl::GL_STREAM_READ);
+    }
+    release_length_fence();
+  }
+
+  void vector_field::release_length_fence()
+  {
+    if (length_fence)
+      gl::glDeleteSync(length_fence);
+    length_fence = nullptr;
+  }
+
+  bool vector_field::advect_progressive(double budget_ms)
+  {
+    if (!progressive)
+      return true;
+
+    const std::size_t seed_count = output->r_conf->seed_count;
+    const std::size_t step_count = i_conf->local_step_count;
+    // Only Euler & RK4 continue from the last vertex, the other strategies trace whole trajectories
+    const bool        step_chunks = (i_conf->strategy == StrategyEuler || i_conf->strategy == StrategyRK4);
+
+    auto round_end = [&]()
+    {
+      return step_chunks ? std::min(progress_step + progress_chunk, step_count) : step_count;
+    };
+
+    // Chunks of seeds in grid order, so the traced ones can be drawn
+    compute_program->setUniform("ordered", 0);
+
+    // Timings of earlier frames, the GPU isn't waited for
+    double measured;
+    while (!interval_work.empty() && p.poll_GPU_interval(measured))
+    {
+      const std::size_t timed_work = interval_work.front();
+      interval_work.pop_front();
+      if (timed_work == 0)
+        continue;
+
+      const double sample = std::max(measured, 1e-3) / timed_work;
+      ms_per_step = (ms_per_step > 0.0) ? 0.5 * (ms_per_step + sample) : sample;
+    }
+
+    const bool timed = p.start_GPU_interval();
+
+    double      planned = 0.0;
+    std::size_t work    = 0;
+    do
+    {
+      const std::size_t end   = round_end();
+      const std::size_t steps = end - progress_step;
+
+      // Seeds fitting into the rest of the budget (a small probe as long as there's no estimate)
+      std::size_t seeds = (ms_per_step > 0.0) ? static_cast<std::size_t>(std::max(budget_ms - planned, 0.0) / (ms_per_step * steps)) : 256;
+      seeds = std::min(std::max<std::size_t>(seeds, 64), std::min<std::size_t>(seed_count - progress_seed, 65535));
+
+      compute_program->setUniform("seed_base",   static_cast<gl::GLuint>(progress_seed));
+      compute_program->setUniform("resume_step", static_cast<gl::GLuint>(step_chunks ? progress_step : 0));
+      compute_program->setUniform("step_end",    static_cast<gl::GLuint>(step_chunks ? end : 0));
+      gl::glDispatchCompute(static_cast<gl::GLuint>(seeds), 1, 1);
+      gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+
+      work    += seeds * steps;
+      planned += seeds * steps * ms_per_step;
+
+      progress_seed += seeds;
+      if (progress_seed == seed_count)
+      {
+        progress_seed = 0;
+        progress_step = end;
+      }
+    }
+    while (progress_step < step_count && ms_per_step > 0.0 && planned < budget_ms);
+
+    if (timed)
+    {
+      p.end_GPU_interval();
+      interval_work.push_back(work);
+    }
+
+    compute_program->setUniform("seed_base",   0U);
+    compute_program->setUniform("resume_step", 0U);
+    compute_program->setUniform("step_end",    0U);
+    compute_program->setUniform("ordered",     (s_conf->ordering != SeedOrderGrid) ? 1 : 0);
+
+    // Drawable part of the traces
+    output->ready_seeds = static_cast<std::uint32_t>(progress_seed);
+    output->ready_steps = static_cast<std::uint32_t>(progress_step);
+    output->next_steps  = static_cast<std::uint32_t>(round_end());
+    // Lengths of an earlier frame: copied on the GPU & read once the copy is done (a frame late at most, shorter traces are drawn)
+    if (c_conf->early_termination)
+    {
+      if (length_fence && gl::glClientWaitSync(length_fence, gl::SyncObjectMask::GL_NONE_BIT, 0) != gl::GL_TIMEOUT_EXPIRED)
+      {
+        output->trace_lengths = b_length_readback->getSubData<gl::GLuint>(static_cast<gl::GLsizei>(seed_count));
+        release_length_fence();
+      }
+
+      if (!length_fence)
+      {
+        output->b_trace_lengths->copySubData(b_length_readback.get(), 0, 0, seed_count * sizeof(gl::GLuint));
+        length_fence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::UnusedMask::GL_NONE_BIT);
+      }
+    }
+
+    if (progress_step < step_count)
+      return false;
+
+    // compact(..) reads the final lengths
+    release_length_fence();
+
+    progressive = false;
+    output->in_progress = false;
+    remember_trace();
+
+    return true;
+  }
+
+  bool vector_field::in_progress() const
+  {
+    return progressive;
+  }
+
+  float vector_field::get_progress() const
+  {
+    const std::size_t seed_count = output->r_conf->seed_count;
+    const std::size_t step_count = i_conf->local_step_count;
+    if (!progressive || seed_count == 0 || step_count == 0)
+      return 1.0f;
+
+    const bool        step_chunks = (i_conf->strategy == StrategyEuler || i_conf->strategy == StrategyRK4);
+    const std::size_t round       = step_chunks ? std::min(progress_step + progress_chunk, step_count) - progress_step : step_count;
+
+    return static_cast<float>(progress_step * seed_count + progress_seed * round) / (static_cast<float>(seed_count) * step_count);
+  }
+
+  void vector_field::remember_trace()
+  {
+    traced             = output->steady_advection;
+    traced_termination = c_conf->early_termination;
+    traced_s_conf      = *s_conf;
+    traced_i_conf      = *i_conf;
+  }
+
   double vector_field::unsteady_advect(std::vector<astc_datatype>& data, bool measure_time)
   {
     const auto& grid    = i_conf->grid;
@@ -747,6 +1362,184 @@ namespace jay
 
 
 
+  double vector_field::unsteady_advect(timestep_source& data, bool measure_time)
+  {
+    unsigned int compute_pass = 0;
+
+    auto full_passes = (i_conf->local_step_count > 0) ? std::floor((i_conf->global_step_count - i_conf->remainder_step_count) / i_conf->local_step_count + 0.001) : 0;
+    bool half_pass = i_conf->remainder_step_count;
+
+    // The first n-1 advections
+    for (unsigned int t = 0; t < full_passes; t++)
+    {
+      // Blocks only if the prefetcher has not caught up yet
+      auto slice_t0 = const_cast<float*>(data.slice(compute_pass + 0));
+      auto slice_t1 = const_cast<float*>(data.slice(compute_pass + 1));
+      if (!slice_t0 || !slice_t1)
+      {
+        printf("Error: Timesteps %u & %u are not available, unsteady advection stopped.\n", compute_pass, compute_pass + 1);
+        return 0.0;
+      }
+      update_global_time(compute_pass);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Texture Update " + std::to_string(compute_pass) + ")", generation_count);
+
+      // Current & next timeslice
+      update_texture_t0(slice_t0, 0, false);
+      update_texture_t1(slice_t1, 0, false);
+      tex0_ptr->bindActive(gl::GLenum::GL_TEXTURE0);
+      tex1_ptr->bindActive(gl::GLenum::GL_TEXTURE1);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Texture Update " + std::to_string(compute_pass) + ")", generation_count);
+
+      // The texture upload copied the slice, so its slot can be refilled while the GPU integrates
+      data.release(compute_pass);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Compute " + std::to_string(compute_pass) + ")", generation_count);
+
+      // Trace for #local_step_count
+      advect(false);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Compute " + std::to_string(compute_pass) + ")", generation_count);
+
+      compute_pass++;
+    }
+
+    if (half_pass)
+    {
+      auto slice = const_cast<float*>(data.slice(compute_pass));
+      if (!slice)
+      {
+        printf("Error: Timestep %u is not available, unsteady advection stopped.\n", compute_pass);
+        return 0.0;
+      }
+      update_global_time(compute_pass, true);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Texture Update " + std::to_string(compute_pass) + ")", generation_count);
+
+      // Last timeslice
+      update_texture_t0(slice, 0, false);
+      tex0_ptr->bindActive(gl::GLenum::GL_TEXTURE0);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Texture Update " + std::to_string(compute_pass) + ")", generation_count);
+
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Compute " + std::to_string(compute_pass) + ")", generation_count);
+
+      // Trace for #local_step_count
+      advect(false);
+
+      // Grab Timer
+      if (measure_time)
+        p.issue_GPU_timestamp("Unsteady Avection (Compute " + std::to_string(compute_pass) + ")", generation_count);
+
+      compute_pass++;
+    }
+
+    // Have the beginning of the field ready for the next advection
+    data.seek(0);
+
+    return 0.0;
+  }
+
+  double vector_field::compact(bool measure_time)
+  {
+    if (!c_conf->early_termination)
+      return 0.0;
+
+    if (measure_time)
+      p.issue_GPU_timestamp("Compaction", generation_count);
+
+    const auto seed_count = static_cast<gl::GLuint>(output->r_conf->seed_count);
+    const auto step_count = static_cast<gl::GLuint>(output->r_conf->step_count);
+    const gl::GLuint zero = 0;
+
+    // Offsets are the exclusive prefix sum of the lengths, the extra last one is the vertex count
+    output->b_trace_offsets = globjects::Buffer::create();
+    output->b_trace_offsets->setData((seed_count + 1) * sizeof(gl::GLuint), NULL, gl::GL_DYNAMIC_COPY);
+    output->b_trace_lengths->copySubData(output->b_trace_offsets.get(), 0, 0, seed_count * sizeof(gl::GLuint));
+    output->b_trace_offsets->setSubData(seed_count * sizeof(gl::GLuint), sizeof(gl::GLuint), &zero);
+    gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+    prefix_sum(output->b_trace_offsets.get(), seed_count + 1);
+    gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+
+    // 4 byte are read back to size the packed buffers
+    const std::size_t vertex_count = output->b_trace_offsets->getSubData<gl::GLuint>(1, seed_count * sizeof(gl::GLuint))[0];
+
+    output->b_trace_offsets->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->offset_binding);
+    output->b_trace_lengths->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->length_binding);
+    output->b_positions    ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->pos_binding);
+    output->b_velocity     ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
+
+    auto b_packed_positions = globjects::Buffer::create();
+    b_packed_positions->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->packed_pos_binding);
+    b_packed_positions->setData(std::max<std::size_t>(vertex_count, 1) * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
+
+    auto b_packed_velocities = globjects::Buffer::create();
+    b_packed_velocities->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->packed_vel_binding);
+    b_packed_velocities->setData(std::max<std::size_t>(vertex_count, 1) * sizeof(glm::vec4), NULL, gl::GL_DYNAMIC_DRAW);
+
+    compact_program->use();
+    compact_program->setUniform("seed_count", seed_count);
+    compact_program->setUniform("step_count", step_count);
+    gl::glDispatchCompute((seed_count + 63) / 64, 1, 1);
+    gl::glMemoryBarrier(gl::GL_ALL_BARRIER_BITS);
+    compute_program->use();
+
+    // The packed buffers replace the full ones, which are released right away (update_storage_buffers(..) allocates them
+    // again for the next advection)
+    output->b_positions = std::move(b_packed_positions);
+    output->b_velocity  = std::move(b_packed_velocities);
+    output->b_positions->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->pos_binding);
+    output->b_velocity ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->vel_binding);
+    output->compacted = true;
+
+    // The CPU gets the ranges of the seeds (for drawing & exports) once the GPU is done with them
+    output->request_trace_ranges();
+
+    if (measure_time)
+      p.issue_GPU_timestamp("Compaction", generation_count);
+
+    return 0.0;
+  }
+
+  void vector_field::prefix_sum(globjects::Buffer* values, gl::GLuint count)
+  {
+    const gl::GLuint blocks = (count + 255) / 256;
+
+    auto sums = globjects::Buffer::create();
+    sums->setData(std::max<gl::GLuint>(blocks, 1) * sizeof(gl::GLuint), NULL, gl::GL_DYNAMIC_COPY);
+
+    values->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->scan_binding);
+    sums  ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->scan_sum_binding);
+    scan_program->use();
+    scan_program->setUniform("count", count);
+    scan_program->setUniform("scan_pass", 0U);
+    gl::glDispatchCompute(blocks, 1, 1);
+    gl::glMemoryBarrier(gl::GL_SHADER_STORAGE_BARRIER_BIT);
+
+    if (blocks > 1)
+    {
+      prefix_sum(sums.get(), blocks);
+
+      values->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->scan_binding);
+      sums  ->bindBase(gl::GL_SHADER_STORAGE_BUFFER, c_conf->scan_sum_binding);
+      scan_program->use();
+      scan_program->setUniform("count", count);
+      scan_program->setUniform("scan_pass", 1U);
+      gl::glDispatchCompute(blocks, 1, 1);
+      gl::glMemoryBarrier(gl::GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    compute_program->use();
+  }
+
   advected_field* vector_field::get_result()
   {
     return output.get();
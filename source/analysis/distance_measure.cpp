@@ -219,6 +219,41 @@ namespace jay
     return seed_areas;
   }
 
+  std::vector<double> calculate_seed_area(const std::vector<float>& b_pos0, const std::vector<unsigned int>& first0, const std::vector<unsigned int>& count0,
+                                          const std::vector<float>& b_pos1, const std::vector<unsigned int>& first1, const std::vector<unsigned int>& count1)
+  {
+    const std::size_t seeds = std::min(count0.size(), count1.size());
+    std::vector<double> seed_areas(seeds, 0.0);
+
+    for (std::size_t s = 0; s < seeds; s++)
+    {
+      if (count0[s] == 0 || count1[s] == 0)
+        continue;
+
+      auto vertex = [](const std::vector<float>& b_pos, std::size_t first, std::size_t count, std::size_t i)
+      {
+        return (glm::dvec4) *reinterpret_cast<const glm::vec4*>(&b_pos[4 * (first + std::min(i, count - 1))]);
+      };
+
+      // Quads past both ends are degenerate
+      const std::size_t quads = std::max(count0[s], count1[s]) - 1;
+      for (std::size_t q = 0; q < quads; q++)
+      {
+        glm::dvec4 v0 = vertex(b_pos0, first0[s], count0[s], q);
+        glm::dvec4 v1 = vertex(b_pos1, first1[s], count1[s], q);
+        glm::dvec4 v2 = vertex(b_pos0, first0[s], count0[s], q + 1);
+        glm::dvec4 v3 = vertex(b_pos1, first1[s], count1[s], q + 1);
+
+        glm::dvec3 V0V3 = glm::dvec3(v3 - v0);
+        glm::dvec3 V2V1 = glm::dvec3(v1 - v2);
+
+        seed_areas[s] += 0.5 * glm::length(glm::cross(V0V3, V2V1));
+      }
+    }
+
+    return seed_areas;
+  }
+
   std::size_t get_strided_element_count(std::size_t elements, long int stride, std::size_t offset)
   {
     return floor((elements - 1 - offset + stride) / stride);
@@ -162,4 +162,48 @@ namespace jay
     return gpu_timers.size() > 0;
   }
 
+  bool performance::start_GPU_interval()
+  {
+    if (interval_queries[0] == 0)
+      gl::glGenQueries(8, interval_queries);
+
+    if (interval_count == 4)
+      return false;
+
+    const auto slot = (interval_first + interval_count) % 4;
+    gl::glQueryCounter(interval_queries[2 * slot], gl::GL_TIMESTAMP);
+    return true;
+  }
+
+  void performance::end_GPU_interval()
+  {
+    const auto slot = (interval_first + interval_count) % 4;
+    gl::glQueryCounter(interval_queries[2 * slot + 1], gl::GL_TIMESTAMP);
+    interval_count++;
+  }
+
+  bool performance::poll_GPU_interval(double& ms)
+  {
+    if (interval_count == 0)
+      return false;
+
+    // Timestamps arrive in order, the end implies the start
+    const auto slot = interval_first;
+    auto available  = 0;
+    gl::glGetQueryObjectiv(interval_queries[2 * slot + 1], gl::GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      return false;
+
+    std::uint64_t t0;
+    std::uint64_t t1;
+    gl::glGetQueryObjectui64v(interval_queries[2 * slot],     gl::GL_QUERY_RESULT, &t0);
+    gl::glGetQueryObjectui64v(interval_queries[2 * slot + 1], gl::GL_QUERY_RESULT, &t1);
+
+    interval_first = (interval_first + 1) % 4;
+    interval_count--;
+
+    ms = (t1 > t0) ? (t1 - t0) / 1000000.0 : 0.0;
+    return true;
+  }
+
 }
\ No newline at end of file
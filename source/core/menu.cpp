@@ -2,6 +2,7 @@
 #include <jay/io/data_io.hpp>
 #include <jay/core/camera.hpp>
 #include <chrono>
+#include <cstdio>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -130,14 +131,15 @@ namespace jay
   void TW_CALL setIntegrationTechniqueCB(const void* value, void* clientData)
   {
     antMenu* menu = static_cast<antMenu*>(clientData);
-    menu->int_strategy_rk4 = *static_cast<const bool*>(value);
+    menu->int_strategy = *static_cast<const std::uint32_t*>(value);
+    menu->displayIntegrationParams();
   }
 
   void TW_CALL getIntegrationTechniqueCB(void* value, void* clientData)
   {
     antMenu* menu = static_cast<antMenu*>(clientData);
 
-    *static_cast<bool*>(value) = menu->int_strategy_rk4;
+    *static_cast<std::uint32_t*>(value) = menu->int_strategy;
   }
 
   void TW_CALL setIntegrationTypeCB(const void* value, void* clientData)
@@ -601,6 +603,7 @@ namespace jay
     seed_range_z = { 0, 0 };
     seed_directional = { 0, 0, 0 };
     seed_count = 0;
+    seed_ordering = 0;
     seed_directional_string = "";
     seed_stride_string = "";
 
@@ -627,6 +630,12 @@ namespace jay
     TwAddVarCB(mainBar, "Seeds",          TW_TYPE_STDSTRING, NULL, getSPDStrCB,    this, "group='Seeding Parameters'");
     TwAddVarCB(mainBar, "Seeds in Total", TW_TYPE_UINT32,    NULL, getSeedsCB,     this, "group='Seeding Parameters'");
 
+    // Enums
+    TwEnumVal orderings[] = { { 0, "Grid (x fastest)" }, { 1, "Morton Curve" }, { 2, "Hilbert Curve" } };
+    TwType    ordering_type = TwDefineEnum("SeedOrdering", orderings, 3);
+
+    TwAddVarRW(mainBar, "Seed Order",     ordering_type,     &seed_ordering,                          "group='Seeding Parameters'");
+
     display_seed_params();
 
     TwDefine((mainBarName + "/'Seeding Parameters' opened=false visible='false'").data());
@@ -639,7 +648,7 @@ namespace jay
     std::string mainBarName = TwGetBarName(mainBar);
 
     // Variable Initialization
-    int_strategy_rk4 = false;
+    int_strategy = 0;
     int_unsteady = !src_steady;
     int_simulation_range = { 0.0, 0.0, 0.0, 0.0 };
     int_global_step_count = 500;
@@ -650,7 +659,17 @@ namespace jay
     int_step_size_dt = int_step_size_h;
     int_iteration_count = 0;
     int_texelfetch = 0;
+    int_early_termination = false;
+    int_progressive = false;
+    int_frame_budget = 8.0;
+    int_progress = 100.0;
+    int_cache_budget = 0;
     int_dataset_factor = 1.0;
+    int_tolerance = 1e-3;
+    int_step_size_min = 1e-3;
+    int_step_size_max = 1.0;
+    int_resample_mode = 1;
+    int_resample_spacing = 0.0;
     generated_seed_vertices = 0;
     int_vram = 0;
 
@@ -659,9 +678,15 @@ namespace jay
     calcExportSize();
 
 
+    // Enums
+    TwEnumVal strategies[] = { { 0, "Improved Euler" }, { 1, "Runge Kutta 4th" }, { 2, "Runge Kutta 45 (adaptive)" }, { 3, "Adams-Bashforth-Moulton 4th" } };
+    TwType    strategy_type = TwDefineEnum("IntegrationStrategy", strategies, 4);
+    TwEnumVal resampling[] = { { 0, "Accepted Steps" }, { 1, "Fixed Time" }, { 2, "Fixed Arc Length" } };
+    TwType    resample_type = TwDefineEnum("ResampleMode", resampling, 3);
+
     // AntTweakBar Variables
     TwAddVarRW(mainBar, "Texture Access",        TW_TYPE_BOOLCPP, &int_texelfetch,                                     "group='Integration Parameters' true='texelFetch' false='texture'");
-    TwAddVarCB(mainBar, "Integration Algorithm", TW_TYPE_BOOLCPP, setIntegrationTechniqueCB, getIntegrationTechniqueCB, this, "group='Integration Parameters' true='Runge Kutta 4th' false='Improved Euler'");
+    TwAddVarCB(mainBar, "Integration Algorithm", strategy_type,   setIntegrationTechniqueCB, getIntegrationTechniqueCB, this, "group='Integration Parameters'");
     TwAddVarCB(mainBar, "Integration Mode",      TW_TYPE_BOOLCPP, setIntegrationTypeCB, getIntegrationTypeCB,           this, "group='Integration Parameters' true='Unsteady' false='Steady'");
 
     //TwAddVarRW(mainBar, "Steps",            TW_TYPE_UINT32, &integrationStepCount,                                 "group='Integration Parameters'");
@@ -676,6 +701,16 @@ namespace jay
     TwAddVarRW(mainBar, "Step Size h",       TW_TYPE_FLOAT,  &int_step_size_h,                                      "group='Integration Parameters' min=0.0 step=0.0001");
     TwAddVarRW(mainBar, "Step Size dt",      TW_TYPE_FLOAT,  &int_step_size_dt,                                     "group='Integration Parameters'");
     TwAddVarRW(mainBar, "Dataset Factor",    TW_TYPE_FLOAT,  &int_dataset_factor,                                   "group='Integration Parameters'");
+    TwAddVarRW(mainBar, "Tolerance",         TW_TYPE_FLOAT,  &int_tolerance,                                        "group='Integration Parameters' min=0.0 step=0.0001");
+    TwAddVarRW(mainBar, "Step Size h (min)", TW_TYPE_FLOAT,  &int_step_size_min,                                    "group='Integration Parameters' min=0.0 step=0.0001");
+    TwAddVarRW(mainBar, "Step Size h (max)", TW_TYPE_FLOAT,  &int_step_size_max,                                    "group='Integration Parameters' min=0.0 step=0.01");
+    TwAddVarRW(mainBar, "Resampling",        resample_type,  &int_resample_mode,                                    "group='Integration Parameters'");
+    TwAddVarRW(mainBar, "Resample Spacing",  TW_TYPE_FLOAT,  &int_resample_spacing,                                 "group='Integration Parameters' min=0.0 step=0.01");
+    TwAddVarRW(mainBar, "Early Termination", TW_TYPE_BOOLCPP, &int_early_termination,                              "group='Integration Parameters' true='Stop at Boundary' false='Freeze at Boundary'");
+    TwAddVarRW(mainBar, "Progressive",       TW_TYPE_BOOLCPP, &int_progressive,                                    "group='Integration Parameters' true='Over Frames' false='At Once'");
+    TwAddVarRW(mainBar, "Frame Budget (ms)", TW_TYPE_FLOAT,  &int_frame_budget,                                     "group='Integration Parameters' min=0.5 step=0.5");
+    TwAddVarRO(mainBar, "Progress (%)",      TW_TYPE_FLOAT,  &int_progress,                                         "group='Integration Parameters'");
+    TwAddVarRW(mainBar, "Trace Cache (MB)",  TW_TYPE_UINT32, &int_cache_budget,                                     "group='Integration Parameters' min=0 step=64");
 
     TwAddVarRW(mainBar, "Simulation Range in X", TW_TYPE_FLOAT, &int_simulation_range.x, "group='Integration Parameters' min=0.0 step=0.01");
     TwAddVarRW(mainBar, "Simulation Range in Y", TW_TYPE_FLOAT, &int_simulation_range.y, "group='Integration Parameters' min=0.0 step=0.01");
@@ -817,6 +852,7 @@ namespace jay
     export_velo_status = true;
     export_pos_status = true;
     export_img_status = true;
+    export_progress = 100.0;
 
     TwAddVarRW(mainBar, "Positions Size (MB)",         TW_TYPE_DOUBLE,    &export_pos_size,    "group='Export'");
     TwAddVarRW(mainBar, "Export Positions Name",       TW_TYPE_STDSTRING, &export_pos_name_string, "group='Export'");
@@ -826,6 +862,7 @@ namespace jay
     TwAddVarRW(mainBar, "Export Velocities Name", TW_TYPE_STDSTRING, &export_velo_name_string, "group='Export'");
     TwAddButton(mainBar, "Export Velocities", buttonExportVelosCB, this, "group='Export'");
     TwAddVarRO(mainBar, "Velo Export Status", TW_TYPE_BOOLCPP, &export_velo_status, "group='Export' true='OK' false='ERROR' label='Export Status'");
+    TwAddVarRO(mainBar, "Export Progress (%)", TW_TYPE_DOUBLE, &export_progress, "group='Export' precision=1");
     TwAddButton(mainBar, "Export Image", button_export_image_CB, this, "group='Export'");
     TwAddVarRO(mainBar, "Image Export Status", TW_TYPE_BOOLCPP, &export_velo_status, "group='Export' true='OK' false='ERROR' label='Export Status'");
 
@@ -1209,6 +1246,21 @@ namespace jay
       TwDefine((mainBarName + "/'Cell Size in T' visible='false'").data());
       TwDefine((mainBarName + "/'Simulation Range in T' visible='false'").data());
     }
+
+    // main_unsteady.glsl has no adaptive step size nor multistep history, the strategy (and its label in timers & exports) falls back to RK4
+    if (int_unsteady && int_strategy >= 2)
+    {
+      printf("Warning: %s is not available for unsteady fields, using Runge Kutta 4th.\n", (int_strategy == 2) ? "Runge Kutta 45" : "Adams-Bashforth-Moulton 4th");
+      int_strategy = 1;
+    }
+
+    // Adaptive step size (steady only)
+    const std::string adaptive = (int_strategy == 2 && !int_unsteady) ? "true" : "false";
+    TwDefine((mainBarName + "/'Tolerance' visible='" + adaptive + "'").data());
+    TwDefine((mainBarName + "/'Step Size h (min)' visible='" + adaptive + "'").data());
+    TwDefine((mainBarName + "/'Step Size h (max)' visible='" + adaptive + "'").data());
+    TwDefine((mainBarName + "/'Resampling' visible='" + adaptive + "'").data());
+    TwDefine((mainBarName + "/'Resample Spacing' visible='" + adaptive + "'").data());
   }
 
   bool antMenu::change_camera_state()
@@ -0,0 +1,362 @@
+#include <jay/integration/astc_sampler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <astcenc_mathlib.h>
+
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/schemes.hpp>
+#include <jay/integration/seed_order.hpp>
+
+namespace jay
+{
+  astc_field::astc_field(const jayComp<astc_datatype>& comp, const std::vector<float>& peaks, const std::vector<std::size_t>& grid, std::size_t t, bool per_component, colorspace color, astcenc_profile profile)
+    : comp     { &comp }
+    , grid     { static_cast<int>(grid[0]), static_cast<int>((grid.size() >= 2) ? grid[1] : 1), static_cast<int>((grid.size() >= 3) ? grid[2] : 1) }
+    , block    { static_cast<int>(comp.block_x), static_cast<int>(comp.block_y), static_cast<int>(std::max<std::size_t>(comp.block_z, 1)) }
+    , volume   { comp.dim_z > 1 }
+    , channels { (color == colorspace::Unknown || int(color) > 4) ? 4 : int(color) }
+    , config   { }
+  {
+    blocks = glm::ivec3((static_cast<int>(comp.dim_x) + block.x - 1) / block.x,
+                        (static_cast<int>(comp.dim_y) + block.y - 1) / block.y,
+                        (static_cast<int>(comp.dim_z) + block.z - 1) / block.z);
+    blocks_per_image = static_cast<std::size_t>(blocks.x) * blocks.y * blocks.z;
+    first_image      = volume ? t : t * this->grid.z;
+
+    if ((blocks_per_image << 4) != comp.img_len)
+      printf("Error: ASTC images of %zu bytes don't match %zu blocks of %dx%dx%d texels.\n", comp.img_len, blocks_per_image, block.x, block.y, block.z);
+
+    // Same as denormalize_float(..) / denormalize_per_component(..), without peaks the data is taken as it is
+    scale .assign(this->grid.z, glm::vec3(1.0f));
+    offset.assign(this->grid.z, glm::vec3(0.0f));
+    for (int z = 0; z < this->grid.z && !peaks.empty(); z++)
+      for (int c = 0; c < 3; c++)
+      {
+        const std::size_t layer = t * this->grid.z + z;
+        const std::size_t id    = per_component ? layer * 3 + c : layer;
+        const float       min   = peaks[2 * id];
+        const float       max   = peaks[2 * id + 1];
+
+        if (min != max)
+        {
+          scale [z][c] = max - min;
+          offset[z][c] = min;
+        }
+        else if (min != 0)
+          scale [z][c] = max;
+      }
+
+    const auto status = astcenc_config_init(profile, block.x, block.y, block.z, astcenc_preset::ASTCENC_PRE_FAST, 0, config);
+    if (status != ASTCENC_SUCCESS)
+      printf("Error: ASTC config for %dx%dx%d blocks failed: %s\n", block.x, block.y, block.z, astcenc_get_error_string(status));
+  }
+
+  field_view astc_field::view() const
+  {
+    return field_view(nullptr, grid.x, grid.y, grid.z);
+  }
+
+  std::size_t astc_field::texels_per_block() const
+  {
+    return static_cast<std::size_t>(block.x) * block.y * block.z;
+  }
+
+  std::size_t astc_field::byte_size() const
+  {
+    return volume ? comp->img_len : comp->img_len * grid.z;
+  }
+
+
+  void astc_cache_stats::add(const astc_cache_stats& other)
+  {
+    hits   += other.hits;
+    misses += other.misses;
+  }
+
+  double astc_cache_stats::hit_rate() const
+  {
+    return (hits + misses > 0) ? static_cast<double>(hits) / (hits + misses) : 0.0;
+  }
+
+
+  astc_block_cache::astc_block_cache(const astc_field& field, std::size_t capacity)
+    : field       { &field }
+    , capacity    { std::max<std::size_t>(capacity, 1) }
+    , slot_floats { field.texels_per_block() * field.channels }
+  {
+    keys.resize(this->capacity);
+    prev.resize(this->capacity);
+    next.resize(this->capacity);
+    data.resize(this->capacity * slot_floats);
+    slots.reserve(2 * this->capacity);
+
+    // Same pointer layout as astc::alloc_data(..) (RGBA, no padding)
+    const auto& b = field.block;
+    texels.resize(4 * field.texels_per_block());
+    rows  .resize(static_cast<std::size_t>(b.z) * b.y);
+    planes.resize(b.z);
+    for (int z = 0; z < b.z; z++)
+    {
+      planes[z] = &rows[static_cast<std::size_t>(z) * b.y];
+      for (int y = 0; y < b.y; y++)
+        rows[static_cast<std::size_t>(z) * b.y + y] = &texels[4 * (static_cast<std::size_t>(z) * b.y + y) * b.x];
+    }
+
+    image           = { };
+    image.dim_x     = b.x;
+    image.dim_y     = b.y;
+    image.dim_z     = b.z;
+    image.dim_pad   = 0;
+    image.data_type = ASTCENC_TYPE_F16;
+    image.data      = static_cast<void*>(planes.data());
+
+    const auto status = astcenc_context_alloc(field.config, 1, &context);
+    if (status != ASTCENC_SUCCESS)
+    {
+      printf("Error: ASTC context allocation failed: %s\n", astcenc_get_error_string(status));
+      context = nullptr;
+    }
+  }
+
+  astc_block_cache::~astc_block_cache()
+  {
+    if (context)
+      astcenc_context_free(context);
+  }
+
+  std::size_t astc_block_cache::get_capacity() const
+  {
+    return capacity;
+  }
+
+  std::size_t astc_block_cache::byte_size() const
+  {
+    return data.size() * sizeof(float) + texels.size() * sizeof(std::uint16_t)
+      + capacity * (sizeof(std::uint64_t) + 2 * sizeof(std::uint32_t))
+      + slots.bucket_count() * sizeof(void*) + slots.size() * (sizeof(std::uint64_t) + sizeof(std::uint32_t) + sizeof(void*));
+  }
+
+  const astc_cache_stats& astc_block_cache::get_stats() const
+  {
+    return stats;
+  }
+
+  void astc_block_cache::reset_stats()
+  {
+    stats = astc_cache_stats();
+  }
+
+  void astc_block_cache::clear()
+  {
+    slots.clear();
+    head = none;
+    tail = none;
+    used = 0;
+  }
+
+  const float* astc_block_cache::lookup(std::uint64_t id)
+  {
+    auto it = slots.find(id);
+    if (it != slots.end())
+    {
+      stats.hits++;
+      unlink(it->second);
+      push_front(it->second);
+      return slot_data(it->second);
+    }
+
+    stats.misses++;
+
+    // Free slot or the least recently used one
+    std::uint32_t slot;
+    if (used < capacity)
+      slot = used++;
+    else
+    {
+      slot = tail;
+      slots.erase(keys[slot]);
+      unlink(slot);
+    }
+
+    keys[slot] = id;
+    slots[id]  = slot;
+    push_front(slot);
+
+    float* dst = slot_data(slot);
+    decode(id, dst);
+    return dst;
+  }
+
+  void astc_block_cache::unlink(std::uint32_t slot)
+  {
+    if (prev[slot] != none)
+      next[prev[slot]] = next[slot];
+    else
+      head = next[slot];
+
+    if (next[slot] != none)
+      prev[next[slot]] = prev[slot];
+    else
+      tail = prev[slot];
+  }
+
+  void astc_block_cache::push_front(std::uint32_t slot)
+  {
+    prev[slot] = none;
+    next[slot] = head;
+    if (head != none)
+      prev[head] = slot;
+    head = slot;
+    if (tail == none)
+      tail = slot;
+  }
+
+  bool astc_block_cache::decode(std::uint64_t id, float* dst)
+  {
+    const auto& f = *field;
+
+    const astcenc_swizzle swizzle { ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A };
+
+    const auto status = (context)
+      ? astcenc_decompress_image(context, &f.comp->data[id << 4], 16, image, swizzle)
+      : ASTCENC_ERR_BAD_PARAM;
+
+    if (status != ASTCENC_SUCCESS)
+    {
+      printf("Error: Decoding ASTC block %llu failed: %s\n", static_cast<unsigned long long>(id), astcenc_get_error_string(status));
+      std::fill(dst, dst + slot_floats, 0.0f);
+      return false;
+    }
+
+    const std::size_t image_id = id / f.blocks_per_image;
+    const std::size_t local    = id % f.blocks_per_image;
+    const int         bx       = static_cast<int>(local % f.blocks.x) * f.block.x;
+    const int         bz       = static_cast<int>(local / (static_cast<std::size_t>(f.blocks.x) * f.blocks.y)) * f.block.z;
+
+    // Denormalize with the peaks of the depth layer & component of every channel
+    const std::uint16_t* src = texels.data();
+    for (int z = 0; z < f.block.z; z++)
+    {
+      const int depth = f.volume ? bz + z : static_cast<int>(image_id - f.first_image);
+      const int layer = std::min(std::max(depth, 0), f.grid.z - 1);
+
+      for (int y = 0; y < f.block.y; y++)
+        for (int x = 0; x < f.block.x; x++, src += 4)
+          for (int ch = 0; ch < f.channels; ch++)
+          {
+            const int c = ((bx + x) * f.channels + ch) % 3;
+            *dst++ = sf16_to_float(src[ch]) * f.scale[layer][c] + f.offset[layer][c];
+          }
+    }
+
+    return true;
+  }
+
+
+  astc_cache_stats astc_trace_stats::total() const
+  {
+    astc_cache_stats result;
+    for (const auto& t : threads)
+      result.add(t);
+    return result;
+  }
+
+  std::size_t astc_trace_stats::resident_bytes() const
+  {
+    return compressed_bytes + cache_bytes;
+  }
+
+  void astc_trace_stats::print() const
+  {
+    const auto all = total();
+    printf("ASTC trace: %.3f ms, hit rate %.2f %% (%zu hits, %zu decoded blocks)\n", trace_time, 100.0 * all.hit_rate(), all.hits, all.misses);
+    printf("Resident: %.2f MB (compressed %.2f MB + caches %.2f MB), decoded field %.2f MB\n",
+      resident_bytes() / 1048576.0, compressed_bytes / 1048576.0, cache_bytes / 1048576.0, decoded_bytes / 1048576.0);
+    for (std::size_t t = 0; t < threads.size(); t++)
+      printf("  Thread %3zu: hit rate %6.2f %%, decoded blocks %8zu\n", t, 100.0 * threads[t].hit_rate(), threads[t].misses);
+  }
+
+
+  astc_tracer::astc_tracer(const astc_field& field, unsigned int thread_count, std::size_t cache_blocks)
+    : field        { field }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+    for (unsigned int t = 0; t < this->thread_count; t++)
+      caches.push_back(std::make_unique<astc_block_cache>(this->field, cache_blocks));
+  }
+
+  cpu_trace_result astc_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf) const
+  {
+    cpu_trace_result result;
+    result.seed_count = cpu_tracer::seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void astc_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (!batch_stepper<>::supported(i_conf.strategy))
+      throw std::invalid_argument("astc_tracer: unknown integration strategy " + std::to_string(i_conf.strategy));
+
+    const auto       seeds  = cpu_tracer::make_seeds(s_conf);
+    const auto       order  = seed_order(s_conf);
+    const field_view bounds = field.view();
+
+    // Every trace starts cold, so the stats are comparable
+    for (auto& cache : caches)
+    {
+      cache->clear();
+      cache->reset_stats();
+    }
+
+    // A chunk is a batch of seeds, neighbours along the seed order
+    const std::size_t width       = particle_batch<>::width;
+    const std::size_t chunk_count = (seeds.size() + width - 1) / width;
+
+    std::vector<batch_stepper<>> steppers(thread_count, batch_stepper<>(i_conf));
+
+    scheduler.run(chunk_count, [&](unsigned int thread, std::size_t chunk)
+    {
+      const astc_sampler sampler(field, *caches[thread]);
+      const std::size_t  first = chunk * width;
+
+      steppers[thread].trace(sampler, bounds, seeds.data(), &order[first], first, std::min(width, seeds.size() - first), positions, velocities);
+    });
+
+    stats                  = astc_trace_stats();
+    stats.compressed_bytes = field.byte_size();
+    stats.decoded_bytes    = 3 * sizeof(float) * static_cast<std::size_t>(field.grid.x) * field.grid.y * field.grid.z;
+    for (const auto& cache : caches)
+    {
+      stats.threads.push_back(cache->get_stats());
+      stats.cache_bytes += cache->byte_size();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  unsigned int astc_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  const astc_trace_stats& astc_tracer::get_stats() const
+  {
+    return stats;
+  }
+}
@@ -0,0 +1,166 @@
+#include <jay/integration/bricked_field.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/seed_order.hpp>
+
+namespace jay
+{
+  bricked_field::bricked_field(field_view field, unsigned int brick_size, unsigned int thread_count)
+    : field       { field }
+    , brick_size  { 4 }
+    , brick_shift { 2 }
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Next power of 2 (at least 4)
+    while (this->brick_size < brick_size && this->brick_size < 256)
+    {
+      this->brick_size <<= 1;
+      brick_shift++;
+    }
+    if (this->brick_size != brick_size)
+      printf("Warning: Brick size %u is not a power of 2 (>= 4), using %u.\n", brick_size, this->brick_size);
+
+    const int b = static_cast<int>(this->brick_size);
+    brick_nodes = this->brick_size + 1;
+    bricks      = glm::ivec3((field.grid_x + b - 1) / b, (field.grid_y + b - 1) / b, (field.grid_z + b - 1) / b);
+    cells       = bricks * b;
+
+    const std::size_t brick_count = static_cast<std::size_t>(bricks.x) * bricks.y * bricks.z;
+    brick_floats = 3 * static_cast<std::size_t>(brick_nodes) * brick_nodes * brick_nodes;
+
+    // Neighbouring bricks close in memory
+    const auto order = grid_order(glm::uvec3(bricks), SeedOrderMorton);
+
+    ranks.resize(brick_count);
+    for (std::size_t i = 0; i < brick_count; i++)
+      ranks[order[i]] = static_cast<std::uint32_t>(i);
+
+    data.resize(brick_count * brick_floats);
+
+    // Bricks are independent, each thread copies a range of them
+    auto copy_bricks = [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t id = begin; id < end; id++)
+      {
+        const int bx = static_cast<int>(id % bricks.x) * b;
+        const int by = static_cast<int>((id / bricks.x) % bricks.y) * b;
+        const int bz = static_cast<int>(id / (static_cast<std::size_t>(bricks.x) * bricks.y)) * b;
+
+        float* dst = data.data() + ranks[id] * brick_floats;
+        for (unsigned int z = 0; z < brick_nodes; z++)
+          for (unsigned int y = 0; y < brick_nodes; y++)
+            for (unsigned int x = 0; x < brick_nodes; x++)
+            {
+              const auto v = this->field.node(bx + x, by + y, bz + z);
+              *dst++ = v.x;
+              *dst++ = v.y;
+              *dst++ = v.z;
+            }
+      }
+    };
+
+    if (thread_count == 0)
+      thread_count = std::max(1U, std::thread::hardware_concurrency());
+
+    std::vector<std::thread> threads(std::min<std::size_t>(thread_count, std::max<std::size_t>(1, brick_count)));
+    for (std::size_t t = 0; t < threads.size(); t++)
+      threads[t] = std::thread(copy_bricks, brick_count * t / threads.size(), brick_count * (t + 1) / threads.size());
+    for (auto& thread : threads)
+      thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    build_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  unsigned int bricked_field::brick_size_for(std::size_t cache_bytes)
+  {
+    unsigned int size = 4;
+    while (size < 256)
+    {
+      const std::size_t nodes = 2 * size + 1;
+      if (nodes * nodes * nodes * 3 * sizeof(float) > cache_bytes)
+        break;
+      size *= 2;
+    }
+    return size;
+  }
+
+  glm::vec3 bricked_field::node(int x, int y, int z) const
+  {
+    if (x < 0 || y < 0 || z < 0 || x >= field.grid_x || y >= field.grid_y || z >= field.grid_z)
+      return glm::vec3(0.0f);
+
+    const unsigned int mask = brick_size - 1;
+
+    const std::size_t brick = ((static_cast<std::size_t>(z >> brick_shift) * bricks.y) + (y >> brick_shift)) * bricks.x + (x >> brick_shift);
+    const std::size_t local = ((static_cast<std::size_t>(z & mask) * brick_nodes) + (y & mask)) * brick_nodes + (x & mask);
+
+    const float* v = data.data() + ranks[brick] * brick_floats + 3 * local;
+    return glm::vec3(v[0], v[1], v[2]);
+  }
+
+  std::size_t bricked_field::byte_size() const
+  {
+    return data.size() * sizeof(float);
+  }
+
+
+  double bricked_report::speedup() const
+  {
+    return (bricked_time > 0.0) ? linear_time / bricked_time : 0.0;
+  }
+
+  void bricked_report::print() const
+  {
+    printf("Bricks: %u^3 (%.1f MB, linear %.1f MB), built in %.3f ms\n", brick_size, bricked_bytes / 1048576.0, linear_bytes / 1048576.0, build_time);
+    printf("Linear:  %10.3f ms (%.3f ns per step)\n", linear_time,  (steps > 0) ? 1e6 * linear_time  / steps : 0.0);
+    printf("Bricked: %10.3f ms (%.3f ns per step)\n", bricked_time, (steps > 0) ? 1e6 * bricked_time / steps : 0.0);
+    printf("Speedup: %.2f, largest position difference: %g\n", speedup(), max_difference);
+  }
+
+  bricked_report compare_bricked_linear(const jaySrc<float>& src, const seeding_conf& s_conf, const integration_conf& i_conf, unsigned int brick_size, unsigned int thread_count, unsigned int runs)
+  {
+    bricked_report report;
+
+    integration_conf conf = i_conf;
+    conf.texelfetch = 1;
+
+    cpu_tracer tracer(src, thread_count);
+    report.steps        = cpu_tracer::seed_count(s_conf) * std::min(conf.local_step_count, conf.global_step_count);
+    report.linear_bytes = src.data.size() * sizeof(float);
+
+    cpu_trace_result linear, bricked;
+
+    report.linear_time = -1.0;
+    for (unsigned int r = 0; r < std::max(1U, runs); r++)
+    {
+      linear = tracer.trace(s_conf, conf);
+      if (report.linear_time < 0.0 || tracer.get_trace_time() < report.linear_time)
+        report.linear_time = tracer.get_trace_time();
+    }
+
+    tracer.use_bricks(brick_size);
+    report.brick_size    = tracer.get_bricks()->brick_size;
+    report.bricked_bytes = tracer.get_bricks()->byte_size();
+    report.build_time    = tracer.get_bricks()->build_time;
+
+    report.bricked_time = -1.0;
+    for (unsigned int r = 0; r < std::max(1U, runs); r++)
+    {
+      bricked = tracer.trace(s_conf, conf);
+      if (report.bricked_time < 0.0 || tracer.get_trace_time() < report.bricked_time)
+        report.bricked_time = tracer.get_trace_time();
+    }
+
+    for (std::size_t i = 0; i < linear.positions.size(); i++)
+      report.max_difference = std::max(report.max_difference, glm::distance(linear.positions[i], bricked.positions[i]));
+
+    return report;
+  }
+}
@@ -0,0 +1,158 @@
+#include <jay/integration/cpu_tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/seed_order.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+
+namespace jay
+{
+  cpu_tracer::cpu_tracer(const jaySrc<float>& src, unsigned int thread_count)
+    : field        { src }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+  }
+
+  cpu_tracer::cpu_tracer(const jaySrcView<float>& src, unsigned int thread_count)
+    : field        { src }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+  }
+
+  cpu_trace_result cpu_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf) const
+  {
+    cpu_trace_result result;
+    result.seed_count = seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void cpu_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const auto seeds = make_seeds(s_conf);
+    rk45_trace_stats = rk45_stats();
+
+    const glm::uvec3 dims(s_conf.seeds);
+
+    if (i_conf.texelfetch && bricks)
+      trace_seeds(bricked_sampler(*bricks), seeds, dims, s_conf.ordering, i_conf, positions, velocities);
+    else if (i_conf.texelfetch)
+      trace_seeds(trilinear_sampler(field), seeds, dims, s_conf.ordering, i_conf, positions, velocities);
+    else
+      trace_seeds(texture_sampler(field), seeds, dims, s_conf.ordering, i_conf, positions, velocities);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  void cpu_tracer::trace(const std::vector<glm::vec4>& seeds, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    rk45_trace_stats = rk45_stats();
+
+    // A single row of seeds
+    const glm::uvec3 dims(static_cast<unsigned int>(seeds.size()), 1, 1);
+
+    if (!seeds.empty())
+    {
+      if (i_conf.texelfetch && bricks)
+        trace_seeds(bricked_sampler(*bricks), seeds, dims, SeedOrderGrid, i_conf, positions, velocities);
+      else if (i_conf.texelfetch)
+        trace_seeds(trilinear_sampler(field), seeds, dims, SeedOrderGrid, i_conf, positions, velocities);
+      else
+        trace_seeds(texture_sampler(field), seeds, dims, SeedOrderGrid, i_conf, positions, velocities);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  void cpu_tracer::use_bricks(unsigned int brick_size)
+  {
+    if (brick_size == 0)
+      bricks.reset();
+    else
+      bricks = std::make_unique<bricked_field>(field, brick_size, thread_count);
+  }
+
+  const bricked_field* cpu_tracer::get_bricks() const
+  {
+    return bricks.get();
+  }
+
+  std::vector<glm::vec4> cpu_tracer::make_seeds(const seeding_conf& s_conf)
+  {
+    std::vector<glm::vec4> seeds;
+    seeds.reserve(seed_count(s_conf));
+
+    const glm::vec3 offset(s_conf.range_x.x, s_conf.range_y.x, s_conf.range_z.x);
+
+    // Same order as gl_GlobalInvocationID in the dispatch
+    for (std::size_t z = 0; z < static_cast<std::size_t>(s_conf.seeds.z); z++)
+      for (std::size_t y = 0; y < static_cast<std::size_t>(s_conf.seeds.y); y++)
+        for (std::size_t x = 0; x < static_cast<std::size_t>(s_conf.seeds.x); x++)
+          seeds.push_back(glm::vec4(glm::vec3(x, y, z) * s_conf.stride + offset, 1.0f));
+
+    return seeds;
+  }
+
+  std::size_t cpu_tracer::seed_count(const seeding_conf& s_conf)
+  {
+    return static_cast<std::size_t>(s_conf.seeds.x) * static_cast<std::size_t>(s_conf.seeds.y) * static_cast<std::size_t>(s_conf.seeds.z);
+  }
+
+  unsigned int cpu_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  double cpu_tracer::get_trace_time() const
+  {
+    return trace_time;
+  }
+
+  rk45_stats cpu_tracer::get_rk45_stats() const
+  {
+    return rk45_trace_stats;
+  }
+
+  const work_stealing_scheduler& cpu_tracer::get_scheduler() const
+  {
+    return scheduler;
+  }
+
+  template <typename Sampler>
+  void cpu_tracer::trace_seeds(const Sampler& sampler, const std::vector<glm::vec4>& seeds, const glm::uvec3& dims, gl::GLuint ordering, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    // Seeds leaving the domain early are cheap, so the seeds are cut into many small chunks (tiles, see seed_tiles)
+    // that are handed out by work stealing. Within a chunk the seeds are advanced in batches of 8 (see batch_stepper.hpp).
+    const seed_tiles tiles(dims, ordering, particle_batch<>::width);
+
+    std::vector<batch_stepper<>> steppers(scheduler.get_thread_count(), batch_stepper<>(i_conf));
+
+    scheduler.run(tiles.count(), [&](unsigned int thread, std::size_t chunk)
+    {
+      // A row holds at most one batch
+      tiles.for_rows(chunk, [&](std::size_t first, std::size_t n)
+      {
+        steppers[thread].trace(sampler, field, seeds.data(), nullptr, first, n, positions, velocities);
+      });
+    });
+
+    for (const auto& stepper : steppers)
+      rk45_trace_stats.add(stepper.stats);
+  }
+}
@@ -0,0 +1,681 @@
+#include <jay/integration/domain_tracer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <jay/integration/schemes.hpp>
+#include <jay/io/hdf5_io.hpp>
+
+namespace jay
+{
+  namespace
+  {
+    namespace bip = boost::interprocess;
+
+    // A particle handed from one subdomain to another
+    struct particle_state
+    {
+      std::uint32_t seed = 0;
+      std::uint32_t step = 0;
+      glm::vec4     p;
+      glm::vec4     v;
+    };
+
+    constexpr std::uint32_t no_seed = 0xFFFFFFFF;
+
+    // Inbox of a subdomain, a list of seeds linked through domain_segment::next.
+    // A particle is in at most one queue, so all queues share one state per seed.
+    struct particle_queue
+    {
+      bip::interprocess_mutex     m;
+      bip::interprocess_condition cv;
+      std::uint32_t               first = no_seed;
+      std::uint32_t               last  = no_seed;
+      bool                        done  = false;
+
+      // Written by the owner
+      std::uint64_t               z_offset    = 0;
+      std::uint64_t               z_count     = 0;
+      std::uint64_t               steps       = 0;
+      std::uint64_t               handoffs    = 0;
+      std::uint64_t               halo_misses = 0;
+      double                      load_ms     = 0.0;
+      bool                        finished    = false;
+    };
+
+    struct domain_header
+    {
+      glm::uvec3    grid;
+      std::uint32_t subdomains    = 0;
+      std::uint32_t halo          = 0;
+      std::uint64_t seed_count    = 0;
+      std::uint64_t global_steps  = 0;
+      std::uint64_t local_steps   = 0;
+      float         h             = 0.0f;
+      float         vector_factor = 1.0f;
+      glm::vec4     cf;
+      bool          euler         = false;
+      bool          trajectories  = true;    // Written to the segment (or directly to the buffers of the caller by worker threads)
+
+      // Particles not done yet, the last one ends the trace
+      bip::interprocess_mutex m;
+      std::uint64_t           outstanding = 0;
+    };
+
+    // The parts of the shared memory segment: header, queues, queued states & their links, positions & velocities (optional)
+    struct domain_segment
+    {
+      domain_header*  header     = nullptr;
+      particle_queue* queues     = nullptr;
+      particle_state* states     = nullptr;   // Of the queued particles, by seed
+      std::uint32_t*  next       = nullptr;   // Seed queued after a seed
+      glm::vec4*      positions  = nullptr;
+      glm::vec4*      velocities = nullptr;
+
+      static std::size_t align(std::size_t bytes)
+      {
+        return (bytes + 63) / 64 * 64;
+      }
+
+      static std::size_t size(std::size_t subdomains, std::size_t seed_count, std::size_t global_steps, bool trajectories)
+      {
+        return align(sizeof(domain_header))
+          + align(subdomains * sizeof(particle_queue))
+          + align(seed_count * sizeof(particle_state))
+          + align(seed_count * sizeof(std::uint32_t))
+          + (trajectories ? 2 * align(seed_count * global_steps * sizeof(glm::vec4)) : 0);
+      }
+
+      domain_segment(void* base, std::size_t subdomains, std::size_t seed_count, std::size_t global_steps, bool trajectories)
+      {
+        auto* bytes = static_cast<char*>(base);
+        header     = reinterpret_cast<domain_header*> (bytes); bytes += align(sizeof(domain_header));
+        queues     = reinterpret_cast<particle_queue*>(bytes); bytes += align(subdomains * sizeof(particle_queue));
+        states     = reinterpret_cast<particle_state*>(bytes); bytes += align(seed_count * sizeof(particle_state));
+        next       = reinterpret_cast<std::uint32_t*> (bytes); bytes += align(seed_count * sizeof(std::uint32_t));
+        if (!trajectories)
+          return;
+
+        positions  = reinterpret_cast<glm::vec4*>     (bytes); bytes += align(seed_count * global_steps * sizeof(glm::vec4));
+        velocities = reinterpret_cast<glm::vec4*>     (bytes);
+      }
+
+      void push(std::size_t rank, const particle_state& state)
+      {
+        auto& q = queues[rank];
+        bip::scoped_lock<bip::interprocess_mutex> lock(q.m);
+        states[state.seed] = state;
+        next  [state.seed] = no_seed;
+        if (q.last == no_seed)
+          q.first = state.seed;
+        else
+          next[q.last] = state.seed;
+        q.last = state.seed;
+        q.cv.notify_one();
+      }
+
+      // Takes all queued particles, waits for some if there are none; false once all particles are done
+      bool pop(std::size_t rank, std::vector<particle_state>& particles)
+      {
+        auto& q = queues[rank];
+        bip::scoped_lock<bip::interprocess_mutex> lock(q.m);
+        while (q.first == no_seed && !q.done)
+          q.cv.wait(lock);
+
+        if (q.first == no_seed)
+          return false;
+
+        particles.clear();
+        for (auto seed = q.first; seed != no_seed; seed = next[seed])
+          particles.push_back(states[seed]);
+        q.first = no_seed;
+        q.last  = no_seed;
+        return true;
+      }
+
+      // Wakes all workers to return
+      void finish_all()
+      {
+        for (std::size_t r = 0; r < header->subdomains; r++)
+        {
+          bip::scoped_lock<bip::interprocess_mutex> lock(queues[r].m);
+          queues[r].done = true;
+          queues[r].cv.notify_all();
+        }
+      }
+
+      void done(std::uint64_t particles)
+      {
+        if (particles == 0)
+          return;
+
+        bool last = false;
+        {
+          bip::scoped_lock<bip::interprocess_mutex> lock(header->m);
+          header->outstanding -= particles;
+          last = (header->outstanding == 0);
+        }
+        if (last)
+          finish_all();
+      }
+    };
+
+    // Cells [first, second) along z of a subdomain
+    std::pair<std::size_t, std::size_t> cell_range(std::size_t grid_z, std::size_t subdomains, std::size_t rank)
+    {
+      const std::size_t cells = std::max<std::size_t>(grid_z, 2) - 1;
+      return { rank * cells / subdomains, (rank + 1) * cells / subdomains };
+    }
+
+    // Subdomain owning the cell of z (clamped to the grid)
+    std::size_t owner_of(float z, std::size_t grid_z, std::size_t subdomains)
+    {
+      const std::size_t cells = std::max<std::size_t>(grid_z, 2) - 1;
+      const std::size_t cell  = static_cast<std::size_t>(glm::clamp(std::floor(z), 0.0f, static_cast<float>(cells - 1)));
+
+      std::size_t rank = std::min(cell * subdomains / cells, subdomains - 1);
+      while (rank + 1 < subdomains && cell_range(grid_z, subdomains, rank + 1).first <= cell)
+        rank++;
+      while (rank > 0 && cell_range(grid_z, subdomains, rank).first > cell)
+        rank--;
+      return rank;
+    }
+
+    // A forked child only has the calling thread, locks held by the other threads would never be released in it
+    bool other_threads_running()
+    {
+#ifdef __linux__
+      std::error_code error;
+      std::size_t     threads = 0;
+      for (std::filesystem::directory_iterator it("/proc/self/task", error), end; !error && it != end; it.increment(error))
+        threads++;
+      return error || threads != 1;
+#else
+      // No portable way to count them
+      return true;
+#endif
+    }
+
+    std::string segment_name()
+    {
+      static std::atomic<std::size_t> counter { 0 };
+      return "jay_domain_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(counter++);
+    }
+  }
+
+
+  std::size_t domain_trace_stats::steps() const
+  {
+    std::size_t sum = 0;
+    for (const auto& s : subdomains)
+      sum += s.steps;
+    return sum;
+  }
+
+  std::size_t domain_trace_stats::handoffs() const
+  {
+    std::size_t sum = 0;
+    for (const auto& s : subdomains)
+      sum += s.handoffs;
+    return sum;
+  }
+
+  std::size_t domain_trace_stats::halo_misses() const
+  {
+    std::size_t sum = 0;
+    for (const auto& s : subdomains)
+      sum += s.halo_misses;
+    return sum;
+  }
+
+  void domain_trace_stats::print() const
+  {
+    printf("Domain trace: %.3f ms, %zu subdomains, %zu steps, %zu handoffs, %zu halo misses\n", trace_time, subdomains.size(), steps(), handoffs(), halo_misses());
+    for (std::size_t r = 0; r < subdomains.size(); r++)
+    {
+      const auto& s = subdomains[r];
+      printf("  Subdomain %zu: layers [%zu, %zu) loaded in %.3f ms, %zu steps, %zu handoffs%s\n", r, s.z_offset, s.z_offset + s.z_count, s.load_ms, s.steps, s.handoffs, s.finished ? "" : " (failed)");
+    }
+  }
+
+
+  domain_tracer::domain_tracer(const glm::uvec3& grid, std::size_t subdomain_count, slab_reader_fn reader, unsigned int halo)
+    : grid            { grid }
+    , subdomain_count { std::max<std::size_t>(1, subdomain_count) }
+    , reader          { std::move(reader) }
+    , halo            { halo }
+  { }
+
+  domain_tracer::domain_tracer(std::string h5_filepath, std::vector<std::string> datasets, std::size_t subdomain_count, unsigned int halo, std::size_t t)
+    : grid            { 0 }
+    , subdomain_count { std::max<std::size_t>(1, subdomain_count) }
+    , halo            { halo }
+  {
+    {
+      std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+      hdf5_io handler(h5_filepath, datasets);
+
+      if (handler.get_vec_len() != 3)
+        printf("Error: The domain tracer needs a field with 3 components.\n");
+
+      const auto g = handler.get_grid_fixsize(false, 1);
+      grid = glm::uvec3(g[0], g[1], g[2]);
+    }
+
+    // Each worker reads its slab once, the library is locked for workers sharing a process (the read locks on its own)
+    reader = [=](std::size_t z_offset, std::size_t z_count, float* dst)
+    {
+      std::unique_ptr<hdf5_io> handler;
+      {
+        std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+        handler = std::make_unique<hdf5_io>(h5_filepath, datasets);
+      }
+      handler->read_hdf5_slab(dst, t, z_offset, z_count, Order::VectorFirst);
+
+      std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+      handler.reset();
+    };
+  }
+
+  cpu_trace_result domain_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf)
+  {
+    cpu_trace_result result;
+    result.seed_count = cpu_tracer::seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void domain_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities)
+  {
+    trace(s_conf, i_conf, positions, velocities, nullptr);
+  }
+
+  void domain_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, const trajectory_fn& consumer)
+  {
+    trace(s_conf, i_conf, nullptr, nullptr, &consumer);
+  }
+
+  void domain_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities, const trajectory_fn* consumer)
+  {
+    if (i_conf.strategy != StrategyEuler && i_conf.strategy != StrategyRK4)
+      throw std::invalid_argument("domain_tracer: only Euler and RK4 are supported, got strategy " + std::to_string(i_conf.strategy));
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const auto        seeds        = cpu_tracer::make_seeds(s_conf);
+    const std::size_t global_steps = i_conf.global_step_count;
+    const std::size_t local_steps  = std::min<std::size_t>(i_conf.local_step_count, global_steps);
+    const field_view  bounds(nullptr, static_cast<int>(grid.x), static_cast<int>(grid.y), static_cast<int>(grid.z));
+
+    stats = domain_trace_stats();
+    stats.subdomains.resize(subdomain_count);
+
+    if (seeds.empty())
+      return;
+
+    // A forked child only has the calling thread, so the workers are threads while others are running
+#ifdef _WIN32
+    const bool processes = false;
+#else
+    const bool processes = !other_threads_running();
+#endif
+    // Worker threads write the trajectories of the caller directly, everything else goes through the segment
+    const bool shared_trajectories = processes || consumer;
+
+    // Removes the segment on every return
+    const std::string name = segment_name();
+    struct remover
+    {
+      std::string name;
+      ~remover() { bip::shared_memory_object::remove(name.c_str()); }
+    } remove_segment { name };
+
+    bip::shared_memory_object shm;
+    bip::mapped_region        region;
+    try
+    {
+      shm    = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+      shm.truncate(static_cast<bip::offset_t>(domain_segment::size(subdomain_count, seeds.size(), global_steps, shared_trajectories)));
+      region = bip::mapped_region(shm, bip::read_write);
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+      printf("Error: Could not create the shared memory of the domain tracer (%s).\n", e.what());
+      return;
+    }
+
+    domain_segment segment(region.get_address(), subdomain_count, seeds.size(), global_steps, shared_trajectories);
+
+    auto* header = new (segment.header) domain_header();
+    header->grid          = grid;
+    header->subdomains    = static_cast<std::uint32_t>(subdomain_count);
+    header->halo          = halo;
+    header->seed_count    = seeds.size();
+    header->global_steps  = global_steps;
+    header->local_steps   = local_steps;
+    header->h             = i_conf.step_size_h;
+    header->vector_factor = i_conf.dataset_factor;
+    header->cf            = cell_factor(i_conf.cell_size);
+    header->euler         = (i_conf.strategy == StrategyEuler);
+    header->trajectories  = shared_trajectories;
+    for (std::size_t r = 0; r < subdomain_count; r++)
+      new (&segment.queues[r]) particle_queue();
+
+    glm::vec4* out_positions  = shared_trajectories ? segment.positions  : positions;
+    glm::vec4* out_velocities = shared_trajectories ? segment.velocities : velocities;
+    std::fill(out_positions,  out_positions  + seeds.size() * global_steps, glm::vec4(0.0f));
+    std::fill(out_velocities, out_velocities + seeds.size() * global_steps, glm::vec4(0.0f));
+
+    // Seeds go to the owner of their cell, the ones outside of the domain are done
+    for (std::uint32_t s = 0; s < seeds.size(); s++)
+    {
+      if (local_steps == 0 || !bounds.contains(glm::vec3(seeds[s])))
+      {
+        for (std::size_t i = 0; i < local_steps; i++)
+          out_positions[s * global_steps + i] = seeds[s];
+        continue;
+      }
+
+      particle_state state;
+      state.seed = s;
+      state.p    = seeds[s];
+      state.v    = glm::vec4(0.0f);
+      segment.push(owner_of(state.p.z, grid.z, subdomain_count), state);
+      header->outstanding++;
+    }
+
+    if (header->outstanding == 0)
+      segment.finish_all();
+
+    bool failed = false;
+
+    // Workers sharing this process, a failed one has released its locks, so the others can be woken
+    auto run_threads = [&]()
+    {
+      std::vector<std::thread> workers(subdomain_count);
+      std::vector<char>        ok(subdomain_count, 0);
+      for (std::size_t r = 0; r < subdomain_count; r++)
+        workers[r] = std::thread([&, r]()
+        {
+          ok[r] = shared_trajectories ? run_worker(name, r, reader) : run_worker(name, r, reader, positions, velocities);
+          if (!ok[r])
+            segment.finish_all();
+        });
+      for (auto& worker : workers)
+        worker.join();
+      failed = std::count(ok.begin(), ok.end(), 0) > 0;
+    };
+
+    if (!processes)
+      run_threads();
+#ifndef _WIN32
+    else
+    {
+      stats.processes = true;
+
+      std::vector<pid_t> pids;
+      for (std::size_t r = 0; r < subdomain_count; r++)
+      {
+        const pid_t pid = fork();
+        if (pid == 0)
+          _exit(run_worker(name, r, reader) ? 0 : 1);
+
+        if (pid < 0)
+        {
+          printf("Error: Could not start the worker of subdomain %zu.\n", r);
+          failed = true;
+          break;
+        }
+        pids.push_back(pid);
+      }
+
+      // The particles of a failed worker are never done and it may have died holding a queue lock,
+      // so the others are killed instead of woken through the shared memory
+      auto kill_workers = [&]()
+      {
+        for (auto pid : pids)
+          if (pid > 0)
+            kill(pid, SIGKILL);
+      };
+
+      if (failed)
+        kill_workers();
+
+      // Only the own workers are reaped, in the order they finish (a failed one leaves the others waiting)
+      std::size_t running = pids.size();
+      while (running > 0)
+      {
+        bool reaped = false;
+        for (std::size_t w = 0; w < pids.size(); w++)
+        {
+          if (pids[w] == 0)
+            continue;
+
+          int status = 0;
+          const pid_t result = waitpid(pids[w], &status, WNOHANG);
+          if (result == 0 || (result < 0 && errno == EINTR))
+            continue;
+
+          const bool ok = (result == pids[w]) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+          pids[w] = 0;
+          running--;
+          reaped  = true;
+
+          if (!ok && !failed)
+          {
+            if (result < 0)
+              printf("Error: Could not wait for the worker of subdomain %zu.\n", w);
+            else if (WIFSIGNALED(status))
+              printf("Error: The worker of subdomain %zu was terminated by signal %d.\n", w, WTERMSIG(status));
+            else
+              printf("Error: The worker of subdomain %zu exited with status %d.\n", w, WEXITSTATUS(status));
+
+            failed = true;
+            kill_workers();
+          }
+        }
+
+        if (!reaped && running > 0)
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+#endif
+
+    if (failed)
+      printf("Error: A worker of the domain tracer failed, the trajectories are incomplete.\n");
+
+    // Streamed out of the segment seed by seed, or copied if the workers couldn't write the trajectories of the caller
+    if (consumer)
+    {
+      for (std::size_t s = 0; s < seeds.size(); s++)
+        (*consumer)(s, segment.positions + s * global_steps, segment.velocities + s * global_steps);
+    }
+    else if (shared_trajectories)
+    {
+      std::copy(segment.positions,  segment.positions  + seeds.size() * global_steps, positions);
+      std::copy(segment.velocities, segment.velocities + seeds.size() * global_steps, velocities);
+    }
+
+    for (std::size_t r = 0; r < subdomain_count; r++)
+    {
+      const auto& q = segment.queues[r];
+      auto&       s = stats.subdomains[r];
+      s.z_offset    = q.z_offset;
+      s.z_count     = q.z_count;
+      s.steps       = q.steps;
+      s.handoffs    = q.handoffs;
+      s.halo_misses = q.halo_misses;
+      s.load_ms     = q.load_ms;
+      s.finished    = q.finished;
+    }
+
+    // A dead worker may have left a lock held, the segment is removed anyway
+    if (!failed)
+    {
+      for (std::size_t r = 0; r < subdomain_count; r++)
+        segment.queues[r].~particle_queue();
+      header->~domain_header();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  bool domain_tracer::run_worker(const std::string& name, std::size_t rank, const slab_reader_fn& reader)
+  {
+    return run_worker(name, rank, reader, nullptr, nullptr);
+  }
+
+  bool domain_tracer::run_worker(const std::string& name, std::size_t rank, const slab_reader_fn& reader, glm::vec4* positions, glm::vec4* velocities)
+  {
+    try
+    {
+      bip::shared_memory_object shm(bip::open_only, name.c_str(), bip::read_write);
+      bip::mapped_region        region(shm, bip::read_write);
+
+      const auto* head = static_cast<const domain_header*>(region.get_address());
+      domain_segment segment(region.get_address(), head->subdomains, head->seed_count, head->global_steps, head->trajectories);
+
+      if (head->trajectories)
+      {
+        positions  = segment.positions;
+        velocities = segment.velocities;
+      }
+      else if (!positions || !velocities)
+      {
+        printf("Error: Worker %zu of the domain tracer has nowhere to write the trajectories.\n", rank);
+        return false;
+      }
+
+      const auto&       header       = *segment.header;
+      auto&             queue        = segment.queues[rank];
+      const std::size_t grid_z       = header.grid.z;
+      const std::size_t global_steps = header.global_steps;
+      const std::size_t local_steps  = header.local_steps;
+      const float       h            = header.h;
+      const field_view  bounds(nullptr, static_cast<int>(header.grid.x), static_cast<int>(header.grid.y), static_cast<int>(grid_z));
+
+      // Own depth layers (the last node of the last cell included) & the halo
+      const auto        cells = cell_range(grid_z, header.subdomains, rank);
+      const std::size_t first = (cells.first > header.halo) ? cells.first - header.halo : 0;
+      const std::size_t last  = std::min<std::size_t>(cells.second + header.halo, grid_z - 1);
+      const std::size_t count = last - first + 1;
+
+      auto load_start = std::chrono::high_resolution_clock::now();
+      std::vector<float> slab(static_cast<std::size_t>(header.grid.x) * header.grid.y * count * 3);
+      reader(first, count, slab.data());
+      auto load_end = std::chrono::high_resolution_clock::now();
+
+      const slab_sampler sampler(field_view(slab.data(), static_cast<int>(header.grid.x), static_cast<int>(header.grid.y), static_cast<int>(count)), static_cast<int>(first), static_cast<int>(grid_z));
+
+      std::uint64_t steps    = 0;
+      std::uint64_t handoffs = 0;
+
+      std::vector<particle_state> particles;
+      while (segment.pop(rank, particles))
+      {
+        std::uint64_t done = 0;
+        for (auto& particle : particles)
+        {
+          auto* pos = positions  + particle.seed * global_steps;
+          auto* vel = velocities + particle.seed * global_steps;
+
+          // Advances the particle until it's done or samples another subdomain next
+          while (particle.step < local_steps)
+          {
+            // Particles outside of the domain are frozen
+            if (!bounds.contains(glm::vec3(particle.p)))
+            {
+              for (auto i = particle.step; i < local_steps; i++)
+              {
+                pos[i] = particle.p;
+                vel[i] = particle.v;
+              }
+              particle.step = static_cast<std::uint32_t>(local_steps);
+              break;
+            }
+
+            const std::size_t owner = owner_of((particle.p + h * particle.v).z, grid_z, header.subdomains);
+            if (owner != rank)
+            {
+              segment.push(owner, particle);
+              handoffs++;
+              break;
+            }
+
+            particle.p = particle.p + h * particle.v;
+            particle.v = header.euler
+              ? euler_velo(sampler, particle.p, h, header.vector_factor, header.cf)
+              : rk4_velo  (sampler, particle.p, h, header.vector_factor, header.cf);
+
+            pos[particle.step] = particle.p;
+            vel[particle.step] = particle.v;
+            particle.step++;
+            steps++;
+          }
+
+          if (particle.step >= local_steps)
+            done++;
+        }
+
+        segment.done(done);
+      }
+
+      queue.z_offset    = first;
+      queue.z_count     = count;
+      queue.steps       = steps;
+      queue.handoffs    = handoffs;
+      queue.halo_misses = sampler.misses;
+      queue.load_ms     = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+      queue.finished    = true;
+      return true;
+    }
+    catch (const std::exception& e)
+    {
+      printf("Error: Worker %zu of the domain tracer failed (%s).\n", rank, e.what());
+      return false;
+    }
+  }
+
+  std::pair<std::size_t, std::size_t> domain_tracer::subdomain_range(std::size_t rank) const
+  {
+    return cell_range(grid.z, subdomain_count, rank);
+  }
+
+  std::size_t domain_tracer::get_subdomain_count() const
+  {
+    return subdomain_count;
+  }
+
+  const domain_trace_stats& domain_tracer::get_stats() const
+  {
+    return stats;
+  }
+}
@@ -0,0 +1,135 @@
+#include <jay/integration/ensemble_tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/seed_order.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+
+namespace jay
+{
+  ensemble_tracer::ensemble_tracer(const std::vector<jaySrc<float>>& members, unsigned int thread_count)
+    : members      { members.begin(), members.end() }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  { }
+
+  ensemble_tracer::ensemble_tracer(const std::vector<const jaySrc<float>*>& members, unsigned int thread_count)
+    : thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+    for (const auto* member : members)
+      this->members.emplace_back(*member);
+  }
+
+  ensemble_trace_result ensemble_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf) const
+  {
+    ensemble_trace_result result;
+    result.member_count = members.size();
+    result.seed_count   = cpu_tracer::seed_count(s_conf);
+    result.step_count   = i_conf.global_step_count;
+    result.positions .resize(result.member_count * result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.member_count * result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void ensemble_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    rk45_trace_stats = rk45_stats();
+
+    if (i_conf.texelfetch && !bricks.empty())
+    {
+      std::vector<bricked_sampler> samplers;
+      for (const auto& member_bricks : bricks)
+        samplers.emplace_back(*member_bricks);
+      trace_members(samplers, s_conf, i_conf, positions, velocities);
+    }
+    else if (i_conf.texelfetch)
+    {
+      std::vector<trilinear_sampler> samplers(members.begin(), members.end());
+      trace_members(samplers, s_conf, i_conf, positions, velocities);
+    }
+    else
+    {
+      std::vector<texture_sampler> samplers(members.begin(), members.end());
+      trace_members(samplers, s_conf, i_conf, positions, velocities);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  void ensemble_tracer::use_bricks(unsigned int brick_size)
+  {
+    bricks.clear();
+    if (brick_size == 0)
+      return;
+
+    for (const auto& member : members)
+      bricks.push_back(std::make_unique<bricked_field>(member, brick_size, thread_count));
+  }
+
+  std::size_t ensemble_tracer::get_member_count() const
+  {
+    return members.size();
+  }
+
+  unsigned int ensemble_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  double ensemble_tracer::get_trace_time() const
+  {
+    return trace_time;
+  }
+
+  rk45_stats ensemble_tracer::get_rk45_stats() const
+  {
+    return rk45_trace_stats;
+  }
+
+  const work_stealing_scheduler& ensemble_tracer::get_scheduler() const
+  {
+    return scheduler;
+  }
+
+  template <typename Sampler>
+  void ensemble_tracer::trace_members(const std::vector<Sampler>& samplers, const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    const auto        seeds        = cpu_tracer::make_seeds(s_conf);
+    const std::size_t global_steps = i_conf.global_step_count;
+
+    if (seeds.empty() || members.empty())
+      return;
+
+    // The tiles of cpu_tracer, numbered member after member, so a thread's range covers as few members as possible
+    const seed_tiles  tiles(glm::uvec3(s_conf.seeds), s_conf.ordering, particle_batch<>::width);
+    const std::size_t member_chunks   = tiles.count();
+    const std::size_t chunk_count     = members.size() * member_chunks;
+    const std::size_t member_vertices = seeds.size() * global_steps;
+
+    std::vector<batch_stepper<>> steppers(thread_count, batch_stepper<>(i_conf));
+
+    scheduler.run(chunk_count, [&](unsigned int thread, std::size_t chunk)
+    {
+      const std::size_t member = chunk / member_chunks;
+
+      // A row holds at most one batch
+      tiles.for_rows(chunk % member_chunks, [&](std::size_t first, std::size_t n)
+      {
+        steppers[thread].trace(samplers[member], members[member], seeds.data(), nullptr, first, n, positions + member * member_vertices, velocities + member * member_vertices);
+      });
+    });
+
+    for (const auto& stepper : steppers)
+      rk45_trace_stats.add(stepper.stats);
+  }
+}
@@ -0,0 +1,509 @@
+#include <jay/integration/flow_map.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+
+namespace jay
+{
+  namespace
+  {
+    // Points per chunk of the scheduler
+    const std::size_t chunk_points = 64;
+
+    // Central differences (one-sided at the border), columns d/dx, d/dy, d/dz
+    glm::dmat3 gradient(const flow_map& map, std::size_t i, std::size_t j, std::size_t k)
+    {
+      glm::dmat3 g(1.0);
+
+      const std::size_t c[3] = { i, j, k };
+      for (int axis = 0; axis < 3; axis++)
+      {
+        const std::size_t n = map.dims[axis];
+        if (n < 2)
+          continue;
+
+        std::size_t lo[3] = { i, j, k };
+        std::size_t hi[3] = { i, j, k };
+        lo[axis] = (c[axis] > 0)     ? c[axis] - 1 : c[axis];
+        hi[axis] = (c[axis] + 1 < n) ? c[axis] + 1 : c[axis];
+
+        const glm::dvec3 d = glm::dvec3(map.node(hi[0], hi[1], hi[2])) - glm::dvec3(map.node(lo[0], lo[1], lo[2]));
+        g[axis] = d / (static_cast<double>(hi[axis] - lo[axis]) * map.node_stride);
+      }
+
+      return g;
+    }
+
+    // Largest eigenvalue of a symmetric 3x3 matrix (trigonometric solution)
+    double max_eigenvalue(const glm::dmat3& m)
+    {
+      const double p1 = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+      const double q  = (m[0][0] + m[1][1] + m[2][2]) / 3.0;
+      const double p2 = (m[0][0] - q) * (m[0][0] - q) + (m[1][1] - q) * (m[1][1] - q) + (m[2][2] - q) * (m[2][2] - q) + 2.0 * p1;
+
+      if (p2 <= 0.0)
+        return q;
+
+      const double     p = std::sqrt(p2 / 6.0);
+      const glm::dmat3 b = (m - q * glm::dmat3(1.0)) / p;
+      const double     r = glm::clamp(glm::determinant(b) / 2.0, -1.0, 1.0);
+
+      return q + 2.0 * p * std::cos(std::acos(r) / 3.0);
+    }
+
+    // Position in nodes & the lower node of its cell (the last cell for positions on the upper border)
+    glm::vec3 node_position(const flow_map& map, const glm::vec3& pos, glm::uvec3& lower)
+    {
+      const glm::vec3 q = glm::clamp(pos / map.node_stride, glm::vec3(0.0f), glm::vec3(map.dims) - 1.0f);
+      lower = glm::min(glm::uvec3(q), map.cell_dims() - 1u);
+      return q;
+    }
+  }
+
+
+  glm::vec3 flow_map::operator()(const glm::vec3& pos) const
+  {
+    glm::uvec3       i0;
+    const glm::vec3  q  = node_position(*this, pos, i0);
+    const glm::uvec3 i1 = glm::min(i0 + 1u, dims - 1u);
+    const glm::vec3  f  = q - glm::vec3(i0);
+
+    const glm::vec3 c00 = glm::mix(node(i0.x, i0.y, i0.z), node(i1.x, i0.y, i0.z), f.x);
+    const glm::vec3 c10 = glm::mix(node(i0.x, i1.y, i0.z), node(i1.x, i1.y, i0.z), f.x);
+    const glm::vec3 c01 = glm::mix(node(i0.x, i0.y, i1.z), node(i1.x, i0.y, i1.z), f.x);
+    const glm::vec3 c11 = glm::mix(node(i0.x, i1.y, i1.z), node(i1.x, i1.y, i1.z), f.x);
+
+    return glm::mix(glm::mix(c00, c10, f.y), glm::mix(c01, c11, f.y), f.z);
+  }
+
+  glm::vec3 flow_map::node(std::size_t i, std::size_t j, std::size_t k) const
+  {
+    return positions[(k * dims.y + j) * dims.x + i];
+  }
+
+  float flow_map::stop_weight(const glm::vec3& pos) const
+  {
+    if (stopped.empty())
+      return 0.0f;
+
+    glm::uvec3       i0;
+    const glm::vec3  q = node_position(*this, pos, i0);
+    const glm::vec3  f = q - glm::vec3(i0);
+
+    float weight = 0.0f;
+    for (std::size_t corner = 0; corner < 8; corner++)
+    {
+      const glm::uvec3 c(corner & 1, (corner >> 1) & 1, corner >> 2);
+      const glm::uvec3 n = glm::min(i0 + c, dims - 1u);
+      const glm::vec3  w = glm::mix(1.0f - f, f, glm::vec3(c));
+
+      if (stopped[(static_cast<std::size_t>(n.z) * dims.y + n.y) * dims.x + n.x])
+        weight += w.x * w.y * w.z;
+    }
+
+    return weight;
+  }
+
+  glm::uvec3 flow_map::cell_dims() const
+  {
+    return glm::max(dims, glm::uvec3(2)) - 1u;
+  }
+
+  std::size_t flow_map::cell(const glm::vec3& pos) const
+  {
+    glm::uvec3 c;
+    node_position(*this, pos, c);
+
+    const glm::uvec3 cells = cell_dims();
+    return (static_cast<std::size_t>(c.z) * cells.y + c.y) * cells.x + c.x;
+  }
+
+
+  flow_map_engine::flow_map_engine(const jaySrc<float>& src, unsigned int thread_count)
+    : src          { &src }
+    , grid         { src.grid.size() > 0 ? src.grid[0] : 1, src.grid.size() > 1 ? src.grid[1] : 1, src.grid.size() > 2 ? src.grid[2] : 1 }
+    , timesteps    { src.grid.size() > 3 ? src.grid[3] : 1 }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+    if (src.grid_dim < 4 || src.vec_len != 3 || src.ordering != Order::VectorFirst)
+      printf("Error: The flow map engine needs a 4D vectorlike ordered field with 3 components.\n");
+  }
+
+  void flow_map_engine::compute(const integration_conf& i_conf, unsigned int node_stride)
+  {
+    if (!batch_stepper<>::batched(i_conf.strategy))
+      throw std::invalid_argument("flow_map_engine: only Euler, RK4 and ABM4 are supported, got strategy " + std::to_string(i_conf.strategy));
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    conf      = i_conf;
+    stride    = std::max(1U, node_stride);
+    node_dims = (grid - 1u) / stride + 1u;
+
+    const std::size_t intervals = get_interval_count();
+    const auto        points    = nodes();
+
+    // Cell centers, to measure the interpolation error
+    std::vector<glm::vec4> samples;
+    const glm::uvec3 cells = glm::max(node_dims, glm::uvec3(2)) - 1u;
+    for (std::size_t k = 0; k < cells.z; k++)
+      for (std::size_t j = 0; j < cells.y; j++)
+        for (std::size_t i = 0; i < cells.x; i++)
+        {
+          const glm::vec3 center = (glm::vec3(i, j, k) + 0.5f) * static_cast<float>(stride);
+          samples.push_back(glm::vec4(glm::min(center, glm::vec3(grid - 1u)), 1.0f));
+        }
+
+    maps.assign(intervals, flow_map());
+    std::vector<std::vector<glm::vec3>> sample_ends(intervals, std::vector<glm::vec3>(samples.size()));
+    for (auto& map : maps)
+    {
+      map.dims        = node_dims;
+      map.node_stride = static_cast<float>(stride);
+      map.positions.resize(points.size());
+      map.stopped  .assign(points.size(), 0);
+    }
+
+    // Sub-interval after sub-interval, so the chunks of a thread stay on the same timesteps
+    const std::size_t node_chunks     = (points .size() + chunk_points - 1) / chunk_points;
+    const std::size_t sample_chunks   = (samples.size() + chunk_points - 1) / chunk_points;
+    const std::size_t interval_chunks = node_chunks + sample_chunks;
+
+    scheduler.run(intervals * interval_chunks, [&](unsigned int, std::size_t chunk)
+    {
+      const std::size_t t = chunk / interval_chunks;
+      const std::size_t c = chunk % interval_chunks;
+
+      if (c < node_chunks)
+      {
+        const std::size_t first = c * chunk_points;
+        advect(t, points.data() + first, std::min(chunk_points, points.size() - first), maps[t].positions.data() + first, maps[t].stopped.data() + first);
+      }
+      else
+      {
+        const std::size_t first = (c - node_chunks) * chunk_points;
+        advect(t, samples.data() + first, std::min(chunk_points, samples.size() - first), sample_ends[t].data() + first);
+      }
+    });
+
+    cell_errors         .assign(intervals, std::vector<float>(samples.size()));
+    cell_lipschitz      .assign(intervals, std::vector<float>(samples.size()));
+    interpolation_errors.assign(intervals, 0.0);
+    lipschitz           .assign(intervals, 0.0);
+
+    scheduler.run(intervals, [&](unsigned int, std::size_t t)
+    {
+      const auto& map = maps[t];
+
+      std::vector<float> node_lipschitz(points.size());
+      for (std::size_t k = 0; k < node_dims.z; k++)
+        for (std::size_t j = 0; j < node_dims.y; j++)
+          for (std::size_t i = 0; i < node_dims.x; i++)
+          {
+            const glm::dmat3 g = gradient(map, i, j, k);
+            node_lipschitz[(k * node_dims.y + j) * node_dims.x + i] = static_cast<float>(std::sqrt(glm::dot(g[0], g[0]) + glm::dot(g[1], g[1]) + glm::dot(g[2], g[2])));
+          }
+
+      std::vector<float> center_errors(samples.size());
+      for (std::size_t c = 0; c < samples.size(); c++)
+        center_errors[c] = glm::distance(map(glm::vec3(samples[c])), sample_ends[t][c]);
+
+      std::size_t c = 0;
+      for (std::size_t k = 0; k < cells.z; k++)
+        for (std::size_t j = 0; j < cells.y; j++)
+          for (std::size_t i = 0; i < cells.x; i++, c++)
+          {
+            // The error varies within a cell, take the largest one measured in the neighbourhood
+            float error = 0.0f;
+            for (std::size_t z = (k > 0 ? k - 1 : k); z <= std::min<std::size_t>(k + 1, cells.z - 1); z++)
+              for (std::size_t y = (j > 0 ? j - 1 : j); y <= std::min<std::size_t>(j + 1, cells.y - 1); y++)
+                for (std::size_t x = (i > 0 ? i - 1 : i); x <= std::min<std::size_t>(i + 1, cells.x - 1); x++)
+                  error = std::max(error, center_errors[(z * cells.y + y) * cells.x + x]);
+
+            float l    = 0.0f;
+            bool  stop = false;
+
+            glm::vec3 lo(std::numeric_limits<float>::max());
+            glm::vec3 hi(std::numeric_limits<float>::lowest());
+            for (std::size_t corner = 0; corner < 8; corner++)
+            {
+              const glm::uvec3  n  = glm::min(glm::uvec3(i + (corner & 1), j + ((corner >> 1) & 1), k + (corner >> 2)), node_dims - 1u);
+              const std::size_t id = (static_cast<std::size_t>(n.z) * node_dims.y + n.y) * node_dims.x + n.x;
+
+              l     = std::max(l, node_lipschitz[id]);
+              stop |= (map.stopped[id] != 0);
+              lo    = glm::min(lo, map.positions[id]);
+              hi    = glm::max(hi, map.positions[id]);
+            }
+
+            // The map bends between stopped & moving corners, somewhere inside of the cell
+            if (stop)
+              error = std::max(error, glm::distance(lo, hi));
+
+            cell_errors   [t][c] = error;
+            cell_lipschitz[t][c] = l;
+          }
+
+      interpolation_errors[t] = *std::max_element(cell_errors   [t].begin(), cell_errors   [t].end());
+      lipschitz           [t] = *std::max_element(cell_lipschitz[t].begin(), cell_lipschitz[t].end());
+    });
+
+    auto end = std::chrono::high_resolution_clock::now();
+    compute_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  flow_map flow_map_engine::compose(std::size_t first, std::size_t length) const
+  {
+    if (length == 0 || first + length > maps.size())
+    {
+      printf("Error: The window [%zu, %zu] is not covered by the %zu computed sub-intervals.\n", first, first + length, maps.size());
+      return flow_map();
+    }
+
+    auto map = compose_maps(first, length);
+    if (tolerance > 0.0 && map.error_bound > tolerance)
+      return trace(first, length);
+
+    return map;
+  }
+
+  flow_map flow_map_engine::trace(std::size_t first, std::size_t length) const
+  {
+    flow_map map;
+    if (length == 0 || first + length > maps.size())
+    {
+      printf("Error: The window [%zu, %zu] is not covered by the %zu computed sub-intervals.\n", first, first + length, maps.size());
+      return map;
+    }
+
+    map.dims        = node_dims;
+    map.node_stride = static_cast<float>(stride);
+    map.positions.resize(static_cast<std::size_t>(node_dims.x) * node_dims.y * node_dims.z);
+    map.stopped  .assign(map.positions.size(), 0);
+
+    // Particles that left the domain stay stopped in the following sub-intervals
+    auto points = nodes();
+    for (std::size_t t = first; t < first + length; t++)
+    {
+      scheduler.run((points.size() + chunk_points - 1) / chunk_points, [&](unsigned int, std::size_t chunk)
+      {
+        const std::size_t begin = chunk * chunk_points;
+        advect(t, points.data() + begin, std::min(chunk_points, points.size() - begin), map.positions.data() + begin, map.stopped.data() + begin);
+      });
+
+      for (std::size_t n = 0; n < points.size(); n++)
+        points[n] = glm::vec4(map.positions[n], 1.0f);
+    }
+
+    return map;
+  }
+
+  double flow_map_engine::error_bound(std::size_t first, std::size_t length) const
+  {
+    if (length == 0 || first + length > maps.size())
+      return 0.0;
+
+    return compose_maps(first, length).error_bound;
+  }
+
+  std::vector<float> flow_map_engine::ftle(const flow_map& map, float integration_time)
+  {
+    std::vector<float> result(map.positions.size(), 0.0f);
+    if (integration_time == 0.0f)
+      return result;
+
+    for (std::size_t k = 0; k < map.dims.z; k++)
+      for (std::size_t j = 0; j < map.dims.y; j++)
+        for (std::size_t i = 0; i < map.dims.x; i++)
+        {
+          // Right Cauchy-Green tensor
+          const glm::dmat3 g      = gradient(map, i, j, k);
+          const double     lambda = max_eigenvalue(glm::transpose(g) * g);
+
+          if (lambda > 0.0)
+            result[(k * map.dims.y + j) * map.dims.x + i] = static_cast<float>(std::log(std::sqrt(lambda)) / std::abs(integration_time));
+        }
+
+    return result;
+  }
+
+  std::vector<float> flow_map_engine::ftle(std::size_t first, std::size_t length) const
+  {
+    return ftle(compose(first, length), static_cast<float>(length * conf.local_step_count) * conf.step_size_h);
+  }
+
+  std::vector<std::vector<float>> flow_map_engine::sliding_ftle(std::size_t length) const
+  {
+    std::vector<std::vector<float>> result;
+    for (std::size_t first = 0; length > 0 && first + length <= maps.size(); first++)
+      result.push_back(ftle(first, length));
+    return result;
+  }
+
+  void flow_map_engine::set_error_tolerance(double tolerance)
+  {
+    this->tolerance = tolerance;
+  }
+
+  double flow_map_engine::get_error_tolerance() const
+  {
+    return tolerance;
+  }
+
+  std::size_t flow_map_engine::get_interval_count() const
+  {
+    return (timesteps > 1) ? timesteps - 1 : 0;
+  }
+
+  glm::uvec3 flow_map_engine::get_node_dims() const
+  {
+    return node_dims;
+  }
+
+  double flow_map_engine::get_interpolation_error(std::size_t t) const
+  {
+    return interpolation_errors[t];
+  }
+
+  double flow_map_engine::get_lipschitz(std::size_t t) const
+  {
+    return lipschitz[t];
+  }
+
+  unsigned int flow_map_engine::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  double flow_map_engine::get_compute_time() const
+  {
+    return compute_time;
+  }
+
+  field_view flow_map_engine::slice(std::size_t t) const
+  {
+    return field_view(src->data.data() + t * grid.x * grid.y * grid.z * 3, static_cast<int>(grid.x), static_cast<int>(grid.y), static_cast<int>(grid.z));
+  }
+
+  flow_map flow_map_engine::compose_maps(std::size_t first, std::size_t length) const
+  {
+    flow_map map = maps[first];
+    map.composed = (length > 1);
+    map.errors.assign(map.positions.size(), 0.0f);
+
+    const std::size_t count = map.positions.size();
+    scheduler.run((count + chunk_points - 1) / chunk_points, [&](unsigned int, std::size_t chunk)
+    {
+      const std::size_t end = std::min(count, (chunk + 1) * chunk_points);
+      for (std::size_t n = chunk * chunk_points; n < end; n++)
+      {
+        // The first map is exact at the nodes, stopped paths stay where they left the domain
+        auto& p         = map.positions[n];
+        auto& stop      = map.stopped[n];
+        bool  uncertain = false;
+        float error     = 0.0f;
+        for (std::size_t t = first + 1; t < first + length && !(stop && !uncertain); t++)
+        {
+          const std::size_t c    = maps[t].cell(p);
+          const glm::vec3   next = maps[t](p);
+
+          error = cell_lipschitz[t][c] * error + cell_errors[t][c];
+          if (uncertain)
+            error += glm::distance(next, p);
+
+          if (stop)
+            continue;
+
+          const float weight = maps[t].stop_weight(p);
+          uncertain |= (weight > 0.0f && weight < 1.0f);
+          stop       = (weight >= 0.5f);
+          p          = next;
+        }
+        map.errors[n] = error;
+      }
+    });
+
+    map.error_bound = *std::max_element(map.errors.begin(), map.errors.end());
+    return map;
+  }
+
+  void flow_map_engine::advect(std::size_t t, const glm::vec4* points, std::size_t n, glm::vec3* ends, std::uint8_t* stopped) const
+  {
+    const auto slice_t0 = slice(t + 0);
+    const auto slice_t1 = slice(t + 1);
+
+    if (conf.texelfetch)
+      advect(time_interpolated_sampler<trilinear_sampler>(slice_t0, slice_t1), slice_t0, points, n, ends, stopped);
+    else
+      advect(time_interpolated_sampler<texture_sampler>  (slice_t0, slice_t1), slice_t0, points, n, ends, stopped);
+  }
+
+  template <typename Sampler>
+  void flow_map_engine::advect(const Sampler& sampler, const field_view& bounds, const glm::vec4* points, std::size_t n, glm::vec3* ends, std::uint8_t* stopped) const
+  {
+    const float       h       = conf.step_size_h;
+    const float       rel_dt  = (conf.local_step_count > 0) ? 1.0f / conf.local_step_count : 0.0f;
+    const std::size_t steps   = conf.local_step_count;
+    const glm::vec3   max_pos = glm::vec3(grid - 1u);
+    const std::size_t width   = particle_batch<>::width;
+
+    batch_stepper<> stepper(conf);
+    auto&           batch = stepper.batch;
+    for (std::size_t s = 0; s < n; s += width)
+    {
+      // Stopped particles sit on the border (inside of the domain), they're loaded outside so they don't move again
+      glm::vec4 batch_points[width];
+      for (std::size_t l = 0; l < width && s + l < n; l++)
+        batch_points[l] = (stopped && stopped[s + l]) ? glm::vec4(-1.0f) : points[s + l];
+
+      stepper.load(batch_points, n - s);
+
+      // Interpolation factor of the 2 timesteps, particles outside of the domain stop
+      float local_time = 0.0f;
+      for (std::size_t i = 0; i < steps && stepper.step(sampler, bounds, local_time, rel_dt); i++)
+        local_time += rel_dt;
+
+      // The velocity of the last step moves the particle at the beginning of the next sub-interval, take that position
+      batch.update_alive(bounds);
+      for (std::size_t l = 0; l < batch.count; l++)
+      {
+        if (stopped && stopped[s + l])
+        {
+          ends[s + l] = glm::vec3(points[s + l]);
+          continue;
+        }
+
+        glm::vec3 p(batch.x[l], batch.y[l], batch.z[l]);
+        if (batch.alive[l])
+          p += h * glm::vec3(batch.vx[l], batch.vy[l], batch.vz[l]);
+
+        ends[s + l] = glm::clamp(p, glm::vec3(0.0f), max_pos);
+        if (stopped)
+          stopped[s + l] = !batch.alive[l];
+      }
+    }
+  }
+
+  std::vector<glm::vec4> flow_map_engine::nodes() const
+  {
+    std::vector<glm::vec4> points;
+    points.reserve(static_cast<std::size_t>(node_dims.x) * node_dims.y * node_dims.z);
+
+    for (std::size_t k = 0; k < node_dims.z; k++)
+      for (std::size_t j = 0; j < node_dims.y; j++)
+        for (std::size_t i = 0; i < node_dims.x; i++)
+          points.push_back(glm::vec4(glm::vec3(i, j, k) * static_cast<float>(stride), 1.0f));
+
+    return points;
+  }
+}
@@ -0,0 +1,210 @@
+#include <jay/integration/lockstep_tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <jay/integration/batch_stepper.hpp>
+#include <jay/integration/seed_order.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+
+namespace jay
+{
+  void divergence_summary::print() const
+  {
+    printf("Divergence: mean distance %.6f (max %.6f, final %.6f), mean area %.6f (total %.6f), mean velocity error %.6f, %zu diverged seeds\n",
+      mean_distance, max_distance, mean_final_distance, mean_area, total_area, mean_velocity_error, diverged_seeds);
+  }
+
+
+  lockstep_tracer::lockstep_tracer(const jaySrc<float>& reference, const jaySrc<float>& other, unsigned int thread_count)
+    : reference    { reference }
+    , other        { other }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  { }
+
+  lockstep_tracer::lockstep_tracer(const jaySrc<float>& reference, const astc_field& other, unsigned int thread_count, std::size_t cache_blocks)
+    : reference    { reference }
+    , other        { other.view() }
+    , other_astc   { &other }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+    , scheduler    { this->thread_count }
+  {
+    for (unsigned int t = 0; t < this->thread_count; t++)
+      caches.push_back(std::make_unique<astc_block_cache>(other, cache_blocks));
+  }
+
+  lockstep_result lockstep_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, float divergence_threshold, bool keep_trajectories) const
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    lockstep_result result;
+
+    if (i_conf.strategy == StrategyRK45)
+    {
+      printf("Error: Lockstep tracing needs fixed steps (Euler, RK4 or ABM4).\n");
+      return result;
+    }
+
+    result.seeds.resize(cpu_tracer::seed_count(s_conf));
+
+    if (keep_trajectories)
+    {
+      for (auto* traces : { &result.reference, &result.other })
+      {
+        traces->seed_count = result.seeds.size();
+        traces->step_count = i_conf.global_step_count;
+        traces->positions .resize(traces->seed_count * traces->step_count, glm::vec4(0.0f));
+        traces->velocities.resize(traces->seed_count * traces->step_count, glm::vec4(0.0f));
+      }
+    }
+
+    auto make_reference = [&](unsigned int) { return trilinear_sampler(reference); };
+    auto make_texture   = [&](unsigned int) { return texture_sampler(reference); };
+
+    if (other_astc)
+    {
+      auto make_other = [&](unsigned int thread) { return astc_sampler(*other_astc, *caches[thread]); };
+      if (i_conf.texelfetch)
+        trace_pairs(make_reference, make_other, s_conf, i_conf, divergence_threshold, result);
+      else
+        trace_pairs(make_texture,   make_other, s_conf, i_conf, divergence_threshold, result);
+    }
+    else if (i_conf.texelfetch)
+      trace_pairs(make_reference, [&](unsigned int) { return trilinear_sampler(other); }, s_conf, i_conf, divergence_threshold, result);
+    else
+      trace_pairs(make_texture,   [&](unsigned int) { return texture_sampler(other);   }, s_conf, i_conf, divergence_threshold, result);
+
+    // Summary over all seeds
+    auto& summary = result.summary;
+    for (const auto& s : result.seeds)
+    {
+      summary.mean_distance       += s.mean_distance;
+      summary.max_distance         = std::max(summary.max_distance, s.max_distance);
+      summary.mean_final_distance += s.final_distance;
+      summary.total_area          += s.area;
+      summary.mean_velocity_error += s.mean_velocity_error;
+      summary.diverged_seeds      += (s.max_distance > divergence_threshold) ? 1 : 0;
+    }
+
+    if (!result.seeds.empty())
+    {
+      const double n = static_cast<double>(result.seeds.size());
+      summary.mean_distance       /= n;
+      summary.mean_final_distance /= n;
+      summary.mean_area            = summary.total_area / n;
+      summary.mean_velocity_error /= n;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+  }
+
+  unsigned int lockstep_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  double lockstep_tracer::get_trace_time() const
+  {
+    return trace_time;
+  }
+
+  template <typename MakeReferenceSampler, typename MakeOtherSampler>
+  void lockstep_tracer::trace_pairs(const MakeReferenceSampler& make_reference, const MakeOtherSampler& make_other, const seeding_conf& s_conf, const integration_conf& i_conf, float divergence_threshold, lockstep_result& result) const
+  {
+    const auto        seeds         = cpu_tracer::make_seeds(s_conf);
+    const auto        order         = seed_order(s_conf);
+    const std::size_t global_steps  = i_conf.global_step_count;
+    const std::size_t local_steps   = std::min<std::size_t>(i_conf.local_step_count, global_steps);
+    const bool        keep          = !result.reference.positions.empty();
+
+    if (other_astc)
+      for (auto& cache : caches)
+        cache->clear();
+
+    // A chunk is a batch of seeds, neighbours along the seed order
+    const std::size_t width       = particle_batch<>::width;
+    const std::size_t chunk_count = (seeds.size() + width - 1) / width;
+
+    // Reference & other trace of each thread
+    std::vector<batch_stepper<>> reference_steppers(thread_count, batch_stepper<>(i_conf));
+    std::vector<batch_stepper<>> other_steppers    (thread_count, batch_stepper<>(i_conf));
+
+    scheduler.run(chunk_count, [&](unsigned int thread, std::size_t chunk)
+    {
+      const auto reference_sampler = make_reference(thread);
+      const auto other_sampler     = make_other(thread);
+      auto&      reference_stepper = reference_steppers[thread];
+      auto&      other_stepper     = other_steppers    [thread];
+
+      const std::size_t    first = chunk * width;
+      const std::size_t    n     = std::min(width, seeds.size() - first);
+      const std::uint32_t* index = &order[first];
+
+      reference_stepper.load(seeds.data(), index, n);
+      other_stepper    .load(seeds.data(), index, n);
+
+      seed_divergence divergence[particle_batch<>::width];
+      glm::dvec3      last_reference[particle_batch<>::width];
+      glm::dvec3      last_other    [particle_batch<>::width];
+      for (std::size_t l = 0; l < n; l++)
+        divergence[l].divergence_step = static_cast<std::uint32_t>(local_steps);
+
+      for (std::size_t i = 0; i < local_steps; i++)
+      {
+        // Particles outside of the domain are frozen
+        reference_stepper.step(reference_sampler, reference);
+        other_stepper    .step(other_sampler,     other);
+
+        const auto& a = reference_stepper.batch;
+        const auto& b = other_stepper    .batch;
+        for (std::size_t l = 0; l < n; l++)
+        {
+          const glm::dvec3 p0(a.x [l], a.y [l], a.z [l]);
+          const glm::dvec3 p1(b.x [l], b.y [l], b.z [l]);
+          const glm::dvec3 v0(a.vx[l], a.vy[l], a.vz[l]);
+          const glm::dvec3 v1(b.vx[l], b.vy[l], b.vz[l]);
+
+          auto&        d        = divergence[l];
+          const double distance = glm::distance(p0, p1);
+
+          d.mean_distance       += distance;
+          d.max_distance         = std::max(d.max_distance, distance);
+          d.final_distance       = distance;
+          d.mean_velocity_error += glm::distance(v0, v1);
+          if (distance > divergence_threshold && d.divergence_step == local_steps)
+            d.divergence_step = static_cast<std::uint32_t>(i);
+
+          // Quad of the last & this vertex of both traces (v0 / v2 reference, v1 / v3 other)
+          if (i > 0)
+            d.area += 0.5 * glm::length(glm::cross(p1 - last_reference[l], last_other[l] - p0));
+
+          last_reference[l] = p0;
+          last_other    [l] = p1;
+        }
+
+        if (keep)
+        {
+          a.store(result.reference.positions.data(), result.reference.velocities.data(), global_steps, i, index);
+          b.store(result.other    .positions.data(), result.other    .velocities.data(), global_steps, i, index);
+        }
+      }
+
+      for (std::size_t l = 0; l < n; l++)
+      {
+        auto& d = divergence[l];
+        if (local_steps > 0)
+        {
+          d.mean_distance       /= static_cast<double>(local_steps);
+          d.mean_velocity_error /= static_cast<double>(local_steps);
+        }
+        result.seeds[index[l]] = d;
+      }
+    });
+  }
+}
@@ -0,0 +1,246 @@
+#include <jay/integration/paged_tracer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <jay/integration/schemes.hpp>
+
+namespace jay
+{
+  void paged_trace_stats::print() const
+  {
+    printf("Paged trace: %.3f ms, %zu steps, %zu brick visits, %zu handoffs, %zu remote samples\n", trace_time, steps, brick_visits, handoffs, remote_samples);
+    printf("Paging: %zu loads (%.1f MB in %.3f ms), %zu hits, %zu evictions\n", paging.loads, paging.bytes / 1048576.0, paging.read_ms, paging.hits, paging.evictions);
+  }
+
+
+  paged_tracer::paged_tracer(paged_field& field, unsigned int thread_count)
+    : field        { field }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+  { }
+
+  cpu_trace_result paged_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf)
+  {
+    cpu_trace_result result;
+    result.seed_count = cpu_tracer::seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void paged_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities)
+  {
+    if (field.brick_count() == 0)
+    {
+      printf("Error: Paged field without bricks.\n");
+      return;
+    }
+
+    // Particles move from brick to brick one step at a time, which leaves no room for an adaptive step size or a multistep history
+    if (i_conf.strategy != StrategyEuler && i_conf.strategy != StrategyRK4)
+      throw std::invalid_argument("paged_tracer: only Euler and RK4 are supported, got strategy " + std::to_string(i_conf.strategy));
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const float       h             = i_conf.step_size_h;
+    const float       vector_factor = i_conf.dataset_factor;
+    const glm::vec4   cf            = cell_factor(i_conf.cell_size);
+    const std::size_t global_steps  = i_conf.global_step_count;
+    const std::size_t local_steps   = std::min<std::size_t>(i_conf.local_step_count, global_steps);
+    const bool        euler         = (i_conf.strategy == StrategyEuler);
+    const field_view  bounds(nullptr, field.grid.x, field.grid.y, field.grid.z);
+
+    // State of every particle: position, velocity & steps done
+    std::vector<glm::vec4>   p = cpu_tracer::make_seeds(s_conf);
+    std::vector<glm::vec4>   v(p.size(), glm::vec4(0.0f));
+    std::vector<std::size_t> step(p.size(), 0);
+
+    stats = paged_trace_stats();
+    field.reset_stats();
+
+    // Frozen particles repeat their state (like the batches of cpu_tracer)
+    auto finish = [&](std::uint32_t s)
+    {
+      for (auto i = step[s]; i < local_steps; i++)
+      {
+        positions [s * global_steps + i] = p[s];
+        velocities[s * global_steps + i] = v[s];
+      }
+      step[s] = local_steps;
+    };
+
+    // The next step samples around the advanced position
+    auto owner = [&](std::uint32_t s)
+    {
+      return field.brick_of(glm::vec3(p[s] + h * v[s]));
+    };
+
+    std::mutex              m;
+    std::condition_variable cv;
+    std::unordered_map<std::size_t, std::vector<std::uint32_t>> pending;
+    std::unordered_set<std::size_t> active;
+    std::size_t outstanding = 0;
+
+    for (std::uint32_t s = 0; s < p.size(); s++)
+    {
+      if (local_steps == 0 || !bounds.contains(glm::vec3(p[s])))
+      {
+        finish(s);
+        continue;
+      }
+      pending[owner(s)].push_back(s);
+      outstanding++;
+    }
+
+    // Queued brick that no thread is working on, resident ones first, then the most particles
+    auto pick = [&](std::size_t& brick)
+    {
+      bool        found    = false;
+      bool        resident = false;
+      std::size_t count    = 0;
+      for (const auto& queue : pending)
+      {
+        if (queue.second.empty() || active.count(queue.first))
+          continue;
+
+        const bool r = field.resident(queue.first);
+        if (!found || (r && !resident) || (r == resident && queue.second.size() > count))
+        {
+          found    = true;
+          resident = r;
+          count    = queue.second.size();
+          brick    = queue.first;
+        }
+      }
+      return found;
+    };
+
+    // Advances a particle inside of the brick, returns false if it has to move on to another brick
+    auto advance = [&](std::uint32_t s, std::size_t brick, const paged_sampler& sampler, std::size_t& steps)
+    {
+      while (step[s] < local_steps)
+      {
+        // Particles outside of the domain are frozen
+        if (!bounds.contains(glm::vec3(p[s])))
+        {
+          finish(s);
+          return true;
+        }
+
+        if (owner(s) != brick)
+          return false;
+
+        p[s] = p[s] + h * v[s];
+        v[s] = euler ? euler_velo(sampler, p[s], h, vector_factor, cf) : rk4_velo(sampler, p[s], h, vector_factor, cf);
+
+        positions [s * global_steps + step[s]] = p[s];
+        velocities[s * global_steps + step[s]] = v[s];
+        step[s]++;
+        steps++;
+      }
+      return true;
+    };
+
+    auto worker = [&]()
+    {
+      std::vector<std::uint32_t>                             particles;
+      std::vector<std::pair<std::size_t, std::uint32_t>>     moved;
+
+      while (true)
+      {
+        std::size_t brick = 0;
+        {
+          std::unique_lock<std::mutex> lock(m);
+          cv.wait(lock, [&]() { return outstanding == 0 || pick(brick); });
+          if (outstanding == 0)
+            return;
+
+          particles.clear();
+          particles.swap(pending[brick]);
+          active.insert(brick);
+          stats.brick_visits++;
+        }
+
+        const paged_sampler sampler(field, brick, field.acquire(brick));
+        std::size_t         steps = 0;
+
+        // Particles arriving while the brick is pinned are advanced before it's released
+        while (!particles.empty())
+        {
+          std::size_t done = 0;
+          for (auto s : particles)
+          {
+            if (advance(s, brick, sampler, steps))
+              done++;
+            else
+              moved.emplace_back(owner(s), s);
+          }
+
+          std::lock_guard<std::mutex> lock(m);
+          for (const auto& move : moved)
+            pending[move.first].push_back(move.second);
+
+          stats.handoffs += moved.size();
+          outstanding    -= done;
+          moved.clear();
+
+          particles.clear();
+          particles.swap(pending[brick]);
+          cv.notify_all();
+        }
+
+        field.release(brick);
+
+        {
+          std::lock_guard<std::mutex> lock(m);
+          // Particles queued after the last pass wait for the next visit
+          auto queue = pending.find(brick);
+          if (queue != pending.end() && queue->second.empty())
+            pending.erase(queue);
+          active.erase(brick);
+          stats.steps          += steps;
+          stats.remote_samples += sampler.remote;
+        }
+        cv.notify_all();
+      }
+    };
+
+    // One brick per thread, one spare slot for remote lookups
+    const auto workers = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(thread_count, field.capacity() - 1)));
+
+    std::vector<std::thread> threads(workers);
+    for (auto& thread : threads)
+      thread = std::thread(worker);
+    for (auto& thread : threads)
+      thread.join();
+
+    stats.paging = field.get_stats();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  unsigned int paged_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  const paged_trace_stats& paged_tracer::get_stats() const
+  {
+    return stats;
+  }
+}
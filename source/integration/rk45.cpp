@@ -0,0 +1,147 @@
+#include <jay/integration/rk45.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <jay/integration/cpu_tracer.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+
+namespace jay
+{
+  namespace
+  {
+    // Largest number of RK4 steps tried (per seed, as power of 2)
+    constexpr std::size_t rk4_max_refinement = 20;
+
+    // Calls f(i) for i < n, handing out single indices to thread_count threads
+    template <typename Function>
+    void parallel_for(std::size_t n, unsigned int thread_count, const Function& f)
+    {
+      std::atomic<std::size_t> next { 0 };
+
+      auto worker = [&]()
+      {
+        for (auto i = next.fetch_add(1); i < n; i = next.fetch_add(1))
+          f(i);
+      };
+
+      std::vector<std::thread> threads(std::min<std::size_t>(thread_count, std::max<std::size_t>(1, n)));
+      for (auto& thread : threads)
+        thread = std::thread(worker);
+      for (auto& thread : threads)
+        thread.join();
+    }
+
+    template <typename Sampler>
+    void compare(const Sampler& sampler, const field_view& field, const std::vector<glm::vec4>& seeds, const integration_conf& i_conf, unsigned int thread_count, rk45_report& report)
+    {
+      const std::size_t steps = std::max<std::size_t>(i_conf.global_step_count, 1);
+      const float       time  = (steps - 1) * i_conf.step_size_h;
+      const glm::vec4   cf    = cell_factor(i_conf.cell_size);
+
+      integration_conf rk45_conf = i_conf;
+      rk45_conf.resample_mode    = 1;
+      rk45_conf.resample_spacing = i_conf.step_size_h;
+
+      integration_conf reference_conf = rk45_conf;
+      reference_conf.tolerance     = i_conf.tolerance * 1e-3f;
+      reference_conf.step_size_min = i_conf.step_size_min * 1e-3f;
+
+      std::vector<glm::vec4>   reference  (seeds.size());
+      std::vector<double>      arc_length (seeds.size());
+      std::vector<double>      rk45_error (seeds.size());
+      std::vector<std::size_t> rk45_samples(seeds.size());
+
+      parallel_for(seeds.size(), thread_count, [&](std::size_t s)
+      {
+        std::vector<glm::vec4> positions(steps), velocities(steps);
+
+        arc_length[s] = rk45_advect(sampler, field, seeds[s], reference_conf, positions.data(), velocities.data(), steps).arc_length;
+        reference [s] = positions.back();
+
+        rk45_samples[s] = rk45_advect(sampler, field, seeds[s], rk45_conf, positions.data(), velocities.data(), steps).samples;
+        rk45_error  [s] = glm::distance(glm::vec3(positions.back()), glm::vec3(reference[s]));
+      });
+
+      report.seeds = seeds.size();
+      for (std::size_t s = 0; s < seeds.size(); s++)
+      {
+        report.arc_length   += arc_length[s];
+        report.rk45_error    = std::max(report.rk45_error, rk45_error[s]);
+        report.rk45_samples += rk45_samples[s];
+      }
+
+      // Coarsest RK4 (1, 2, 4, .. steps to the same time) that is at least as accurate
+      std::vector<double>      rk4_error  (seeds.size());
+      std::vector<std::size_t> rk4_samples(seeds.size());
+      for (std::size_t r = 0; r <= rk4_max_refinement; r++)
+      {
+        const std::size_t rk4_steps = std::size_t(1) << r;
+        const float       h         = time / rk4_steps;
+
+        parallel_for(seeds.size(), thread_count, [&](std::size_t s)
+        {
+          auto pos = seeds[s];
+          rk4_samples[s] = 0;
+
+          // Frozen outside of the domain
+          for (std::size_t i = 0; i < rk4_steps && field.contains(glm::vec3(pos)); i++)
+          {
+            pos += h * rk4_velo(sampler, pos, h, i_conf.dataset_factor, cf);
+            rk4_samples[s] += 4;
+          }
+
+          rk4_error[s] = glm::distance(glm::vec3(pos), glm::vec3(reference[s]));
+        });
+
+        report.rk4_steps   = rk4_steps;
+        report.rk4_error   = *std::max_element(rk4_error.begin(), rk4_error.end());
+        report.rk4_samples = 0;
+        for (auto samples : rk4_samples)
+          report.rk4_samples += samples;
+
+        if (report.rk4_error <= report.rk45_error)
+          break;
+      }
+    }
+  }
+
+  rk45_report compare_rk45_rk4(const jaySrc<float>& src, const seeding_conf& s_conf, const integration_conf& i_conf, unsigned int thread_count)
+  {
+    const field_view field(src);
+    const auto       seeds = cpu_tracer::make_seeds(s_conf);
+
+    rk45_report report;
+    if (seeds.empty())
+      return report;
+
+    thread_count = (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency());
+
+    if (i_conf.texelfetch)
+      compare(trilinear_sampler(field), field, seeds, i_conf, thread_count, report);
+    else
+      compare(texture_sampler(field), field, seeds, i_conf, thread_count, report);
+
+    return report;
+  }
+
+  double rk45_report::rk45_samples_per_length() const
+  {
+    return (arc_length > 0.0) ? rk45_samples / arc_length : 0.0;
+  }
+
+  double rk45_report::rk4_samples_per_length() const
+  {
+    return (arc_length > 0.0) ? rk4_samples / arc_length : 0.0;
+  }
+
+  void rk45_report::print() const
+  {
+    printf("RK45 vs. RK4 at equal error: %zu seeds, arc length %.2f\n", seeds, arc_length);
+    printf("  RK45: error %.3e, %zu samples (%.2f per unit length)\n", rk45_error, rk45_samples, rk45_samples_per_length());
+    printf("  RK4 (%zu steps): error %.3e, %zu samples (%.2f per unit length)\n", rk4_steps, rk4_error, rk4_samples, rk4_samples_per_length());
+  }
+}
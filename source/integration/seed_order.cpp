@@ -0,0 +1,169 @@
+#include <jay/integration/seed_order.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace jay
+{
+  namespace
+  {
+    // Spreads the lower 21 bits, 2 zero bits between each
+    std::uint64_t spread_bits(std::uint64_t v)
+    {
+      v &= 0x1fffff;
+      v = (v | (v << 32)) & 0x1f00000000ffffULL;
+      v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+      v = (v | (v << 8))  & 0x100f00f00f00f00fULL;
+      v = (v | (v << 4))  & 0x10c30c30c30c30c3ULL;
+      v = (v | (v << 2))  & 0x1249249249249249ULL;
+      return v;
+    }
+
+    // Bits needed for the largest coordinate
+    unsigned int curve_bits(const std::vector<glm::uvec3>& cells)
+    {
+      std::uint32_t max = 1;
+      for (const auto& c : cells)
+        max = std::max(max, std::max(c.x, std::max(c.y, c.z)));
+
+      unsigned int bits = 1;
+      while (bits < 21 && (max >> bits) > 0)
+        bits++;
+      return bits;
+    }
+  }
+
+  std::uint64_t morton_key(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+  {
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+  }
+
+  std::uint64_t hilbert_key(std::uint32_t x, std::uint32_t y, std::uint32_t z, unsigned int bits)
+  {
+    // J. Skilling, Programming the Hilbert curve (2004): axes to transposed key
+    std::uint32_t X[3] = { x, y, z };
+    const std::uint32_t M = 1U << (bits - 1);
+
+    // Inverse undo
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      const std::uint32_t P = Q - 1;
+      for (int i = 0; i < 3; i++)
+      {
+        if (X[i] & Q)
+          X[0] ^= P;
+        else
+        {
+          const std::uint32_t t = (X[0] ^ X[i]) & P;
+          X[0] ^= t;
+          X[i] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for (int i = 1; i < 3; i++)
+      X[i] ^= X[i - 1];
+
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+      if (X[2] & Q)
+        t ^= Q - 1;
+
+    for (int i = 0; i < 3; i++)
+      X[i] ^= t;
+
+    // Transposed key to a single number (most significant bit of x first)
+    std::uint64_t key = 0;
+    for (int b = static_cast<int>(bits) - 1; b >= 0; b--)
+      for (int i = 0; i < 3; i++)
+        key = (key << 1) | ((X[i] >> b) & 1);
+
+    return key;
+  }
+
+  std::vector<std::uint32_t> curve_order(const std::vector<glm::uvec3>& cells, gl::GLuint ordering)
+  {
+    std::vector<std::uint32_t> order(cells.size());
+    std::iota(order.begin(), order.end(), 0U);
+
+    if (ordering == SeedOrderGrid)
+      return order;
+
+    const auto bits = curve_bits(cells);
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(cells.size());
+    for (std::size_t i = 0; i < cells.size(); i++)
+    {
+      const auto& c = cells[i];
+      keys[i].first  = (ordering == SeedOrderHilbert) ? hilbert_key(c.x, c.y, c.z, bits) : morton_key(c.x, c.y, c.z);
+      keys[i].second = static_cast<std::uint32_t>(i);
+    }
+
+    // Unique second => same result as a stable sort by key
+    std::sort(keys.begin(), keys.end());
+
+    for (std::size_t i = 0; i < keys.size(); i++)
+      order[i] = keys[i].second;
+
+    return order;
+  }
+
+  std::vector<std::uint32_t> seed_order(const seeding_conf& s_conf)
+  {
+    return grid_order(glm::uvec3(s_conf.seeds), s_conf.ordering);
+  }
+
+  std::vector<std::uint32_t> grid_order(const glm::uvec3& dims, gl::GLuint ordering)
+  {
+    std::vector<glm::uvec3> cells;
+    cells.reserve(static_cast<std::size_t>(dims.x) * dims.y * dims.z);
+
+    for (std::uint32_t z = 0; z < dims.z; z++)
+      for (std::uint32_t y = 0; y < dims.y; y++)
+        for (std::uint32_t x = 0; x < dims.x; x++)
+          cells.emplace_back(x, y, z);
+
+    return curve_order(cells, ordering);
+  }
+
+  std::vector<std::uint32_t> position_order(const glm::vec4* positions, std::size_t stride, const std::vector<std::uint32_t>& index, const glm::vec3& grid, gl::GLuint ordering)
+  {
+    if (ordering == SeedOrderGrid)
+      return index;
+
+    // Same cell size in all directions, the longest axis gets 1024 cells
+    const float longest = std::max(grid.x, std::max(grid.y, grid.z));
+    const float scale   = (longest > 0.0f) ? 1023.0f / longest : 0.0f;
+    const auto  cells_max = glm::uvec3(glm::max(grid * scale, glm::vec3(0.0f)));
+
+    std::vector<glm::uvec3> cells(index.size());
+    for (std::size_t i = 0; i < index.size(); i++)
+    {
+      const glm::vec3 p = glm::vec3(positions[index[i] * stride]) * scale;
+      cells[i] = glm::min(glm::uvec3(glm::max(p, glm::vec3(0.0f))), cells_max);
+    }
+
+    const auto order = curve_order(cells, ordering);
+
+    std::vector<std::uint32_t> result(index.size());
+    for (std::size_t i = 0; i < index.size(); i++)
+      result[i] = index[order[i]];
+
+    return result;
+  }
+
+
+  seed_tiles::seed_tiles(const glm::uvec3& dims, gl::GLuint ordering, unsigned int row_width)
+    : dims  { dims }
+    , tile  { row_width, 4, 2 }
+    , tiles { (dims + tile - 1U) / tile }
+    , order { grid_order(tiles, ordering) }
+  { }
+
+  std::size_t seed_tiles::count() const
+  {
+    return order.size();
+  }
+}
@@ -0,0 +1,303 @@
+#include <jay/integration/trace_cache.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace jay
+{
+  namespace
+  {
+    // FNV-1a
+    struct hasher
+    {
+      std::uint64_t value = 14695981039346656037ULL;
+
+      template <typename T>
+      void add(const T& v)
+      {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        for (auto b : bytes)
+        {
+          value ^= b;
+          value *= 1099511628211ULL;
+        }
+      }
+
+      // Word by word, bulk data would take too long byte by byte
+      void add_words(const void* data, std::size_t byte_size)
+      {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+
+        std::size_t i = 0;
+        for (std::uint64_t word; i + sizeof(word) <= byte_size; i += sizeof(word))
+        {
+          std::memcpy(&word, bytes + i, sizeof(word));
+          value ^= word;
+          value *= 1099511628211ULL;
+        }
+        for (; i < byte_size; i++)
+          add(bytes[i]);
+      }
+    };
+  }
+
+  double trace_cache_stats::hit_rate() const
+  {
+    return (hits + misses > 0) ? static_cast<double>(hits) / (hits + misses) : 0.0;
+  }
+
+
+  bool trace_cache::key::operator==(const key& other) const
+  {
+    return field == other.field && params == other.params && seed == other.seed;
+  }
+
+  std::size_t trace_cache::key_hash::operator()(const key& k) const
+  {
+    hasher h;
+    h.add(k.field);
+    h.add(k.params);
+    h.add(k.seed.x);
+    h.add(k.seed.y);
+    h.add(k.seed.z);
+    return static_cast<std::size_t>(h.value);
+  }
+
+
+  trace_cache::trace_cache(std::size_t budget_bytes)
+    : budget { budget_bytes }
+  { }
+
+  std::uint64_t trace_cache::params_id(const integration_conf& i_conf)
+  {
+    hasher h;
+    h.add(i_conf.strategy);
+    h.add(i_conf.texelfetch);
+    h.add(i_conf.grid.x);
+    h.add(i_conf.grid.y);
+    h.add(i_conf.grid.z);
+    h.add(i_conf.grid.w);
+    h.add(i_conf.cell_size.x);
+    h.add(i_conf.cell_size.y);
+    h.add(i_conf.cell_size.z);
+    h.add(i_conf.cell_size.w);
+    h.add(i_conf.step_size_h);
+    h.add(i_conf.step_size_dt);
+    h.add(i_conf.dataset_factor);
+    h.add(i_conf.global_step_count);
+    h.add(i_conf.local_step_count);
+    h.add(i_conf.remainder_step_count);
+    h.add(i_conf.tolerance);
+    h.add(i_conf.step_size_min);
+    h.add(i_conf.step_size_max);
+    h.add(i_conf.resample_mode);
+    h.add(i_conf.resample_spacing);
+    return h.value;
+  }
+
+  std::uint64_t trace_cache::params_id(const integration_conf& i_conf, std::uint64_t variant)
+  {
+    hasher h;
+    h.value = params_id(i_conf);
+    h.add(variant);
+    return h.value;
+  }
+
+  std::uint64_t trace_cache::field_id(const jaySrc<float>& src)
+  {
+    hasher h;
+    for (auto g : src.grid)
+      h.add(g);
+    h.add(src.grid_dim);
+    h.add(src.vec_len);
+    h.add(src.ordering);
+    h.add_words(src.data.data(), src.data.size() * sizeof(float));
+
+    // 0 means "no id" for the tracers
+    return (h.value != 0) ? h.value : 1;
+  }
+
+  const trace_cache::entry* trace_cache::find(const key& k)
+  {
+    auto it = entries.find(k);
+    if (it == entries.end())
+    {
+      stats.misses++;
+      return nullptr;
+    }
+
+    // Most recently used
+    lru.splice(lru.begin(), lru, it->second);
+    stats.hits++;
+    return &it->second->second;
+  }
+
+  void trace_cache::insert(const key& k, const glm::vec4* positions, const glm::vec4* velocities, std::size_t steps)
+  {
+    const std::size_t entry_bytes = 2 * steps * sizeof(glm::vec4);
+
+    auto it = entries.find(k);
+    if (it != entries.end())
+    {
+      bytes -= 2 * it->second->second.positions.size() * sizeof(glm::vec4);
+      lru.erase(it->second);
+      entries.erase(it);
+    }
+
+    if (entry_bytes > budget)
+      return;
+
+    evict(budget - entry_bytes);
+
+    lru.emplace_front();
+    lru.front().first = k;
+    lru.front().second.positions .assign(positions,  positions  + steps);
+    lru.front().second.velocities.assign(velocities, velocities + steps);
+    entries[k] = lru.begin();
+    bytes     += entry_bytes;
+  }
+
+  std::size_t trace_cache::size() const
+  {
+    return entries.size();
+  }
+
+  std::size_t trace_cache::byte_size() const
+  {
+    return bytes;
+  }
+
+  std::size_t trace_cache::get_budget() const
+  {
+    return budget;
+  }
+
+  void trace_cache::set_budget(std::size_t budget_bytes)
+  {
+    budget = budget_bytes;
+    evict(budget);
+  }
+
+  const trace_cache_stats& trace_cache::get_stats() const
+  {
+    return stats;
+  }
+
+  void trace_cache::reset_stats()
+  {
+    stats = trace_cache_stats();
+  }
+
+  void trace_cache::clear()
+  {
+    lru.clear();
+    entries.clear();
+    bytes = 0;
+  }
+
+  void trace_cache::evict(std::size_t budget_bytes)
+  {
+    while (bytes > budget_bytes && !lru.empty())
+    {
+      bytes -= 2 * lru.back().second.positions.size() * sizeof(glm::vec4);
+      entries.erase(lru.back().first);
+      lru.pop_back();
+      stats.evictions++;
+    }
+  }
+
+
+  cached_tracer::cached_tracer(const jaySrc<float>& src, std::size_t budget_bytes, unsigned int thread_count, std::uint64_t field_id)
+    : tracer   { src, thread_count }
+    , cache    { budget_bytes }
+    , field_id { (field_id != 0) ? field_id : trace_cache::field_id(src) }
+  { }
+
+  cpu_trace_result cached_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf)
+  {
+    cpu_trace_result result;
+    result.seed_count = cpu_tracer::seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void cached_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const auto        seeds        = cpu_tracer::make_seeds(s_conf);
+    const std::size_t global_steps = i_conf.global_step_count;
+    // Steps after local_step_count are left untouched (see cpu_tracer)
+    const std::size_t steps        = std::min<std::size_t>(i_conf.local_step_count, global_steps);
+
+    trace_cache::key k;
+    k.field  = field_id;
+    k.params = trace_cache::params_id(i_conf);
+
+    // Cached trajectories are copied right away, the others are traced as one list
+    std::vector<std::size_t> missing;
+    std::vector<glm::vec4>   missing_seeds;
+    for (std::size_t s = 0; s < seeds.size(); s++)
+    {
+      k.seed = glm::vec3(seeds[s]);
+      if (const auto* e = cache.find(k))
+      {
+        std::copy(e->positions .begin(), e->positions .end(), positions  + s * global_steps);
+        std::copy(e->velocities.begin(), e->velocities.end(), velocities + s * global_steps);
+        continue;
+      }
+      missing.push_back(s);
+      missing_seeds.push_back(seeds[s]);
+    }
+
+    traced_seeds = missing.size();
+
+    if (!missing.empty())
+    {
+      std::vector<glm::vec4> traced_positions (missing.size() * global_steps, glm::vec4(0.0f));
+      std::vector<glm::vec4> traced_velocities(missing.size() * global_steps, glm::vec4(0.0f));
+      tracer.trace(missing_seeds, i_conf, traced_positions.data(), traced_velocities.data());
+
+      for (std::size_t m = 0; m < missing.size(); m++)
+      {
+        const auto* p = traced_positions .data() + m * global_steps;
+        const auto* v = traced_velocities.data() + m * global_steps;
+        std::copy(p, p + steps, positions  + missing[m] * global_steps);
+        std::copy(v, v + steps, velocities + missing[m] * global_steps);
+
+        k.seed = glm::vec3(missing_seeds[m]);
+        cache.insert(k, p, v, steps);
+      }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  trace_cache& cached_tracer::get_cache()
+  {
+    return cache;
+  }
+
+  cpu_tracer& cached_tracer::get_tracer()
+  {
+    return tracer;
+  }
+
+  std::size_t cached_tracer::get_traced_seeds() const
+  {
+    return traced_seeds;
+  }
+
+  double cached_tracer::get_trace_time() const
+  {
+    return trace_time;
+  }
+}
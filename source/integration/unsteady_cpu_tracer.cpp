@@ -0,0 +1,208 @@
+#include <jay/integration/unsteady_cpu_tracer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include <jay/integration/particle_batch.hpp>
+#include <jay/integration/schemes.hpp>
+#include <jay/integration/seed_order.hpp>
+#include <jay/integration/trilinear_sampler.hpp>
+#include <jay/io/timestep_source.hpp>
+
+namespace jay
+{
+  unsteady_cpu_tracer::unsteady_cpu_tracer(const jaySrc<float>& src, unsigned int thread_count)
+    : src          { &src }
+    , grid         { src.grid }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+  {
+    if (src.grid_dim < 4 || src.vec_len != 3 || src.ordering != Order::VectorFirst)
+      printf("Error: The unsteady tracer needs a 4D vectorlike ordered field with 3 components.\n");
+
+    grid.resize(4, 1);
+  }
+
+  unsteady_cpu_tracer::unsteady_cpu_tracer(timestep_source& source, unsigned int thread_count)
+    : source       { &source }
+    , grid         { source.grid }
+    , thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+  {
+    if (source.vec_len != 3)
+      printf("Error: The unsteady tracer needs a field with 3 components.\n");
+
+    grid.resize(4, 1);
+  }
+
+  cpu_trace_result unsteady_cpu_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf)
+  {
+    cpu_trace_result result;
+    result.seed_count = cpu_tracer::seed_count(s_conf);
+    result.step_count = i_conf.global_step_count;
+    result.positions .resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+    result.velocities.resize(result.seed_count * result.step_count, glm::vec4(0.0f));
+
+    trace(s_conf, i_conf, result.positions.data(), result.velocities.data());
+
+    return result;
+  }
+
+  void unsteady_cpu_tracer::trace(const seeding_conf& s_conf, const integration_conf& i_conf, glm::vec4* positions, glm::vec4* velocities)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const auto  seeds        = cpu_tracer::make_seeds(s_conf);
+    auto        order        = seed_order(s_conf);
+    std::size_t compute_pass = 0;
+
+    auto full_passes = (i_conf.local_step_count > 0) ? std::floor((i_conf.global_step_count - i_conf.remainder_step_count) / i_conf.local_step_count + 0.001) : 0;
+    bool half_pass   = i_conf.remainder_step_count;
+
+    // The first n-1 advections between timestep t and t + 1
+    for (std::size_t t = 0; t < full_passes; t++)
+    {
+      if (compute_pass + 1 >= grid[3])
+      {
+        printf("Error: Not enough timesteps for %zu passes.\n", static_cast<std::size_t>(full_passes));
+        break;
+      }
+
+      const auto slice_t0 = acquire(compute_pass + 0);
+      const auto slice_t1 = acquire(compute_pass + 1);
+      const auto offset   = compute_pass * i_conf.local_step_count;
+
+      // Particles drift apart, sort them by their last position
+      if (resort_interval > 0 && offset > 0 && t % resort_interval == 0)
+        order = position_order(positions + offset - 1, i_conf.global_step_count, order, glm::vec3(grid[0], grid[1], grid[2]), s_conf.ordering);
+
+      if (i_conf.texelfetch)
+        pass(time_interpolated_sampler<trilinear_sampler>(slice_t0, slice_t1), slice_t0, seeds, order, i_conf, offset, i_conf.local_step_count, positions, velocities);
+      else
+        pass(time_interpolated_sampler<texture_sampler>  (slice_t0, slice_t1), slice_t0, seeds, order, i_conf, offset, i_conf.local_step_count, positions, velocities);
+
+      // Timestep t is done, t + 1 stays for the next pass
+      release(compute_pass);
+      compute_pass++;
+    }
+
+    // The remainder steps in the last timestep
+    if (half_pass && compute_pass < grid[3])
+    {
+      const auto slice  = acquire(compute_pass);
+      const auto offset = compute_pass * i_conf.local_step_count;
+
+      if (i_conf.texelfetch)
+        pass(trilinear_sampler(slice), slice, seeds, order, i_conf, offset, i_conf.remainder_step_count, positions, velocities);
+      else
+        pass(texture_sampler  (slice), slice, seeds, order, i_conf, offset, i_conf.remainder_step_count, positions, velocities);
+
+      compute_pass++;
+    }
+
+    // Have the beginning of the field ready for the next trace
+    if (source)
+      source->seek(0);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    trace_time = std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  void unsteady_cpu_tracer::set_resort_interval(std::size_t passes)
+  {
+    resort_interval = passes;
+  }
+
+  unsigned int unsteady_cpu_tracer::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  double unsteady_cpu_tracer::get_trace_time() const
+  {
+    return trace_time;
+  }
+
+  field_view unsteady_cpu_tracer::acquire(std::size_t t)
+  {
+    const int x = static_cast<int>(grid[0]);
+    const int y = static_cast<int>(grid[1]);
+    const int z = static_cast<int>(grid[2]);
+
+    // Blocks only if the prefetcher has not caught up yet
+    if (source)
+      return field_view(source->slice(t), x, y, z);
+
+    return field_view(src->data.data() + t * grid[0] * grid[1] * grid[2] * 3, x, y, z);
+  }
+
+  void unsteady_cpu_tracer::release(std::size_t t)
+  {
+    if (source)
+      source->release(t);
+  }
+
+  template <typename Sampler>
+  void unsteady_cpu_tracer::pass(const Sampler& sampler, const field_view& bounds, const std::vector<glm::vec4>& seeds, const std::vector<std::uint32_t>& order, const integration_conf& i_conf, std::size_t offset, std::size_t steps, glm::vec4* positions, glm::vec4* velocities) const
+  {
+    const float       h             = i_conf.step_size_h;
+    const float       rel_dt        = (i_conf.local_step_count > 0) ? 1.0f / i_conf.local_step_count : 0.0f;
+    const float       vector_factor = i_conf.dataset_factor;
+    const glm::vec4   cf            = cell_factor(i_conf.cell_size);
+    const std::size_t global_steps  = i_conf.global_step_count;
+    const bool        rk4           = (i_conf.strategy != 0);
+
+    steps = std::min(steps, (global_steps > offset) ? global_steps - offset : 0);
+
+    // All seeds finish the pass before the window slides, small chunks keep all threads busy until then
+    const std::size_t        chunk = 64;
+    std::atomic<std::size_t> next  { 0 };
+
+    auto worker = [&]()
+    {
+      particle_batch<> batch;
+
+      for (auto begin = next.fetch_add(chunk); begin < order.size(); begin = next.fetch_add(chunk))
+      {
+        const auto end = std::min(begin + chunk, order.size());
+        for (auto s = begin; s < end; s += batch.width)
+        {
+          const auto* index = &order[s];
+
+          // Last known position / velocity
+          if (offset == 0)
+            batch.load(seeds.data(), index, end - s);
+          else
+            batch.resume(positions, velocities, global_steps, offset - 1, index, end - s);
+
+          // Interpolation factor of the 2 present timesteps
+          float local_time = 0.0f;
+
+          for (std::size_t i = 0; i < steps; i++)
+          {
+            // Particles outside of the domain are frozen
+            if (batch.update_alive(bounds))
+            {
+              if (rk4)
+                rk4_step  (batch, sampler, h, vector_factor, cf, local_time, rel_dt);
+              else
+                euler_step(batch, sampler, h, vector_factor, cf, local_time, rel_dt);
+            }
+
+            batch.store(positions, velocities, global_steps, offset + i, index);
+
+            local_time += rel_dt;
+          }
+        }
+      }
+    };
+
+    std::vector<std::thread> threads(std::min<std::size_t>(thread_count, std::max<std::size_t>(1, (order.size() + chunk - 1) / chunk)));
+    for (auto& thread : threads)
+      thread = std::thread(worker);
+    for (auto& thread : threads)
+      thread.join();
+  }
+}
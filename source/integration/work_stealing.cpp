@@ -0,0 +1,152 @@
+#include <jay/integration/work_stealing.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace jay
+{
+  work_stealing_scheduler::work_stealing_scheduler(unsigned int thread_count)
+    : thread_count { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+  {
+    for (unsigned int t = 0; t < this->thread_count; t++)
+      ranges.push_back(std::make_unique<chunk_range>());
+  }
+
+  void work_stealing_scheduler::run(std::size_t chunk_count, const std::function<void(unsigned int, std::size_t)>& task)
+  {
+    using clock = std::chrono::high_resolution_clock;
+
+    stats.assign(thread_count, worker_stats());
+
+    // Contiguous initial ranges
+    for (unsigned int t = 0; t < thread_count; t++)
+    {
+      ranges[t]->begin = chunk_count *  t      / thread_count;
+      ranges[t]->end   = chunk_count * (t + 1) / thread_count;
+    }
+
+    auto start = clock::now();
+
+    auto worker = [&](unsigned int thread)
+    {
+      auto& s = stats[thread];
+
+      std::size_t chunk;
+      while (pop(thread, chunk) || (steal(thread) && pop(thread, chunk)))
+      {
+        auto begin = clock::now();
+        task(thread, chunk);
+        s.busy_ms += std::chrono::duration<double, std::milli>(clock::now() - begin).count();
+        s.chunks++;
+      }
+    };
+
+    std::vector<std::thread> threads(thread_count);
+    for (unsigned int t = 0; t < thread_count; t++)
+      threads[t] = std::thread(worker, t);
+    for (auto& thread : threads)
+      thread.join();
+
+    run_time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    for (auto& s : stats)
+      s.idle_ms = std::max(0.0, run_time - s.busy_ms);
+  }
+
+  bool work_stealing_scheduler::pop(unsigned int thread, std::size_t& chunk)
+  {
+    auto& range = *ranges[thread];
+
+    std::lock_guard<std::mutex> lock(range.m);
+    if (range.begin == range.end)
+      return false;
+
+    chunk = range.begin++;
+    return true;
+  }
+
+  bool work_stealing_scheduler::steal(unsigned int thread)
+  {
+    // Chunks only move between ranges, so once all ranges are empty no more work will show up
+    while (true)
+    {
+      // Largest remaining range (sizes may change until the victim is locked)
+      unsigned int victim    = thread;
+      std::size_t  remaining = 0;
+      for (unsigned int i = 1; i < thread_count; i++)
+      {
+        const auto  t = (thread + i) % thread_count;
+        auto&       r = *ranges[t];
+
+        std::lock_guard<std::mutex> lock(r.m);
+        if (r.end - r.begin > remaining)
+        {
+          victim    = t;
+          remaining = r.end - r.begin;
+        }
+      }
+
+      if (remaining == 0)
+        return false;
+
+      std::size_t begin, end;
+      {
+        auto& r = *ranges[victim];
+
+        std::lock_guard<std::mutex> lock(r.m);
+        remaining = r.end - r.begin;
+        if (remaining == 0)
+          continue;
+
+        // Back half (at least the last chunk), the victim keeps the front it is working towards
+        end     = r.end;
+        begin   = r.end - std::max<std::size_t>(1, remaining / 2);
+        r.end   = begin;
+      }
+
+      auto& own = *ranges[thread];
+
+      std::lock_guard<std::mutex> lock(own.m);
+      own.begin = begin;
+      own.end   = end;
+      stats[thread].steals++;
+      return true;
+    }
+  }
+
+  unsigned int work_stealing_scheduler::get_thread_count() const
+  {
+    return thread_count;
+  }
+
+  const std::vector<worker_stats>& work_stealing_scheduler::get_stats() const
+  {
+    return stats;
+  }
+
+  double work_stealing_scheduler::get_run_time() const
+  {
+    return run_time;
+  }
+
+  double work_stealing_scheduler::efficiency() const
+  {
+    if (stats.empty() || run_time <= 0.0)
+      return 0.0;
+
+    double busy = 0.0;
+    for (const auto& s : stats)
+      busy += s.busy_ms;
+
+    return busy / (stats.size() * run_time);
+  }
+
+  void work_stealing_scheduler::print() const
+  {
+    printf("Threads: %u, run time: %.3f ms, efficiency: %.1f %%\n", thread_count, run_time, 100.0 * efficiency());
+    for (std::size_t t = 0; t < stats.size(); t++)
+      printf("  Thread %3zu: busy %10.3f ms, idle %10.3f ms, chunks %6zu, steals %4zu\n", t, stats[t].busy_ms, stats[t].idle_ms, stats[t].chunks, stats[t].steals);
+  }
+}
@@ -1,4 +1,7 @@
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <thread>
 
 #include <jay/io/astc_io.hpp>
 #include <jay/io/data_io.hpp>
@@ -90,7 +93,7 @@ namespace jay
 
     if (!astc_file)
     {
-      printf("Error: File open failed '%s'\n", filepath);
+      printf("Error: File open failed '%s'\n", filepath.c_str());
       return {};
     }
 
@@ -106,7 +109,7 @@ namespace jay
     unsigned int magicval = unpack_bytes(hdr.magic[0], hdr.magic[1], hdr.magic[2], hdr.magic[3]);
     if (magicval != ASTC_MAGIC_ID)
     {
-      printf("Error: File not recognized as ASTC: '%s'\n", filepath);
+      printf("Error: File not recognized as ASTC: '%s'\n", filepath.c_str());
       return {};
     }
 
@@ -123,7 +126,7 @@ namespace jay
 
     if (dim_x == 0 || dim_y == 0 || dim_z == 0)
     {
-      printf("Error: File corrupt: '%s'\n", filepath);
+      printf("Error: File corrupt: '%s'\n", filepath.c_str());
       return {};
     }
 
@@ -140,7 +143,7 @@ namespace jay
 
     if (data_size % img_size > 0)
     {
-      printf("Error: File corrupt: '%s'\n", filepath);
+      printf("Error: File corrupt: '%s'\n", filepath.c_str());
       return {};
     }
 
@@ -161,7 +164,7 @@ namespace jay
 
     if (!astc_file)
     {
-      printf("Error: File read failed: '%s'\n", filepath);
+      printf("Error: File read failed: '%s'\n", filepath.c_str());
       return {};
     }
 
@@ -173,14 +176,93 @@ namespace jay
 
   std::vector<jayComp<astc_datatype>> astc_io::astc_read_multiple(const std::vector<std::string>& filenames)
   {
-    std::vector<jayComp<astc_datatype>> compressed_images;
-    compressed_images.reserve(filenames.size());
+    // A few concurrent reads are enough to keep the disk busy
+    return astc_read_multiple(filenames, 4);
+  }
+
+
+  std::vector<jayComp<astc_datatype>> astc_io::astc_read_multiple(
+    const std::vector<std::string>& filenames,
+    unsigned int                    io_threads,
+    astc_read_callback              on_read,
+    astc_read_stats*                stats
+  )
+  {
+    using clock = std::chrono::high_resolution_clock;
+
+    std::vector<jayComp<astc_datatype>> compressed_images(filenames.size());
+    std::vector<double>                 file_ms          (filenames.size());
 
-    for (std::uint16_t i = 0; i < filenames.size(); i++)
+    io_threads = (io_threads > 0) ? io_threads : 1;
+    io_threads = (io_threads < filenames.size()) ? io_threads : filenames.size();
+
+    std::atomic<std::size_t> next{ 0 };
+    auto worker = [&]()
     {
-      compressed_images.push_back(astc_read(filenames[i]));
+      for (auto i = next++; i < filenames.size(); i = next++)
+      {
+        auto t0 = clock::now();
+        compressed_images[i] = astc_read(filenames[i]);
+        auto t1 = clock::now();
+
+        file_ms[i] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        // Decoding overlaps with the reads of the other threads
+        if (on_read && !compressed_images[i].data.empty())
+          on_read(i, compressed_images[i]);
+      }
+    };
+
+    auto t0 = clock::now();
+
+    std::vector<std::thread> threads(io_threads);
+    for (auto& thread : threads)
+      thread = std::thread(worker);
+    for (auto& thread : threads)
+      thread.join();
+
+    auto t1 = clock::now();
+
+    if (stats)
+    {
+      stats->filenames   = filenames;
+      stats->file_ms     = file_ms;
+      stats->file_bytes  .resize(filenames.size());
+      stats->total_ms    = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      stats->total_bytes = 0;
+
+      for (std::size_t i = 0; i < filenames.size(); i++)
+      {
+        stats->file_bytes[i] = (compressed_images[i].data_len > 0) ? compressed_images[i].data_len + sizeof(astc_header) : 0;
+        stats->total_bytes  += stats->file_bytes[i];
+      }
     }
 
     return compressed_images;
   }
+
+
+  /* =============================================================
+
+                          Read Statistics
+
+     ============================================================= */
+
+  double astc_read_stats::file_throughput(std::size_t i) const
+  {
+    return (file_ms[i] > 0.0) ? (file_bytes[i] / 1000000.0) / (file_ms[i] / 1000.0) : 0.0;
+  }
+
+  double astc_read_stats::throughput() const
+  {
+    return (total_ms > 0.0) ? (total_bytes / 1000000.0) / (total_ms / 1000.0) : 0.0;
+  }
+
+  void astc_read_stats::print() const
+  {
+    for (std::size_t i = 0; i < filenames.size(); i++)
+      printf("  %s: %.2f MB in %.2f ms (%.1f MB/s)\n", filenames[i].c_str(), file_bytes[i] / 1000000.0, file_ms[i], file_throughput(i));
+
+    printf("Read %zu files: %.2f MB in %.2f ms (%.1f MB/s)\n", filenames.size(), total_bytes / 1000000.0, total_ms, throughput());
+  }
 }
\ No newline at end of file
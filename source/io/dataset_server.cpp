@@ -0,0 +1,343 @@
+#include <jay/io/dataset_server.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#include <jay/integration/astc_sampler.hpp>
+#include <jay/io/hdf5_io.hpp>
+
+namespace jay
+{
+namespace
+{
+namespace bip = boost::interprocess;
+
+std::size_t align(std::size_t bytes)
+{
+  return (bytes + 63) / 64 * 64;
+}
+
+std::uint64_t current_process()
+{
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return static_cast<std::uint64_t>(getpid());
+#endif
+}
+
+bool process_alive(std::uint64_t pid)
+{
+#ifdef _WIN32
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+  if (!process)
+    return GetLastError() == ERROR_ACCESS_DENIED;
+
+  DWORD code = 0;
+  const bool alive = GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+  CloseHandle(process);
+  return alive;
+#else
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+enum class segment_state { missing, stale, in_use };
+
+// A segment is stale if it's a dataset whose server process is gone; anything else (a server still creating its
+// segment, other data under that name) is left alone
+segment_state state_of(const std::string& name)
+{
+  bip::shared_memory_object shm;
+  try
+  {
+    shm = bip::shared_memory_object(bip::open_only, name.c_str(), bip::read_only);
+  }
+  catch (const bip::interprocess_exception&)
+  {
+    return segment_state::missing;
+  }
+
+  try
+  {
+    bip::mapped_region region(shm, bip::read_only);
+    if (region.get_size() < sizeof(dataset_descriptor))
+      return segment_state::in_use;
+
+    const auto* desc = static_cast<const dataset_descriptor*>(region.get_address());
+    if (desc->magic == dataset_descriptor::magic_value && desc->owner != 0 && !process_alive(desc->owner))
+      return segment_state::stale;
+  }
+  catch (const bip::interprocess_exception&)
+  {
+  }
+
+  return segment_state::in_use;
+}
+
+jaySrcView<float> view_of(const void* base)
+{
+  const auto* desc  = static_cast<const dataset_descriptor*>(base);
+  const auto* bytes = static_cast<const char*>(base);
+
+  std::vector<std::size_t> grid(desc->grid, desc->grid + 4);
+  return jaySrcView<float>(reinterpret_cast<const float*>(bytes + desc->data_offset), grid, desc->grid_dim, desc->vec_len, static_cast<Order>(desc->ordering));
+}
+}
+
+/* =========================================================================*/
+/*                             Constructors
+/* =========================================================================*/
+dataset_server::dataset_server(std::string name, const jaySrc<float>& src, std::vector<float> peaks)
+  : name { name }
+{
+  auto loader = [&](float* dst)
+  {
+    std::copy(src.data.begin(), src.data.end(), dst);
+  };
+
+  publish(loader, src.grid, src.grid_dim, src.vec_len, src.ordering, peaks);
+}
+
+dataset_server::dataset_server(std::string name, std::string h5_filepath, std::vector<std::string> datasets, Order ordering, std::vector<float> peaks)
+  : name { name }
+{
+  std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+  hdf5_io handler(h5_filepath, datasets);
+
+  const auto grid     = handler.get_grid_fixsize(false, 1);
+  const auto grid_dim = handler.get_grid_dim();
+  const auto vec_len  = handler.get_vec_len();
+  const auto grid_elements_scalar = grid[0] * grid[1] * grid[2] * grid[3];
+
+  auto loader = [&](float* dst)
+  {
+    // Vectorlike ordering (stride = vec_len, offset = component_id)
+    if (ordering == Order::VectorFirst)
+      for (std::size_t c = 0; c < vec_len; c++)
+        handler.read_hdf5(dst, c, vec_len, static_cast<unsigned int>(c));
+    // Componentwise ordering (stride = 1, offset = blocksize)
+    else
+      for (std::size_t c = 0; c < vec_len; c++)
+        handler.read_hdf5(dst, c * grid_elements_scalar, 1, static_cast<unsigned int>(c));
+  };
+
+  publish(loader, grid, grid_dim, vec_len, ordering, peaks);
+}
+
+dataset_server::dataset_server(std::string name, const astc_field& field, std::vector<float> peaks)
+  : name { name }
+{
+  // Depth layers are decoded in parallel, each thread with its own cache
+  auto loader = [&](float* dst)
+  {
+    const unsigned int thread_count = std::max(1U, std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(field.grid.z)));
+
+    std::vector<std::thread> threads;
+    for (unsigned int thread = 0; thread < thread_count; thread++)
+      threads.emplace_back([&, thread]()
+      {
+        astc_block_cache   cache(field);
+        const astc_sampler sampler(field, cache);
+
+        for (int z = static_cast<int>(thread); z < field.grid.z; z += thread_count)
+          for (int y = 0; y < field.grid.y; y++)
+            for (int x = 0; x < field.grid.x; x++)
+            {
+              const glm::vec3 v = sampler.node(x, y, z);
+              float* node = dst + 3 * ((static_cast<std::size_t>(z) * field.grid.y + y) * field.grid.x + x);
+              node[0] = v.x;
+              node[1] = v.y;
+              node[2] = v.z;
+            }
+      });
+
+    for (auto& thread : threads)
+      thread.join();
+  };
+
+  publish(loader, { static_cast<std::size_t>(field.grid.x), static_cast<std::size_t>(field.grid.y), static_cast<std::size_t>(field.grid.z), 1 }, 3, 3, Order::VectorFirst, peaks);
+}
+
+dataset_server::dataset_server(std::string name, loader_fn loader, std::vector<std::size_t> grid, std::size_t grid_dim, std::size_t vec_len, Order ordering, std::vector<float> peaks)
+  : name { name }
+{
+  publish(loader, grid, grid_dim, vec_len, ordering, peaks);
+}
+
+dataset_server::~dataset_server()
+{
+  if (!region)
+    return;
+
+  region.reset();
+  bip::shared_memory_object::remove(name.c_str());
+}
+
+/* =========================================================================*/
+/*                                Methods
+/* =========================================================================*/
+bool dataset_server::valid() const
+{
+  return region != nullptr;
+}
+
+const std::string& dataset_server::get_name() const
+{
+  return name;
+}
+
+std::size_t dataset_server::byte_size() const
+{
+  return region ? region->get_size() : 0;
+}
+
+jaySrcView<float> dataset_server::view() const
+{
+  return region ? view_of(region->get_address()) : jaySrcView<float>();
+}
+
+double dataset_server::get_load_time() const
+{
+  return load_ms;
+}
+
+void dataset_server::publish(const loader_fn& loader, std::vector<std::size_t> grid, std::size_t grid_dim, std::size_t vec_len, Order ordering, const std::vector<float>& peaks)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  grid.resize(4, 1);
+  const std::size_t element_count = grid[0] * grid[1] * grid[2] * grid[3] * vec_len;
+  const std::size_t peak_offset   = align(sizeof(dataset_descriptor));
+  const std::size_t data_offset   = peak_offset + align(peaks.size() * sizeof(float));
+  const std::size_t size          = data_offset + element_count * sizeof(float);
+
+  // A segment of a crashed server would never be completed, one of a running server is kept
+  const auto state = state_of(name);
+  if (state == segment_state::stale)
+    bip::shared_memory_object::remove(name.c_str());
+  else if (state == segment_state::in_use)
+  {
+    printf("Error: Dataset '%s' is already served.\n", name.c_str());
+    return;
+  }
+
+  try
+  {
+    bip::shared_memory_object shm(bip::create_only, name.c_str(), bip::read_write);
+    shm.truncate(static_cast<bip::offset_t>(size));
+    region = std::make_unique<bip::mapped_region>(shm, bip::read_write);
+  }
+  catch (const bip::interprocess_exception& e)
+  {
+    printf("Error: Could not create the shared memory of dataset '%s' (%s).\n", name.c_str(), e.what());
+    region.reset();
+    return;
+  }
+
+  auto* bytes = static_cast<char*>(region->get_address());
+  auto* desc  = new (bytes) dataset_descriptor();
+  desc->owner = current_process();
+  for (std::size_t i = 0; i < 4; i++)
+    desc->grid[i] = grid[i];
+  desc->grid_dim      = grid_dim;
+  desc->vec_len       = vec_len;
+  desc->ordering      = static_cast<std::uint32_t>(ordering);
+  desc->peak_count    = peaks.size();
+  desc->element_count = element_count;
+  desc->peak_offset   = peak_offset;
+  desc->data_offset   = data_offset;
+
+  if (!peaks.empty())
+    std::memcpy(bytes + peak_offset, peaks.data(), peaks.size() * sizeof(float));
+
+  loader(reinterpret_cast<float*>(bytes + data_offset));
+  desc->ready.store(1, std::memory_order_release);
+
+  auto end = std::chrono::high_resolution_clock::now();
+  load_ms = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+
+/* =========================================================================*/
+/*                             Constructors
+/* =========================================================================*/
+dataset_client::dataset_client(std::string name, double timeout_ms)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+  // The server may still be creating or filling the segment
+  while (true)
+  {
+    try
+    {
+      bip::shared_memory_object shm(bip::open_only, name.c_str(), bip::read_only);
+      region = std::make_unique<bip::mapped_region>(shm, bip::read_only);
+
+      const auto* desc = static_cast<const dataset_descriptor*>(region->get_address());
+      if (region->get_size() >= sizeof(dataset_descriptor) && desc->magic == dataset_descriptor::magic_value && desc->ready.load(std::memory_order_acquire))
+        return;
+    }
+    catch (const bip::interprocess_exception&)
+    {
+    }
+    region.reset();
+
+    const double waited = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    if (waited >= timeout_ms)
+    {
+      printf("Error: Dataset '%s' is not served.\n", name.c_str());
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+/* =========================================================================*/
+/*                                Methods
+/* =========================================================================*/
+bool dataset_client::valid() const
+{
+  return region != nullptr;
+}
+
+jaySrcView<float> dataset_client::view() const
+{
+  return region ? view_of(region->get_address()) : jaySrcView<float>();
+}
+
+std::vector<float> dataset_client::peaks() const
+{
+  if (!region)
+    return {};
+
+  const auto& desc  = descriptor();
+  const auto* first = reinterpret_cast<const float*>(static_cast<const char*>(region->get_address()) + desc.peak_offset);
+  return std::vector<float>(first, first + desc.peak_count);
+}
+
+const dataset_descriptor& dataset_client::descriptor() const
+{
+  return *static_cast<const dataset_descriptor*>(region->get_address());
+}
+
+std::size_t dataset_client::byte_size() const
+{
+  return region ? region->get_size() : 0;
+}
+}
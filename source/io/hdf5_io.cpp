@@ -11,7 +11,7 @@ namespace jay
 ) : hdf5_file     { filepath, HighFive::File::ReadOnly }
   , hdf5_datasets { dataset_names }
 {
-  // no-op
+  get_dims();
 }
 
 
@@ -28,9 +28,8 @@ std::size_t hdf5_io::get_datatype_bytesize()
 
 std::vector<std::size_t> hdf5_io::get_grid(bool desc_order)
 {
-  HighFive::DataSet        dataset  = hdf5_file.getDataSet   (hdf5_datasets[0]);
-  std::vector<std::size_t> grid     = dataset  .getDimensions()                ;
-  std::uint8_t             grid_dim = grid     .size         ()                ;
+  const auto&              grid     = get_dims();
+  std::uint8_t             grid_dim = grid.size();
 
   std::size_t  grid_t   = (grid_dim == 4) ? grid[grid_dim - 4] : 0;
   std::size_t  grid_z   = (grid_dim >= 3) ? grid[grid_dim - 3] : 0;
@@ -66,9 +65,8 @@ std::vector<std::size_t> hdf5_io::get_grid(bool desc_order)
 
 std::vector<std::size_t> hdf5_io::get_grid_fixsize(bool desc_order, std::size_t fillvalue)
 {
-  HighFive::DataSet        dataset  = hdf5_file.getDataSet   (hdf5_datasets[0]);
-  std::vector<std::size_t> grid     = dataset  .getDimensions()                ;
-  std::uint8_t             grid_dim = grid     .size         ()                ;
+  const auto&              grid     = get_dims();
+  std::uint8_t             grid_dim = grid.size();
 
   std::size_t  grid_t = (grid_dim == 4) ? grid[grid_dim - 4] : 0;
   std::size_t  grid_z = (grid_dim >= 3) ? grid[grid_dim - 3] : 0;
@@ -109,14 +107,26 @@ std::vector<std::size_t> hdf5_io::get_grid_fixsize(bool desc_order, std::size_t
 
 std::size_t hdf5_io::get_grid_dim()
 {
-  HighFive::DataSet        dataset = hdf5_file.getDataSet   (hdf5_datasets[0]);
-  std::vector<std::size_t> grid    = dataset  .getDimensions()                ;
-
-  return grid.size();
+  return get_dims().size();
 }
 
 std::size_t hdf5_io::get_vec_len()
 {
   return hdf5_datasets.size();
 }
+
+const std::vector<std::size_t>& hdf5_io::get_dims()
+{
+  // Opening the dataset is costly, its shape can't change while the file is open
+  if (hdf5_dims.empty() && !hdf5_datasets.empty())
+    hdf5_dims = hdf5_file.getDataSet(hdf5_datasets[0]).getDimensions();
+
+  return hdf5_dims;
+}
+
+std::mutex& hdf5_io::library_mutex()
+{
+  static std::mutex m;
+  return m;
+}
 }
\ No newline at end of file
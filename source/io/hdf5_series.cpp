@@ -0,0 +1,269 @@
+#include <jay/io/hdf5_series.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+#include <hdf5.h>
+
+namespace jay
+{
+namespace
+{
+// Orders digit runs by their value, so "step_2" comes before "step_10"
+bool natural_less(const std::string& a, const std::string& b)
+{
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < a.size() && j < b.size())
+  {
+    if (std::isdigit(static_cast<unsigned char>(a[i])) && std::isdigit(static_cast<unsigned char>(b[j])))
+    {
+      std::size_t end_a = i;
+      std::size_t end_b = j;
+      while (end_a < a.size() && std::isdigit(static_cast<unsigned char>(a[end_a])))
+        end_a++;
+      while (end_b < b.size() && std::isdigit(static_cast<unsigned char>(b[end_b])))
+        end_b++;
+
+      // Leading zeros don't change the value
+      std::size_t first_a = i;
+      std::size_t first_b = j;
+      while (first_a + 1 < end_a && a[first_a] == '0')
+        first_a++;
+      while (first_b + 1 < end_b && b[first_b] == '0')
+        first_b++;
+
+      const auto digits_a = a.substr(first_a, end_a - first_a);
+      const auto digits_b = b.substr(first_b, end_b - first_b);
+      if (digits_a.size() != digits_b.size())
+        return digits_a.size() < digits_b.size();
+      if (digits_a != digits_b)
+        return digits_a < digits_b;
+
+      i = end_a;
+      j = end_b;
+      continue;
+    }
+
+    if (a[i] != b[j])
+      return a[i] < b[j];
+    i++;
+    j++;
+  }
+
+  if ((a.size() - i) != (b.size() - j))
+    return (a.size() - i) < (b.size() - j);
+  return a < b;
+}
+}
+
+/* =========================================================================*/
+/*                             Constructors
+/* =========================================================================*/
+hdf5_series::hdf5_series(
+  std::vector<std::string> filepaths,
+  std::vector<std::string> datasets,
+  unsigned int             thread_count
+) : hdf5_datasets { datasets }
+  , thread_count  { (thread_count > 0) ? thread_count : std::max(1U, std::thread::hardware_concurrency()) }
+{
+  std::vector<std::string> files;
+
+  for (const auto& filepath : filepaths)
+  {
+    if (filepath.find_first_of("*?") == std::string::npos)
+    {
+      files.push_back(filepath);
+      continue;
+    }
+
+    auto matches = expand_pattern(filepath);
+    if (matches.empty())
+      printf("Error: No files match '%s'\n", filepath.c_str());
+
+    files.insert(files.end(), matches.begin(), matches.end());
+  }
+
+  open(files);
+}
+
+
+/* =========================================================================*/
+/*                             Getter / Setter
+/* =========================================================================*/
+bool hdf5_series::valid() const
+{
+  return consistent;
+}
+
+std::vector<std::size_t> hdf5_series::get_grid() const
+{
+  if (!consistent)
+    return { 0, 0, 0, 0 };
+
+  const auto& grid = members.front().grid;
+  return { grid[0], grid[1], grid[2], timesteps() };
+}
+
+std::size_t hdf5_series::get_grid_dim() const
+{
+  if (!consistent)
+    return 0;
+
+  // A series of 3D files becomes 4D
+  return (timesteps() > 1) ? 4 : members.front().grid_dim;
+}
+
+std::size_t hdf5_series::get_vec_len() const
+{
+  return hdf5_datasets.size();
+}
+
+std::size_t hdf5_series::timesteps() const
+{
+  if (!consistent)
+    return 0;
+
+  return members.back().t_begin + members.back().grid[3];
+}
+
+std::size_t hdf5_series::slice_elements() const
+{
+  const auto grid = get_grid();
+  return grid[0] * grid[1] * grid[2] * get_vec_len();
+}
+
+std::vector<std::string> hdf5_series::expand_pattern(std::string pattern)
+{
+  const std::filesystem::path path(pattern);
+  const auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+  const auto filename  = path.filename().string();
+
+  // Simple glob: '*' matches any sequence, '?' any single character
+  std::function<bool(std::size_t, const std::string&, std::size_t)> match = [&](std::size_t p, const std::string& name, std::size_t n) -> bool
+  {
+    if (p == filename.size())
+      return n == name.size();
+
+    if (filename[p] == '*')
+      return match(p + 1, name, n) || (n < name.size() && match(p, name, n + 1));
+
+    if (n < name.size() && (filename[p] == '?' || filename[p] == name[n]))
+      return match(p + 1, name, n + 1);
+
+    return false;
+  };
+
+  std::vector<std::string> files;
+
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    if (entry.is_regular_file() && match(0, entry.path().filename().string(), 0))
+      files.push_back(entry.path().string());
+
+  std::sort(files.begin(), files.end(), natural_less);
+
+  return files;
+}
+
+std::function<void(std::size_t, float*)> hdf5_series::timestep_reader()
+{
+  if (!valid())
+    printf("Error: Can't stream an inconsistent series.\n");
+
+  return [this](std::size_t t, float* dst)
+  {
+    read_timestep(dst, t, Order::VectorFirst);
+  };
+}
+
+
+/* =========================================================================*/
+/*                                Methods
+/* =========================================================================*/
+void hdf5_series::open(std::vector<std::string> filepaths)
+{
+  members.resize(filepaths.size());
+
+  bool failed = filepaths.empty();
+
+  // Opening is HDF5 work only, so threads would just wait for the library lock
+  std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+
+  for (std::size_t i = 0; i < filepaths.size(); i++)
+  {
+    auto& m = members[i];
+    m.filepath = filepaths[i];
+
+    if (!std::filesystem::exists(m.filepath))
+    {
+      printf("Error: File open failed '%s'\n", m.filepath.c_str());
+      failed = true;
+      continue;
+    }
+
+    try
+    {
+      m.handler  = std::make_unique<hdf5_io>(m.filepath, hdf5_datasets);
+      m.grid     = m.handler->get_grid_fixsize(false, 1);
+      m.grid_dim = m.handler->get_grid_dim();
+      m.raw_offset.assign(hdf5_datasets.size(), -1);
+
+      for (std::size_t c = 0; c < hdf5_datasets.size(); c++)
+      {
+        auto dataset = m.handler->hdf5_file.getDataSet(hdf5_datasets[c]);
+
+        if (dataset.getDimensions() != m.handler->get_dims())
+        {
+          printf("Error: Datasets of '%s' differ in their shape.\n", m.filepath.c_str());
+          failed = true;
+        }
+
+        // Only contiguous, uncompressed native floats have a valid offset
+        if (dataset.getDataType() == HighFive::AtomicType<float>())
+        {
+          haddr_t offset = H5Dget_offset(dataset.getId());
+          if (offset != HADDR_UNDEF)
+            m.raw_offset[c] = static_cast<long long>(offset);
+        }
+      }
+    }
+    catch (const std::exception& e)
+    {
+      printf("Error: Could not open '%s': %s\n", m.filepath.c_str(), e.what());
+      failed = true;
+    }
+  }
+
+  if (failed)
+    return;
+
+  // Validate the grids and assign the global timesteps
+  bool        matching = true;
+  std::size_t t_begin  = 0;
+  for (auto& m : members)
+  {
+    const auto& first = members.front().grid;
+    if (m.grid[0] != first[0] || m.grid[1] != first[1] || m.grid[2] != first[2])
+    {
+      printf("Error: Grid of '%s' (%zu, %zu, %zu) does not match (%zu, %zu, %zu).\n", m.filepath.c_str(), m.grid[0], m.grid[1], m.grid[2], first[0], first[1], first[2]);
+      matching = false;
+    }
+
+    m.t_begin = t_begin;
+    t_begin  += m.grid[3];
+  }
+
+  consistent = matching;
+}
+
+std::size_t hdf5_series::find_member(std::size_t t) const
+{
+  if (t >= timesteps())
+    return members.size();
+
+  auto it = std::upper_bound(members.begin(), members.end(), t, [](std::size_t t, const member& m) { return t < m.t_begin; });
+  return std::distance(members.begin(), it) - 1;
+}
+}
@@ -74,4 +74,9 @@ namespace jay
   {
     return astc_handler->astc_read_multiple(filenames);
   }
+
+  std::vector<jayComp<astc_datatype>> io::astc_read_multiple(const std::vector<std::string>& filenames, unsigned int io_threads, astc_io::astc_read_callback on_read, astc_read_stats* stats)
+  {
+    return astc_handler->astc_read_multiple(filenames, io_threads, on_read, stats);
+  }
 }
\ No newline at end of file
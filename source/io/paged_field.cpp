@@ -0,0 +1,414 @@
+#include <jay/io/paged_field.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include <jay/io/hdf5_io.hpp>
+
+namespace jay
+{
+namespace
+{
+  struct paged_header
+  {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t grid[3];
+    std::uint32_t brick_size;
+    std::uint32_t ghost;
+  };
+
+  const char paged_magic[4] = { 'J', 'A', 'Y', 'B' };
+
+  // Cells per axis covered by the bricks (at least one brick per axis)
+  glm::ivec3 brick_grid(const glm::ivec3& grid, unsigned int brick_size)
+  {
+    const glm::ivec3 cells = glm::max(grid - 1, glm::ivec3(1));
+    return (cells + static_cast<int>(brick_size) - 1) / static_cast<int>(brick_size);
+  }
+}
+
+/* =========================================================================*/
+/*                             Constructors
+/* =========================================================================*/
+paged_field::paged_field(std::string filepath, std::size_t budget_bytes)
+  : filepath { filepath }
+{
+  auto file = std::make_unique<std::ifstream>(filepath, std::ios::in | std::ios::binary);
+
+  paged_header hdr{};
+  if (!*file || !file->read(reinterpret_cast<char*>(&hdr), sizeof(paged_header)) || std::memcmp(hdr.magic, paged_magic, 4) != 0)
+  {
+    printf("Error: File not recognized as paged field: '%s'\n", filepath.c_str());
+    grid   = glm::ivec3(0);
+    bricks = glm::ivec3(0);
+    return;
+  }
+
+  grid        = glm::ivec3(hdr.grid[0], hdr.grid[1], hdr.grid[2]);
+  brick_size  = hdr.brick_size;
+  ghost       = hdr.ghost;
+  brick_nodes = brick_size + 2 * ghost + 1;
+  bricks      = brick_grid(grid, brick_size);
+
+  // Memory of the slots is only allocated once they are used
+  const auto count = std::min(std::max<std::size_t>(budget_bytes / brick_bytes(), 2), brick_count());
+  slots  .resize(count);
+  slot_of.assign(brick_count(), -1);
+  prev   .resize(count);
+  next   .resize(count);
+
+  for (std::size_t s = 0; s < count; s++)
+    push_front(s);
+
+  files.push_back(std::move(file));
+}
+
+paged_field::~paged_field()
+{
+  files.clear();
+}
+
+
+/* =========================================================================*/
+/*                                Methods
+/* =========================================================================*/
+bool paged_field::write(slab_reader_fn reader, const glm::uvec3& grid, std::string filepath, unsigned int brick_size, unsigned int ghost)
+{
+  std::ofstream out(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    printf("Error: File open failed '%s'\n", filepath.c_str());
+    return false;
+  }
+
+  paged_header hdr{};
+  std::memcpy(hdr.magic, paged_magic, 4);
+  hdr.version    = 1;
+  hdr.grid[0]    = grid.x;
+  hdr.grid[1]    = grid.y;
+  hdr.grid[2]    = grid.z;
+  hdr.brick_size = brick_size;
+  hdr.ghost      = ghost;
+  out.write(reinterpret_cast<const char*>(&hdr), sizeof(paged_header));
+
+  const glm::ivec3  g(grid);
+  const glm::ivec3  bricks = brick_grid(g, brick_size);
+  const int         n      = static_cast<int>(brick_size + 2 * ghost + 1);
+  const std::size_t layer  = static_cast<std::size_t>(g.x) * g.y * 3;
+
+  std::vector<float> slab;
+  std::vector<float> brick(static_cast<std::size_t>(n) * n * n * 3);
+
+  // Bricks are stored x fastest, so a row of bricks in z is written at once from a slab of depth layers
+  for (int bz = 0; bz < bricks.z; bz++)
+  {
+    const int z0 = bz * static_cast<int>(brick_size) - static_cast<int>(ghost);
+    const int z_begin = std::max(z0, 0);
+    const int z_end   = std::min(z0 + n, g.z);
+
+    slab.resize(layer * std::max(z_end - z_begin, 0));
+    if (z_end > z_begin)
+      reader(z_begin, z_end - z_begin, slab.data());
+
+    for (int by = 0; by < bricks.y; by++)
+      for (int bx = 0; bx < bricks.x; bx++)
+      {
+        const glm::ivec3 origin(bx * static_cast<int>(brick_size) - static_cast<int>(ghost), by * static_cast<int>(brick_size) - static_cast<int>(ghost), z0);
+
+        float* dst = brick.data();
+        for (int z = origin.z; z < origin.z + n; z++)
+          for (int y = origin.y; y < origin.y + n; y++)
+            for (int x = origin.x; x < origin.x + n; x++, dst += 3)
+            {
+              if (x < 0 || y < 0 || z < 0 || x >= g.x || y >= g.y || z >= g.z)
+              {
+                dst[0] = dst[1] = dst[2] = 0.0f;
+                continue;
+              }
+
+              const float* v = slab.data() + static_cast<std::size_t>(z - z_begin) * layer + 3 * (static_cast<std::size_t>(y) * g.x + x);
+              dst[0] = v[0];
+              dst[1] = v[1];
+              dst[2] = v[2];
+            }
+
+        out.write(reinterpret_cast<const char*>(brick.data()), brick.size() * sizeof(float));
+      }
+  }
+
+  if (!out)
+  {
+    printf("Error: File write failed '%s'\n", filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool paged_field::write(const jaySrc<float>& src, std::string filepath, unsigned int brick_size, unsigned int ghost, std::size_t t)
+{
+  if (src.vec_len != 3 || src.ordering != Order::VectorFirst)
+  {
+    printf("Error: Paged fields need a vectorlike ordered field with 3 components.\n");
+    return false;
+  }
+
+  const glm::uvec3  grid(src.grid[0], src.grid[1], src.grid[2]);
+  const std::size_t layer = static_cast<std::size_t>(grid.x) * grid.y * 3;
+  const float*      data  = src.data.data() + t * layer * grid.z;
+
+  auto reader = [&](std::size_t z_offset, std::size_t z_count, float* dst)
+  {
+    std::copy(data + z_offset * layer, data + (z_offset + z_count) * layer, dst);
+  };
+
+  return write(reader, grid, filepath, brick_size, ghost);
+}
+
+bool paged_field::write_hdf5(std::string h5_filepath, std::vector<std::string> datasets, std::string filepath, unsigned int brick_size, unsigned int ghost, std::size_t t)
+{
+  std::unique_ptr<hdf5_io> handler;
+  std::size_t              vec_len;
+  std::vector<std::size_t> grid;
+  {
+    std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+    handler = std::make_unique<hdf5_io>(h5_filepath, datasets);
+    vec_len = handler->get_vec_len();
+    grid    = handler->get_grid_fixsize(false, 1);
+  }
+
+  // Closing the file is a library call as well
+  auto close = [&]()
+  {
+    std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+    handler.reset();
+  };
+
+  if (vec_len != 3)
+  {
+    printf("Error: Paged fields need a field with 3 components.\n");
+    close();
+    return false;
+  }
+
+  // The slab reads take the library lock on their own
+  auto reader = [&](std::size_t z_offset, std::size_t z_count, float* dst)
+  {
+    handler->read_hdf5_slab(dst, t, z_offset, z_count, Order::VectorFirst);
+  };
+
+  const bool written = write(reader, glm::uvec3(grid[0], grid[1], grid[2]), filepath, brick_size, ghost);
+  close();
+  return written;
+}
+
+const float* paged_field::acquire(std::size_t brick)
+{
+  std::unique_lock<std::mutex> lock(m);
+
+  while (true)
+  {
+    const auto resident_slot = slot_of[brick];
+    if (resident_slot >= 0)
+    {
+      auto& s = slots[resident_slot];
+      if (s.pins++ == 0)
+        unlink(resident_slot);
+
+      // Someone else is reading it
+      cv.wait(lock, [&]() { return !s.loading; });
+      stats.hits++;
+      return s.data.data();
+    }
+
+    // All slots pinned: wait for a release
+    if (tail < 0)
+    {
+      cv.wait(lock);
+      continue;
+    }
+
+    // Least recently used unpinned slot
+    const auto victim = tail;
+    unlink(victim);
+
+    auto& s = slots[victim];
+    if (s.brick >= 0)
+    {
+      slot_of[s.brick] = -1;
+      stats.evictions++;
+    }
+
+    s.brick         = static_cast<long long>(brick);
+    s.pins          = 1;
+    s.loading       = true;
+    slot_of[brick]  = victim;
+
+    // Read without holding the lock, so other threads can keep working on their bricks
+    lock.unlock();
+
+    s.data.resize(static_cast<std::size_t>(brick_nodes) * brick_nodes * brick_nodes * 3);
+    read(brick, s.data.data());
+
+    lock.lock();
+    s.loading = false;
+    stats.loads++;
+    cv.notify_all();
+
+    return s.data.data();
+  }
+}
+
+void paged_field::release(std::size_t brick)
+{
+  {
+    std::lock_guard<std::mutex> lock(m);
+
+    const auto s = slot_of[brick];
+    if (s < 0 || slots[s].pins == 0)
+    {
+      printf("Error: Brick %zu released without being acquired.\n", brick);
+      return;
+    }
+
+    if (--slots[s].pins == 0)
+      push_front(s);
+  }
+  cv.notify_all();
+}
+
+bool paged_field::resident(std::size_t brick) const
+{
+  std::lock_guard<std::mutex> lock(m);
+  return slot_of[brick] >= 0 && !slots[slot_of[brick]].loading;
+}
+
+std::size_t paged_field::brick_of(const glm::vec3& pos) const
+{
+  const glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(pos)), glm::ivec3(0), glm::max(grid - 2, glm::ivec3(0)));
+  const glm::ivec3 b    = glm::min(cell / static_cast<int>(brick_size), bricks - 1);
+
+  return (static_cast<std::size_t>(b.z) * bricks.y + b.y) * bricks.x + b.x;
+}
+
+glm::ivec3 paged_field::brick_origin(std::size_t brick) const
+{
+  const glm::ivec3 b(brick % bricks.x, (brick / bricks.x) % bricks.y, brick / (static_cast<std::size_t>(bricks.x) * bricks.y));
+  return b * static_cast<int>(brick_size) - static_cast<int>(ghost);
+}
+
+glm::vec3 paged_field::node(int x, int y, int z)
+{
+  if (x < 0 || y < 0 || z < 0 || x >= grid.x || y >= grid.y || z >= grid.z)
+    return glm::vec3(0.0f);
+
+  const glm::ivec3  b     = glm::min(glm::ivec3(x, y, z) / static_cast<int>(brick_size), bricks - 1);
+  const std::size_t brick = (static_cast<std::size_t>(b.z) * bricks.y + b.y) * bricks.x + b.x;
+  const glm::ivec3  local = glm::ivec3(x, y, z) - brick_origin(brick);
+
+  const float* data = acquire(brick);
+  const float* v    = data + 3 * ((static_cast<std::size_t>(local.z) * brick_nodes + local.y) * brick_nodes + local.x);
+  const glm::vec3 result(v[0], v[1], v[2]);
+  release(brick);
+
+  return result;
+}
+
+void paged_field::unlink(long long s)
+{
+  if (prev[s] >= 0)
+    next[prev[s]] = next[s];
+  else
+    head = next[s];
+
+  if (next[s] >= 0)
+    prev[next[s]] = prev[s];
+  else
+    tail = prev[s];
+
+  prev[s] = next[s] = -1;
+}
+
+void paged_field::push_front(long long s)
+{
+  prev[s] = -1;
+  next[s] = head;
+  if (head >= 0)
+    prev[head] = s;
+  head = s;
+  if (tail < 0)
+    tail = s;
+}
+
+void paged_field::read(std::size_t brick, float* dst)
+{
+  std::unique_ptr<std::ifstream> file;
+  {
+    std::lock_guard<std::mutex> lock(file_mutex);
+    if (!files.empty())
+    {
+      file = std::move(files.back());
+      files.pop_back();
+    }
+  }
+
+  if (!file)
+    file = std::make_unique<std::ifstream>(filepath, std::ios::in | std::ios::binary);
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  file->seekg(sizeof(paged_header) + brick * brick_bytes(), std::ios::beg);
+  if (!file->read(reinterpret_cast<char*>(dst), brick_bytes()))
+  {
+    printf("Error: File read failed '%s' (brick %zu)\n", filepath.c_str(), brick);
+    file->clear();
+    std::fill(dst, dst + brick_bytes() / sizeof(float), 0.0f);
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(file_mutex);
+    files.push_back(std::move(file));
+  }
+
+  std::lock_guard<std::mutex> stats_lock(m);
+  stats.bytes   += brick_bytes();
+  stats.read_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+
+/* =========================================================================*/
+/*                             Getter / Setter
+/* =========================================================================*/
+std::size_t paged_field::brick_count() const
+{
+  return static_cast<std::size_t>(bricks.x) * bricks.y * bricks.z;
+}
+
+std::size_t paged_field::capacity() const
+{
+  return slots.size();
+}
+
+std::size_t paged_field::brick_bytes() const
+{
+  return static_cast<std::size_t>(brick_nodes) * brick_nodes * brick_nodes * 3 * sizeof(float);
+}
+
+paged_stats paged_field::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(m);
+  return stats;
+}
+
+void paged_field::reset_stats()
+{
+  std::lock_guard<std::mutex> lock(m);
+  stats = paged_stats();
+}
+}
@@ -0,0 +1,201 @@
+#include <jay/io/timestep_source.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace jay
+{
+/* =========================================================================*/
+/*                             Constructors
+/* =========================================================================*/
+timestep_source::timestep_source(
+  std::string              filepath,
+  std::vector<std::string> datasets,
+  std::size_t              resident_steps
+)
+{
+  {
+    std::lock_guard<std::mutex> lock(hdf5_io::library_mutex());
+    hdf5_handler = std::make_unique<hdf5_io>(filepath, datasets);
+
+    grid     = hdf5_handler->get_grid_fixsize(false, 1);
+    grid_dim = hdf5_handler->get_grid_dim();
+    vec_len  = hdf5_handler->get_vec_len();
+  }
+
+  reader = [this](std::size_t t, float* dst)
+  {
+    hdf5_handler->read_hdf5_timestep(dst, t, Order::VectorFirst);
+  };
+
+  start(resident_steps);
+}
+
+timestep_source::timestep_source(
+  reader_fn                reader,
+  std::vector<std::size_t> grid,
+  std::size_t              grid_dim,
+  std::size_t              vec_len,
+  std::size_t              resident_steps
+) : grid     { grid }
+  , grid_dim { grid_dim }
+  , vec_len  { vec_len }
+  , reader   { reader }
+{
+  this->grid.resize(4, 1);
+  start(resident_steps);
+}
+
+timestep_source::~timestep_source()
+{
+  {
+    std::lock_guard<std::mutex> lock(m);
+    stop = true;
+  }
+  cv_load.notify_all();
+
+  if (prefetcher.joinable())
+    prefetcher.join();
+}
+
+void timestep_source::start(std::size_t resident_steps)
+{
+  // An unsteady pass needs t and t+1 at once
+  resident_steps = std::max<std::size_t>(resident_steps, 2);
+  resident_steps = std::min<std::size_t>(resident_steps, timesteps());
+  resident_steps = std::max<std::size_t>(resident_steps, 1);
+
+  slots    .resize(resident_steps, std::vector<float>(slice_elements()));
+  slot_step.resize(resident_steps, -1);
+
+  prefetcher = std::thread(&timestep_source::prefetch_loop, this);
+}
+
+
+/* =========================================================================*/
+/*                                Methods
+/* =========================================================================*/
+const float* timestep_source::slice(std::size_t t)
+{
+  if (t >= timesteps())
+  {
+    printf("Error: Timestep %zu is out of range (%zu timesteps).\n", t, timesteps());
+    return nullptr;
+  }
+
+  const auto K    = slots.size();
+  const auto slot = t % K;
+
+  std::unique_lock<std::mutex> lock(m);
+
+  // Jumped back: restart the stream at t
+  if (t < window_begin)
+    seek_locked(t);
+
+  // Jumped ahead: everything before the new window is implicitly released
+  else if (t >= window_begin + K)
+  {
+    window_begin = t + 1 - K;
+    next_load    = std::max(next_load, window_begin);
+    cv_load.notify_one();
+  }
+
+  cv_ready.wait(lock, [&]() { return slot_step[slot] == static_cast<long long>(t); });
+
+  return slots[slot].data();
+}
+
+void timestep_source::release(std::size_t t)
+{
+  {
+    std::lock_guard<std::mutex> lock(m);
+    window_begin = std::max(window_begin, t + 1);
+    next_load    = std::max(next_load, window_begin);
+  }
+  cv_load.notify_one();
+}
+
+void timestep_source::seek(std::size_t t)
+{
+  {
+    std::lock_guard<std::mutex> lock(m);
+    seek_locked(t);
+  }
+}
+
+void timestep_source::seek_locked(std::size_t t)
+{
+  // Results of reads that are still in flight will be dropped
+  generation++;
+  window_begin = t;
+  next_load    = t;
+  std::fill(slot_step.begin(), slot_step.end(), -1);
+
+  cv_load.notify_one();
+}
+
+void timestep_source::prefetch_loop()
+{
+  std::unique_lock<std::mutex> lock(m);
+
+  while (true)
+  {
+    cv_load.wait(lock, [&]() { return stop || (next_load < timesteps() && next_load < window_begin + slots.size()); });
+
+    if (stop)
+      return;
+
+    const auto t    = next_load++;
+    const auto slot = t % slots.size();
+    const auto gen  = generation;
+    slot_step[slot] = -1;
+
+    // Read without holding the lock, so the consumer can keep working on the resident slices
+    lock.unlock();
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    reader(t, slots[slot].data());
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    lock.lock();
+
+    read_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    if (gen == generation)
+      slot_step[slot] = t;
+
+    cv_ready.notify_all();
+  }
+}
+
+
+/* =========================================================================*/
+/*                             Getter / Setter
+/* =========================================================================*/
+std::size_t timestep_source::timesteps() const
+{
+  return (grid_dim > 3) ? grid[3] : 1;
+}
+
+std::size_t timestep_source::resident_steps() const
+{
+  return slots.size();
+}
+
+std::size_t timestep_source::slice_elements() const
+{
+  return grid[0] * grid[1] * grid[2] * vec_len;
+}
+
+std::size_t timestep_source::slice_bytes() const
+{
+  return slice_elements() * sizeof(float);
+}
+
+double timestep_source::read_time() const
+{
+  std::lock_guard<std::mutex> lock(m);
+  return read_ms;
+}
+}
@@ -0,0 +1,459 @@
+#include <jay/io/trajectory_io.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace
+{
+  const char          TRAJECTORY_MAGIC[4] = { 'J', 'T', 'R', 'J' };
+  const std::uint16_t TRAJECTORY_VERSION  = 1;
+
+  static_assert(sizeof(jay::trajectory_header) == 24, "trajectory_header must not be padded");
+
+  // Size of [valid_len][byte_len][box_min][box_max] in front of every payload
+  const std::size_t   CHUNK_HEADER_SIZE   = 2 * sizeof(std::uint32_t) + 6 * sizeof(float);
+
+  template <typename T>
+  void put(std::vector<std::uint8_t>& out, const T& value)
+  {
+    auto ptr = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), ptr, ptr + sizeof(T));
+  }
+
+  void put_varint(std::vector<std::uint8_t>& out, std::uint32_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  bool get_varint(const std::uint8_t*& ptr, const std::uint8_t* end, std::uint32_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; ptr < end && shift < 35; shift += 7)
+    {
+      const auto byte = *ptr++;
+      value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  std::uint32_t zigzag(std::int32_t value)
+  {
+    return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+  }
+
+  std::int32_t unzigzag(std::uint32_t value)
+  {
+    return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+  }
+
+  // Linear prediction from the last two samples (exact on the quantized values, so no drift)
+  std::int64_t predict(const std::int64_t* q, std::size_t i, std::size_t c)
+  {
+    if (i == 0)
+      return 0;
+    if (i == 1)
+      return q[3 * (i - 1) + c];
+
+    return 2 * q[3 * (i - 1) + c] - q[3 * (i - 2) + c];
+  }
+
+  // Appends [valid_len][byte_len][box_min][box_max][payload] of a single seed (steps vec4) to out.
+  void encode_seed(const float* src, std::uint32_t steps, unsigned int bits, std::vector<std::uint8_t>& out)
+  {
+    const double q_max = static_cast<double>((1u << bits) - 1);
+
+    float box_min[3] = {  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max() };
+    float box_max[3] = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+
+    for (std::uint32_t i = 0; i < steps; i++)
+      for (std::size_t c = 0; c < 3; c++)
+      {
+        const auto v = src[4 * i + c];
+        if (!std::isfinite(v))
+          continue;
+
+        box_min[c] = std::min(box_min[c], v);
+        box_max[c] = std::max(box_max[c], v);
+      }
+
+    double scale[3];
+    for (std::size_t c = 0; c < 3; c++)
+    {
+      // No finite sample at all
+      if (box_min[c] > box_max[c])
+        box_min[c] = box_max[c] = 0.0f;
+
+      scale[c] = (box_max[c] > box_min[c]) ? q_max / (static_cast<double>(box_max[c]) - box_min[c]) : 0.0;
+    }
+
+    std::vector<std::int64_t> q(3 * static_cast<std::size_t>(steps));
+    for (std::uint32_t i = 0; i < steps; i++)
+      for (std::size_t c = 0; c < 3; c++)
+      {
+        const auto v = src[4 * i + c];
+        q[3 * i + c] = std::isfinite(v) ? static_cast<std::int64_t>(std::clamp(std::round((v - box_min[c]) * scale[c]), 0.0, q_max)) : 0;
+      }
+
+    // Drop the frozen tail
+    std::uint32_t valid_len = steps;
+    while (valid_len > 1
+      && q[3 * (valid_len - 1) + 0] == q[3 * (valid_len - 2) + 0]
+      && q[3 * (valid_len - 1) + 1] == q[3 * (valid_len - 2) + 1]
+      && q[3 * (valid_len - 1) + 2] == q[3 * (valid_len - 2) + 2])
+      valid_len--;
+
+    const auto chunk_begin = out.size();
+    put(out, valid_len);
+    put(out, std::uint32_t(0));
+    for (std::size_t c = 0; c < 3; c++) put(out, box_min[c]);
+    for (std::size_t c = 0; c < 3; c++) put(out, box_max[c]);
+
+    const auto payload_begin = out.size();
+    for (std::uint32_t i = 0; i < valid_len; i++)
+      for (std::size_t c = 0; c < 3; c++)
+      {
+        if (i == 0)
+          put_varint(out, static_cast<std::uint32_t>(q[c]));
+        else
+          put_varint(out, zigzag(static_cast<std::int32_t>(q[3 * i + c] - predict(q.data(), i, c))));
+      }
+
+    const std::uint32_t byte_len = static_cast<std::uint32_t>(out.size() - payload_begin);
+    std::memcpy(out.data() + chunk_begin + sizeof(std::uint32_t), &byte_len, sizeof(std::uint32_t));
+  }
+
+  // Decodes a payload into steps vec4 at dst.
+  bool decode_seed(
+    const std::uint8_t* ptr,
+    const std::uint8_t* end,
+    std::uint32_t       valid_len,
+    const float*        box_min,
+    const float*        box_max,
+    std::uint32_t       steps,
+    unsigned int        bits,
+    float               w,
+    float*              dst
+  )
+  {
+    const double q_max = static_cast<double>((1u << bits) - 1);
+
+    double inv_scale[3];
+    for (std::size_t c = 0; c < 3; c++)
+      inv_scale[c] = (static_cast<double>(box_max[c]) - box_min[c]) / q_max;
+
+    valid_len = std::min(valid_len, steps);
+
+    std::vector<std::int64_t> q(3 * static_cast<std::size_t>(valid_len));
+    for (std::uint32_t i = 0; i < valid_len; i++)
+    {
+      for (std::size_t c = 0; c < 3; c++)
+      {
+        std::uint32_t value;
+        if (!get_varint(ptr, end, value))
+          return false;
+
+        q[3 * i + c]   = (i == 0) ? value : predict(q.data(), i, c) + unzigzag(value);
+        dst[4 * i + c] = static_cast<float>(box_min[c] + q[3 * i + c] * inv_scale[c]);
+      }
+      dst[4 * i + 3] = w;
+    }
+
+    // Refill the frozen tail
+    for (std::uint32_t i = valid_len; i < steps; i++)
+      for (std::size_t c = 0; c < 4; c++)
+        dst[4 * i + c] = (valid_len > 0) ? dst[4 * (valid_len - 1) + c] : ((c == 3) ? w : 0.0f);
+
+    return true;
+  }
+}
+
+namespace jay
+{
+  /* =============================================================
+
+                            Writer
+
+     ============================================================= */
+
+  trajectory_writer::trajectory_writer(
+    std::string     filepath,
+    trajectory_kind kind,
+    std::uint32_t   seeds,
+    std::uint32_t   steps,
+    unsigned int    bits,
+    unsigned int    threads
+  ) : file    (filepath, std::ios::out | std::ios::binary | std::ios::trunc)
+    , hdr     { }
+    , threads { (threads > 0) ? threads : std::max(1U, std::thread::hardware_concurrency()) }
+  {
+    std::memcpy(hdr.magic, TRAJECTORY_MAGIC, 4);
+    hdr.version      = TRAJECTORY_VERSION;
+    hdr.kind         = static_cast<std::uint8_t>(kind);
+    hdr.bits         = static_cast<std::uint8_t>(std::clamp(bits, 8U, 24U));
+    hdr.seeds        = seeds;
+    hdr.steps        = steps;
+    hdr.index_offset = 0;
+
+    if (!file)
+    {
+      printf("Error: File open failed '%s'\n", filepath.c_str());
+      failed = true;
+      return;
+    }
+
+    offsets.reserve(seeds);
+    file.write(reinterpret_cast<const char*>(&hdr), sizeof(trajectory_header));
+  }
+
+  trajectory_writer::~trajectory_writer()
+  {
+    if (file.is_open())
+      close();
+  }
+
+  bool trajectory_writer::good() const
+  {
+    return !failed && file.good();
+  }
+
+  bool trajectory_writer::append(const float* data, std::uint32_t seed_count)
+  {
+    const std::vector<std::uint32_t> lengths(seed_count, hdr.steps);
+    return append(data, lengths.data(), seed_count);
+  }
+
+  bool trajectory_writer::append(const float* data, const std::uint32_t* lengths, std::uint32_t seed_count)
+  {
+    if (!good())
+      return false;
+
+    if (offsets.size() + seed_count > hdr.seeds)
+    {
+      printf("Error: Appending %u seeds exceeds the announced %u seeds.\n", seed_count, hdr.seeds);
+      failed = true;
+      return false;
+    }
+
+    // First vertex of every seed
+    std::vector<std::size_t> first(seed_count, 0);
+    for (std::uint32_t s = 1; s < seed_count; s++)
+      first[s] = first[s - 1] + lengths[s - 1];
+
+    // Encode all seeds of this chunk in parallel..
+    std::vector<std::vector<std::uint8_t>> chunks(seed_count);
+    std::atomic<std::uint32_t>             next{ 0 };
+
+    auto worker = [&]()
+    {
+      for (auto s = next++; s < seed_count; s = next++)
+      {
+        const auto steps = std::min(lengths[s], hdr.steps);
+        chunks[s].reserve(CHUNK_HEADER_SIZE + 4 * static_cast<std::size_t>(steps));
+        encode_seed(data + 4 * first[s], steps, hdr.bits, chunks[s]);
+      }
+    };
+
+    std::vector<std::thread> pool(std::min<std::size_t>(threads, seed_count));
+    for (auto& thread : pool)
+      thread = std::thread(worker);
+    for (auto& thread : pool)
+      thread.join();
+
+    // .. and write them in order
+    for (const auto& chunk : chunks)
+    {
+      offsets.push_back(static_cast<std::uint64_t>(file.tellp()));
+      file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+
+    return good();
+  }
+
+  long long trajectory_writer::close()
+  {
+    if (!file.is_open())
+      return -1;
+
+    if (offsets.size() != hdr.seeds)
+    {
+      printf("Warning: Only %zu of %u seeds were written.\n", offsets.size(), hdr.seeds);
+      hdr.seeds = static_cast<std::uint32_t>(offsets.size());
+    }
+
+    hdr.index_offset = static_cast<std::uint64_t>(file.tellp());
+    file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+
+    const long long filesize = file.tellp();
+
+    // Completing the header marks the file as valid
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&hdr), sizeof(trajectory_header));
+
+    const bool ok = good();
+    file.close();
+
+    return ok ? filesize : -1;
+  }
+
+
+  /* =============================================================
+
+                            Reader
+
+     ============================================================= */
+
+  trajectory_reader::trajectory_reader(std::string filepath)
+    : file (filepath, std::ios::in | std::ios::binary)
+    , hdr  { }
+  {
+    if (!file)
+    {
+      printf("Error: File open failed '%s'\n", filepath.c_str());
+      failed = true;
+      return;
+    }
+
+    file.read(reinterpret_cast<char*>(&hdr), sizeof(trajectory_header));
+
+    if (!file || std::memcmp(hdr.magic, TRAJECTORY_MAGIC, 4) != 0 || hdr.version != TRAJECTORY_VERSION || hdr.index_offset == 0)
+    {
+      printf("Error: File not recognized as trajectory file: '%s'\n", filepath.c_str());
+      failed = true;
+    }
+  }
+
+  bool trajectory_reader::good() const
+  {
+    return !failed;
+  }
+
+  const trajectory_header& trajectory_reader::header() const
+  {
+    return hdr;
+  }
+
+  std::uint32_t trajectory_reader::read(float* dst, std::uint32_t seed_count)
+  {
+    std::uint32_t decoded = 0;
+
+    while (decoded < seed_count && next_seed < hdr.seeds && good())
+    {
+      if (!read_chunk(dst + 4 * static_cast<std::size_t>(decoded) * hdr.steps))
+        break;
+
+      decoded++;
+      next_seed++;
+    }
+
+    return decoded;
+  }
+
+  bool trajectory_reader::read_seed(std::uint32_t seed, float* dst)
+  {
+    if (!good() || seed >= hdr.seeds)
+      return false;
+
+    const auto position = file.tellg();
+
+    std::uint64_t offset = 0;
+    file.seekg(hdr.index_offset + seed * sizeof(std::uint64_t));
+    file.read(reinterpret_cast<char*>(&offset), sizeof(std::uint64_t));
+    file.seekg(offset);
+
+    const bool ok = read_chunk(dst);
+
+    // Don't disturb the sequential reads
+    file.seekg(position);
+
+    return ok;
+  }
+
+  bool trajectory_reader::read_chunk(float* dst)
+  {
+    std::uint32_t valid_len = 0;
+    std::uint32_t byte_len  = 0;
+    float         box_min[3];
+    float         box_max[3];
+
+    file.read(reinterpret_cast<char*>(&valid_len), sizeof(std::uint32_t));
+    file.read(reinterpret_cast<char*>(&byte_len),  sizeof(std::uint32_t));
+    file.read(reinterpret_cast<char*>(box_min),    sizeof(box_min));
+    file.read(reinterpret_cast<char*>(box_max),    sizeof(box_max));
+
+    payload.resize(byte_len);
+    file.read(reinterpret_cast<char*>(payload.data()), byte_len);
+
+    const float w = (hdr.kind == static_cast<std::uint8_t>(trajectory_kind::Positions)) ? 1.0f : 0.0f;
+
+    if (!file || !decode_seed(payload.data(), payload.data() + payload.size(), valid_len, box_min, box_max, hdr.steps, hdr.bits, w, dst))
+    {
+      printf("Error: Trajectory file corrupt (seed %u).\n", next_seed);
+      failed = true;
+      return false;
+    }
+
+    return true;
+  }
+
+
+  /* =============================================================
+
+                       Trajectory I/O Operations
+
+     ============================================================= */
+
+  bool trajectory_io::is_trajectory_file(std::string filepath)
+  {
+    std::ifstream file(filepath, std::ios::in | std::ios::binary);
+
+    char magic[4] = { 0 };
+    file.read(magic, 4);
+
+    return file && std::memcmp(magic, TRAJECTORY_MAGIC, 4) == 0;
+  }
+
+  long long trajectory_io::store(
+    const float*    data,
+    std::uint32_t   seeds,
+    std::uint32_t   steps,
+    trajectory_kind kind,
+    std::string     filepath,
+    unsigned int    bits,
+    unsigned int    threads
+  )
+  {
+    trajectory_writer writer(filepath, kind, seeds, steps, bits, threads);
+    writer.append(data, seeds);
+
+    return writer.close();
+  }
+
+  std::vector<float> trajectory_io::load(std::string filepath, trajectory_header* hdr)
+  {
+    trajectory_reader reader(filepath);
+    if (!reader.good())
+      return {};
+
+    const auto& h = reader.header();
+    if (hdr)
+      *hdr = h;
+
+    std::vector<float> trajectories(4 * static_cast<std::size_t>(h.seeds) * h.steps);
+    if (reader.read(trajectories.data(), h.seeds) != h.seeds)
+      return {};
+
+    return trajectories;
+  }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+// Counts the sampled positions
+struct counting_sampler
+{
+  jay::trilinear_sampler sampler;
+  std::size_t*           count;
+
+  glm::vec3 operator()(const glm::vec3& pos) const
+  {
+    (*count)++;
+    return sampler(pos);
+  }
+
+  void sample(std::size_t n, const float* x, const float* y, const float* z, float* vx, float* vy, float* vz) const
+  {
+    *count += n;
+    sampler.sample(n, x, y, z, vx, vy, vz);
+  }
+};
+
+
+TEST_CASE("ABM4 Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 field rotating around the z-axis through the center with angular velocity 1
+  const std::size_t n      = 33;
+  const float       center = 16.0f;
+
+  auto src = jay_test::rotation_field(n, center);
+
+  // 4 x 1 x 1 seeds on a line through the center
+  auto s_conf = jay_test::make_seeding(glm::vec3(2.0f, 1.0f, 1.0f), glm::uvec2(18, 26), glm::uvec2(16, 17), glm::uvec2(8, 9), glm::vec3(4, 1, 1));
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyABM4, 0.02f, 1000);
+
+  jay::cpu_tracer tracer(src, 4);
+
+  SECTION("ABM4 follows the exact solution as close as RK4")
+  {
+    auto abm4 = tracer.trace(s_conf, i_conf);
+
+    i_conf.strategy = jay::StrategyRK4;
+    auto rk4 = tracer.trace(s_conf, i_conf);
+
+    for (std::size_t s = 0; s < abm4.seed_count; s++)
+    {
+      const float radius = 2.0f + 2.0f * s;
+
+      for (std::size_t i = 0; i < abm4.step_count; i++)
+      {
+        const auto& p = abm4.positions[s * abm4.step_count + i];
+        const auto& q = rk4 .positions[s * rk4 .step_count + i];
+        const float t = i * i_conf.step_size_h;
+        REQUIRE(p.x == Approx(center + radius * std::cos(t)).margin(1e-3));
+        REQUIRE(p.y == Approx(center + radius * std::sin(t)).margin(1e-3));
+        REQUIRE(glm::distance(p, q) < 1e-3f);
+      }
+    }
+  }
+
+  SECTION("Two samples per step after the RK4 bootstrap")
+  {
+    const jay::field_view field(src);
+    const auto            seeds = jay::cpu_tracer::make_seeds(s_conf);
+
+    std::size_t            count = 0;
+    const counting_sampler sampler { jay::trilinear_sampler(field), &count };
+    const glm::vec4        cf = jay::cell_factor(i_conf.cell_size);
+
+    jay::particle_batch<> batch;
+    jay::abm4_history<>   history;
+    batch.load(seeds.data(), seeds.size());
+    history.reset();
+
+    for (std::size_t i = 0; i < 3; i++)
+    {
+      batch.update_alive(field);
+      jay::abm4_step(batch, history, sampler, i_conf.step_size_h, 1.0f, cf);
+    }
+    REQUIRE(count == 3 * 4 * batch.width);
+
+    count = 0;
+    for (std::size_t i = 0; i < 100; i++)
+    {
+      batch.update_alive(field);
+      jay::abm4_step(batch, history, sampler, i_conf.step_size_h, 1.0f, cf);
+    }
+    REQUIRE(count == 100 * 2 * batch.width);
+  }
+}
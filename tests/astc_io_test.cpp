@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("ASTC I/O Test.", "[jay::io]")
+{
+  // 3 files of 2, 3 and 4 images (16^2 texels in 4x4 blocks -> 256 bytes per image)
+  std::vector<std::string> filenames;
+  for (std::size_t i = 0; i < 3; i++)
+  {
+    jayComp<astc_datatype> comp{};
+    comp.dim_x    = 16;
+    comp.dim_y    = 16;
+    comp.dim_z    = 1;
+    comp.block_x  = 4;
+    comp.block_y  = 4;
+    comp.block_z  = 1;
+    comp.img_len  = 256;
+    comp.data_len = (i + 2) * comp.img_len;
+    comp.data.resize(comp.data_len);
+    for (std::size_t b = 0; b < comp.data_len; b++)
+      comp.data[b] = static_cast<astc_datatype>(b * (i + 1));
+
+    filenames.push_back("astc_io_test_" + std::to_string(i) + ".astc");
+    jay::astc_io::astc_store(comp, filenames.back(), true);
+  }
+
+  SECTION("Concurrent reads keep the order and report their timings")
+  {
+    std::vector<std::size_t> decoded(filenames.size(), 0);
+
+    jay::astc_read_stats stats;
+    auto result = jay::astc_io::astc_read_multiple(filenames, 2, [&](std::size_t i, jayComp<astc_datatype>& comp) { decoded[i] = comp.data_len; }, &stats);
+
+    REQUIRE(result.size() == filenames.size());
+    REQUIRE(stats.filenames == filenames);
+    REQUIRE(stats.file_ms.size()    == filenames.size());
+    REQUIRE(stats.file_bytes.size() == filenames.size());
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < filenames.size(); i++)
+    {
+      REQUIRE(result[i].data_len == (i + 2) * 256);
+      REQUIRE(result[i].data[1]  == static_cast<astc_datatype>(i + 1));
+      REQUIRE(decoded[i] == result[i].data_len);
+      REQUIRE(stats.file_bytes[i] == result[i].data_len + sizeof(jay::astc_header));
+      REQUIRE(stats.file_throughput(i) >= 0.0);
+      total += stats.file_bytes[i];
+    }
+
+    REQUIRE(stats.total_bytes == total);
+    REQUIRE(stats.total_ms > 0.0);
+    REQUIRE(stats.throughput() > 0.0);
+  }
+
+  SECTION("Missing files count zero bytes")
+  {
+    jay::astc_read_stats stats;
+    auto result = jay::astc_io::astc_read_multiple({ filenames[0], "astc_io_test_missing.astc" }, 2, nullptr, &stats);
+
+    REQUIRE(result[1].data.empty());
+    REQUIRE(stats.file_bytes[1] == 0);
+    REQUIRE(stats.total_bytes   == stats.file_bytes[0]);
+  }
+
+  for (const auto& filename : filenames)
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("ASTC Sampler Test.", "[jay::integration]")
+{
+  // 37 x 29 x 9 field with smooth, non-linear content, compressed to 4x4 RGB slices
+  auto src = jay_test::make_field({ 37, 29, 9 }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(std::sin(0.2f * y) + 0.1f * z, std::cos(0.3f * x) - 0.05f * z, 0.2f * std::sin(0.1f * (x + y)));
+  });
+
+  jay::astc astc_compressor = jay::astc();
+  astc_compressor.set_blocksizes(4, 4, 1);
+  astc_compressor.color_setting = jay::colorspace::RGB;
+  astc_compressor.apply_all_settings();
+
+  auto peaks     = astc_compressor.find_peaks<float>(src);
+  auto imgs      = astc_compressor.convert_data_to_img(src, true, peaks, jay::colorspace::RGB, jay::slicetype::Plane, 0);
+  auto astc_imgs = astc_compressor.compress(imgs);
+
+  // Reference: the fully decompressed field
+  jaySrc<float> decompressed = src;
+  decompressed.data = astc_compressor.convert_img_to_data(astc_compressor.decompress(astc_imgs), src.grid, 3, true, peaks, jay::colorspace::RGB);
+
+  const jay::astc_field field(astc_imgs, peaks, src.grid);
+
+  SECTION("Nodes match the decompressed field")
+  {
+    REQUIRE(field.blocks == glm::ivec3(10, 8, 1));
+    REQUIRE(field.byte_size() == astc_imgs.data_len);
+
+    jay::astc_block_cache  cache(field, 8);
+    const jay::astc_sampler sampler(field, cache);
+    const jay::field_view   reference(decompressed);
+
+    for (int z = -1; z <= 9; z++)
+      for (int y = -1; y <= 29; y++)
+        for (int x = -1; x <= 37; x++)
+          REQUIRE(glm::distance(sampler.node(x, y, z), reference.node(x, y, z)) < 1e-5f);
+
+    REQUIRE(cache.get_stats().misses >= 10 * 8 * 9);
+    REQUIRE(cache.get_stats().hit_rate() > 0.5);
+  }
+
+  SECTION("Least recently used blocks are evicted first")
+  {
+    jay::astc_block_cache cache(field, 2);
+
+    cache.block(0);
+    cache.block(1);
+    cache.block(0);
+    cache.block(2);   // Evicts 1
+    cache.block(0);
+    cache.block(1);
+
+    REQUIRE(cache.get_stats().hits   == 2);
+    REQUIRE(cache.get_stats().misses == 4);
+  }
+
+  SECTION("Tracing on the compressed field")
+  {
+    auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 2.0f), glm::uvec2(0, 36), glm::uvec2(0, 28), glm::uvec2(0, 8), glm::vec3(12, 9, 4), jay::SeedOrderHilbert);
+    auto i_conf = jay_test::make_integration(glm::uvec4(37, 29, 9, 0), jay::StrategyRK4, 0.1f, 100);
+
+    jay::astc_tracer tracer(field, 4, 32);
+    auto compressed = tracer.trace(s_conf, i_conf);
+
+    jay::cpu_tracer reference_tracer(decompressed, 4);
+    auto reference = reference_tracer.trace(s_conf, i_conf);
+
+    REQUIRE(compressed.positions.size() == reference.positions.size());
+    for (std::size_t i = 0; i < reference.positions.size(); i++)
+      REQUIRE(glm::distance(compressed.positions[i], reference.positions[i]) < 1e-3f);
+
+    const auto& stats = tracer.get_stats();
+    REQUIRE(stats.threads.size() == 4);
+    REQUIRE(stats.total().hit_rate() > 0.9);
+    REQUIRE(stats.compressed_bytes == astc_imgs.data_len);
+    REQUIRE(stats.resident_bytes() < stats.decoded_bytes);
+
+    // Same strategies as cpu_tracer, RK45 resampled at fixed times (the accepted steps may differ)
+    i_conf.tolerance     = 1e-4f;
+    i_conf.step_size_min = 0.001f;
+    i_conf.step_size_max = 0.5f;
+    i_conf.resample_mode = 1;
+    for (auto strategy : { jay::StrategyEuler, jay::StrategyRK45, jay::StrategyABM4 })
+    {
+      i_conf.strategy = strategy;
+      compressed = tracer.trace(s_conf, i_conf);
+      reference  = reference_tracer.trace(s_conf, i_conf);
+
+      const float margin = (strategy == jay::StrategyRK45) ? 1e-2f : 1e-3f;
+      for (std::size_t i = 0; i < reference.positions.size(); i++)
+        REQUIRE(glm::distance(compressed.positions[i], reference.positions[i]) < margin);
+    }
+
+    i_conf.strategy = 7;
+    REQUIRE_THROWS_AS(tracer.trace(s_conf, i_conf), std::invalid_argument);
+  }
+}
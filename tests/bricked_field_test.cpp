@@ -0,0 +1,122 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Bricked Field Test.", "[jay::integration]")
+{
+  // 37 x 29 x 21 field (no multiple of the brick size) with smooth, non-linear content
+  auto src = jay_test::make_field({ 37, 29, 21 }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(std::sin(0.2f * y) + 0.1f * z, std::cos(0.3f * x) - 0.05f * z, 0.2f * std::sin(0.1f * (x + y)));
+  });
+
+  const jay::field_view field(src);
+
+  SECTION("Nodes & ghost layers match the linear field")
+  {
+    jay::bricked_field bricks(field, 8, 3);
+
+    REQUIRE(bricks.brick_size == 8);
+    REQUIRE(bricks.bricks == glm::ivec3(5, 4, 3));
+    REQUIRE(bricks.data.size() == 5 * 4 * 3 * 9 * 9 * 9 * 3);
+
+    for (int z = -1; z <= 21; z++)
+      for (int y = -1; y <= 29; y++)
+        for (int x = -1; x <= 37; x++)
+          REQUIRE(bricks.node(x, y, z) == field.node(x, y, z));
+  }
+
+  SECTION("Samples match the linear sampler")
+  {
+    jay::bricked_field            bricks(field, 4);
+    const jay::bricked_sampler    sampler(bricks);
+    const jay::trilinear_sampler  linear(field);
+
+    std::mt19937                          rng(7);
+    std::uniform_real_distribution<float> ux(-1.5f, 37.5f), uy(-1.5f, 29.5f), uz(-1.5f, 21.5f);
+
+    for (int i = 0; i < 100000; i++)
+    {
+      const glm::vec3 p(ux(rng), uy(rng), uz(rng));
+      const auto      a = sampler(p);
+      const auto      b = linear(p);
+
+      // Identical arithmetic in the interior, the border cells differ in rounding only
+      if (p.x >= 0.0f && p.y >= 0.0f && p.z >= 0.0f && p.x < 36.0f && p.y < 28.0f && p.z < 20.0f)
+        REQUIRE(a == b);
+      else
+        REQUIRE(glm::distance(a, b) < 1e-5f);
+    }
+  }
+
+  SECTION("Batches match single samples, with and without gathers")
+  {
+    jay::bricked_field     bricks(field, 4);
+    jay::bricked_sampler   sampler(bricks);
+    REQUIRE(sampler.gather);
+
+    // As taken by fields of 2^31 floats or more
+    jay::bricked_sampler scalar(bricks);
+    scalar.gather = false;
+
+    std::mt19937                          rng(11);
+    std::uniform_real_distribution<float> ux(-1.5f, 37.5f), uy(-1.5f, 29.5f), uz(-1.5f, 21.5f);
+
+    const std::size_t  n = 1003;
+    std::vector<float> x(n), y(n), z(n), vx(n), vy(n), vz(n), sx(n), sy(n), sz(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+      x[i] = ux(rng);
+      y[i] = uy(rng);
+      z[i] = uz(rng);
+    }
+
+    sampler.sample(n, x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data());
+    scalar .sample(n, x.data(), y.data(), z.data(), sx.data(), sy.data(), sz.data());
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+      const auto v = sampler(glm::vec3(x[i], y[i], z[i]));
+      REQUIRE(sx[i] == v.x);
+      REQUIRE(sy[i] == v.y);
+      REQUIRE(sz[i] == v.z);
+      REQUIRE(vx[i] == Approx(v.x).margin(1e-5));
+      REQUIRE(vy[i] == Approx(v.y).margin(1e-5));
+      REQUIRE(vz[i] == Approx(v.z).margin(1e-5));
+    }
+  }
+
+  SECTION("Brick sizes")
+  {
+    REQUIRE(jay::bricked_field::brick_size_for(32 * 1024)  == 8);
+    REQUIRE(jay::bricked_field::brick_size_for(256 * 1024) == 16);
+    REQUIRE(jay::bricked_field::brick_size_for(1024)       == 4);
+
+    // Rounded up to a power of 2
+    jay::bricked_field bricks(field, 6);
+    REQUIRE(bricks.brick_size  == 8);
+    REQUIRE(bricks.brick_shift == 3);
+  }
+
+  SECTION("Tracing on bricks")
+  {
+    auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(0, 36), glm::uvec2(0, 28), glm::uvec2(0, 20), glm::vec3(12, 9, 6));
+    auto i_conf = jay_test::make_integration(glm::uvec4(37, 29, 21, 0), jay::StrategyRK4, 0.1f, 300);
+
+    auto report = jay::compare_bricked_linear(src, s_conf, i_conf, 8, 4, 1);
+
+    REQUIRE(report.brick_size == 8);
+    REQUIRE(report.steps == 12 * 9 * 6 * 300);
+    REQUIRE(report.bricked_bytes > report.linear_bytes);
+    REQUIRE(report.linear_time  > 0.0);
+    REQUIRE(report.bricked_time > 0.0);
+    REQUIRE(report.max_difference < 1e-3f);
+  }
+}
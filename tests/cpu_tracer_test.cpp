@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("CPU Tracer Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 field rotating around the z-axis through the center (linear => trilinear is exact)
+  const std::size_t n      = 33;
+  const float       center = 16.0f;
+
+  auto src = jay_test::rotation_field(n, center);
+
+  // 4 x 1 x 1 seeds on a line through the center
+  auto s_conf = jay_test::make_seeding(glm::vec3(2.0f, 1.0f, 1.0f), glm::uvec2(18, 26), glm::uvec2(16, 17), glm::uvec2(8, 9), glm::vec3(4, 1, 1));
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.01f, 1000);
+
+  jay::cpu_tracer tracer(src, 4);
+
+  SECTION("RK4 keeps the particles on their circles")
+  {
+    auto result = tracer.trace(s_conf, i_conf);
+
+    REQUIRE(result.seed_count == 4);
+    REQUIRE(result.positions.size() == 4 * 1000);
+
+    for (std::size_t s = 0; s < result.seed_count; s++)
+    {
+      const auto& seed   = result.positions[s * result.step_count];
+      const float radius = 2.0f + 2.0f * s;
+
+      // First step writes the seed itself
+      REQUIRE(seed.x == Approx(center + radius));
+      REQUIRE(seed.w == 1.0f);
+
+      for (std::size_t i = 0; i < result.step_count; i++)
+      {
+        const auto& p = result.positions[s * result.step_count + i];
+        REQUIRE(std::hypot(p.x - center, p.y - center) == Approx(radius).epsilon(1e-3));
+        REQUIRE(p.z == 8.0f);
+        REQUIRE(result.velocities[s * result.step_count + i].w == 0.0f);
+      }
+    }
+  }
+
+  SECTION("Particles leaving the domain are frozen")
+  {
+    // Uniform field in x
+    for (std::size_t i = 0; i < src.data.size(); i += 3)
+    {
+      src.data[i + 0] = 1.0f;
+      src.data[i + 1] = 0.0f;
+    }
+
+    i_conf.strategy    = 0;
+    i_conf.texelfetch  = 0;
+    i_conf.step_size_h = 0.5f;
+    i_conf.global_step_count = 100;
+    i_conf.local_step_count  = 100;
+
+    auto result = tracer.trace(s_conf, i_conf);
+
+    // The last seed starts at x = 24 and steps 0.5 per step, until it's beyond x = 32
+    const auto* p = &result.positions[3 * result.step_count];
+    REQUIRE(p[0].x  == 24.0f);
+    REQUIRE(p[16].x == 32.0f);
+    REQUIRE(p[17].x == 32.5f);
+    REQUIRE(p[99].x == 32.5f);
+  }
+}
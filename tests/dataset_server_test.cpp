@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Dataset Server Test.", "[jay::io]")
+{
+  auto src = jay_test::make_field({ 41, 33, 19, 1 }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(-(y - 16.0f) * 0.5f + 0.1f * std::sin(0.3f * z), (x - 20.0f) * 0.5f, 0.3f * std::cos(0.2f * (x + y)));
+  });
+  const std::vector<float> peaks = { -8.0f, 8.0f, -10.0f, 10.0f };
+
+  const std::string name = "jay_dataset_server_test";
+  jay::dataset_server server(name, src, peaks);
+  REQUIRE(server.valid());
+  REQUIRE(server.byte_size() >= src.data.size() * sizeof(float));
+
+  auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(1, 40), glm::uvec2(1, 32), glm::uvec2(1, 18), glm::vec3(13, 10, 6));
+  auto i_conf = jay_test::make_integration(glm::uvec4(41, 33, 19, 0), jay::StrategyRK4, 0.1f, 100);
+
+  const auto reference = jay::cpu_tracer(src, 2).trace(s_conf, i_conf);
+
+  // Attaches, checks the descriptor & data and traces on the shared copy
+  auto run_job = [&]()
+  {
+    jay::dataset_client client(name);
+    if (!client.valid())
+      return false;
+
+    const auto view = client.view();
+    if (view.grid != src.grid || view.grid_dim != 3 || view.vec_len != 3 || view.ordering != jay::Order::VectorFirst || client.peaks() != peaks)
+      return false;
+    if (view.data == src.data.data() || !std::equal(src.data.begin(), src.data.end(), view.data))
+      return false;
+
+    const auto result = jay::cpu_tracer(view, 2).trace(s_conf, i_conf);
+    return result.positions == reference.positions && result.velocities == reference.velocities;
+  };
+
+  SECTION("Attach in the same process")
+  {
+    REQUIRE(run_job());
+    REQUIRE(!jay::dataset_client("jay_dataset_server_missing", 10.0).valid());
+  }
+
+  SECTION("A served name is not taken over")
+  {
+    jay::dataset_server second(name, src);
+    REQUIRE(!second.valid());
+    REQUIRE(run_job());
+  }
+
+#ifndef _WIN32
+  SECTION("Eight jobs share one copy")
+  {
+    std::vector<pid_t> jobs;
+    for (int j = 0; j < 8; j++)
+    {
+      const pid_t pid = fork();
+      if (pid == 0)
+        _exit(run_job() ? 0 : 1);
+      REQUIRE(pid > 0);
+      jobs.push_back(pid);
+    }
+
+    for (auto pid : jobs)
+    {
+      int status = 0;
+      REQUIRE(waitpid(pid, &status, 0) == pid);
+      REQUIRE(WIFEXITED(status));
+      REQUIRE(WEXITSTATUS(status) == 0);
+    }
+  }
+
+  SECTION("The segment of a crashed server is replaced")
+  {
+    const std::string crashed = "jay_dataset_server_crashed";
+
+    // The server exits without removing its segment
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      jay::dataset_server server(crashed, src);
+      _exit(server.valid() ? 0 : 1);
+    }
+    REQUIRE(pid > 0);
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WEXITSTATUS(status) == 0);
+
+    jay::dataset_server replacement(crashed, src, peaks);
+    REQUIRE(replacement.valid());
+    REQUIRE(jay::dataset_client(crashed).peaks() == peaks);
+  }
+#endif
+}
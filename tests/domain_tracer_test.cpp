@@ -0,0 +1,143 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Domain Tracer Test.", "[jay::integration]")
+{
+  // 41 x 33 x 19 field with swirl in x/y & flow up and down along z, so particles cross the slabs
+  auto src = jay_test::make_field({ 41, 33, 19 }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(-(y - 16.0f) * 0.5f + 0.1f * std::sin(0.3f * z), (x - 20.0f) * 0.5f, 1.5f * std::cos(0.2f * (x + y)));
+  });
+
+  // Slabs are copied from the field, like hyperslabs read from a file
+  auto reader = [&](std::size_t z_offset, std::size_t z_count, float* dst)
+  {
+    const std::size_t layer = 41 * 33 * 3;
+    std::copy(src.data.begin() + z_offset * layer, src.data.begin() + (z_offset + z_count) * layer, dst);
+  };
+
+  auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(1, 40), glm::uvec2(1, 32), glm::uvec2(1, 18), glm::vec3(13, 10, 6));
+  auto i_conf = jay_test::make_integration(glm::uvec4(41, 33, 19, 0), jay::StrategyRK4, 0.1f, 200);
+
+  jay::cpu_tracer    reference_tracer(src, 4);
+  jay::domain_tracer tracer(glm::uvec3(41, 33, 19), 3, reader, 2);
+
+  REQUIRE(tracer.subdomain_range(0).first  == 0);
+  REQUIRE(tracer.subdomain_range(2).second == 18);
+  for (std::size_t r = 1; r < 3; r++)
+    REQUIRE(tracer.subdomain_range(r).first == tracer.subdomain_range(r - 1).second);
+
+  for (auto strategy : { jay::StrategyRK4, jay::StrategyEuler })
+  {
+    i_conf.strategy = strategy;
+
+    auto reference = reference_tracer.trace(s_conf, i_conf);
+    auto domain    = tracer.trace(s_conf, i_conf);
+
+    REQUIRE(domain.positions.size() == reference.positions.size());
+    for (std::size_t i = 0; i < reference.positions.size(); i++)
+    {
+      REQUIRE(glm::distance(domain.positions [i], reference.positions [i]) < 1e-3f);
+      REQUIRE(glm::distance(domain.velocities[i], reference.velocities[i]) < 1e-3f);
+    }
+
+    // Each worker loaded only its slab & halo
+    const auto& stats = tracer.get_stats();
+    REQUIRE(stats.subdomains.size() == 3);
+    for (const auto& s : stats.subdomains)
+    {
+      REQUIRE(s.finished);
+      REQUIRE(s.z_count < 19);
+      REQUIRE(s.steps > 0);
+    }
+    REQUIRE(stats.steps() > 0);
+    REQUIRE(stats.handoffs() > 0);
+    REQUIRE(stats.halo_misses() == 0);
+    REQUIRE(stats.processes);
+  }
+
+  i_conf.strategy = jay::StrategyRK4;
+  auto reference = reference_tracer.trace(s_conf, i_conf);
+
+  auto same = [&](const jay::cpu_trace_result& domain)
+  {
+    REQUIRE(domain.positions.size() == reference.positions.size());
+    for (std::size_t i = 0; i < reference.positions.size(); i++)
+      REQUIRE(glm::distance(domain.positions[i], reference.positions[i]) < 1e-3f);
+  };
+
+  // Workers read hyperslabs of a HDF5 file
+  {
+    const std::string h5_filepath = "domain_tracer_test.h5";
+    jay_test::write_hdf5(h5_filepath, { "u", "v", "w" }, src);
+
+    jay::domain_tracer h5_tracer(h5_filepath, { "u", "v", "w" }, 3, 2);
+    same(h5_tracer.trace(s_conf, i_conf));
+    for (const auto& s : h5_tracer.get_stats().subdomains)
+      REQUIRE(s.finished);
+
+    std::remove(h5_filepath.c_str());
+  }
+
+  // A running thread could hold locks a forked worker inherits, the workers become threads
+  {
+    std::atomic<bool> stop { false };
+    std::thread background([&]() { while (!stop) std::this_thread::yield(); });
+
+    same(tracer.trace(s_conf, i_conf));
+    REQUIRE(!tracer.get_stats().processes);
+
+    stop = true;
+    background.join();
+  }
+
+  // Streamed out of the shared memory seed by seed
+  {
+    const std::size_t steps = i_conf.global_step_count;
+
+    jay::cpu_trace_result streamed;
+    streamed.positions.resize(reference.positions.size());
+    std::size_t seeds = 0;
+    tracer.trace(s_conf, i_conf, [&](std::size_t seed, const glm::vec4* positions, const glm::vec4*)
+    {
+      std::copy(positions, positions + steps, streamed.positions.begin() + seed * steps);
+      seeds++;
+    });
+
+    REQUIRE(seeds == reference.seed_count);
+    same(streamed);
+  }
+
+  // A failing worker ends the trace instead of leaving the others waiting for its particles
+  {
+    auto failing = [&](std::size_t z_offset, std::size_t z_count, float* dst)
+    {
+      if (z_offset > 0 && z_offset + z_count < 19)
+        throw std::runtime_error("unreadable slab");
+      reader(z_offset, z_count, dst);
+    };
+
+    jay::domain_tracer failing_tracer(glm::uvec3(41, 33, 19), 3, failing, 2);
+    failing_tracer.trace(s_conf, i_conf);
+    REQUIRE(!failing_tracer.get_stats().subdomains[1].finished);
+  }
+
+  // Adaptive & multistep schemes aren't supported
+  for (auto strategy : { jay::StrategyRK45, jay::StrategyABM4 })
+  {
+    i_conf.strategy = strategy;
+    REQUIRE_THROWS_AS(tracer.trace(s_conf, i_conf), std::invalid_argument);
+  }
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Ensemble Tracer Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 members: a swirl with a drift in z that differs per member
+  const std::size_t n       = 33;
+  const std::size_t members = 4;
+
+  std::vector<jaySrc<float>> ensemble;
+  for (std::size_t m = 0; m < members; m++)
+    ensemble.push_back(jay_test::make_field({ n, n, n }, [&](float x, float y, float, float)
+    {
+      return glm::vec3(-(y - 16.0f) * 0.3f, (x - 16.0f) * 0.3f, 0.1f * (m + 1) * std::sin(0.2f * x));
+    }));
+
+  auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(2, 29), glm::uvec2(2, 29), glm::uvec2(4, 28), glm::vec3(9, 9, 8), jay::SeedOrderMorton);
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.05f, 150);
+  i_conf.tolerance     = 1e-4f;
+  i_conf.step_size_min = 0.001f;
+  i_conf.step_size_max = 0.5f;
+
+  jay::ensemble_tracer tracer(ensemble, 4);
+  REQUIRE(tracer.get_member_count() == members);
+
+  for (auto strategy : { jay::StrategyEuler, jay::StrategyRK4, jay::StrategyRK45, jay::StrategyABM4 })
+    for (auto texelfetch : { 0, 1 })
+    {
+      i_conf.strategy   = strategy;
+      i_conf.texelfetch = texelfetch;
+
+      auto result = tracer.trace(s_conf, i_conf);
+      REQUIRE(result.member_count == members);
+      REQUIRE(result.seed_count   == 9 * 9 * 8);
+      REQUIRE(result.positions.size() == members * result.seed_count * result.step_count);
+
+      // Member after member, each the same as tracing the member on its own
+      for (std::size_t m = 0; m < members; m++)
+      {
+        jay::cpu_tracer single(ensemble[m], 4);
+        auto reference = single.trace(s_conf, i_conf);
+
+        const std::size_t offset = result.offset(m, 0);
+        for (std::size_t v = 0; v < reference.positions.size(); v++)
+        {
+          REQUIRE(result.positions [offset + v] == reference.positions [v]);
+          REQUIRE(result.velocities[offset + v] == reference.velocities[v]);
+        }
+      }
+    }
+
+  // Bricked members, each the same as a bricked cpu_tracer
+  tracer.use_bricks(8);
+  i_conf.strategy   = jay::StrategyRK4;
+  i_conf.texelfetch = 1;
+  {
+    auto result = tracer.trace(s_conf, i_conf);
+    for (std::size_t m = 0; m < members; m++)
+    {
+      jay::cpu_tracer single(ensemble[m], 4);
+      single.use_bricks(8);
+      auto reference = single.trace(s_conf, i_conf);
+
+      const std::size_t offset = result.offset(m, 0);
+      for (std::size_t v = 0; v < reference.positions.size(); v++)
+        REQUIRE(result.positions[offset + v] == reference.positions[v]);
+    }
+  }
+  tracer.use_bricks(0);
+
+  // Members differ
+  i_conf.strategy = jay::StrategyRK4;
+  auto result = tracer.trace(s_conf, i_conf);
+  REQUIRE(result.positions[result.offset(0, 10) + 100] != result.positions[result.offset(3, 10) + 100]);
+}
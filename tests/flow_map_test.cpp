@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Flow Map Test.", "[jay::integration]")
+{
+  // Synthetic 25^3 x 7 fields
+  const std::size_t n = 25;
+  const std::size_t t = 7;
+
+  auto make_field = [&](auto velocity)
+  {
+    return jay_test::make_field({ n, n, n, t }, [&](float x, float y, float z, float s) { return velocity(glm::vec3(x, y, z), s); });
+  };
+
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, t), jay::StrategyRK4, 0.05f, 20 * (t - 1));
+  i_conf.local_step_count = 20;
+
+  SECTION("Composition follows the direct trace")
+  {
+    // Time dependent swirls
+    const auto src = make_field([](const glm::vec3& p, float s)
+    {
+      return glm::vec3(std::sin(0.25f * p.y + 0.3f * s), std::sin(0.25f * p.z), std::sin(0.25f * p.x - 0.2f * s));
+    });
+
+    jay::flow_map_engine engine(src, 4);
+    engine.compute(i_conf);
+    REQUIRE(engine.get_interval_count() == t - 1);
+    REQUIRE(engine.get_node_dims() == glm::uvec3(n, n, n));
+
+    // A single sub-interval is exact at the nodes
+    auto single = engine.compose(2, 1);
+    auto direct = engine.trace  (2, 1);
+    REQUIRE(!single.composed);
+    REQUIRE(single.positions == direct.positions);
+
+    for (std::size_t length = 2; length <= 4; length++)
+    {
+      auto composed  = engine.compose(1, length);
+      auto reference = engine.trace  (1, length);
+      REQUIRE(composed.composed);
+      REQUIRE(composed.error_bound == engine.error_bound(1, length));
+
+      // Within the bound of each node, which stays small away from the border
+      double max_error = 0.0;
+      for (std::size_t i = 0; i < composed.positions.size(); i++)
+      {
+        const float error = glm::distance(composed.positions[i], reference.positions[i]);
+        REQUIRE(error <= composed.errors[i]);
+        max_error = std::max(max_error, static_cast<double>(error));
+      }
+      REQUIRE(max_error > 0.0);
+      REQUIRE(composed.errors[(12 * n + 12) * n + 12] < 0.1f);
+    }
+
+    // Windows above the tolerance are traced directly
+    engine.set_error_tolerance(engine.error_bound(0, 3) * 0.5);
+    auto fallback = engine.compose(0, 3);
+    REQUIRE(!fallback.composed);
+    REQUIRE(fallback.positions == engine.trace(0, 3).positions);
+
+    // Coarser nodes
+    engine.compute(i_conf, 4);
+    REQUIRE(engine.get_node_dims() == glm::uvec3(7, 7, 7));
+    REQUIRE(engine.compose(0, 2).positions.size() == 7 * 7 * 7);
+  }
+
+  SECTION("Particles leaving the domain stay stopped")
+  {
+    // A drift of 3 cells per sub-interval in x, slower along the border in y
+    const auto src = make_field([](const glm::vec3&, float)
+    {
+      return glm::vec3(3.0f, 0.5f, 0.0f);
+    });
+
+    jay::flow_map_engine engine(src, 4);
+    engine.compute(i_conf);
+
+    auto id = [&](std::size_t x, std::size_t y, std::size_t z) { return (z * n + y) * n + x; };
+
+    // Node 23 leaves halfway through the first sub-interval, node 17 in the third one, node 14 stays inside
+    const auto first     = engine.trace(0, 1);
+    const auto reference = engine.trace(0, 3);
+    REQUIRE( first    .stopped[id(23, 4, 4)]);
+    REQUIRE(!first    .stopped[id(17, 4, 4)]);
+    REQUIRE( reference.stopped[id(17, 4, 4)]);
+    REQUIRE(!reference.stopped[id(14, 4, 4)]);
+
+    // Stopped particles don't move anymore
+    REQUIRE(reference.positions[id(23, 4, 4)] == first.positions[id(23, 4, 4)]);
+    REQUIRE(reference.positions[id(23, 4, 4)].x == Approx(n - 1));
+
+    auto composed = engine.compose(0, 3);
+    REQUIRE(composed.composed);
+    for (std::size_t i = 0; i < composed.positions.size(); i++)
+    {
+      REQUIRE(glm::distance(composed.positions[i], reference.positions[i]) <= composed.errors[i] + 1e-4f);
+      if (first.stopped[i])
+      {
+        REQUIRE(composed.stopped[i]);
+        REQUIRE(composed.positions[i] == reference.positions[i]);
+      }
+    }
+    REQUIRE(composed.stopped[id(17, 4, 4)]);
+    REQUIRE(composed.positions[id(17, 4, 4)].x == Approx(n - 1));
+
+    // Adaptive steps don't fit sub-intervals of fixed steps
+    auto rk45 = i_conf;
+    rk45.strategy = jay::StrategyRK45;
+    REQUIRE_THROWS_AS(engine.compute(rk45), std::invalid_argument);
+  }
+
+  SECTION("FTLE of a saddle")
+  {
+    // Stretching in x, compression in y: the FTLE is the rate a everywhere away from the border
+    const float a   = 0.2f;
+    const auto  src = make_field([&](const glm::vec3& p, float)
+    {
+      return glm::vec3(a * (p.x - 12.0f), -a * (p.y - 12.0f), 0.0f);
+    });
+
+    jay::flow_map_engine engine(src, 4);
+    engine.compute(i_conf);
+
+    const auto windows = engine.sliding_ftle(2);
+    REQUIRE(windows.size() == t - 2);
+
+    for (const auto& field : windows)
+    {
+      REQUIRE(field.size() == n * n * n);
+      // Nodes that stay inside the domain over 2 time units
+      for (std::size_t z = 1; z < n - 1; z++)
+        for (std::size_t y = 3; y < n - 3; y++)
+          for (std::size_t x = 10; x < 15; x++)
+            REQUIRE(field[(z * n + y) * n + x] == Approx(a).epsilon(0.01));
+    }
+  }
+}
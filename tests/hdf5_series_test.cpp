@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("HDF5 Series Test.", "[jay::io]")
+{
+  // 7 timesteps of a 9 x 6 x 5 field: a 4D file with 3 timesteps, then 4 3D files
+  const std::vector<std::string> datasets = { "u", "v", "w" };
+
+  auto value = [](float x, float y, float z, float t) { return glm::vec3(x + 10.0f * t, y - z, 0.5f * t + z); };
+  auto whole = jay_test::make_field({ 9, 6, 5, 7 }, value);
+
+  std::vector<std::string> files;
+  files.push_back("hdf5_series_test_0.h5");
+  jay_test::write_hdf5(files.back(), datasets, jay_test::make_field({ 9, 6, 5, 3 }, value));
+  for (int t = 3; t < 7; t++)
+  {
+    files.push_back("hdf5_series_test_" + std::to_string(t) + ".h5");
+    jay_test::write_hdf5(files.back(), datasets, jay_test::make_field({ 9, 6, 5 }, [&](float x, float y, float z, float) { return value(x, y, z, static_cast<float>(t)); }));
+  }
+
+  SECTION("Files matching a pattern form one 4D field")
+  {
+    jay::hdf5_series series({ "hdf5_series_test_*.h5" }, datasets, 4);
+
+    REQUIRE(series.valid());
+    REQUIRE(series.members.size() == 5);
+    REQUIRE(series.get_grid() == std::vector<std::size_t>{ 9, 6, 5, 7 });
+    REQUIRE(series.get_grid_dim() == 4);
+    REQUIRE(series.timesteps() == 7);
+
+    auto read = series.read<float>();
+    REQUIRE(read.data == whole.data);
+
+    // Single timesteps, vectorlike & componentwise
+    std::vector<float> slice(series.slice_elements());
+    series.read_timestep(slice.data(), 4);
+    REQUIRE(std::equal(slice.begin(), slice.end(), whole.data.begin() + 4 * series.slice_elements()));
+
+    series.read_timestep(slice.data(), 5, jay::Order::ComponentFirst);
+    const std::size_t nodes = series.slice_elements() / 3;
+    for (std::size_t i = 0; i < nodes; i++)
+      for (std::size_t c = 0; c < 3; c++)
+        REQUIRE(slice[c * nodes + i] == whole.data[5 * series.slice_elements() + 3 * i + c]);
+  }
+
+  SECTION("Mismatching grids are rejected")
+  {
+    jay_test::write_hdf5("hdf5_series_test_other.h5", datasets, jay_test::make_field({ 9, 6, 4 }, value));
+
+    jay::hdf5_series series({ files[0], "hdf5_series_test_other.h5" }, datasets);
+    REQUIRE(!series.valid());
+    REQUIRE(series.timesteps() == 0);
+
+    std::remove("hdf5_series_test_other.h5");
+  }
+
+  SECTION("Missing files leave an empty series")
+  {
+    jay::hdf5_series series({ files[0], "hdf5_series_test_missing.h5" }, datasets);
+    REQUIRE(!series.valid());
+    REQUIRE(series.get_grid() == std::vector<std::size_t>{ 0, 0, 0, 0 });
+    REQUIRE(series.get_grid_dim() == 0);
+    REQUIRE(series.timesteps() == 0);
+
+    // Reads are refused and leave the buffer untouched
+    std::vector<float> slice(9 * 6 * 5 * 3, -1.0f);
+    series.read_timestep(slice.data(), 0);
+    series.timestep_reader()(0, slice.data());
+    REQUIRE(slice == std::vector<float>(9 * 6 * 5 * 3, -1.0f));
+  }
+
+  SECTION("Timesteps beyond the last file are refused")
+  {
+    jay::hdf5_series series({ "hdf5_series_test_*.h5" }, datasets);
+    std::vector<float> slice(series.slice_elements(), -1.0f);
+    series.read_timestep(slice.data(), 7);
+    series.read_component(slice.data(), 100, 0);
+    REQUIRE(slice == std::vector<float>(series.slice_elements(), -1.0f));
+  }
+
+  SECTION("Numbered files are ordered by their number")
+  {
+    for (auto step : { "2", "10", "1", "002a" })
+      jay_test::write_hdf5(std::string("hdf5_series_order_") + step + ".h5", datasets, jay_test::make_field({ 2, 2, 2 }, value));
+
+    const auto matches = jay::hdf5_series::expand_pattern("hdf5_series_order_*.h5");
+    REQUIRE(matches.size() == 4);
+    REQUIRE(std::filesystem::path(matches[0]).filename() == "hdf5_series_order_1.h5");
+    REQUIRE(std::filesystem::path(matches[1]).filename() == "hdf5_series_order_2.h5");
+    REQUIRE(std::filesystem::path(matches[2]).filename() == "hdf5_series_order_002a.h5");
+    REQUIRE(std::filesystem::path(matches[3]).filename() == "hdf5_series_order_10.h5");
+
+    for (const auto& match : matches)
+      std::remove(match.c_str());
+  }
+
+  for (const auto& file : files)
+    std::remove(file.c_str());
+}
@@ -64,7 +64,7 @@ TEST_CASE("Jay Unsteady Test.", "[jay::engine]")
     menu->int_step_size_dt = 0.1;
     menu->int_step_size_h = 0.1;
     menu->int_global_step_count = 2000;
-    menu->int_strategy_rk4 = true;
+    menu->int_strategy = 1;
     menu->int_simulation_range = glm::vec4(1, 0.6, 0.2, 2.01);
     menu->calc_executed_steps();
     menu->displayIntegrationParams();
@@ -141,7 +141,7 @@ TEST_CASE("Jay Unsteady Test.", "[jay::engine]")
     menu->int_step_size_dt = 0.1;
     menu->int_step_size_h = 0.1;
     menu->int_global_step_count = 2000;
-    menu->int_strategy_rk4 = true;
+    menu->int_strategy = 1;
     menu->int_simulation_range = glm::vec4(1, 0.6, 0.2, 2.01);
     menu->calc_executed_steps();
     menu->displayIntegrationParams();
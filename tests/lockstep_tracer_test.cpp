@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Lockstep Tracer Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 field with a swirl & a drift in z, the other one slightly perturbed
+  const std::size_t n = 33;
+
+  auto make_field = [&](float perturbation)
+  {
+    return jay_test::make_field({ n, n, n }, [&](float x, float y, float z, float)
+    {
+      return glm::vec3(-(y - 16.0f) * 0.3f, (x - 16.0f) * 0.3f + perturbation * std::cos(0.3f * z), 0.2f * std::sin(0.2f * x));
+    });
+  };
+
+  const auto reference = make_field(0.0f);
+  const auto other     = make_field(0.05f);
+
+  auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(2, 29), glm::uvec2(2, 29), glm::uvec2(4, 28), glm::vec3(9, 9, 8), jay::SeedOrderHilbert);
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.05f, 200);
+
+  const std::size_t seeds = 9 * 9 * 8;
+
+  jay::cpu_tracer      reference_tracer(reference, 4);
+  jay::cpu_tracer      other_tracer    (other,     4);
+  jay::lockstep_tracer tracer(reference, other, 4);
+
+  for (auto strategy : { jay::StrategyEuler, jay::StrategyRK4, jay::StrategyABM4 })
+  {
+    i_conf.strategy = strategy;
+
+    auto a = reference_tracer.trace(s_conf, i_conf);
+    auto b = other_tracer    .trace(s_conf, i_conf);
+    auto r = tracer.trace(s_conf, i_conf, 0.5f, true);
+
+    REQUIRE(r.seeds.size() == seeds);
+
+    // Same trajectories as tracing both fields on their own
+    REQUIRE(r.reference.positions.size() == a.positions.size());
+    REQUIRE(r.other    .positions.size() == b.positions.size());
+    for (std::size_t v = 0; v < a.positions.size(); v++)
+    {
+      REQUIRE(r.reference.positions[v] == a.positions[v]);
+      REQUIRE(r.other    .positions[v] == b.positions[v]);
+    }
+
+    // Same measures as on the read back trajectories
+    std::vector<float> pos0(reinterpret_cast<float*>(a.positions.data()), reinterpret_cast<float*>(a.positions.data() + a.positions.size()));
+    std::vector<float> pos1(reinterpret_cast<float*>(b.positions.data()), reinterpret_cast<float*>(b.positions.data() + b.positions.size()));
+    const auto distances = jay::calculate_seed_distance(pos0, pos1, seeds);
+    const auto areas     = jay::calculate_seed_area    (pos0, pos1, seeds);
+
+    std::size_t diverged = 0;
+    for (std::size_t s = 0; s < seeds; s++)
+    {
+      REQUIRE(r.seeds[s].mean_distance == Approx(distances[s]).margin(1e-9));
+      REQUIRE(r.seeds[s].area          == Approx(areas    [s]).margin(1e-9));
+      REQUIRE(r.seeds[s].max_distance  >= r.seeds[s].mean_distance);
+      REQUIRE(r.seeds[s].divergence_step <= 200);
+      diverged += (r.seeds[s].divergence_step < 200) ? 1 : 0;
+    }
+
+    REQUIRE(r.summary.diverged_seeds == diverged);
+    REQUIRE(r.summary.max_distance > 0.0);
+
+    // Packed traces have the area of their frozen full layout
+    const std::size_t steps = a.positions.size() / seeds;
+    std::vector<unsigned int> first0(seeds), count0(seeds), first1(seeds), count1(seeds);
+    std::vector<float>        packed0, packed1;
+    for (std::size_t s = 0; s < seeds; s++)
+    {
+      count0[s] = static_cast<unsigned int>(1 + (s * 7) % steps);
+      count1[s] = static_cast<unsigned int>(1 + (s * 13) % steps);
+      first0[s] = static_cast<unsigned int>(packed0.size() / 4);
+      first1[s] = static_cast<unsigned int>(packed1.size() / 4);
+
+      for (std::size_t i = 0; i < steps; i++)
+      {
+        if (i < count0[s])
+          packed0.insert(packed0.end(), &pos0[4 * (s * steps + i)], &pos0[4 * (s * steps + i)] + 4);
+        else
+          std::copy(&pos0[4 * (s * steps + count0[s] - 1)], &pos0[4 * (s * steps + count0[s])], &pos0[4 * (s * steps + i)]);
+
+        if (i < count1[s])
+          packed1.insert(packed1.end(), &pos1[4 * (s * steps + i)], &pos1[4 * (s * steps + i)] + 4);
+        else
+          std::copy(&pos1[4 * (s * steps + count1[s] - 1)], &pos1[4 * (s * steps + count1[s])], &pos1[4 * (s * steps + i)]);
+      }
+    }
+
+    const auto frozen_areas = jay::calculate_seed_area(pos0, pos1, seeds);
+    const auto packed_areas = jay::calculate_seed_area(packed0, first0, count0, packed1, first1, count1);
+    for (std::size_t s = 0; s < seeds; s++)
+      REQUIRE(packed_areas[s] == Approx(frozen_areas[s]).margin(1e-9));
+  }
+
+  SECTION("Identical fields don't diverge")
+  {
+    jay::lockstep_tracer same(reference, reference, 4);
+    auto r = same.trace(s_conf, i_conf);
+
+    REQUIRE(r.reference.positions.empty());
+    REQUIRE(r.summary.max_distance   == 0.0);
+    REQUIRE(r.summary.total_area     == 0.0);
+    REQUIRE(r.summary.diverged_seeds == 0);
+  }
+}
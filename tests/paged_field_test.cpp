@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Paged Field Test.", "[jay::io]")
+{
+  // 41 x 33 x 19 field (no multiple of the brick size) with smooth, non-linear content
+  auto src = jay_test::make_field({ 41, 33, 19 }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(-(y - 16.0f) * 0.5f + 0.1f * std::sin(0.3f * z), (x - 20.0f) * 0.5f, 0.3f * std::cos(0.2f * (x + y)));
+  });
+
+  const std::string filepath = "paged_field_test.jayb";
+  REQUIRE(jay::paged_field::write(src, filepath, 8, 2));
+
+  const jay::field_view linear(src);
+
+  SECTION("Nodes match the field")
+  {
+    // Room for 3 bricks of 13^3 nodes
+    jay::paged_field field(filepath, 3 * 13 * 13 * 13 * 3 * sizeof(float));
+
+    REQUIRE(field.brick_nodes == 13);
+    REQUIRE(field.bricks == glm::ivec3(5, 4, 3));
+    REQUIRE(field.capacity() == 3);
+
+    for (int z = -1; z <= 19; z++)
+      for (int y = -1; y <= 33; y++)
+        for (int x = -1; x <= 41; x++)
+          REQUIRE(field.node(x, y, z) == linear.node(x, y, z));
+
+    // Ghost layers hold the nodes of the neighbours
+    const auto  brick  = field.brick_of(glm::vec3(9.5f, 9.5f, 9.5f));
+    const auto  origin = field.brick_origin(brick);
+    const float* data  = field.acquire(brick);
+    REQUIRE(origin == glm::ivec3(6, 6, 6));
+    for (int z = 0; z < 13; z++)
+      for (int y = 0; y < 13; y++)
+        for (int x = 0; x < 13; x++)
+        {
+          const float* v = data + 3 * ((z * 13 + y) * 13 + x);
+          REQUIRE(glm::vec3(v[0], v[1], v[2]) == linear.node(origin.x + x, origin.y + y, origin.z + z));
+        }
+    field.release(brick);
+
+    REQUIRE(field.get_stats().loads >= field.brick_count());
+    REQUIRE(field.get_stats().evictions > 0);
+  }
+
+  SECTION("Tracing brick by brick")
+  {
+    auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 3.0f), glm::uvec2(1, 40), glm::uvec2(1, 32), glm::uvec2(1, 18), glm::vec3(13, 10, 6));
+    auto i_conf = jay_test::make_integration(glm::uvec4(41, 33, 19, 0), jay::StrategyRK4, 0.1f, 200);
+
+    jay::cpu_tracer reference_tracer(src, 4);
+    auto reference = reference_tracer.trace(s_conf, i_conf);
+
+    // Budget of 4 bricks out of 60
+    jay::paged_field  field(filepath, 4 * 13 * 13 * 13 * 3 * sizeof(float));
+    jay::paged_tracer tracer(field, 4);
+    auto paged = tracer.trace(s_conf, i_conf);
+
+    REQUIRE(paged.positions.size() == reference.positions.size());
+    for (std::size_t i = 0; i < reference.positions.size(); i++)
+    {
+      REQUIRE(glm::distance(paged.positions [i], reference.positions [i]) < 1e-3f);
+      REQUIRE(glm::distance(paged.velocities[i], reference.velocities[i]) < 1e-3f);
+    }
+
+    const auto& stats = tracer.get_stats();
+    REQUIRE(stats.steps > 0);
+    REQUIRE(stats.handoffs > 0);
+    REQUIRE(stats.paging.evictions > 0);
+    // Particles are processed brick by brick, not step by step
+    REQUIRE(stats.paging.loads < stats.steps / 10);
+
+    for (auto strategy : { jay::StrategyRK45, jay::StrategyABM4 })
+    {
+      i_conf.strategy = strategy;
+      REQUIRE_THROWS_AS(tracer.trace(s_conf, i_conf), std::invalid_argument);
+    }
+  }
+
+  SECTION("Threads page in bricks at the same time")
+  {
+    // Room for all 60 bricks, every thread reads its own ones
+    jay::paged_field field(filepath, 60 * 13 * 13 * 13 * 3 * sizeof(float));
+
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> mismatches{ 0 };
+    for (std::size_t t = 0; t < 4; t++)
+      threads.emplace_back([&, t]()
+      {
+        for (std::size_t brick = t; brick < field.brick_count(); brick += 4)
+        {
+          const float*     nodes  = field.acquire(brick);
+          const glm::ivec3 origin = field.brick_origin(brick);
+          const int        n      = field.brick_nodes;
+
+          for (int z = 0; z < n; z++)
+            for (int y = 0; y < n; y++)
+              for (int x = 0; x < n; x++)
+              {
+                const float* node = nodes + 3 * ((static_cast<std::size_t>(z) * n + y) * n + x);
+                if (glm::vec3(node[0], node[1], node[2]) != linear.node(origin.x + x, origin.y + y, origin.z + z))
+                  mismatches++;
+              }
+
+          field.release(brick);
+        }
+      });
+
+    for (auto& thread : threads)
+      thread.join();
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(field.get_stats().loads == field.brick_count());
+  }
+
+  SECTION("Bricks of a HDF5 file")
+  {
+    const std::string h5_filepath = "paged_field_test.h5";
+    jay_test::write_hdf5(h5_filepath, { "u", "v", "w" }, src);
+
+    REQUIRE(jay::paged_field::write_hdf5(h5_filepath, { "u", "v", "w" }, "paged_field_test_h5.jayb", 8, 2));
+
+    jay::paged_field field("paged_field_test_h5.jayb", 3 * 13 * 13 * 13 * 3 * sizeof(float));
+    for (int z = -1; z <= 19; z++)
+      for (int y = -1; y <= 33; y++)
+        for (int x = -1; x <= 41; x++)
+          REQUIRE(field.node(x, y, z) == linear.node(x, y, z));
+
+    std::remove(h5_filepath.c_str());
+    std::remove("paged_field_test_h5.jayb");
+  }
+
+  std::remove(filepath.c_str());
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+#include <jay/api.hpp>
+#include <jay/integration/schemes.hpp>
+
+
+TEST_CASE("Particle Batch Test.", "[jay::integration]")
+{
+  // Random 16^3 field with a drift in x, so that some particles leave the domain
+  const std::size_t n = 16;
+
+  std::mt19937                          rng(7);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+  jaySrc<float> src;
+  src.grid     = { n, n, n };
+  src.grid_dim = 3;
+  src.vec_len  = 3;
+  src.ordering = jay::Order::VectorFirst;
+  src.data.resize(n * n * n * 3);
+  for (std::size_t i = 0; i < src.data.size(); i++)
+    src.data[i] = value(rng) + ((i % 3 == 0) ? 1.0f : 0.0f);
+
+  // 11 seeds: a full and a partial batch
+  std::uniform_real_distribution<float> position(0.0f, n - 1.0f);
+  std::vector<glm::vec4> seeds(11);
+  for (auto& seed : seeds)
+    seed = glm::vec4(position(rng), position(rng), position(rng), 1.0f);
+
+  const jay::field_view        field(src);
+  const jay::trilinear_sampler sampler(field);
+  const glm::vec4              cf    = jay::cell_factor(glm::vec4(1.0f, 2.0f, 1.0f, 0.0f));
+  const float                  h     = 0.25f;
+  const std::size_t            steps = 200;
+
+  for (bool rk4 : { false, true })
+  {
+    // Batched
+    std::vector<glm::vec4> positions(seeds.size() * steps), velocities(seeds.size() * steps);
+    for (std::size_t s = 0; s < seeds.size(); s += 8)
+    {
+      jay::particle_batch<> batch;
+      batch.load(&seeds[s], seeds.size() - s);
+
+      for (std::size_t i = 0; i < steps; i++)
+      {
+        if (batch.update_alive(field))
+        {
+          if (rk4)
+            jay::rk4_step  (batch, sampler, h, 0.5f, cf);
+          else
+            jay::euler_step(batch, sampler, h, 0.5f, cf);
+        }
+        batch.store(&positions[s * steps], &velocities[s * steps], steps, i);
+      }
+    }
+
+    // Scalar reference
+    std::size_t frozen = 0;
+    for (std::size_t s = 0; s < seeds.size(); s++)
+    {
+      auto pos  = seeds[s];
+      auto velo = glm::vec4(0.0f);
+      for (std::size_t i = 0; i < steps; i++)
+      {
+        if (field.contains(glm::vec3(pos)))
+        {
+          pos  = pos + h * velo;
+          velo = rk4 ? jay::rk4_velo(sampler, pos, h, 0.5f, cf) : jay::euler_velo(sampler, pos, h, 0.5f, cf);
+        }
+
+        const auto& p = positions [s * steps + i];
+        const auto& v = velocities[s * steps + i];
+        REQUIRE(p.x == Approx(pos.x).margin(1e-3));
+        REQUIRE(p.y == Approx(pos.y).margin(1e-3));
+        REQUIRE(p.z == Approx(pos.z).margin(1e-3));
+        REQUIRE(p.w == 1.0f);
+        REQUIRE(v.x == Approx(velo.x).margin(1e-3));
+        REQUIRE(v.w == 0.0f);
+      }
+
+      if (!field.contains(glm::vec3(pos)))
+        frozen++;
+    }
+
+    CHECK(frozen > 0);
+  }
+}
@@ -616,6 +616,31 @@ double weighted_mean_of_seeds(std::vector<double>& averaged_error, std::vector<i
   return mean / datapoints;
 }
 
+// Exported trajectories as vec4 (seed-major), legacy raw exports are prefixed with the seed count
+std::vector<float> load_trajectories(jay::io& filedriver, const std::string& filepath, std::uint32_t& seeds)
+{
+  if (jay::trajectory_io::is_trajectory_file(filepath))
+  {
+    jay::trajectory_header hdr;
+    auto trajectories = jay::trajectory_io::load(filepath, &hdr);
+
+    seeds = trajectories.empty() ? 0 : hdr.seeds;
+    return trajectories;
+  }
+
+  auto trajectories = filedriver.read_vector<float>(filepath);
+  if (trajectories.empty())
+  {
+    seeds = 0;
+    return trajectories;
+  }
+
+  memcpy(&seeds, trajectories.data(), sizeof(std::uint32_t));
+  trajectories.erase(trajectories.begin());
+
+  return trajectories;
+}
+
 TEST_CASE("Results Test.", "[jay::engine]")
 {
   std::string input_path = "../files/input/";
@@ -666,17 +691,21 @@ TEST_CASE("Results Test.", "[jay::engine]")
 
   for (const auto& paths : files)
   { 
-    auto src = filedriver.read_vector<float>(paths.first.string());
-    auto cmp = filedriver.read_vector<float>(paths.second.string());
+    std::uint32_t cmp_seeds = 0;
+    auto src = load_trajectories(filedriver, paths.first.string(), seeds);
+    auto cmp = load_trajectories(filedriver, paths.second.string(), cmp_seeds);
+
+    if (seeds == 0 || seeds != cmp_seeds || src.size() != cmp.size())
+    {
+      std::cout << "Skipping: " << paths.first.filename() << " and " << paths.second.filename() << " don't match" << std::endl;
+      continue;
+    }
 
     std::cout << "Processing: " << paths.first.filename() << std::endl;
     std::cout << "Comparing: " << paths.second.filename() << std::endl;
 
     if (paths.first.extension().string()._Equal(".positions"))
     {
-      seeds = *reinterpret_cast<std::uint32_t*>(&src[0]);
-      src.erase(src.begin());
-      cmp.erase(cmp.begin());
       std::vector<double> scalars;
 
       int steps_skipped = 0;
@@ -735,9 +764,6 @@ TEST_CASE("Results Test.", "[jay::engine]")
     }
     else
     {
-      seeds = *reinterpret_cast<std::uint32_t*>(&src[0]);
-      src.erase(src.begin());
-      cmp.erase(cmp.begin());
 
       std::vector<double> scalars;
 
@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("RK45 Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 field rotating around the z-axis through the center with angular velocity 1
+  const std::size_t n      = 33;
+  const float       center = 16.0f;
+
+  auto src = jay_test::rotation_field(n, center);
+
+  // 4 x 1 x 1 seeds on a line through the center
+  auto s_conf = jay_test::make_seeding(glm::vec3(2.0f, 1.0f, 1.0f), glm::uvec2(18, 26), glm::uvec2(16, 17), glm::uvec2(8, 9), glm::vec3(4, 1, 1));
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK45, 0.05f, 200);
+  i_conf.tolerance        = 1e-4f;
+  i_conf.step_size_min    = 1e-3f;
+  i_conf.step_size_max    = 1.0f;
+  i_conf.resample_mode    = 1;
+  i_conf.resample_spacing = 0.0f;
+
+  jay::cpu_tracer tracer(src, 4);
+
+  SECTION("Fixed time resampling follows the exact solution")
+  {
+    auto result = tracer.trace(s_conf, i_conf);
+
+    for (std::size_t s = 0; s < result.seed_count; s++)
+    {
+      const float radius = 2.0f + 2.0f * s;
+
+      for (std::size_t i = 0; i < result.step_count; i++)
+      {
+        const auto& p = result.positions[s * result.step_count + i];
+        const float t = i * i_conf.step_size_h;
+        REQUIRE(p.x == Approx(center + radius * std::cos(t)).margin(1e-2));
+        REQUIRE(p.y == Approx(center + radius * std::sin(t)).margin(1e-2));
+        REQUIRE(p.z == 8.0f);
+      }
+    }
+
+    // Far less than one step per sample
+    const auto stats = tracer.get_rk45_stats();
+    REQUIRE(stats.accepted > 0);
+    REQUIRE(stats.accepted < result.seed_count * result.step_count / 2);
+  }
+
+  SECTION("Fixed arc length resampling")
+  {
+    i_conf.resample_mode    = 2;
+    i_conf.resample_spacing = 0.5f;
+
+    auto result = tracer.trace(s_conf, i_conf);
+
+    for (std::size_t s = 0; s < result.seed_count; s++)
+      for (std::size_t i = 1; i < result.step_count; i++)
+      {
+        const auto* p = &result.positions[s * result.step_count];
+        REQUIRE(glm::distance(glm::vec3(p[i]), glm::vec3(p[i - 1])) == Approx(0.5f).epsilon(2e-2));
+      }
+  }
+
+  SECTION("Every accepted step")
+  {
+    i_conf.resample_mode = 0;
+
+    auto result = tracer.trace(s_conf, i_conf);
+
+    // Steps grow up to step_size_max, the radius is kept
+    const auto* p = &result.positions[3 * result.step_count];
+    REQUIRE(glm::distance(glm::vec3(p[20]), glm::vec3(p[19])) > 1.0f);
+    for (std::size_t i = 0; i < result.step_count; i++)
+      REQUIRE(std::hypot(p[i].x - center, p[i].y - center) == Approx(8.0f).epsilon(1e-3));
+  }
+
+  SECTION("RK45 needs fewer samples than RK4 at equal error")
+  {
+    auto report = jay::compare_rk45_rk4(src, s_conf, i_conf, 4);
+    report.print();
+
+    REQUIRE(report.seeds == 4);
+    REQUIRE(report.rk4_error <= report.rk45_error);
+    REQUIRE(report.rk45_samples_per_length() < report.rk4_samples_per_length());
+  }
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Seed Order Test.", "[jay::integration]")
+{
+  SECTION("Morton keys interleave the bits")
+  {
+    REQUIRE(jay::morton_key(1, 0, 0) == 1);
+    REQUIRE(jay::morton_key(0, 1, 0) == 2);
+    REQUIRE(jay::morton_key(0, 0, 1) == 4);
+    REQUIRE(jay::morton_key(3, 3, 3) == 63);
+    REQUIRE(jay::morton_key(2, 0, 0) == 8);
+  }
+
+  SECTION("The Hilbert curve visits every cell once, in steps to a neighbour")
+  {
+    const glm::uvec3 dims(8, 8, 8);
+    const auto       order = jay::grid_order(dims, jay::SeedOrderHilbert);
+
+    REQUIRE(order.size() == 512);
+
+    auto sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < sorted.size(); i++)
+      REQUIRE(sorted[i] == i);
+
+    auto cell = [&](std::uint32_t i) { return glm::ivec3(i % dims.x, (i / dims.x) % dims.y, i / (dims.x * dims.y)); };
+    for (std::size_t i = 1; i < order.size(); i++)
+    {
+      const auto d = glm::abs(cell(order[i]) - cell(order[i - 1]));
+      REQUIRE(d.x + d.y + d.z == 1);
+    }
+  }
+
+  SECTION("Curves keep consecutive seeds closer than the grid order")
+  {
+    const glm::uvec3 dims(30, 20, 10);
+
+    auto mean_distance = [&](const std::vector<std::uint32_t>& order)
+    {
+      double sum = 0.0;
+      for (std::size_t i = 1; i < order.size(); i++)
+      {
+        const glm::vec3 a(order[i - 1] % dims.x, (order[i - 1] / dims.x) % dims.y, order[i - 1] / (dims.x * dims.y));
+        const glm::vec3 b(order[i]     % dims.x, (order[i]     / dims.x) % dims.y, order[i]     / (dims.x * dims.y));
+        sum += glm::distance(a, b);
+      }
+      return sum / (order.size() - 1);
+    };
+
+    const auto grid    = jay::grid_order(dims, jay::SeedOrderGrid);
+    const auto morton  = jay::grid_order(dims, jay::SeedOrderMorton);
+    const auto hilbert = jay::grid_order(dims, jay::SeedOrderHilbert);
+
+    REQUIRE(grid.size()    == 6000);
+    REQUIRE(morton.size()  == 6000);
+    REQUIRE(hilbert.size() == 6000);
+    REQUIRE(grid[1] == 1);
+
+    CHECK(mean_distance(hilbert) < mean_distance(morton));
+    CHECK(mean_distance(morton)  < mean_distance(grid));
+  }
+
+  SECTION("Ordered traces are written in grid order")
+  {
+    const std::size_t n = 33;
+
+    auto src = jay_test::make_field({ n, n, n }, [&](float x, float y, float z, float)
+    {
+      return glm::vec3(-(y - 16.0f), (x - 16.0f), 0.25f);
+    });
+
+    auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 3.0f, 4.0f), glm::uvec2(1, 31), glm::uvec2(1, 31), glm::uvec2(2, 30), glm::vec3(10, 10, 7));
+    auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.05f, 100);
+
+    jay::cpu_tracer tracer(src, 4);
+    auto reference = tracer.trace(s_conf, i_conf);
+
+    s_conf.ordering = jay::SeedOrderHilbert;
+    auto hilbert = tracer.trace(s_conf, i_conf);
+
+    REQUIRE(hilbert.positions  == reference.positions);
+    REQUIRE(hilbert.velocities == reference.velocities);
+  }
+
+  SECTION("Re-sorting live particles doesn't change the pathlines")
+  {
+    // 16^3 field with 6 timesteps, rotating around the z-axis, getting faster with time
+    auto src = jay_test::make_field({ 16, 16, 16, 6 }, [&](float x, float y, float, float t)
+    {
+      return glm::vec3(-(y - 7.5f) * (1.0f + 0.2f * t), (x - 7.5f) * (1.0f + 0.2f * t), 0.1f);
+    });
+
+    auto s_conf = jay_test::make_seeding(glm::vec3(1.5f, 1.5f, 2.0f), glm::uvec2(1, 15), glm::uvec2(1, 15), glm::uvec2(1, 15), glm::vec3(9, 9, 7), jay::SeedOrderMorton);
+    auto i_conf = jay_test::make_integration(glm::uvec4(16, 16, 16, 6), jay::StrategyRK4, 0.1f, 50, 0.1f);
+    i_conf.cell_size        = glm::vec4(1.0f);
+    i_conf.local_step_count = 10;
+
+    jay::unsteady_cpu_tracer tracer(src, 3);
+    auto reference = tracer.trace(s_conf, i_conf);
+
+    tracer.set_resort_interval(1);
+    auto sorted = tracer.trace(s_conf, i_conf);
+
+    REQUIRE(sorted.positions  == reference.positions);
+    REQUIRE(sorted.velocities == reference.velocities);
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef JAY_TESTS_TEST_FIELDS_HPP
+#define JAY_TESTS_TEST_FIELDS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <highfive/H5File.hpp>
+
+#include <jay/advection/field_objects.hpp>
+#include <jay/types/jaydata.hpp>
+
+// Fields & configs shared by the tracer tests
+namespace jay_test
+{
+  /* Vectorlike 3-component field on grid (x, y, z(, t)), node values f(x, y, z, t) -> glm::vec3.
+   * More than 1 timestep makes a 4D field, otherwise t is 0.
+   */
+  template <typename F>
+  inline jaySrc<float> make_field(const std::vector<std::size_t>& grid, F f)
+  {
+    const std::size_t timesteps = (grid.size() > 3) ? grid[3] : 1;
+
+    jaySrc<float> src;
+    src.grid     = grid;
+    src.grid_dim = (timesteps > 1) ? 4 : 3;
+    src.vec_len  = 3;
+    src.ordering = jay::Order::VectorFirst;
+    src.data.resize(grid[0] * grid[1] * grid[2] * timesteps * 3);
+
+    float* v = src.data.data();
+    for (std::size_t t = 0; t < timesteps; t++)
+      for (std::size_t z = 0; z < grid[2]; z++)
+        for (std::size_t y = 0; y < grid[1]; y++)
+          for (std::size_t x = 0; x < grid[0]; x++, v += 3)
+          {
+            const glm::vec3 value = f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), static_cast<float>(t));
+            v[0] = value.x;
+            v[1] = value.y;
+            v[2] = value.z;
+          }
+
+    return src;
+  }
+
+  // Writes a vectorlike field as one dataset per component, stored slowest first: (t,) z, y, x
+  inline void write_hdf5(const std::string& filepath, const std::vector<std::string>& datasets, const jaySrc<float>& src)
+  {
+    const std::size_t timesteps = (src.grid_dim > 3) ? src.grid[3] : 1;
+    const std::size_t elements  = src.grid[0] * src.grid[1] * src.grid[2] * timesteps;
+
+    std::vector<std::size_t> dims = { src.grid[2], src.grid[1], src.grid[0] };
+    if (src.grid_dim > 3)
+      dims.insert(dims.begin(), timesteps);
+
+    HighFive::File file(filepath, HighFive::File::Overwrite);
+    std::vector<float> component(elements);
+    for (std::size_t c = 0; c < datasets.size(); c++)
+    {
+      for (std::size_t i = 0; i < elements; i++)
+        component[i] = src.data[i * src.vec_len + c];
+
+      auto dataset = file.createDataSet<float>(datasets[c], HighFive::DataSpace(dims));
+      dataset.write_raw(component.data());
+    }
+  }
+
+  // n^3 field rotating around the z-axis through (center, center) (linear => trilinear is exact)
+  inline jaySrc<float> rotation_field(std::size_t n, float center)
+  {
+    return make_field({ n, n, n }, [&](float x, float y, float, float) { return glm::vec3(-(y - center), x - center, 0.0f); });
+  }
+
+  inline jay::seeding_conf make_seeding(const glm::vec3& stride, const glm::uvec2& range_x, const glm::uvec2& range_y, const glm::uvec2& range_z, const glm::vec3& seeds, unsigned int ordering = jay::SeedOrderGrid)
+  {
+    jay::seeding_conf s_conf;
+    s_conf.stride   = stride;
+    s_conf.range_x  = range_x;
+    s_conf.range_y  = range_y;
+    s_conf.range_z  = range_z;
+    s_conf.seeds    = seeds;
+    s_conf.ordering = ordering;
+    return s_conf;
+  }
+
+  // texelFetch sampling, unit cells, all steps in one pass (grid.w > 0 for unsteady fields)
+  inline jay::integration_conf make_integration(const glm::uvec4& grid, unsigned int strategy, float step_size_h, unsigned int step_count, float step_size_dt = 0.0f)
+  {
+    jay::integration_conf i_conf;
+    i_conf.strategy             = strategy;
+    i_conf.texelfetch           = 1;
+    i_conf.grid                 = grid;
+    i_conf.cell_size            = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+    i_conf.step_size_h          = step_size_h;
+    i_conf.step_size_dt         = step_size_dt;
+    i_conf.dataset_factor       = 1.0f;
+    i_conf.global_step_count    = step_count;
+    i_conf.local_step_count     = step_count;
+    i_conf.remainder_step_count = 0;
+    return i_conf;
+  }
+}
+
+#endif
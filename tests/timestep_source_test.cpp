@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("Timestep Source Test.", "[jay::io]")
+{
+  // Synthetic 4x3x2 field with 6 timesteps: every value encodes its timestep
+  const std::vector<std::size_t> grid = { 4, 3, 2, 6 };
+  const std::size_t              vec_len = 3;
+
+  std::atomic<int> reads{ 0 };
+  auto reader = [&](std::size_t t, float* dst)
+  {
+    reads++;
+    for (std::size_t i = 0; i < grid[0] * grid[1] * grid[2] * vec_len; i++)
+      dst[i] = static_cast<float>(t * 1000 + i);
+  };
+
+  jay::timestep_source source(reader, grid, 4, vec_len, 3);
+
+  REQUIRE(source.timesteps()      == 6);
+  REQUIRE(source.resident_steps() == 3);
+  REQUIRE(source.slice_elements() == 4 * 3 * 2 * 3);
+
+  SECTION("Consumes all timesteps in order")
+  {
+    for (std::size_t t = 0; t + 1 < source.timesteps(); t++)
+    {
+      auto s0 = source.slice(t);
+      auto s1 = source.slice(t + 1);
+
+      REQUIRE(s0[0]  == Approx(t * 1000.0f));
+      REQUIRE(s1[5]  == Approx((t + 1) * 1000.0f + 5));
+
+      source.release(t);
+    }
+
+    // Every timestep is read exactly once
+    REQUIRE(reads == 6);
+  }
+
+  SECTION("Restarts after jumping back")
+  {
+    source.slice(4);
+    auto s = source.slice(1);
+
+    REQUIRE(s[2] == Approx(1002.0f));
+  }
+
+  REQUIRE(source.slice(10) == nullptr);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Trace Cache Test.", "[jay::integration]")
+{
+  // Synthetic 33^3 field with a swirl & a drift in z
+  const std::size_t n = 33;
+
+  auto src = jay_test::make_field({ n, n, n }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(-(y - 16.0f) * 0.3f, (x - 16.0f) * 0.3f, 0.2f * std::sin(0.2f * x));
+  });
+
+  auto s_conf = jay_test::make_seeding(glm::vec3(2.0f, 2.0f, 2.0f), glm::uvec2(2, 30), glm::uvec2(2, 30), glm::uvec2(4, 28), glm::vec3(14, 14, 12));
+  auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.05f, 300);
+
+  jay::cpu_tracer    reference_tracer(src, 4);
+  jay::cached_tracer tracer(src, 256 * 1024 * 1024, 4);
+
+  auto same = [&](const jay::seeding_conf& s, const jay::integration_conf& i)
+  {
+    auto reference = reference_tracer.trace(s, i);
+    auto cached    = tracer.trace(s, i);
+
+    REQUIRE(cached.positions.size() == reference.positions.size());
+    for (std::size_t v = 0; v < reference.positions.size(); v++)
+    {
+      REQUIRE(cached.positions [v] == reference.positions [v]);
+      REQUIRE(cached.velocities[v] == reference.velocities[v]);
+    }
+  };
+
+  SECTION("Only new seeds are integrated")
+  {
+    same(s_conf, i_conf);
+    REQUIRE(tracer.get_traced_seeds() == 14 * 14 * 12);
+
+    // Revisiting the configuration
+    same(s_conf, i_conf);
+    REQUIRE(tracer.get_traced_seeds() == 0);
+
+    // Half the range in x: all seeds are known
+    auto narrow = s_conf;
+    narrow.range_x = glm::uvec2(2, 16);
+    narrow.seeds.x = 7;
+    same(narrow, i_conf);
+    REQUIRE(tracer.get_traced_seeds() == 0);
+
+    // Twice the density in y: every second row is new
+    auto dense = s_conf;
+    dense.stride.y = 1.0f;
+    dense.seeds.y  = 28;
+    same(dense, i_conf);
+    REQUIRE(tracer.get_traced_seeds() == 14 * 14 * 12);
+
+    // Other parameters trace everything again
+    auto euler = i_conf;
+    euler.strategy = jay::StrategyEuler;
+    same(s_conf, euler);
+    REQUIRE(tracer.get_traced_seeds() == 14 * 14 * 12);
+
+    REQUIRE(tracer.get_cache().get_stats().evictions == 0);
+    REQUIRE(tracer.get_cache().size() == 3 * 14 * 14 * 12);
+  }
+
+  SECTION("The budget is kept")
+  {
+    // Room for 100 trajectories
+    const std::size_t trajectory_bytes = 2 * 300 * sizeof(glm::vec4);
+    tracer.get_cache().set_budget(100 * trajectory_bytes);
+
+    same(s_conf, i_conf);
+    REQUIRE(tracer.get_cache().size() == 100);
+    REQUIRE(tracer.get_cache().byte_size() <= tracer.get_cache().get_budget());
+    REQUIRE(tracer.get_cache().get_stats().evictions == 14 * 14 * 12 - 100);
+
+    // The most recently traced seeds are kept
+    same(s_conf, i_conf);
+    REQUIRE(tracer.get_traced_seeds() < 14 * 14 * 12);
+    REQUIRE(tracer.get_cache().byte_size() <= tracer.get_cache().get_budget());
+  }
+
+  SECTION("Fields are told apart by their content")
+  {
+    // Same values at another address
+    auto copy = src;
+    REQUIRE(jay::trace_cache::field_id(copy) == jay::trace_cache::field_id(src));
+
+    // A single value differs
+    auto changed = src;
+    changed.data[3 * (16 * n * n + 16 * n + 16)] += 1.0f;
+    REQUIRE(jay::trace_cache::field_id(changed) != jay::trace_cache::field_id(src));
+
+    // Other parameters of the same field
+    auto euler = i_conf;
+    euler.strategy = jay::StrategyEuler;
+    REQUIRE(jay::trace_cache::params_id(i_conf) != jay::trace_cache::params_id(euler));
+    REQUIRE(jay::trace_cache::params_id(i_conf, 1) != jay::trace_cache::params_id(i_conf, 2));
+
+    jay::cached_tracer changed_tracer(changed, 256 * 1024 * 1024, 4);
+    REQUIRE(changed_tracer.trace(s_conf, i_conf).positions != reference_tracer.trace(s_conf, i_conf).positions);
+  }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("Trajectory Export Test.", "[jay::engine]")
+{
+  // The application provides the GL context
+  auto application = std::make_unique<jay::application>();
+
+  const std::uint32_t seeds    = 300;
+  const std::uint32_t steps    = 400;
+  const std::string   filepath = "trajectory_export_test.positions";
+
+  std::vector<glm::vec4> positions(seeds * steps);
+  for (std::uint32_t s = 0; s < seeds; s++)
+    for (std::uint32_t i = 0; i < steps; i++)
+      positions[s * steps + i] = glm::vec4(10.0f * std::cos(0.02f * i + s), 10.0f * std::sin(0.02f * i + s), 0.01f * i, 1.0f);
+
+  auto check_file = [&](const std::vector<std::uint32_t>& lengths)
+  {
+    jay::trajectory_header hdr;
+    auto loaded = jay::trajectory_io::load(filepath, &hdr);
+
+    REQUIRE(hdr.seeds == seeds);
+    REQUIRE(hdr.steps == steps);
+    REQUIRE(loaded.size() == 4 * positions.size());
+
+    // Frozen after the last valid vertex
+    float max_error = 0.0f;
+    for (std::uint32_t s = 0; s < seeds; s++)
+      for (std::uint32_t i = 0; i < steps; i++)
+      {
+        const auto& p = positions[s * steps + std::min(i, (lengths.empty() ? steps : lengths[s]) - 1)];
+        for (int c = 0; c < 3; c++)
+          max_error = std::max(max_error, std::abs(loaded[4 * (s * steps + i) + c] - p[c]));
+      }
+
+    CHECK(max_error < 1e-3f);
+    std::remove(filepath.c_str());
+  };
+
+  SECTION("The source can be replaced while the export runs")
+  {
+    auto source = globjects::Buffer::create();
+    source->setData(positions, gl::GL_DYNAMIC_DRAW);
+
+    // Small chunks, so the export takes many updates
+    jay::trajectory_export exporter(source.get(), seeds, steps, jay::trajectory_kind::Positions, filepath, 16 * steps * sizeof(glm::vec4), 2);
+    exporter.update();
+
+    // Overwritten, then released (e.g. by a new advection)
+    source->setData(std::vector<glm::vec4>(positions.size(), glm::vec4(-1.0f)), gl::GL_DYNAMIC_DRAW);
+    source = nullptr;
+
+    REQUIRE(exporter.finish());
+    REQUIRE(exporter.done());
+    REQUIRE(exporter.progress() == 1.0f);
+    check_file({});
+  }
+
+  SECTION("Compacted sources are exported seed by seed")
+  {
+    std::vector<std::uint32_t> lengths(seeds);
+    std::vector<glm::vec4>     packed;
+    for (std::uint32_t s = 0; s < seeds; s++)
+    {
+      lengths[s] = 1 + (s * 37) % steps;
+      packed.insert(packed.end(), positions.begin() + s * steps, positions.begin() + s * steps + lengths[s]);
+    }
+
+    auto source = globjects::Buffer::create();
+    source->setData(packed, gl::GL_DYNAMIC_DRAW);
+
+    jay::trajectory_export exporter(source.get(), lengths, steps, jay::trajectory_kind::Positions, filepath, 16 * steps * sizeof(glm::vec4), 2);
+    source = nullptr;
+
+    while (!exporter.update());
+
+    REQUIRE(!exporter.failed());
+    check_file(lengths);
+  }
+}
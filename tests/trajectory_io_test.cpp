@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("Trajectory I/O Test.", "[jay::io]")
+{
+  const std::uint32_t seeds    = 500;
+  const std::uint32_t steps    = 2000;
+  const std::string   filepath = "trajectory_io_test.positions";
+
+  // Synthetic helices in a 128^3 domain, every second one leaves the domain halfway
+  std::vector<float> positions(4 * seeds * steps);
+  for (std::uint32_t s = 0; s < seeds; s++)
+    for (std::uint32_t i = 0; i < steps; i++)
+    {
+      const auto t = (s % 2 == 1 && i > steps / 2) ? steps / 2 : i;
+      float* p = &positions[4 * (s * steps + i)];
+
+      p[0] = 64.0f + 20.0f * std::cos(0.01f * t + s);
+      p[1] = 64.0f + 20.0f * std::sin(0.01f * t + s);
+      p[2] = 0.05f * t + 0.1f * s;
+      p[3] = 1.0f;
+    }
+
+  const auto filesize = jay::trajectory_io::store(positions.data(), seeds, steps, jay::trajectory_kind::Positions, filepath);
+  REQUIRE(filesize > 0);
+  REQUIRE(jay::trajectory_io::is_trajectory_file(filepath));
+
+  // At least 4x smaller than the raw vec4 export
+  const auto raw_size = sizeof(std::uint32_t) + positions.size() * sizeof(float);
+  CHECK(raw_size / static_cast<double>(filesize) >= 4.0);
+
+  jay::trajectory_header hdr;
+  auto loaded = jay::trajectory_io::load(filepath, &hdr);
+
+  REQUIRE(hdr.seeds == seeds);
+  REQUIRE(hdr.steps == steps);
+  REQUIRE(loaded.size() == positions.size());
+
+  // 16 bit per component inside the box of each seed (< 64 units)
+  float max_error = 0.0f;
+  for (std::size_t i = 0; i < loaded.size(); i++)
+    max_error = std::max(max_error, std::abs(loaded[i] - positions[i]));
+
+  CHECK(max_error < 64.0f / 65535.0f);
+
+  // Random access matches the streamed result
+  std::vector<float> seed(4 * steps);
+  jay::trajectory_reader reader(filepath);
+  REQUIRE(reader.read_seed(123, seed.data()));
+  REQUIRE(seed[4 * 1999 + 2] == loaded[4 * (123 * steps + 1999) + 2]);
+
+  std::remove(filepath.c_str());
+
+  // Compacted (early terminated) seeds read back as their frozen full length trajectories
+  std::vector<std::uint32_t> lengths(seeds);
+  std::vector<float>         packed;
+  for (std::uint32_t s = 0; s < seeds; s++)
+  {
+    lengths[s] = (s % 2 == 1) ? steps / 2 + 1 : steps;
+    packed.insert(packed.end(), &positions[4 * s * steps], &positions[4 * (s * steps + lengths[s])]);
+  }
+
+  {
+    jay::trajectory_writer writer(filepath, jay::trajectory_kind::Positions, seeds, steps);
+    REQUIRE(writer.append(packed.data(), lengths.data(), seeds));
+    REQUIRE(writer.close() > 0);
+  }
+
+  auto unpacked = jay::trajectory_io::load(filepath);
+  REQUIRE(unpacked.size() == loaded.size());
+
+  max_error = 0.0f;
+  for (std::size_t i = 0; i < unpacked.size(); i++)
+    max_error = std::max(max_error, std::abs(unpacked[i] - positions[i]));
+
+  CHECK(max_error < 64.0f / 65535.0f);
+
+  std::remove(filepath.c_str());
+
+  // The header round-trips, files of another version are rejected
+  const std::string velocities = "trajectory_io_test.velocities";
+  REQUIRE(jay::trajectory_io::store(positions.data(), 10, steps, jay::trajectory_kind::Velocities, velocities, 12) > 0);
+
+  {
+    jay::trajectory_reader reader(velocities);
+    REQUIRE(reader.good());
+
+    const auto& stored = reader.header();
+    REQUIRE(std::string(stored.magic, 4) == "JTRJ");
+    REQUIRE(stored.kind  == static_cast<std::uint8_t>(jay::trajectory_kind::Velocities));
+    REQUIRE(stored.bits  == 12);
+    REQUIRE(stored.seeds == 10);
+    REQUIRE(stored.steps == steps);
+    REQUIRE(stored.index_offset > sizeof(jay::trajectory_header));
+    hdr = stored;
+  }
+
+  {
+    std::fstream file(velocities, std::ios::in | std::ios::out | std::ios::binary);
+    const std::uint16_t version = hdr.version + 1;
+    file.seekp(offsetof(jay::trajectory_header, version));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  }
+
+  REQUIRE(jay::trajectory_io::is_trajectory_file(velocities));
+  REQUIRE(!jay::trajectory_reader(velocities).good());
+  REQUIRE(jay::trajectory_io::load(velocities).empty());
+
+  // Legacy raw exports start with the seed count
+  {
+    std::ofstream file(velocities, std::ios::out | std::ios::binary | std::ios::trunc);
+    const std::uint32_t legacy_seeds = seeds;
+    file.write(reinterpret_cast<const char*>(&legacy_seeds), sizeof(legacy_seeds));
+    file.write(reinterpret_cast<const char*>(positions.data()), 4 * steps * sizeof(float));
+  }
+
+  REQUIRE(!jay::trajectory_io::is_trajectory_file(velocities));
+
+  std::remove(velocities.c_str());
+}
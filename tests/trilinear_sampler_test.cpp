@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("Trilinear Sampler Test.", "[jay::integration]")
+{
+  // Random 17 x 13 x 9 field
+  const std::size_t X = 17, Y = 13, Z = 9;
+
+  std::mt19937                          rng(42);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+  jaySrc<float> src;
+  src.grid     = { X, Y, Z };
+  src.grid_dim = 3;
+  src.vec_len  = 3;
+  src.ordering = jay::Order::VectorFirst;
+  src.data.resize(X * Y * Z * 3);
+  for (auto& v : src.data)
+    v = value(rng);
+
+  jay::field_view         field(src);
+  jay::texelfetch_sampler reference(field);
+  jay::trilinear_sampler  sampler(field);
+
+  // Includes positions on and slightly beyond the border
+  const std::size_t n = 1001;
+  std::uniform_real_distribution<float> px(-0.5f, X - 0.5f), py(-0.5f, Y - 0.5f), pz(-0.5f, Z - 0.5f);
+
+  std::vector<float> x(n), y(n), z(n), vx(n), vy(n), vz(n);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    x[i] = px(rng);
+    y[i] = py(rng);
+    z[i] = pz(rng);
+  }
+  x[0] = X - 1.0f; y[0] = Y - 1.0f; z[0] = Z - 1.0f;
+  x[1] = 0.0f;     y[1] = 0.0f;     z[1] = 0.0f;
+
+  SECTION("Matches the texelFetch reference")
+  {
+    for (std::size_t i = 0; i < n; i++)
+    {
+      const auto a = reference(glm::vec3(x[i], y[i], z[i]));
+      const auto b = sampler  (glm::vec3(x[i], y[i], z[i]));
+
+      REQUIRE(b.x == Approx(a.x).margin(1e-5));
+      REQUIRE(b.y == Approx(a.y).margin(1e-5));
+      REQUIRE(b.z == Approx(a.z).margin(1e-5));
+    }
+  }
+
+  SECTION("Batches match single samples")
+  {
+    sampler.sample(n, x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data());
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+      const auto a = sampler(glm::vec3(x[i], y[i], z[i]));
+
+      REQUIRE(vx[i] == Approx(a.x).margin(1e-5));
+      REQUIRE(vy[i] == Approx(a.y).margin(1e-5));
+      REQUIRE(vz[i] == Approx(a.z).margin(1e-5));
+    }
+  }
+
+  SECTION("Fields of 2^31 floats or more aren't gathered with 32 bit offsets")
+  {
+    REQUIRE(sampler.gather);
+
+    // Only the size matters, nothing is read
+    REQUIRE( jay::trilinear_sampler(jay::field_view(src.data.data(), 1024, 1024, 682)).gather);
+    REQUIRE(!jay::trilinear_sampler(jay::field_view(src.data.data(), 1024, 1024, 683)).gather);
+    REQUIRE(!jay::trilinear_sampler(jay::field_view(src.data.data(), 2048, 2048, 2048)).gather);
+  }
+
+  SECTION("regular_grid interpolates a single component")
+  {
+    jay::regular_grid<float, 3> grid(std::vector<std::size_t>{ Z, Y, X });
+    for (std::size_t k = 0; k < Z; k++)
+      for (std::size_t j = 0; j < Y; j++)
+        for (std::size_t i = 0; i < X; i++)
+          grid.data[k][j][i] = src.data[3 * ((k * Y + j) * X + i) + 1];
+
+    for (std::size_t i = 2; i < n; i++)
+    {
+      if (x[i] < 0 || y[i] < 0 || z[i] < 0 || x[i] >= X - 1 || y[i] >= Y - 1 || z[i] >= Z - 1)
+        continue;
+
+      const auto a = sampler(glm::vec3(x[i], y[i], z[i]));
+      REQUIRE(grid.interpolate(glm::vec3(z[i], y[i], x[i])) == Approx(a.y).margin(1e-5));
+    }
+  }
+}
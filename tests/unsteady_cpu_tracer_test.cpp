@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+#include <jay/api.hpp>
+
+
+TEST_CASE("Unsteady CPU Tracer Test.", "[jay::integration]")
+{
+  // 8^3 field with 4 timesteps, uniform flow in x with speed 0.1 * (t + 1)
+  const std::vector<std::size_t> grid = { 8, 8, 8, 4 };
+  const std::size_t              slice = grid[0] * grid[1] * grid[2] * 3;
+
+  jaySrc<float> src;
+  src.grid     = grid;
+  src.grid_dim = 4;
+  src.vec_len  = 3;
+  src.ordering = jay::Order::VectorFirst;
+  src.data.resize(slice * grid[3], 0.0f);
+  for (std::size_t t = 0; t < grid[3]; t++)
+    for (std::size_t i = 0; i < slice; i += 3)
+      src.data[t * slice + i] = 0.1f * (t + 1);
+
+  // 2 x 2 x 1 seeds
+  jay::seeding_conf s_conf;
+  s_conf.stride  = glm::vec3(2.0f, 2.0f, 1.0f);
+  s_conf.range_x = glm::uvec2(1, 5);
+  s_conf.range_y = glm::uvec2(1, 5);
+  s_conf.range_z = glm::uvec2(3, 4);
+  s_conf.seeds   = glm::vec3(2, 2, 1);
+
+  // 3 full passes a 4 steps and 2 remainder steps
+  jay::integration_conf i_conf;
+  i_conf.strategy          = 1;
+  i_conf.texelfetch        = 1;
+  i_conf.grid              = glm::uvec4(8, 8, 8, 4);
+  i_conf.cell_size         = glm::vec4(1.0f);
+  i_conf.step_size_h       = 0.5f;
+  i_conf.step_size_dt      = 0.25f;
+  i_conf.dataset_factor    = 1.0f;
+  i_conf.global_step_count = 14;
+  i_conf.local_step_count  = 4;
+  i_conf.remainder_step_count = 2;
+
+  jay::unsteady_cpu_tracer tracer(src, 2);
+  auto result = tracer.trace(s_conf, i_conf);
+
+  REQUIRE(result.seed_count == 4);
+  REQUIRE(result.positions.size() == 4 * 14);
+
+  for (std::size_t s = 0; s < result.seed_count; s++)
+  {
+    const auto* p = &result.positions [s * result.step_count];
+    const auto* v = &result.velocities[s * result.step_count];
+
+    // RK4 on a flow linear in time yields the velocity in the middle of the step
+    for (std::size_t t = 0; t < 3; t++)
+      for (std::size_t i = 0; i < 4; i++)
+        REQUIRE(v[4 * t + i].x == Approx(0.1f * (t + 1) + 0.1f * (i + 0.5f) / 4.0f));
+
+    // Remainder steps only see the last timestep
+    REQUIRE(v[12].x == Approx(0.4f));
+    REQUIRE(v[13].x == Approx(0.4f));
+
+    // The pathline continues across passes
+    for (std::size_t i = 1; i < result.step_count; i++)
+      REQUIRE(p[i].x == Approx(p[i - 1].x + 0.5f * v[i - 1].x));
+  }
+
+  SECTION("Streaming the timesteps gives the same pathlines")
+  {
+    auto reader = [&](std::size_t t, float* dst)
+    {
+      std::copy(src.data.begin() + t * slice, src.data.begin() + (t + 1) * slice, dst);
+    };
+
+    jay::timestep_source     source(reader, grid, 4, 3, 2);
+    jay::unsteady_cpu_tracer streaming(source, 2);
+
+    i_conf.strategy   = 0;
+    i_conf.texelfetch = 0;
+    auto a = tracer   .trace(s_conf, i_conf);
+    auto b = streaming.trace(s_conf, i_conf);
+
+    for (std::size_t i = 0; i < a.positions.size(); i++)
+    {
+      REQUIRE(a.positions [i].x == b.positions [i].x);
+      REQUIRE(a.velocities[i].x == b.velocities[i].x);
+    }
+  }
+}
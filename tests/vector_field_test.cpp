@@ -0,0 +1,199 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Vector Field Test.", "[jay::engine]")
+{
+  // The application provides the GL context
+  auto application = std::make_unique<jay::application>();
+  auto menu        = application->add_menu();
+
+  // Synthetic 33^3 field with a swirl & a drift in z
+  const std::size_t n = 33;
+
+  auto src = jay_test::make_field({ n, n, n }, [&](float x, float y, float z, float)
+  {
+    return glm::vec3(-(y - 16.0f) * 0.3f, (x - 16.0f) * 0.3f, 0.2f * std::sin(0.2f * x));
+  });
+
+  menu->useSrcInfo("vector_field_test", src);
+  menu->useSeedingParams();
+  menu->useIntegrationParams();
+
+  menu->seed_stride           = glm::vec3(2.0f, 2.0f, 2.0f);
+  menu->seed_range_x          = glm::uvec2(2, 30);
+  menu->seed_range_y          = glm::uvec2(2, 30);
+  menu->seed_range_z          = glm::uvec2(4, 28);
+  menu->seed_directional      = glm::uvec3(14, 14, 12);
+  menu->int_strategy          = jay::StrategyRK4;
+  menu->int_step_size_h       = 0.05f;
+  menu->int_global_step_count = 200;
+  menu->int_local_step_count  = 200;
+
+  jay::vector_field field(true);
+  field.init_configuration(menu, false, false);
+  field.setup_compute_shader(false, false);
+  field.compute_program->use();
+  field.setup_storage_buffers(false);
+  field.setup_uniform_buffers(false);
+  field.setup_textures(false);
+  field.update_texture(src.data.data(), 0, false);
+  field.update_global_time(0U);
+
+  auto trace = [&](bool cached)
+  {
+    field.update_configuration(menu);
+    field.update_seeding(false);
+    field.update_integration(false);
+    field.update_storage_buffers(false);
+
+    if (cached)
+      field.advect_cached(false);
+    else
+      field.advect(false);
+    field.compact(false);
+
+    return std::make_pair(field.get_result()->get_positions<glm::vec4>(), field.get_result()->get_velocity<glm::vec4>());
+  };
+
+  auto same = [&](bool termination)
+  {
+    menu->int_early_termination = termination;
+    const auto reference = trace(false);
+    const auto cached    = trace(true);
+
+    REQUIRE(cached.first  == reference.first);
+    REQUIRE(cached.second == reference.second);
+
+    // The new trajectories arrive in the cache once their copies are done
+    REQUIRE(field.fetch_cached_traces(true));
+  };
+
+  SECTION("Cached advections match full ones")
+  {
+    field.set_trace_cache(256 * 1024 * 1024);
+    REQUIRE(field.caching());
+
+    for (auto termination : { false, true })
+    {
+      field.get_trace_cache()->clear();
+
+      same(termination);
+      REQUIRE(field.get_traced_seeds() == 14 * 14 * 12);
+
+      // Revisiting the configuration
+      same(termination);
+      REQUIRE(field.get_traced_seeds() == 0);
+
+      // Twice the density in y: every second row is dispatched
+      menu->seed_stride.y      = 1.0f;
+      menu->seed_directional.y = 28;
+      same(termination);
+      REQUIRE(field.get_traced_seeds() == 14 * 14 * 12);
+
+      menu->seed_stride.y      = 2.0f;
+      menu->seed_directional.y = 14;
+    }
+  }
+
+  SECTION("Cached advections keep the seed order")
+  {
+    field.set_trace_cache(256 * 1024 * 1024);
+    menu->seed_ordering = jay::SeedOrderHilbert;
+
+    same(false);
+    // Twice the density in y: the missing seeds are dispatched along the curve
+    menu->seed_stride.y      = 1.0f;
+    menu->seed_directional.y = 28;
+    same(false);
+    REQUIRE(field.get_traced_seeds() == 14 * 14 * 12);
+  }
+
+  SECTION("Only trajectories within the budget are cached")
+  {
+    // 200 steps of positions & velocities per seed
+    const std::size_t seed_bytes = 2 * 200 * sizeof(glm::vec4);
+    field.set_trace_cache(100 * seed_bytes);
+
+    same(false);
+    REQUIRE(field.get_trace_cache()->size() == 100);
+    REQUIRE(field.get_trace_cache()->byte_size() <= 100 * seed_bytes);
+    REQUIRE(field.get_trace_cache()->get_stats().evictions == 0);
+
+    same(false);
+    REQUIRE(field.get_traced_seeds() == 14 * 14 * 12 - 100);
+  }
+
+  SECTION("Progressive advections match full ones")
+  {
+    for (auto termination : { false, true })
+    {
+      menu->int_early_termination = termination;
+      const auto reference = trace(false);
+
+      field.update_configuration(menu);
+      field.update_seeding(false);
+      field.update_integration(false);
+      field.update_storage_buffers(false);
+      field.begin_progressive(16);
+
+      // A small budget spreads the trace over many frames
+      std::size_t frames = 1;
+      while (!field.advect_progressive(0.5))
+      {
+        REQUIRE(field.in_progress());
+        frames++;
+      }
+      field.compact(false);
+
+      REQUIRE(frames > 1);
+      REQUIRE(field.get_progress() == 1.0f);
+      REQUIRE(field.get_result()->get_positions<glm::vec4>() == reference.first);
+      REQUIRE(field.get_result()->get_velocity<glm::vec4>()  == reference.second);
+    }
+  }
+
+  SECTION("Compacted traces are read back packed")
+  {
+    menu->int_early_termination = true;
+    const auto full = trace(false);
+
+    std::vector<gl::GLuint> first, count;
+    field.get_result()->get_trace_ranges(first, count);
+    const auto packed = field.get_result()->get_packed_positions<glm::vec4>();
+
+    REQUIRE(first.size() == 14 * 14 * 12);
+    REQUIRE(packed.size() <= full.first.size());
+
+    // Seed s holds its vertices from first[s] on, the full layout freezes them after the last one
+    const std::size_t steps = full.first.size() / first.size();
+    std::size_t vertices = 0;
+    for (std::size_t s = 0; s < first.size(); s++)
+    {
+      REQUIRE(first[s] == vertices);
+      for (std::size_t i = 0; i < count[s]; i++)
+        REQUIRE(packed[first[s] + i] == full.first[s * steps + i]);
+      vertices += count[s];
+    }
+    REQUIRE(packed.size() == vertices);
+  }
+
+  SECTION("A new texture invalidates the cached trajectories")
+  {
+    field.set_trace_cache(256 * 1024 * 1024);
+
+    same(false);
+    field.update_texture(src.data.data(), 0, false);
+    same(false);
+    REQUIRE(field.get_traced_seeds() == 14 * 14 * 12);
+
+    field.set_trace_cache(0);
+    REQUIRE(!field.caching());
+  }
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <jay/api.hpp>
+
+#include "test_fields.hpp"
+
+
+TEST_CASE("Work Stealing Test.", "[jay::integration]")
+{
+  SECTION("Every chunk runs once, idle threads steal from the busy one")
+  {
+    const std::size_t chunks = 64;
+
+    jay::work_stealing_scheduler scheduler(4);
+
+    // All the work is in the range of thread 0
+    std::vector<std::atomic<int>> runs(chunks);
+    scheduler.run(chunks, [&](unsigned int thread, std::size_t chunk)
+    {
+      runs[chunk]++;
+      if (chunk < chunks / 4)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    });
+
+    for (const auto& r : runs)
+      REQUIRE(r == 1);
+
+    const auto& stats = scheduler.get_stats();
+    REQUIRE(stats.size() == 4);
+
+    std::size_t executed = 0, steals = 0;
+    for (const auto& s : stats)
+    {
+      executed += s.chunks;
+      steals   += s.steals;
+      REQUIRE(s.busy_ms + s.idle_ms == Approx(scheduler.get_run_time()).margin(1e-6));
+    }
+    REQUIRE(executed == chunks);
+    REQUIRE(steals > 0);
+
+    // Thread 0 alone would need 16 * 5 ms
+    CHECK(stats[0].chunks < chunks / 4);
+  }
+
+  SECTION("More threads than chunks")
+  {
+    jay::work_stealing_scheduler scheduler(8);
+
+    std::atomic<std::size_t> sum { 0 };
+    scheduler.run(3, [&](unsigned int, std::size_t chunk) { sum += chunk + 1; });
+    REQUIRE(sum == 6);
+
+    scheduler.run(0, [&](unsigned int, std::size_t) { sum = 0; });
+    REQUIRE(sum == 6);
+  }
+
+  SECTION("Traces don't depend on the thread count")
+  {
+    const std::size_t n = 33;
+
+    // Rotation around the z-axis, most seeds leave the domain early
+    auto src = jay_test::make_field({ n, n, n }, [&](float x, float y, float z, float)
+    {
+      return glm::vec3(-(y - 16.0f), (x - 16.0f), 0.5f);
+    });
+
+    // 11 x 7 x 5 seeds (partial tiles in all directions)
+    auto s_conf = jay_test::make_seeding(glm::vec3(3.0f, 4.0f, 6.0f), glm::uvec2(0, 33), glm::uvec2(2, 30), glm::uvec2(1, 31), glm::vec3(11, 7, 5));
+    auto i_conf = jay_test::make_integration(glm::uvec4(n, n, n, 0), jay::StrategyRK4, 0.05f, 200);
+
+    jay::cpu_tracer single(src, 1);
+    jay::cpu_tracer many  (src, 6);
+
+    auto a = single.trace(s_conf, i_conf);
+    auto b = many  .trace(s_conf, i_conf);
+
+    REQUIRE(a.seed_count == 11 * 7 * 5);
+    REQUIRE(a.positions  == b.positions);
+    REQUIRE(a.velocities == b.velocities);
+
+    // Seeds are written at their dispatch index
+    const auto seeds = jay::cpu_tracer::make_seeds(s_conf);
+    for (std::size_t s = 0; s < seeds.size(); s++)
+      REQUIRE(b.positions[s * b.step_count] == seeds[s]);
+
+    REQUIRE(many.get_scheduler().get_stats().size() == 6);
+  }
+}